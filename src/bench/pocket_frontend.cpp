@@ -0,0 +1,131 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <bench/bench.h>
+#include <pocketdb/web/PocketFrontend.h>
+
+#include <fs.h>
+#include <sync.h>
+#include <tinyformat.h>
+#include <util/system.h>
+
+#include <event2/buffer.h>
+
+#include <cassert>
+#include <fstream>
+
+// Frontend bundle - scripts and styles from a few KB to 4 MB
+static const int STATIC_FILES = 24;
+
+class StaticRoot
+{
+public:
+    fs::path Path;
+    std::vector<std::string> Files;
+
+    StaticRoot()
+    {
+        Path = fs::temp_directory_path() / fs::unique_path("pocket_frontend_%%%%%%%%");
+        fs::create_directories(Path);
+
+        for (int i = 0; i < STATIC_FILES; i++)
+        {
+            std::string name = strprintf("/chunk%d.%s", i, i % 4 ? "js" : "css");
+            std::ofstream file((Path / name).string(), std::ios::binary);
+
+            size_t size = (size_t) 2048 << (i % 12);
+            for (size_t written = 0; written < size; written += 64)
+                file << strprintf("function f%d(a,b){return a.map(x=>x*b+%d).filter(Boolean);}\n", written % 997, i);
+
+            Files.push_back(name);
+        }
+
+        gArgs.ForceSetArg("-staticpath", Path.string());
+    }
+
+    ~StaticRoot()
+    {
+        fs::remove_all(Path);
+    }
+};
+
+// Previous frontend - whole file content in string under single map, copied to reply buffer
+class StringFrontend
+{
+private:
+    Mutex m_mutex;
+    std::map<std::string, std::shared_ptr<std::string>> m_cache;
+
+public:
+    explicit StringFrontend(const StaticRoot& root)
+    {
+        for (const auto& name : root.Files)
+        {
+            std::ifstream file((root.Path / name).string());
+            m_cache.emplace(name, std::make_shared<std::string>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>()));
+        }
+    }
+
+    std::shared_ptr<std::string> Get(const std::string& path)
+    {
+        LOCK(m_mutex);
+        if (m_cache.find(path) != m_cache.end())
+            return m_cache.at(path);
+        return nullptr;
+    }
+};
+
+static void StaticFileStringCopy(benchmark::Bench& bench)
+{
+    StaticRoot root;
+    StringFrontend frontend(root);
+    struct evbuffer* evb = evbuffer_new();
+
+    size_t request = 0;
+    bench.unit("request").run([&] {
+        auto content = frontend.Get(root.Files[request++ % root.Files.size()]);
+        evbuffer_add(evb, content->data(), content->size());
+        evbuffer_drain(evb, evbuffer_get_length(evb));
+    });
+
+    evbuffer_free(evb);
+}
+
+static void StaticFileReference(benchmark::Bench& bench)
+{
+    StaticRoot root;
+    PocketWeb::PocketFrontend frontend;
+    frontend.Init();
+    struct evbuffer* evb = evbuffer_new();
+
+    // Warm cache - files are read and compressed once
+    for (const auto& name : root.Files)
+        frontend.GetFile(name);
+
+    size_t request = 0;
+    bench.unit("request").run([&] {
+        auto[code, file] = frontend.GetFile(root.Files[request++ % root.Files.size()]);
+        assert(code == HTTP_OK);
+
+        // Client accepts gzip - the same selection as get_static_web
+        const char* data = file->Content->Data();
+        size_t size = file->Content->Size();
+        if (auto encoded = file->Encoded.find(HTTPContentEncoding::GZIP); encoded != file->Encoded.end())
+        {
+            data = encoded->second.data();
+            size = encoded->second.size();
+        }
+
+        auto* ref = new std::shared_ptr<const void>(file);
+        evbuffer_add_reference(evb, data, size, [](const void*, size_t, void* arg) {
+            delete static_cast<std::shared_ptr<const void>*>(arg);
+        }, ref);
+        evbuffer_drain(evb, evbuffer_get_length(evb));
+    });
+
+    evbuffer_free(evb);
+}
+
+BENCHMARK(StaticFileStringCopy);
+BENCHMARK(StaticFileReference);
@@ -0,0 +1,186 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <bench/bench.h>
+#include <pocketdb/helpers/BlockColumns.h>
+#include <pocketdb/helpers/DbViewHelper.h>
+#include <pocketdb/services/Serializer.h>
+
+#include <chainparams.h>
+
+#include <primitives/block.h>
+#include <script/standard.h>
+#include <uint256.h>
+
+#include <cassert>
+#include <memory_resource>
+#include <set>
+#include <string>
+#include <string_view>
+
+// Posts with payload, inputs and outputs
+static PocketHelpers::PocketBlock CreateContentBlock(int count)
+{
+    CBlock block;
+    for (int i = 0; i < count; i++)
+    {
+        CMutableTransaction tx;
+        tx.nTime = 1650000000 + i;
+        tx.vin.resize(1);
+        tx.vin[0].prevout = COutPoint(uint256S(std::to_string(i + 1)), 1);
+        tx.vout.resize(3);
+        tx.vout[0].scriptPubKey = CScript() << OP_RETURN << ParseHex(OR_POST) << ParseHex(std::string(64, 'a'));
+        tx.vout[1].scriptPubKey = GetScriptForDestination(PKHash(uint160(std::vector<unsigned char>(20, (unsigned char) (i % 100 + 1)))));
+        tx.vout[1].nValue = 100000;
+        tx.vout[2].scriptPubKey = GetScriptForDestination(PKHash(uint160(std::vector<unsigned char>(20, (unsigned char) (i % 7 + 1)))));
+        tx.vout[2].nValue = 5000;
+        block.vtx.push_back(MakeTransactionRef(tx));
+    }
+
+    auto[ok, pocketBlock] = PocketServices::Serializer::DeserializeBlock(block);
+    assert(ok && (int) pocketBlock.size() == count);
+
+    for (const auto& ptx : pocketBlock)
+    {
+        UniValue src(UniValue::VOBJ);
+        src.pushKV("address", "PEj7QNjKdDPqE9kMDRboKoCtp8V6vZeZPd");
+        src.pushKV("lang", "en");
+        src.pushKV("caption", "Caption of the post");
+        src.pushKV("message", std::string(600, 'm'));
+        src.pushKV("tags", R"(["news","tech","pocketnet"])");
+        src.pushKV("images", R"(["https://pocketnet.app/images/1.jpg"])");
+        src.pushKV("url", "");
+        src.pushKV("settings", R"({"v":"a"})");
+
+        ptx->Deserialize(src);
+        ptx->DeserializePayload(src);
+        ptx->SetHash(ptx->BuildHash());
+    }
+
+    return pocketBlock;
+}
+
+// Allocations of pmr containers created while the resource is default
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+    size_t Allocations = 0;
+
+private:
+    std::pmr::memory_resource* m_upstream = std::pmr::new_delete_resource();
+
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        Allocations++;
+        return m_upstream->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override
+    {
+        m_upstream->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+// Previous preparation of InsertTransactions - copies of every transaction part,
+// sets of strings and lists as in removed _findStringsAndListsToBeInserted
+static size_t CollectCopies(const PocketHelpers::PocketBlock& pocketBlock)
+{
+    using Strings = std::pmr::vector<std::pmr::string>;
+
+    struct Copy
+    {
+        Strings Data;
+        std::pmr::vector<Strings> Inputs;
+        std::pmr::vector<Strings> Outputs;
+        Strings Payload;
+    };
+
+    const auto copy = [](Strings& values, const auto&... value) {
+        (values.emplace_back(value ? std::string_view(*value) : std::string_view()), ...);
+    };
+
+    std::pmr::vector<Copy> copies;
+    std::pmr::set<std::pmr::string> strings;
+    std::pmr::set<std::pmr::string> lists;
+    const auto insert = [&strings](const auto&... value) {
+        ((value ? (void) strings.emplace(*value) : (void) 0), ...);
+    };
+
+    for (const auto& ptx : pocketBlock)
+    {
+        PocketHelpers::TxContextualData data;
+        PocketHelpers::DbViewHelper::Extract(data, ptx);
+
+        Copy& c = copies.emplace_back();
+        copy(c.Data, ptx->GetHash(), data.string1, data.string2, data.string3, data.string4, data.string5, data.list);
+
+        for (const auto& input : ptx->Inputs())
+            copy(c.Inputs.emplace_back(), input.GetSpentTxHash(), input.GetTxHash(), input.GetAddressHash());
+
+        for (const auto& output : ptx->OutputsConst())
+            copy(c.Outputs.emplace_back(), output.GetTxHash(), output.GetAddressHash(), output.GetScriptPubKey(), output.GetSpentTxHash());
+
+        if (const auto& payload = ptx->GetPayload())
+        {
+            copy(c.Payload, payload->GetTxHash(), payload->GetString1(), payload->GetString2(), payload->GetString3(),
+                payload->GetString4(), payload->GetString5(), payload->GetString6(), payload->GetString7());
+        }
+
+        insert(ptx->GetHash(), data.string1, data.string2, data.string3, data.string4, data.string5);
+
+        if (data.list) lists.emplace(*data.list);
+
+        for (const auto& output : ptx->OutputsConst())
+            insert(output.GetAddressHash(), output.GetScriptPubKey(), output.GetTxHash(), output.GetSpentTxHash());
+
+        for (const auto& input : ptx->Inputs())
+            insert(input.GetSpentTxHash(), input.GetTxHash(), input.GetAddressHash());
+    }
+
+    std::pmr::vector<std::pmr::string> ids(strings.begin(), strings.end());
+    return ids.size() + lists.size() + copies.size();
+}
+
+static size_t BuildColumns(const PocketHelpers::PocketBlock& pocketBlock)
+{
+    PocketHelpers::BlockColumns columns;
+    bool built = columns.Build(pocketBlock);
+    assert(built);
+    return columns.Registry.Size() + columns.Count();
+}
+
+static void PocketBlockPrepare(benchmark::Bench& bench, size_t (*prepare)(const PocketHelpers::PocketBlock&))
+{
+    SelectParams(CBaseChainParams::MAIN);
+    auto pocketBlock = CreateContentBlock(2000);
+
+    // Allocations are counted once outside of timed runs
+    CountingResource counting;
+    auto previous = std::pmr::set_default_resource(&counting);
+    ankerl::nanobench::doNotOptimizeAway(prepare(pocketBlock));
+    std::pmr::set_default_resource(previous);
+
+    bench.name(bench.name() + " (" + std::to_string(counting.Allocations) + " allocations per block)");
+    bench.unit("block").run([&] {
+        ankerl::nanobench::doNotOptimizeAway(prepare(pocketBlock));
+    });
+}
+
+static void PocketBlockCollectCopies(benchmark::Bench& bench)
+{
+    PocketBlockPrepare(bench, CollectCopies);
+}
+
+static void PocketBlockColumnsBuild(benchmark::Bench& bench)
+{
+    PocketBlockPrepare(bench, BuildColumns);
+}
+
+BENCHMARK(PocketBlockCollectCopies);
+BENCHMARK(PocketBlockColumnsBuild);
@@ -0,0 +1,126 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <bench/bench.h>
+#include <pocketdb/helpers/JsonWriter.h>
+
+#include <sqlite3.h>
+#include <univalue.h>
+
+#include <cassert>
+#include <functional>
+
+// Comment-like rows in memory database
+static sqlite3* CreateCommentsDb(int rows)
+{
+    sqlite3* db = nullptr;
+    int res = sqlite3_open(":memory:", &db);
+    assert(res == SQLITE_OK);
+
+    res = sqlite3_exec(db, R"sql(
+        create table Comments (Hash text, Address text, Time int, Height int, Msg text, ScoreUp int, ScoreDown int);
+    )sql", nullptr, nullptr, nullptr);
+    assert(res == SQLITE_OK);
+
+    sqlite3_stmt* stmt = nullptr;
+    sqlite3_prepare_v2(db, "insert into Comments values (?, ?, ?, ?, ?, ?, ?)", -1, &stmt, nullptr);
+    const std::string msg = R"({"message":"Comment \"text\" with some length to look like real one","url":"","images":[]})";
+    for (int i = 0; i < rows; i++)
+    {
+        std::string hash = std::to_string(i) + std::string(60, 'a');
+        std::string address = "P" + std::to_string(i % 100) + std::string(30, 'b');
+        sqlite3_bind_text(stmt, 1, hash.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_text(stmt, 2, address.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int64(stmt, 3, 1650000000 + i);
+        sqlite3_bind_int64(stmt, 4, 1700000 + i);
+        sqlite3_bind_text(stmt, 5, msg.c_str(), -1, SQLITE_TRANSIENT);
+        sqlite3_bind_int64(stmt, 6, i % 10);
+        sqlite3_bind_int64(stmt, 7, i % 3);
+        sqlite3_step(stmt);
+        sqlite3_reset(stmt);
+    }
+    sqlite3_finalize(stmt);
+
+    return db;
+}
+
+static void SelectComments(sqlite3* db, const std::function<void(sqlite3_stmt*)>& func)
+{
+    sqlite3_stmt* stmt = nullptr;
+    sqlite3_prepare_v2(db, "select Hash, Address, Time, Height, Msg, ScoreUp, ScoreDown from Comments", -1, &stmt, nullptr);
+    func(stmt);
+    sqlite3_finalize(stmt);
+}
+
+static std::string ColumnString(sqlite3_stmt* stmt, int index)
+{
+    return std::string(reinterpret_cast<const char*>(sqlite3_column_text(stmt, index)));
+}
+
+static std::string_view ColumnView(sqlite3_stmt* stmt, int index)
+{
+    auto text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, index));
+    return std::string_view(text, sqlite3_column_bytes(stmt, index));
+}
+
+// Copy columns to strings, build UniValue tree and serialize it
+static void PocketDbJsonUniValue(benchmark::Bench& bench)
+{
+    sqlite3* db = CreateCommentsDb(1000);
+
+    bench.run([&] {
+        SelectComments(db, [&](sqlite3_stmt* stmt) {
+            UniValue result(UniValue::VARR);
+            while (sqlite3_step(stmt) == SQLITE_ROW)
+            {
+                UniValue record(UniValue::VOBJ);
+                record.pushKV("id", ColumnString(stmt, 0));
+                record.pushKV("address", ColumnString(stmt, 1));
+                record.pushKV("time", std::to_string(sqlite3_column_int64(stmt, 2)));
+                record.pushKV("block", std::to_string(sqlite3_column_int64(stmt, 3)));
+                record.pushKV("msg", ColumnString(stmt, 4));
+                record.pushKV("scoreUp", std::to_string(sqlite3_column_int64(stmt, 5)));
+                record.pushKV("scoreDown", std::to_string(sqlite3_column_int64(stmt, 6)));
+                record.pushKV("deleted", false);
+                result.push_back(record);
+            }
+            ankerl::nanobench::doNotOptimizeAway(result.write());
+        });
+    });
+
+    sqlite3_close(db);
+}
+
+// Write columns directly from sqlite memory to output buffer
+static void PocketDbJsonWriter(benchmark::Bench& bench)
+{
+    sqlite3* db = CreateCommentsDb(1000);
+
+    bench.run([&] {
+        SelectComments(db, [&](sqlite3_stmt* stmt) {
+            PocketHelpers::JsonWriter result;
+            result.BeginArray();
+            while (sqlite3_step(stmt) == SQLITE_ROW)
+            {
+                result.BeginObject();
+                result.Member("id", ColumnView(stmt, 0));
+                result.Member("address", ColumnView(stmt, 1));
+                result.Member("time", std::to_string(sqlite3_column_int64(stmt, 2)));
+                result.Member("block", std::to_string(sqlite3_column_int64(stmt, 3)));
+                result.Member("msg", ColumnView(stmt, 4));
+                result.Member("scoreUp", std::to_string(sqlite3_column_int64(stmt, 5)));
+                result.Member("scoreDown", std::to_string(sqlite3_column_int64(stmt, 6)));
+                result.Member("deleted", false);
+                result.EndObject();
+            }
+            result.EndArray();
+            ankerl::nanobench::doNotOptimizeAway(result.Release());
+        });
+    });
+
+    sqlite3_close(db);
+}
+
+BENCHMARK(PocketDbJsonUniValue);
+BENCHMARK(PocketDbJsonWriter);
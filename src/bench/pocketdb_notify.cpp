@@ -0,0 +1,115 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <bench/bench.h>
+#include <pocketdb/services/Serializer.h>
+#include <websocket/notifyprocessor.h>
+
+#include <chainparams.h>
+#include <core_io.h>
+#include <key_io.h>
+
+#include <primitives/block.h>
+#include <script/standard.h>
+#include <uint256.h>
+
+#include <boost/algorithm/string.hpp>
+
+#include <cassert>
+
+// Busy block - posts, scores, comments and subscribes of different accounts
+static NotifyBlockEntry CreateBusyBlock(int count)
+{
+    static const std::vector<std::string> types{ OR_POST, OR_SCORE, OR_SCORE, OR_COMMENT, OR_SUBSCRIBE };
+
+    NotifyBlockEntry entry;
+    entry.Index = nullptr;
+
+    for (int i = 0; i < count; i++)
+    {
+        CMutableTransaction tx;
+        tx.nTime = 1650000000 + i;
+        tx.vin.resize(1);
+        tx.vin[0].prevout = COutPoint(uint256S(std::to_string(i + 1)), 1);
+        tx.vout.resize(2);
+        tx.vout[0].scriptPubKey = CScript() << OP_RETURN << ParseHex(types[i % types.size()]) << ParseHex(std::string(64, 'a'));
+        tx.vout[1].scriptPubKey = GetScriptForDestination(PKHash(uint160(std::vector<unsigned char>(20, (unsigned char) (i % 100 + 1)))));
+        tx.vout[1].nValue = 100000;
+        entry.Block.vtx.push_back(MakeTransactionRef(tx));
+    }
+
+    auto[ok, pocketBlock] = PocketServices::Serializer::DeserializeBlock(entry.Block);
+    assert(ok && (int) pocketBlock.size() == count);
+    entry.PocketBlock = std::make_shared<PocketHelpers::PocketBlock>(std::move(pocketBlock));
+
+    return entry;
+}
+
+// Previous notifier - type from disassembled OP_RETURN of each output
+static void PocketNotifyParseAsm(benchmark::Bench& bench)
+{
+    SelectParams(CBaseChainParams::MAIN);
+    auto entry = CreateBusyBlock(2000);
+
+    bench.unit("block").run([&] {
+        for (const auto& tx : entry.Block.vtx)
+        {
+            std::map<std::string, std::pair<int, int64_t>> addrs;
+            std::string optype;
+
+            for (size_t i = 0; i < tx->vout.size(); i++)
+            {
+                const CTxOut& txout = tx->vout[i];
+                if (txout.scriptPubKey[0] == OP_RETURN)
+                {
+                    std::string asmstr = ScriptToAsmStr(txout.scriptPubKey);
+                    std::vector<std::string> spl;
+                    boost::split(spl, asmstr, boost::is_any_of("\t "));
+                    if (spl.size() >= 3)
+                    {
+                        if (spl[1] == OR_POST) optype = "share";
+                        else if (spl[1] == OR_SCORE) optype = "upvoteShare";
+                        else if (spl[1] == OR_SUBSCRIBE) optype = "subscribe";
+                        else if (spl[1] == OR_COMMENT) optype = "comment";
+                    }
+                }
+
+                CTxDestination destAddress;
+                if (ExtractDestination(txout.scriptPubKey, destAddress))
+                    addrs.emplace(EncodeDestination(destAddress), std::make_pair(i, (int64_t) txout.nValue));
+            }
+
+            ankerl::nanobench::doNotOptimizeAway(optype);
+        }
+    });
+}
+
+// Types from PocketBlock parsed by ConnectTip
+static void PocketNotifyPrepareBlock(benchmark::Bench& bench)
+{
+    SelectParams(CBaseChainParams::MAIN);
+    auto entry = CreateBusyBlock(2000);
+
+    bench.unit("block").run([&] {
+        auto data = NotifyBlockProcessor::PrepareBlock(entry);
+        assert(data.Txs.size() == entry.Block.vtx.size());
+    });
+}
+
+// Block without PocketBlock - types from TransactionHelper::ParseType
+static void PocketNotifyPrepareBlockParse(benchmark::Bench& bench)
+{
+    SelectParams(CBaseChainParams::MAIN);
+    auto entry = CreateBusyBlock(2000);
+    entry.PocketBlock = nullptr;
+
+    bench.unit("block").run([&] {
+        auto data = NotifyBlockProcessor::PrepareBlock(entry);
+        assert(data.Txs.size() == entry.Block.vtx.size());
+    });
+}
+
+BENCHMARK(PocketNotifyParseAsm);
+BENCHMARK(PocketNotifyPrepareBlock);
+BENCHMARK(PocketNotifyPrepareBlockParse);
@@ -0,0 +1,208 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <bench/bench.h>
+#include <bench/data.h>
+#include <pocketdb/consensus/PayloadCheckQueue.h>
+#include <pocketdb/services/Serializer.h>
+
+#include <chainparams.h>
+
+#include <primitives/block.h>
+#include <script/standard.h>
+#include <streams.h>
+#include <uint256.h>
+#include <version.h>
+
+#include <cassert>
+#include <condition_variable>
+
+// Payload of post like in the mainnet - text message, images and tags
+static void FillPost(const PocketHelpers::PTransactionRef& ptx)
+{
+    UniValue src(UniValue::VOBJ);
+    src.pushKV("address", "PEj7QNjKdDPqE9kMDRboKoCtp8V6vZeZPd");
+    src.pushKV("lang", "en");
+    src.pushKV("caption", "Caption of the post");
+    src.pushKV("message", std::string(600, 'm') + "<a href=\"https://pocketnet.app\">link</a>\n\"quoted\"");
+    src.pushKV("tags", R"(["news","tech","pocketnet"])");
+    src.pushKV("images", R"(["https://pocketnet.app/images/1.jpg","https://pocketnet.app/images/2.jpg"])");
+    src.pushKV("url", "");
+    src.pushKV("settings", R"({"v":"a"})");
+
+    ptx->Deserialize(src);
+    ptx->DeserializePayload(src);
+}
+
+// Block with posts
+static std::pair<CBlock, PocketHelpers::PocketBlock> CreatePostsBlock(int count)
+{
+    CBlock block;
+    for (int i = 0; i < count; i++)
+    {
+        CMutableTransaction tx;
+        tx.nTime = 1650000000 + i;
+        tx.vin.resize(1);
+        tx.vin[0].prevout = COutPoint(uint256S(std::to_string(i + 1)), 1);
+        tx.vout.resize(2);
+        tx.vout[0].scriptPubKey = CScript() << OP_RETURN << ParseHex(OR_POST) << ParseHex(std::string(64, 'a'));
+        tx.vout[1].scriptPubKey = GetScriptForDestination(PKHash(uint160(std::vector<unsigned char>(20, (unsigned char) (i % 100 + 1)))));
+        tx.vout[1].nValue = 100000;
+        block.vtx.push_back(MakeTransactionRef(tx));
+    }
+
+    auto[ok, pocketBlock] = PocketServices::Serializer::DeserializeBlock(block);
+    assert(ok && (int) pocketBlock.size() == count);
+
+    for (const auto& ptx : pocketBlock)
+        FillPost(ptx);
+
+    return { block, pocketBlock };
+}
+
+static void PocketPayloadEncodeJson(benchmark::Bench& bench)
+{
+    auto data = CreatePostsBlock(200);
+    const auto& pocketBlock = data.second;
+    auto size = PocketServices::Serializer::SerializeBlock(pocketBlock)->write().size();
+
+    bench.batch(size).unit("byte").run([&] {
+        auto json = PocketServices::Serializer::SerializeBlock(pocketBlock)->write();
+        ankerl::nanobench::doNotOptimizeAway(json);
+    });
+}
+
+static void PocketPayloadEncodeCompact(benchmark::Bench& bench)
+{
+    auto data = CreatePostsBlock(200);
+    const auto& pocketBlock = data.second;
+    auto size = PocketServices::Serializer::SerializeBlockCompact(pocketBlock).size();
+
+    bench.batch(size).unit("byte").run([&] {
+        auto compact = PocketServices::Serializer::SerializeBlockCompact(pocketBlock);
+        ankerl::nanobench::doNotOptimizeAway(compact);
+    });
+}
+
+static void PocketPayloadDecode(benchmark::Bench& bench, const CBlock& block, const std::string& data)
+{
+    bench.batch(data.size()).unit("byte").run([&] {
+        CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+        stream << data;
+
+        auto[ok, pocketBlock] = PocketServices::Serializer::DeserializeBlock(block, stream);
+        assert(ok && pocketBlock.size() == block.vtx.size());
+    });
+}
+
+static void PocketPayloadDecodeJson(benchmark::Bench& bench)
+{
+    auto[block, pocketBlock] = CreatePostsBlock(200);
+    PocketPayloadDecode(bench, block, PocketServices::Serializer::SerializeBlock(pocketBlock)->write());
+}
+
+static void PocketPayloadDecodeCompact(benchmark::Bench& bench)
+{
+    auto[block, pocketBlock] = CreatePostsBlock(200);
+    PocketPayloadDecode(bench, block, PocketServices::Serializer::SerializeBlockCompact(pocketBlock));
+}
+
+// Coinbase and coinstake of mainnet block with posts appended.
+// OP_RETURN of posts contains hash of payload, so consensus Check passes for all transactions.
+static std::pair<CBlock, std::string> CreateSyncBlock(int count)
+{
+    CBlock block;
+    CDataStream stream(benchmark::data::block1533073, SER_NETWORK, PROTOCOL_VERSION);
+    stream >> block;
+    block.vtx.resize(2);
+
+    auto posts = CreatePostsBlock(count);
+    for (int i = 0; i < count; i++)
+    {
+        CMutableTransaction tx(*posts.first.vtx[i]);
+        tx.vout[0].scriptPubKey = CScript() << OP_RETURN << ParseHex(OR_POST) << ParseHex(posts.second[i]->BuildHash());
+        block.vtx.push_back(MakeTransactionRef(tx));
+    }
+
+    auto[ok, pocketBlock] = PocketServices::Serializer::DeserializeBlock(block);
+    assert(ok);
+
+    for (const auto& ptx : pocketBlock)
+        if (*ptx->GetType() == PocketTx::CONTENT_POST)
+            FillPost(ptx);
+
+    return { block, PocketServices::Serializer::SerializeBlockCompact(pocketBlock) };
+}
+
+static std::vector<std::shared_ptr<PocketConsensus::PayloadCheckJob>> CreateSyncJobs(const CBlock& block, const std::string& data, int count)
+{
+    auto pblock = std::make_shared<const CBlock>(block);
+
+    std::vector<std::shared_ptr<PocketConsensus::PayloadCheckJob>> jobs;
+    for (int i = 0; i < count; i++)
+    {
+        CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+        stream << data;
+        jobs.push_back(std::make_shared<PocketConsensus::PayloadCheckJob>(0, pblock, std::move(stream), 1533073));
+    }
+
+    return jobs;
+}
+
+// Blocks of initial sync processed on message handler thread
+static void PocketPayloadCheckSerial(benchmark::Bench& bench)
+{
+    SelectParams(CBaseChainParams::MAIN);
+    auto[block, data] = CreateSyncBlock(200);
+
+    bench.batch(16).unit("block").run([&] {
+        for (const auto& job : CreateSyncJobs(block, data, 16))
+            PocketConsensus::PayloadCheckQueue::Process(*job);
+    });
+}
+
+// Blocks of initial sync checked ahead on workers
+static void PocketPayloadCheckQueue(benchmark::Bench& bench)
+{
+    SelectParams(CBaseChainParams::MAIN);
+    auto[block, data] = CreateSyncBlock(200);
+
+    Mutex mutex;
+    std::condition_variable cv;
+
+    PocketConsensus::PayloadCheckQueue queue;
+    queue.Start(4, [&]() { cv.notify_all(); });
+
+    bench.batch(16).unit("block").run([&] {
+        for (const auto& job : CreateSyncJobs(block, data, 16))
+        {
+            bool pushed = queue.Push(job);
+            assert(pushed);
+        }
+
+        size_t completed = 0;
+        while (completed < 16)
+        {
+            {
+                WAIT_LOCK(mutex, lock);
+                cv.wait_for(lock, std::chrono::milliseconds(1));
+            }
+
+            for (const auto& job : queue.TakeCompleted())
+            {
+                queue.Forget(job->Block->GetHash());
+                completed++;
+            }
+        }
+    });
+
+    queue.Stop();
+}
+
+BENCHMARK(PocketPayloadEncodeJson);
+BENCHMARK(PocketPayloadEncodeCompact);
+BENCHMARK(PocketPayloadDecodeJson);
+BENCHMARK(PocketPayloadDecodeCompact);
+BENCHMARK(PocketPayloadCheckSerial);
+BENCHMARK(PocketPayloadCheckQueue);
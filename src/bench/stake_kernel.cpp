@@ -0,0 +1,85 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <bench/bench.h>
+#include <pos.h>
+
+#include <chain.h>
+#include <chainparams.h>
+#include <uint256.h>
+
+// Wallet with many coins, kernel is not found so every coin and timestamp is hashed
+static const int WALLET_COINS = 10000;
+static const unsigned int KERNEL_BITS = 0x03000001;
+static const uint32_t KERNEL_TIME = 1650000000 & ~STAKE_TIMESTAMP_MASK;
+
+static std::vector<StakeKernelCandidate> CreateCandidates(std::vector<StakeKernelHashTx>& txs)
+{
+    std::vector<StakeKernelCandidate> candidates;
+    for (int i = 0; i < WALLET_COINS; i++)
+    {
+        StakeKernelHashTx tx{"", KERNEL_TIME - 30 * 24 * 3600 - i, 100 * COIN + i};
+        txs.push_back(tx);
+
+        StakeKernelCandidate candidate;
+        bool ok = BuildStakeKernelCandidate(COutPoint(uint256S(std::to_string(i + 1)), i % 3), (uint32_t) tx.TxTime, tx, KERNEL_BITS, candidate);
+        assert(ok);
+        candidates.push_back(candidate);
+    }
+
+    return candidates;
+}
+
+// Previous search - stream and target built for every coin and timestamp
+static void StakeKernelCheckEach(benchmark::Bench& bench)
+{
+    SelectParams(CBaseChainParams::MAIN);
+
+    std::vector<StakeKernelHashTx> txs;
+    auto candidates = CreateCandidates(txs);
+
+    CBlockIndex indexPrev;
+    indexPrev.nStakeModifier = 0x1234567890abcdef;
+
+    std::vector<CBlockIndex> blocksFrom(candidates.size());
+    for (size_t i = 0; i < candidates.size(); i++)
+        blocksFrom[i].nTime = candidates[i].BlockFromTime;
+
+    bench.batch(candidates.size()).unit("coin").run([&] {
+        arith_uint256 hashProofOfStake, targetProofOfStake;
+        CDataStream hashProofOfStakeSource(SER_GETHASH, 0);
+
+        for (size_t i = 0; i < candidates.size(); i++)
+            CheckStakeKernelHash(&indexPrev, KERNEL_BITS, blocksFrom[i], txs[i], candidates[i].Prevout, KERNEL_TIME,
+                hashProofOfStake, hashProofOfStakeSource, targetProofOfStake, false);
+    });
+}
+
+static void StakeKernelSearch(benchmark::Bench& bench, int threads)
+{
+    SelectParams(CBaseChainParams::MAIN);
+
+    std::vector<StakeKernelHashTx> txs;
+    auto candidates = CreateCandidates(txs);
+
+    bench.batch(candidates.size()).unit("coin").run([&] {
+        StakeKernelHit hit;
+        bool found = SearchStakeKernel(candidates, 0x1234567890abcdef, KERNEL_TIME, 1, threads, 0, hit);
+        assert(!found);
+    });
+}
+
+static void StakeKernelSearchSingle(benchmark::Bench& bench)
+{
+    StakeKernelSearch(bench, 1);
+}
+
+static void StakeKernelSearchThreads(benchmark::Bench& bench)
+{
+    StakeKernelSearch(bench, 4);
+}
+
+BENCHMARK(StakeKernelCheckEach);
+BENCHMARK(StakeKernelSearchSingle);
+BENCHMARK(StakeKernelSearchThreads);
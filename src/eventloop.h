@@ -45,7 +45,7 @@ public:
             }
         }
 
-        if (m_queue.empty()) {
+        if (_Size() == 0) {
             m_cv.wait(lock);
         }
 
@@ -55,13 +55,11 @@ public:
             }
         }
 
-        if (m_queue.empty()) {
+        if (_Size() == 0) {
             return false;
         }
 
-        out = std::forward<T>(m_queue.front());
-        m_queue.pop();
-        return true;
+        return _Pop(out);
     }
 
     bool Add(T entry)
@@ -72,7 +70,7 @@ public:
             return false;
         }
 
-        m_queue.push(std::forward<T>(entry));
+        _Push(std::forward<T>(entry));
         m_cv.notify_one();
         return true;
     }
@@ -101,10 +99,23 @@ protected:
         return true;
     }
 
-    size_t _Size()
+    // Override following methods to change order of entries. Called under queue lock.
+    virtual size_t _Size()
     {
         return m_queue.size();
     }
+
+    virtual void _Push(T entry)
+    {
+        m_queue.push(std::forward<T>(entry));
+    }
+
+    virtual bool _Pop(T& out)
+    {
+        out = std::forward<T>(m_queue.front());
+        m_queue.pop();
+        return true;
+    }
 private:
     std::queue<T> m_queue;
     Mutex m_mutex;
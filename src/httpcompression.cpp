@@ -0,0 +1,138 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#if defined(HAVE_CONFIG_H)
+#include <config/pocketcoin-config.h>
+#endif
+
+#include <httpcompression.h>
+
+#include <util/strencodings.h>
+#include <util/string.h>
+
+#include <boost/algorithm/string.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef USE_BROTLI
+#include <brotli/encode.h>
+#endif
+
+HTTPContentEncoding SelectContentEncoding(const std::string& acceptEncoding)
+{
+    bool deflate = false, gzip = false, brotli = false;
+
+    std::vector<std::string> codings;
+    boost::split(codings, acceptEncoding, boost::is_any_of(","));
+    for (auto& coding : codings)
+    {
+        // Coding with parameters: "gzip;q=0.5"
+        std::vector<std::string> parts;
+        boost::split(parts, coding, boost::is_any_of(";"));
+
+        std::string name = ToLower(TrimString(parts[0]));
+        bool refused = false;
+        for (size_t i = 1; i < parts.size(); i++)
+        {
+            std::string param = TrimString(parts[i]);
+            if (param.size() > 2 && ToLower(param.substr(0, 2)) == "q=")
+                refused = std::strtod(param.c_str() + 2, nullptr) <= 0;
+        }
+
+        if (refused)
+            continue;
+
+        if (name == "deflate") deflate = true;
+        else if (name == "gzip" || name == "x-gzip") gzip = true;
+        else if (name == "br") brotli = true;
+    }
+
+#ifdef USE_BROTLI
+    if (brotli) return HTTPContentEncoding::BROTLI;
+#endif
+#ifdef USE_ZLIB
+    if (gzip) return HTTPContentEncoding::GZIP;
+    if (deflate) return HTTPContentEncoding::DEFLATE;
+#endif
+
+    return HTTPContentEncoding::IDENTITY;
+}
+
+std::string ContentEncodingName(HTTPContentEncoding encoding)
+{
+    switch (encoding)
+    {
+        case HTTPContentEncoding::DEFLATE: return "deflate";
+        case HTTPContentEncoding::GZIP: return "gzip";
+        case HTTPContentEncoding::BROTLI: return "br";
+        default: return "";
+    }
+}
+
+bool IsCompressibleContentType(const std::string& contentType)
+{
+    return contentType.rfind("text/", 0) == 0 ||
+        contentType.find("json") != std::string::npos ||
+        contentType.find("javascript") != std::string::npos ||
+        contentType.find("xml") != std::string::npos;
+}
+
+#ifdef USE_ZLIB
+static bool CompressZlib(std::string_view content, bool gzip, int level, std::string& result)
+{
+    z_stream stream{};
+    // Window bits 15 + 16 writes gzip header, plain 15 writes zlib stream expected for "deflate"
+    if (deflateInit2(&stream, level, Z_DEFLATED, gzip ? 15 + 16 : 15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return false;
+
+    result.resize(deflateBound(&stream, content.size()) + (gzip ? 18 : 0));
+
+    stream.next_in = (Bytef*) content.data();
+    stream.avail_in = (uInt) content.size();
+    stream.next_out = (Bytef*) result.data();
+    stream.avail_out = (uInt) result.size();
+
+    int ret = deflate(&stream, Z_FINISH);
+    result.resize(stream.total_out);
+    deflateEnd(&stream);
+
+    return ret == Z_STREAM_END;
+}
+#endif
+
+bool CompressContent(std::string_view content, HTTPContentEncoding encoding, int level, std::string& result)
+{
+    switch (encoding)
+    {
+#ifdef USE_ZLIB
+        case HTTPContentEncoding::DEFLATE:
+            return CompressZlib(content, false, level, result);
+        case HTTPContentEncoding::GZIP:
+            return CompressZlib(content, true, level, result);
+#endif
+#ifdef USE_BROTLI
+        case HTTPContentEncoding::BROTLI:
+        {
+            // zlib levels map to brotli quality, precompressed content gets maximum
+            int quality = level >= HTTP_PRECOMPRESSION_LEVEL ? BROTLI_MAX_QUALITY : level;
+            size_t size = BrotliEncoderMaxCompressedSize(content.size());
+            result.resize(size);
+            if (!BrotliEncoderCompress(quality, BROTLI_DEFAULT_WINDOW, BROTLI_MODE_TEXT, content.size(),
+                (const uint8_t*) content.data(), &size, (uint8_t*) result.data()))
+                return false;
+
+            result.resize(size);
+            return true;
+        }
+#endif
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,39 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETCOIN_HTTPCOMPRESSION_H
+#define POCKETCOIN_HTTPCOMPRESSION_H
+
+#include <string>
+#include <string_view>
+
+static const bool DEFAULT_HTTP_COMPRESSION = true;
+//! Smaller bodies are sent as is - compression would not pay off
+static const size_t HTTP_COMPRESSION_MIN_SIZE = 1024;
+//! zlib level for replies compressed per request
+static const int HTTP_COMPRESSION_LEVEL = 6;
+//! Level for content compressed once and cached
+static const int HTTP_PRECOMPRESSION_LEVEL = 9;
+
+enum class HTTPContentEncoding
+{
+    IDENTITY,
+    DEFLATE,
+    GZIP,
+    BROTLI,
+};
+
+//! Best encoding supported by build and accepted by client in Accept-Encoding value
+HTTPContentEncoding SelectContentEncoding(const std::string& acceptEncoding);
+
+//! Value of Content-Encoding header, empty for IDENTITY
+std::string ContentEncodingName(HTTPContentEncoding encoding);
+
+//! Text based content types worth compressing
+bool IsCompressibleContentType(const std::string& contentType);
+
+//! Returns false if encoding is not supported by build or compression failed
+bool CompressContent(std::string_view content, HTTPContentEncoding encoding, int level, std::string& result);
+
+#endif // POCKETCOIN_HTTPCOMPRESSION_H
@@ -0,0 +1,132 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include <httpscheduler.h>
+
+#include <init.h>
+#include <logging.h>
+
+std::string HTTPLaneName(HTTPLane lane)
+{
+    switch (lane)
+    {
+        case HTTPLane::FAST:
+            return "fast";
+        case HTTPLane::NORMAL:
+            return "normal";
+        case HTTPLane::HEAVY:
+            return "heavy";
+        default:
+            return "";
+    }
+}
+
+std::string PeekRPCMethod(const std::string& body)
+{
+    size_t start = body.find_first_not_of(" \t\r\n");
+    if (start != std::string::npos && body[start] == '[')
+        return "batch";
+
+    size_t key = body.find("\"method\"");
+    if (key == std::string::npos)
+        return "";
+
+    size_t open = body.find_first_not_of(" \t\r\n:", key + 8);
+    if (open == std::string::npos || body[open] != '"')
+        return "";
+
+    size_t close = body.find('"', open + 1);
+    if (close == std::string::npos)
+        return "";
+
+    return body.substr(open + 1, close - open - 1);
+}
+
+HTTPLane HTTPCostClassifier::Classify(const std::string& method)
+{
+    if (method.empty())
+        return HTTPLane::NORMAL;
+
+    LOCK(m_mutex);
+    if (auto it = m_lanes.find(method); it != m_lanes.end())
+        return it->second;
+
+    return HTTPLane::NORMAL;
+}
+
+void HTTPCostClassifier::Refresh()
+{
+    int64_t now = gStatEngineInstance.GetCurrentSystemSeconds();
+    if (now - m_refreshed.load() < HTTP_LANE_REFRESH_INTERVAL || m_refreshing.exchange(true))
+        return;
+
+    // Snapshots are merged outside of lock - lookups in event loop are not blocked
+    std::unordered_map<std::string, HTTPLane> lanes;
+    for (const auto& [method, snapshot] : gStatEngineInstance.GetRequestSnapshots())
+    {
+        if (snapshot.Exec.Count < HTTP_LANE_MIN_REQUESTS)
+            continue;
+
+        auto cost = (int64_t) snapshot.Exec.Avg();
+        if (cost < HTTP_FAST_LANE_COST)
+            lanes.emplace(method, HTTPLane::FAST);
+        else if (cost >= HTTP_HEAVY_LANE_COST)
+            lanes.emplace(method, HTTPLane::HEAVY);
+    }
+
+    {
+        LOCK(m_mutex);
+        m_lanes.swap(lanes);
+    }
+
+    m_refreshed = now;
+    m_refreshing = false;
+}
+
+void HTTPClientLimiter::SetLimit(int limit)
+{
+    m_limit = std::max(limit, 0);
+}
+
+bool HTTPClientLimiter::Acquire(const std::string& client)
+{
+    int limit = m_limit;
+
+    LOCK(m_mutex);
+    auto& active = m_active[client];
+    if (limit > 0 && active >= limit)
+    {
+        if (active == 0)
+            m_active.erase(client);
+
+        m_rejected.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    active++;
+    return true;
+}
+
+void HTTPClientLimiter::Release(const std::string& client)
+{
+    LOCK(m_mutex);
+    auto it = m_active.find(client);
+    if (it == m_active.end())
+        return;
+
+    if (--it->second <= 0)
+        m_active.erase(it);
+}
+
+UniValue HTTPClientLimiter::Statistic()
+{
+    UniValue result(UniValue::VOBJ);
+    {
+        LOCK(m_mutex);
+        result.pushKV("active", (int64_t) m_active.size());
+    }
+    result.pushKV("limit", m_limit.load());
+    result.pushKV("rejected", (int64_t) m_rejected.load(std::memory_order_relaxed));
+    return result;
+}
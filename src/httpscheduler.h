@@ -0,0 +1,241 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETCOIN_HTTPSCHEDULER_H
+#define POCKETCOIN_HTTPSCHEDULER_H
+
+#include <eventloop.h>
+#include <sync.h>
+#include <tinyformat.h>
+#include <univalue.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <string>
+#include <unordered_map>
+
+//! Concurrent requests of one public client address, queued and executing, 0 - not limited.
+//! Disabled by default: behind a reverse proxy all requests come from one address.
+static const int DEFAULT_HTTP_CLIENT_CONCURRENCY = 0;
+//! Requests predicted to wait longer in queue are rejected, milliseconds
+static const int DEFAULT_HTTP_QUEUE_DEADLINE = 10000;
+//! Average execution of method below which it goes to fast lane, microseconds
+static const int64_t HTTP_FAST_LANE_COST = 10000;
+//! Average execution of method from which it goes to heavy lane, microseconds
+static const int64_t HTTP_HEAVY_LANE_COST = 250000;
+//! Seconds between rebuilding method lanes from statistic
+static const int64_t HTTP_LANE_REFRESH_INTERVAL = 10;
+//! Requests of method in statistic window required to leave the normal lane
+static const uint64_t HTTP_LANE_MIN_REQUESTS = 10;
+//! Bytes of request body looked through for JSON-RPC method
+static const size_t HTTP_PEEK_BODY_SIZE = 512;
+
+enum class HTTPLane
+{
+    FAST,
+    NORMAL,
+    HEAVY,
+};
+
+static const size_t HTTP_LANES = 3;
+//! Dequeue shares of lanes - cheap requests are not stuck behind heavy ones, heavy are not starved
+static const std::array<int64_t, HTTP_LANES> HTTP_LANE_WEIGHTS{8, 4, 1};
+//! Expected execution of lane before any request is measured, microseconds
+static const std::array<int64_t, HTTP_LANES> HTTP_LANE_INITIAL_COSTS{2000, 50000, 500000};
+
+std::string HTTPLaneName(HTTPLane lane);
+
+//! JSON-RPC method from the start of request body without parsing it, "batch" for arrays
+std::string PeekRPCMethod(const std::string& body);
+
+/**
+ * Lanes of RPC methods by average execution time measured by statistic engine.
+ * Methods without enough requests in window stay in the normal lane.
+ */
+class HTTPCostClassifier
+{
+private:
+    Mutex m_mutex;
+    std::unordered_map<std::string, HTTPLane> m_lanes GUARDED_BY(m_mutex);
+    std::atomic<int64_t> m_refreshed{0};
+    std::atomic_bool m_refreshing{false};
+
+public:
+    HTTPLane Classify(const std::string& method);
+
+    // Rebuild lanes if refresh interval passed, called by worker threads after request
+    void Refresh();
+};
+
+/** Concurrent requests by client address */
+class HTTPClientLimiter
+{
+private:
+    Mutex m_mutex;
+    std::unordered_map<std::string, int> m_active GUARDED_BY(m_mutex);
+    std::atomic<int> m_limit{DEFAULT_HTTP_CLIENT_CONCURRENCY};
+    std::atomic<uint64_t> m_rejected{0};
+
+public:
+    // 0 disables limit
+    void SetLimit(int limit);
+
+    bool Acquire(const std::string& client);
+    void Release(const std::string& client);
+
+    UniValue Statistic();
+};
+
+/**
+ * Work queue with separate lane for every cost class of requests. Lanes are dequeued with
+ * smooth weighted round robin over non-empty lanes. Depth and execution time of lanes are
+ * tracked without queue lock for metrics and wait prediction.
+ *
+ * @tparam T - queue entry with Lane() method
+ */
+template<class T>
+class LaneQueue : public Queue<T>
+{
+public:
+    explicit LaneQueue(size_t maxDepth) : m_maxDepth(maxDepth)
+    {
+        for (size_t i = 0; i < HTTP_LANES; i++)
+            m_cost[i] = HTTP_LANE_INITIAL_COSTS[i];
+    }
+
+    void SetThreads(int threads)
+    {
+        m_threads = std::max(threads, 1);
+    }
+
+    // Execution of dequeued request, moves lane average
+    void Complete(HTTPLane lane, int64_t execTime)
+    {
+        auto& cost = m_cost[(size_t) lane];
+        int64_t prev = cost.load(std::memory_order_relaxed);
+        while (!cost.compare_exchange_weak(prev, prev + (execTime - prev) / 16, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void Shed(HTTPLane lane)
+    {
+        m_shed[(size_t) lane].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * Wait of new request of lane before execution, microseconds.
+     * Counts requests of own lane and shares of other lanes dequeued before it.
+     */
+    int64_t PredictWait(HTTPLane lane) const
+    {
+        size_t own = (size_t) lane;
+        int64_t rounds = (int64_t) m_depth[own].load(std::memory_order_relaxed) + 1;
+
+        int64_t ahead = (rounds - 1) * m_cost[own].load(std::memory_order_relaxed);
+        for (size_t i = 0; i < HTTP_LANES; i++)
+        {
+            if (i == own)
+                continue;
+
+            int64_t share = std::min<int64_t>(m_depth[i].load(std::memory_order_relaxed),
+                (rounds * HTTP_LANE_WEIGHTS[i] + HTTP_LANE_WEIGHTS[own] - 1) / HTTP_LANE_WEIGHTS[own]);
+            ahead += share * m_cost[i].load(std::memory_order_relaxed);
+        }
+
+        return ahead / m_threads.load(std::memory_order_relaxed);
+    }
+
+    UniValue Statistic() const
+    {
+        UniValue result(UniValue::VOBJ);
+        for (size_t i = 0; i < HTTP_LANES; i++)
+        {
+            UniValue lane(UniValue::VOBJ);
+            lane.pushKV("depth", (int64_t) m_depth[i].load(std::memory_order_relaxed));
+            lane.pushKV("cost", m_cost[i].load(std::memory_order_relaxed));
+            lane.pushKV("shed", (int64_t) m_shed[i].load(std::memory_order_relaxed));
+            result.pushKV(HTTPLaneName((HTTPLane) i), lane);
+        }
+        return result;
+    }
+
+    // Prometheus samples of lanes with queue label
+    std::string PrometheusText(const std::string& queue) const
+    {
+        std::string result;
+        for (size_t i = 0; i < HTTP_LANES; i++)
+        {
+            auto labels = strprintf("queue=\"%s\",lane=\"%s\"", queue, HTTPLaneName((HTTPLane) i));
+            result += strprintf("pocketnet_http_queue_depth{%s} %d\n", labels, m_depth[i].load(std::memory_order_relaxed));
+            result += strprintf("pocketnet_http_lane_cost_seconds{%s} %.6f\n", labels, m_cost[i].load(std::memory_order_relaxed) / 1e6);
+            result += strprintf("pocketnet_http_queue_shed_total{%s} %d\n", labels, m_shed[i].load(std::memory_order_relaxed));
+        }
+        return result;
+    }
+
+protected:
+    bool AddConditionCheck() override
+    {
+        return _Size() < m_maxDepth;
+    }
+
+    size_t _Size() override
+    {
+        return m_size;
+    }
+
+    void _Push(T entry) override
+    {
+        size_t lane = (size_t) entry->Lane();
+        m_lanes[lane].push_back(std::forward<T>(entry));
+        m_depth[lane].fetch_add(1, std::memory_order_relaxed);
+        m_size++;
+    }
+
+    bool _Pop(T& out) override
+    {
+        // Smooth weighted round robin - every non-empty lane gains its weight,
+        // the richest is served and pays total weight of competitors
+        int64_t total = 0;
+        size_t best = HTTP_LANES;
+        for (size_t i = 0; i < HTTP_LANES; i++)
+        {
+            if (m_lanes[i].empty())
+                continue;
+
+            m_current[i] += HTTP_LANE_WEIGHTS[i];
+            total += HTTP_LANE_WEIGHTS[i];
+            if (best == HTTP_LANES || m_current[i] > m_current[best])
+                best = i;
+        }
+
+        if (best == HTTP_LANES)
+            return false;
+
+        m_current[best] -= total;
+        out = std::forward<T>(m_lanes[best].front());
+        m_lanes[best].pop_front();
+        if (m_lanes[best].empty())
+            m_current[best] = 0;
+        m_depth[best].fetch_sub(1, std::memory_order_relaxed);
+        m_size--;
+        return true;
+    }
+
+private:
+    size_t m_maxDepth;
+    size_t m_size = 0;
+    std::array<std::deque<T>, HTTP_LANES> m_lanes;
+    std::array<int64_t, HTTP_LANES> m_current{};
+
+    std::atomic<int> m_threads{1};
+    std::array<std::atomic<size_t>, HTTP_LANES> m_depth{};
+    std::array<std::atomic<int64_t>, HTTP_LANES> m_cost{};
+    std::array<std::atomic<uint64_t>, HTTP_LANES> m_shed{};
+};
+
+#endif // POCKETCOIN_HTTPSCHEDULER_H
@@ -5,6 +5,7 @@
 #include "logging.h"
 #include "rpc/blockchain.h"
 #include <httpserver.h>
+#include <httpcompression.h>
 #include <interfaces/chain.h>
 
 #include <event2/bufferevent.h>
@@ -25,6 +26,7 @@
 #include <rpc/register.h>
 #include <walletinitinterface.h>
 #include "eventloop.h"
+#include "pocketdb/pocketnet.h"
 
 #ifdef EVENT__HAVE_NETINET_IN_H
 #include <netinet/in.h>
@@ -40,26 +42,29 @@
 /** Maximum size of http request (request line + headers) */
 static const size_t MAX_HEADERS_SIZE = 8192;
 
+//! Compress replies for clients sending Accept-Encoding
+static bool g_http_compression = DEFAULT_HTTP_COMPRESSION;
+//! Predicted queue wait rejected with 503, microseconds, 0 - disabled
+static int64_t g_http_queue_deadline = DEFAULT_HTTP_QUEUE_DEADLINE * 1000;
+static HTTPCostClassifier g_http_costs;
+static HTTPClientLimiter g_http_clients;
+
 class ExecutorSqlite : public IQueueProcessor<std::unique_ptr<HTTPClosure>>
 {
 public:
-    explicit ExecutorSqlite()
-    {
-        m_sqliteConnection = std::make_shared<PocketDb::SQLiteConnection>(true);
-    }
     void Process(std::unique_ptr<HTTPClosure> closure) override
     {
-        (*closure)(m_sqliteConnection);
+        // Connection is checked out from the shared pool by the first HTTPRequest::DbConnection() call,
+        // static, REST and metrics requests without database do not hold a pool slot
+        (*closure)();
     }
-private:
-    DbConnectionRef m_sqliteConnection;
 };
 
 
 struct HTTPPathHandler
 {
     HTTPPathHandler(std::string _prefix, bool _exactMatch, HTTPRequestHandler _handler,
-                    std::shared_ptr<Queue<std::unique_ptr<HTTPClosure>>> _queue) :
+                    std::shared_ptr<HTTPWorkQueue> _queue) :
         prefix(_prefix), exactMatch(_exactMatch), handler(_handler), queue(_queue)
     {
     }
@@ -67,7 +72,7 @@ struct HTTPPathHandler
     std::string prefix;
     bool exactMatch;
     HTTPRequestHandler handler;
-    std::shared_ptr<Queue<std::unique_ptr<HTTPClosure>>> queue;
+    std::shared_ptr<HTTPWorkQueue> queue;
 };
 
 /** HTTP module state */
@@ -240,7 +245,36 @@ static void http_request_cb(struct evhttp_request *req, void *arg)
     // Dispatch to worker thread
     if (i != iend)
     {
-        auto item = std::make_unique<HTTPWorkItem>(hreq, path, i->handler);
+        // JSON-RPC requests are queued to lanes by cost of method
+        auto lane = HTTPLane::NORMAL;
+        if (hreq->GetRequestMethod() == HTTPRequest::POST)
+            lane = g_http_costs.Classify(PeekRPCMethod(hreq->PeekBody(HTTP_PEEK_BODY_SIZE)));
+
+        // Shed early instead of letting request time out in queue
+        if (auto wait = i->queue->PredictWait(lane); g_http_queue_deadline > 0 && wait > g_http_queue_deadline)
+        {
+            i->queue->Shed(lane);
+            LogPrint(BCLog::RPCERROR, "WARNING: request rejected because predicted wait %.2fms of %s lane exceeded deadline.\n",
+                0.001 * (double) wait, HTTPLaneName(lane));
+            hreq->WriteHeader("Retry-After", strprintf("%d", wait / 1000000 + 1));
+            hreq->WriteReply(HTTP_SERVICE_UNAVAILABLE, "Predicted queue wait exceeds deadline");
+            return;
+        }
+
+        std::string client;
+        if (httpSock->m_publicAccess)
+        {
+            client = hreq->GetPeer().ToStringIP();
+            if (!g_http_clients.Acquire(client))
+            {
+                LogPrint(BCLog::RPCERROR, "WARNING: request rejected because client %s exceeded concurrent requests.\n", client);
+                hreq->WriteReply(HTTP_TOO_MANY_REQUESTS, "Too many concurrent requests");
+                return;
+            }
+        }
+
+        auto item = std::make_unique<HTTPWorkItem>(hreq, path, i->handler, lane, i->queue.get(),
+            client.empty() ? nullptr : &g_http_clients, client);
 
         if (!i->queue->Add(std::move(item)))
         {
@@ -392,6 +426,9 @@ bool InitHTTPServer(const util::Ref& context)
 #endif
     
     int timeout = gArgs.GetArg("-rpcservertimeout", DEFAULT_HTTP_SERVER_TIMEOUT);
+    g_http_compression = gArgs.GetBoolArg("-httpcompression", DEFAULT_HTTP_COMPRESSION);
+    g_http_queue_deadline = std::max<int64_t>(gArgs.GetArg("-rpcqueuedeadline", DEFAULT_HTTP_QUEUE_DEADLINE), 0) * 1000;
+    g_http_clients.SetLimit(gArgs.GetArg("-rpcclientconcurrency", DEFAULT_HTTP_CLIENT_CONCURRENCY));
     int workQueueMainDepth = std::max((long) gArgs.GetArg("-rpcworkqueue", DEFAULT_HTTP_WORKQUEUE), 1L);
     int workQueuePostDepth = std::max((long) gArgs.GetArg("-rpcpostworkqueue", DEFAULT_HTTP_POST_WORKQUEUE), 1L);
     int workQueuePublicDepth = std::max((long) gArgs.GetArg("-rpcpublicworkqueue", DEFAULT_HTTP_PUBLIC_WORKQUEUE), 1L);
@@ -470,6 +507,9 @@ void StartHTTPServer()
     int rpcStaticThreads = std::max((long) gArgs.GetArg("-rpcstaticthreads", DEFAULT_HTTP_STATIC_THREADS), 1L);
     int rpcRestThreads = std::max((long) gArgs.GetArg("-rpcrestthreads", DEFAULT_HTTP_REST_THREADS), 1L);
 
+    int sqlPoolSize = std::max((long) gArgs.GetArg("-sqlpoolsize", DEFAULT_SQL_POOL_SIZE), 1L);
+    PocketDb::SQLiteConnectionPoolInst.Start(sqlPoolSize);
+
     g_thread_http = std::thread(ThreadHTTP, eventBase);
 
     if (g_socket)
@@ -521,6 +561,9 @@ void StopHTTPServer()
     if (g_staticSocket) g_staticSocket->StopHTTPSocket();
     if (g_restSocket) g_restSocket->StopHTTPSocket();
 
+    // All workers are stopped - close pooled connections
+    PocketDb::SQLiteConnectionPoolInst.Stop();
+
     if (eventBase)
     {
         LogPrint(BCLog::HTTP, "Waiting for HTTP event thread to exit\n");
@@ -603,7 +646,7 @@ HTTPSocket::HTTPSocket(struct event_base *base, int timeout, int queueDepth, boo
         evhttp_cmd_type::EVHTTP_REQ_OPTIONS
     );
 
-    m_workQueue = std::make_shared<QueueLimited<std::unique_ptr<HTTPClosure>>>(queueDepth);
+    m_workQueue = std::make_shared<HTTPWorkQueue>(queueDepth);
 
     // transfer ownership to eventBase/HTTP via .release()
     m_eventHTTP = http_ctr.release(); 
@@ -618,11 +661,11 @@ HTTPSocket::~HTTPSocket()
     }
 }
 
-void HTTPSocket::StartThreads(const std::string name, std::shared_ptr<Queue<std::unique_ptr<HTTPClosure>>> queue, int threadCount)
+void HTTPSocket::StartThreads(const std::string name, std::shared_ptr<HTTPWorkQueue> queue, int threadCount)
 {
+    queue->SetThreads(threadCount);
     for (int i = 0; i < threadCount; i++) {
-        // Creating exec processor for every thread to guarantee each thread will have its own sqliteConnection.
-        // If unique sqliteConnection for each thread is not required, execProcessor can be shared between threads
+        // Executor does not own sqlite connection - it is taken from the shared pool for every request
         auto execProcessor = std::make_shared<ExecutorSqlite>();
         auto thread = std::make_shared<QueueEventLoopThread<std::unique_ptr<HTTPClosure>>>(queue, std::move(execProcessor));
         thread->Start(name);
@@ -701,7 +744,7 @@ int HTTPSocket::GetAddressCount()
 }
 
 void HTTPSocket::RegisterHTTPHandler(const std::string &prefix, bool exactMatch,
-                                     const HTTPRequestHandler &handler, std::shared_ptr<Queue<std::unique_ptr<HTTPClosure>>> _queue)
+                                     const HTTPRequestHandler &handler, std::shared_ptr<HTTPWorkQueue> _queue)
 {
     LogPrint(BCLog::HTTP, "Registering HTTP handler for %s (exactmatch %d)\n", prefix, exactMatch);
     m_pathHandlers.emplace_back(prefix, exactMatch, handler, _queue);
@@ -767,12 +810,13 @@ bool HTTPSocket::HTTPReq(HTTPRequest* req, const util::Ref& context, CRPCTable&
         // Set the URI
         jreq.URI = req->GetURI();
         std::string strReply;
+        bool notModified = false;
 
         // singleton request
         if (valRequest.isObject())
         {
             jreq.parse(valRequest);
-            jreq.SetDbConnection(req->DbConnection());
+            jreq.SetDbConnection([req]() { return req->DbConnection(); });
 
             uri = jreq.URI;
             method = jreq.strMethod;
@@ -783,20 +827,32 @@ bool HTTPSocket::HTTPReq(HTTPRequest* req, const util::Ref& context, CRPCTable&
             LogPrint(BCLog::RPC, "RPC started method %s%s (%s) with params: %s\n",
                 uri, method, rpcKey, prms);
 
-            UniValue result = table.execute(jreq);
+            std::string etag;
+            auto result = table.executeSerialized(jreq, &etag);
 
             auto execute = gStatEngineInstance.GetCurrentSystemTime();
 
             LogPrint(BCLog::RPC, "RPC executed method %s%s (%s) > %.2fms\n",
-                uri, method, rpcKey, (execute.count() - start.count()));
+                uri, method, rpcKey, 0.001 * (double) (execute.count() - start.count()));
+
+            // Cached result did not change since the client received it
+            if (!etag.empty())
+            {
+                req->WriteHeader("ETag", etag);
+
+                auto[hasIfNoneMatch, ifNoneMatch] = req->GetHeader("If-None-Match");
+                notModified = hasIfNoneMatch && ifNoneMatch.find(etag) != std::string::npos;
+            }
 
             // Send reply
-            strReply = JSONRPCReply(result, NullUniValue, jreq.id);
+            if (!notModified)
+                strReply = JSONRPCReplySerialized(*result, jreq.id);
         }
         else
         {
             if (valRequest.isArray())
             {
+                method = "batch";
                 strReply = JSONRPCExecBatch(jreq, valRequest.get_array(), table);
             }
             else
@@ -805,8 +861,15 @@ bool HTTPSocket::HTTPReq(HTTPRequest* req, const util::Ref& context, CRPCTable&
             }
         }
 
-        req->WriteHeader("Content-Type", "application/json");
-        req->WriteReply(HTTP_OK, strReply);
+        if (notModified)
+        {
+            req->WriteReply(HTTP_NOT_MODIFIED);
+        }
+        else
+        {
+            req->WriteHeader("Content-Type", "application/json");
+            req->WriteReply(HTTP_OK, strReply);
+        }
     }
     catch (const UniValue& objError)
     {
@@ -821,24 +884,20 @@ bool HTTPSocket::HTTPReq(HTTPRequest* req, const util::Ref& context, CRPCTable&
         executeSuccess = false;
     }
 
-    // Collect statistic data
-    if (gArgs.GetBoolArg("-collectstat", false) || LogInstance().WillLogCategory(BCLog::STAT))
-    {
-        auto finish = gStatEngineInstance.GetCurrentSystemTime();
-
-        gStatEngineInstance.AddSample(
-            Statistic::RequestSample{
-                method,
-                req->Created,
-                start,
-                finish,
-                peer,
-                !executeSuccess,
-                0,
-                0
-            }
-        );
-    }
+    // Collect statistic data - histograms are cheap enough for every request
+    // Method names come from clients - only registered methods get own histograms
+    gStatEngineInstance.AddSample(
+        Statistic::RequestSample{
+            table[method] ? method : Statistic::STAT_UNKNOWN_KEY,
+            req->Created,
+            start,
+            gStatEngineInstance.GetCurrentSystemTime(),
+            peer,
+            !executeSuccess,
+            0,
+            0
+        }
+    );
 
     return executeSuccess;
 }
@@ -847,7 +906,7 @@ bool HTTPSocket::HTTPReq(HTTPRequest* req, const util::Ref& context, CRPCTable&
 HTTPWebSocket::HTTPWebSocket(struct event_base* base, int timeout, int queueDepth, int queuePostDepth, bool publicAccess, bool fUseTls)
     : HTTPSocket(base, timeout, queueDepth, publicAccess, fUseTls)
 {
-    m_workPostQueue = std::make_shared<QueueLimited<std::unique_ptr<HTTPClosure>>>(queuePostDepth);
+    m_workPostQueue = std::make_shared<HTTPWorkQueue>(queuePostDepth);
 }
 
 HTTPWebSocket::~HTTPWebSocket() = default;
@@ -871,6 +930,58 @@ void HTTPWebSocket::InterruptHTTPSocket()
     HTTPSocket::InterruptHTTPSocket();
 }
 
+HTTPWorkItem::~HTTPWorkItem()
+{
+    if (limiter)
+        limiter->Release(client);
+}
+
+void HTTPWorkItem::operator()()
+{
+    int64_t start = GetTimeMicros();
+    func(req.get(), path);
+
+    // Connection returns to the pool as soon as the handler is done
+    req->ReleaseDbConnection();
+
+    if (queue)
+        queue->Complete(lane, GetTimeMicros() - start);
+
+    g_http_costs.Refresh();
+}
+
+UniValue HTTPQueueStatistic()
+{
+    UniValue result(UniValue::VOBJ);
+
+    UniValue queues(UniValue::VOBJ);
+    if (g_socket && g_socket->m_workQueue) queues.pushKV("main", g_socket->m_workQueue->Statistic());
+    if (g_webSocket && g_webSocket->m_workQueue) queues.pushKV("public", g_webSocket->m_workQueue->Statistic());
+    if (g_webSocket && g_webSocket->m_workPostQueue) queues.pushKV("post", g_webSocket->m_workPostQueue->Statistic());
+    if (g_restSocket && g_restSocket->m_workQueue) queues.pushKV("rest", g_restSocket->m_workQueue->Statistic());
+    if (g_staticSocket && g_staticSocket->m_workQueue) queues.pushKV("static", g_staticSocket->m_workQueue->Statistic());
+
+    result.pushKV("queues", queues);
+    result.pushKV("clients", g_http_clients.Statistic());
+    result.pushKV("deadline", g_http_queue_deadline / 1000);
+    return result;
+}
+
+std::string HTTPQueuePrometheusText()
+{
+    std::string result = "# HELP pocketnet_http_queue_depth Requests waiting in lane of work queue\n# TYPE pocketnet_http_queue_depth gauge\n"
+        "# HELP pocketnet_http_lane_cost_seconds Moving average of request execution in lane\n# TYPE pocketnet_http_lane_cost_seconds gauge\n"
+        "# HELP pocketnet_http_queue_shed_total Requests rejected with predicted wait over deadline\n# TYPE pocketnet_http_queue_shed_total counter\n";
+
+    if (g_socket && g_socket->m_workQueue) result += g_socket->m_workQueue->PrometheusText("main");
+    if (g_webSocket && g_webSocket->m_workQueue) result += g_webSocket->m_workQueue->PrometheusText("public");
+    if (g_webSocket && g_webSocket->m_workPostQueue) result += g_webSocket->m_workPostQueue->PrometheusText("post");
+    if (g_restSocket && g_restSocket->m_workQueue) result += g_restSocket->m_workQueue->PrometheusText("rest");
+    if (g_staticSocket && g_staticSocket->m_workQueue) result += g_staticSocket->m_workQueue->PrometheusText("static");
+
+    return result;
+}
+
 HTTPEvent::HTTPEvent(struct event_base *base, bool _deleteWhenTriggered, std::function<void()> _handler) :
     deleteWhenTriggered(_deleteWhenTriggered), handler(std::move(_handler))
 {
@@ -919,6 +1030,18 @@ std::pair<bool, std::string> HTTPRequest::GetHeader(const std::string &hdr) cons
         return std::make_pair(false, "");
 }
 
+std::string HTTPRequest::PeekBody(size_t maxSize) const
+{
+    struct evbuffer *buf = evhttp_request_get_input_buffer(req);
+    if (!buf)
+        return "";
+
+    std::string rv(std::min(evbuffer_get_length(buf), maxSize), '\0');
+    ev_ssize_t copied = evbuffer_copyout(buf, rv.data(), rv.size());
+    rv.resize(copied > 0 ? (size_t) copied : 0);
+    return rv;
+}
+
 std::string HTTPRequest::ReadBody()
 {
     struct evbuffer *buf = evhttp_request_get_input_buffer(req);
@@ -946,6 +1069,30 @@ void HTTPRequest::WriteHeader(const std::string &hdr, const std::string &value)
     evhttp_add_header(headers, hdr.c_str(), value.c_str());
 }
 
+bool HTTPRequest::Compress(const std::string &strReply, std::string &compressed)
+{
+    if (!g_http_compression || strReply.size() < HTTP_COMPRESSION_MIN_SIZE)
+        return false;
+
+    struct evkeyvalq *headers = evhttp_request_get_output_headers(req);
+    assert(headers);
+    const char *contentType = evhttp_find_header(headers, "Content-Type");
+    if (!contentType || !IsCompressibleContentType(contentType) || evhttp_find_header(headers, "Content-Encoding"))
+        return false;
+
+    auto[hasAcceptEncoding, acceptEncoding] = GetHeader("Accept-Encoding");
+    if (!hasAcceptEncoding)
+        return false;
+
+    auto encoding = SelectContentEncoding(acceptEncoding);
+    if (encoding == HTTPContentEncoding::IDENTITY || !CompressContent(strReply, encoding, HTTP_COMPRESSION_LEVEL, compressed))
+        return false;
+
+    WriteHeader("Content-Encoding", ContentEncodingName(encoding));
+    WriteHeader("Vary", "Accept-Encoding");
+    return true;
+}
+
 /** Closure sent to main thread to request a reply to be sent to
  * a HTTP request.
  * Replies must be sent in the main loop in the main http thread,
@@ -961,7 +1108,36 @@ void HTTPRequest::WriteReply(int nStatus, const std::string &strReply)
     // Send event to main http thread to send reply message
     struct evbuffer *evb = evhttp_request_get_output_buffer(req);
     assert(evb);
-    evbuffer_add(evb, strReply.data(), strReply.size());
+    std::string compressed;
+    if (Compress(strReply, compressed))
+        evbuffer_add(evb, compressed.data(), compressed.size());
+    else
+        evbuffer_add(evb, strReply.data(), strReply.size());
+    SendReply(nStatus);
+}
+
+void HTTPRequest::WriteReply(int nStatus, std::shared_ptr<const void> owner, const char* data, size_t size)
+{
+    assert(!replySent && req);
+    if (ShutdownRequested())
+    {
+        WriteHeader("Connection", "close");
+    }
+    struct evbuffer *evb = evhttp_request_get_output_buffer(req);
+    assert(evb);
+    if (size > 0)
+    {
+        // Owner is released by libevent after the data is written to socket
+        auto *ref = new std::shared_ptr<const void>(std::move(owner));
+        evbuffer_add_reference(evb, data, size, [](const void*, size_t, void* arg) {
+            delete static_cast<std::shared_ptr<const void>*>(arg);
+        }, ref);
+    }
+    SendReply(nStatus);
+}
+
+void HTTPRequest::SendReply(int nStatus)
+{
     auto req_copy = req;
     auto *ev = new HTTPEvent(eventBase, true, [req_copy, nStatus]
     {
@@ -986,14 +1162,17 @@ void HTTPRequest::WriteReply(int nStatus, const std::string &strReply)
     req = nullptr; // transferred back to main thread
 }
 
-void HTTPRequest::SetDbConnection(const DbConnectionRef& _dbConnection)
+const DbConnectionRef& HTTPRequest::DbConnection() const
 {
-    dbConnection = _dbConnection;
+    if (!dbConnection)
+        dbConnection = PocketDb::SQLiteConnectionPoolInst.Acquire();
+
+    return dbConnection;
 }
 
-const DbConnectionRef& HTTPRequest::DbConnection() const
+void HTTPRequest::ReleaseDbConnection()
 {
-    return dbConnection;
+    dbConnection = nullptr;
 }
 
 CService HTTPRequest::GetPeer() const
@@ -16,6 +16,7 @@
 #include <event2/util.h>
 #include <event2/keyvalq_struct.h>
 #include <support/events.h>
+#include <httpscheduler.h>
 #include "crypto/x509.h"
 #include "rpc/server.h"
 #include "init.h"
@@ -88,7 +89,14 @@ private:
     struct evhttp_request* req;
     bool replySent;
 
-    DbConnectionRef dbConnection;
+    //! Checked out from the pool by the first DbConnection() call
+    mutable DbConnectionRef dbConnection;
+
+    //! Compress reply with encoding accepted by client, sets Content-Encoding on success
+    bool Compress(const std::string& strReply, std::string& compressed);
+
+    //! Pass output buffer to main http thread
+    void SendReply(int nStatus);
 
 public:
     explicit HTTPRequest(struct evhttp_request* req, bool _replySent = false);
@@ -124,6 +132,11 @@ public:
      */
     std::pair<bool, std::string> GetHeader(const std::string& hdr) const;
 
+    /**
+     * Copy of up to maxSize first bytes of request body, the body is not consumed.
+     */
+    std::string PeekBody(size_t maxSize) const;
+
     /**
      * Read request body.
      *
@@ -143,15 +156,24 @@ public:
      * Write HTTP reply.
      * nStatus is the HTTP status code to send.
      * strReply is the body of the reply. Keep it empty to send a standard message.
+     * Text replies are compressed if client accepts it and -httpcompression is set.
      *
      * @note Can be called only once. As this will give the request back to the
      * main thread, do not call any other HTTPRequest methods after calling this.
      */
     void WriteReply(int nStatus, const std::string& strReply = "");
 
-    void SetDbConnection(const DbConnectionRef& _dbConnection);
+    /**
+     * Write HTTP reply without copying the body.
+     * data stays referenced by the output buffer until it is sent, owner keeps it alive.
+     * The body is sent as is, set Content-Encoding before if it is compressed.
+     */
+    void WriteReply(int nStatus, std::shared_ptr<const void> owner, const char* data, size_t size);
 
+    //! Connection of the worker thread, acquired from the pool on first call
     const DbConnectionRef& DbConnection() const;
+
+    void ReleaseDbConnection();
 };
 
 /** Event handler closure.
@@ -159,10 +181,13 @@ public:
 class HTTPClosure
 {
 public:
-    virtual void operator()(DbConnectionRef& sqliteConnection) = 0;
+    virtual void operator()() = 0;
+    virtual HTTPLane Lane() const { return HTTPLane::NORMAL; }
     virtual ~HTTPClosure() {}
 };
 
+using HTTPWorkQueue = LaneQueue<std::unique_ptr<HTTPClosure>>;
+
 /** Event class. This can be used either as a cross-thread trigger or as a timer.
  */
 class HTTPEvent
@@ -227,24 +252,29 @@ private:
 class HTTPWorkItem final : public HTTPClosure
 {
 public:
-    HTTPWorkItem(std::shared_ptr<HTTPRequest> _req, const std::string &_path, const HTTPRequestHandler &_func) :
-        req(std::move(_req)), path(_path), func(_func)
+    HTTPWorkItem(std::shared_ptr<HTTPRequest> _req, const std::string &_path, const HTTPRequestHandler &_func,
+        HTTPLane _lane = HTTPLane::NORMAL, HTTPWorkQueue* _queue = nullptr, HTTPClientLimiter* _limiter = nullptr, std::string _client = "") :
+        req(std::move(_req)), path(_path), func(_func), lane(_lane), queue(_queue), limiter(_limiter), client(std::move(_client))
     {
     }
 
-    void operator()(DbConnectionRef& dbConnection) override
-    {
-        auto jreq = req.get();
-        jreq->SetDbConnection(dbConnection);
+    /** Releases client slot - after execution or when request is dropped from queue */
+    ~HTTPWorkItem();
 
-        func(jreq, path);
-    }
+    void operator()() override;
+
+    HTTPLane Lane() const override { return lane; }
 
     std::shared_ptr<HTTPRequest> req;
 
 private:
     std::string path;
     HTTPRequestHandler func;
+    HTTPLane lane;
+    // Queue outlives its items, execution time is reported back to it
+    HTTPWorkQueue* queue;
+    HTTPClientLimiter* limiter;
+    std::string client;
 };
 
 class HTTPSocket
@@ -257,7 +287,7 @@ private:
     std::optional<SSLContext> m_sslCtx;
 
 protected:
-    void StartThreads(const std::string name, std::shared_ptr<Queue<std::unique_ptr<HTTPClosure>>> queue, int threadCount);
+    void StartThreads(const std::string name, std::shared_ptr<HTTPWorkQueue> queue, int threadCount);
 
 public:
     HTTPSocket(struct event_base* base, int timeout, int queueDepth, bool publicAccess, bool fUseTls = false);
@@ -269,7 +299,7 @@ public:
     
     /** Work queue for handling longer requests off the event loop thread */
     CRPCTable m_table_rpc;
-    std::shared_ptr<Queue<std::unique_ptr<HTTPClosure>>> m_workQueue;
+    std::shared_ptr<HTTPWorkQueue> m_workQueue;
     std::vector<HTTPPathHandler> m_pathHandlers;
 
     /** Start worker threads to listen on bound http sockets */
@@ -288,7 +318,7 @@ public:
      * be invoked.
      */
     void RegisterHTTPHandler(const std::string& prefix, bool exactMatch,
-        const HTTPRequestHandler& handler, std::shared_ptr<Queue<std::unique_ptr<HTTPClosure>>> _queue);
+        const HTTPRequestHandler& handler, std::shared_ptr<HTTPWorkQueue> _queue);
 
     /** Unregister handler for prefix */
     void UnregisterHTTPHandler(const std::string& prefix, bool exactMatch);
@@ -300,7 +330,7 @@ class HTTPWebSocket: public HTTPSocket
 {
 public:
     CRPCTable m_table_post_rpc;
-    std::shared_ptr<Queue<std::unique_ptr<HTTPClosure>>> m_workPostQueue;
+    std::shared_ptr<HTTPWorkQueue> m_workPostQueue;
 
     HTTPWebSocket(struct event_base* base, int timeout, int queueDepth, int queuePostDepth, bool publicAccess, bool fUseTls = false);
     ~HTTPWebSocket();
@@ -315,4 +345,9 @@ extern HTTPSocket* g_restSocket;
 extern HTTPWebSocket* g_webSocket;
 extern HTTPWebSocket* g_webSocketHttps;
 
+/** Lanes of work queues and client limits for getnodeinfo */
+UniValue HTTPQueueStatistic();
+/** The same in Prometheus text format */
+std::string HTTPQueuePrometheusText();
+
 #endif // POCKETCOIN_HTTPSERVER_H
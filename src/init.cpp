@@ -19,6 +19,7 @@
 #include <consensus/validation.h>
 #include <fs.h>
 #include <hash.h>
+#include <httpcompression.h>
 #include <httprpc.h>
 #include <httpserver.h>
 #include <index/blockfilterindex.h>
@@ -74,6 +75,10 @@
 #include "pocketdb/SQLiteDatabase.h"
 #include "pocketdb/pocketnet.h"
 #include "pocketdb/services/ChainPostProcessing.h"
+#include "pocketdb/services/BlockPayloadCache.h"
+#include "pocketdb/services/MempoolMirror.h"
+#include "pocketdb/consensus/SocialValidationPool.h"
+#include "pocketdb/consensus/PayloadCheckQueue.h"
 #include "pocketdb/migrations/base.h"
 #include "pocketdb/migrations/main.h"
 #include "pocketdb/migrations/web.h"
@@ -106,9 +111,9 @@ static const bool DEFAULT_STOPAFTERBLOCKIMPORT = false;
 
 Statistic::RequestStatEngine gStatEngineInstance;
 
-std::shared_ptr<ProtectedMap<std::string, WSUser>> WSConnections;
-std::shared_ptr<QueueEventLoopThread<std::pair<CBlock, CBlockIndex*>>> notifyClientsThread;
-std::shared_ptr<Queue<std::pair<CBlock, CBlockIndex*>>> notifyClientsQueue;
+std::shared_ptr<WSConnectionRegistry> WSConnections;
+std::shared_ptr<QueueEventLoopThread<NotifyBlockEntry>> notifyClientsThread;
+std::shared_ptr<Queue<NotifyBlockEntry>> notifyClientsQueue;
 
 #ifdef WIN32
 // Win32 LevelDB doesn't use filedescriptors, and the ones used for
@@ -181,6 +186,22 @@ static boost::thread_group threadGroup;
 
 void ShutdownPocketServices()
 {
+    PocketConsensus::SocialValidationPoolInst.Stop();
+
+    PocketServices::MempoolMirrorInst.Stop();
+
+    // Last blocks indexed during initial sync if chainstate was not flushed
+    try
+    {
+        PocketDb::SQLiteDbInst.CommitBatch();
+    }
+    catch (const std::exception& e)
+    {
+        LogPrintf("Error: Failed commit pocket database: %s\n", e.what());
+    }
+
+    PocketServices::BlockPayloadCacheInst.CloseStore();
+
     PocketDb::SQLiteDbInst.m_connection_mutex.lock();
 
     PocketDb::TransRepoInst.Destroy();
@@ -222,7 +243,8 @@ void Shutdown(NodeContext& node)
     Assert(node.args);
 
     PocketServices::WebPostProcessorInst.Stop();
-    // PocketServices::WalControllerInst.Stop();
+    PocketServices::IndexBuilderInst.Stop();
+    PocketServices::WalControllerInst.Stop();
     gStatEngineInstance.Stop();
 
     if (notifyClientsThread) {
@@ -260,6 +282,8 @@ void Shutdown(NodeContext& node)
     //   EraseOrphansFor, which locks g_cs_orphans.
     //
     // Thus the implicit locking order requirement is: (1) cs_main, (2) g_cs_orphans, (3) cs_vNodes.
+    PocketConsensus::PayloadCheckQueueInst.Stop();
+
     if (node.connman) {
         node.connman->StopThreads();
         LOCK2(::cs_main, ::g_cs_orphans);
@@ -475,6 +499,10 @@ void SetupServerArgs(NodeContext& node)
     argsman.AddArg("-minimumchainwork=<hex>", strprintf("Minimum work assumed to exist on a valid chain in hex (default: %s, testnet: %s, signet: %s)", defaultChainParams->GetConsensus().nMinimumChainWork.GetHex(), testnetChainParams->GetConsensus().nMinimumChainWork.GetHex(), signetChainParams->GetConsensus().nMinimumChainWork.GetHex()), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::OPTIONS);
     argsman.AddArg("-par=<n>", strprintf("Set the number of script verification threads (%u to %d, 0 = auto, <0 = leave that many cores free, default: %d)",
         -GetNumCores(), MAX_SCRIPTCHECK_THREADS, DEFAULT_SCRIPTCHECK_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-pocketvalidationthreads=<n>", strprintf("Set the number of additional threads for social consensus validation of block transactions (0 to %d, 0 = serial, default: %d)",
+        MAX_POCKET_VALIDATION_THREADS, DEFAULT_POCKET_VALIDATION_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
+    argsman.AddArg("-pocketpayloadthreads=<n>", strprintf("Set the number of threads for deserialization and context-free check of Pocket payloads of blocks downloaded during initial sync (0 to %d, 0 = inline, default: %d)",
+        MAX_POCKET_PAYLOAD_THREADS, DEFAULT_POCKET_PAYLOAD_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-persistmempool", strprintf("Whether to save the mempool on shutdown and load on restart (default: %u)", DEFAULT_PERSIST_MEMPOOL), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-pid=<file>", strprintf("Specify pid file. Relative paths will be prefixed by a net-specific datadir location. (default: %s)", POCKETCOIN_PID_FILENAME), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     argsman.AddArg("-prune=<n>", strprintf("Reduce storage requirements by enabling pruning (deleting) of old blocks. This allows the pruneblockchain RPC to be called to delete specific blocks, and enables automatic pruning of old blocks if a target size in MiB is provided. This mode is incompatible with -txindex and -rescan. "
@@ -640,7 +668,9 @@ void SetupServerArgs(NodeContext& node)
     argsman.AddArg("-rest", strprintf("Accept public REST requests (default: %u)", DEFAULT_REST_ENABLE), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::RPC);
 
     argsman.AddArg("-static", strprintf("Accept public requests to static resources (default: %u)", DEFAULT_STATIC_ENABLE), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
-    argsman.AddArg("-staticpath", "Path to static resources (default: GetDataDir()/wwwroot", ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-staticpath", "Path to static resources (default: GetDataDir()/wwwroot). Files are cached in memory and dropped from cache when changed on disk", ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-staticcachesize=<n>", strprintf("Memory limit of cached static files and their compressed variants in megabytes (default: %d)", DEFAULT_STATIC_CACHE_SIZE), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-staticwatchinterval=<n>", strprintf("Check cached static files for changes on disk every <n> seconds, 0 to disable (default: %d)", DEFAULT_STATIC_WATCH_INTERVAL), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
 
     argsman.AddArg("-rpcallowip=<ip>", "Allow JSON-RPC connections from specified source. Valid for <ip> are a single IP (e.g. 1.2.3.4), a network/netmask (e.g. 1.2.3.4/255.255.255.0) or a network/CIDR (e.g. 1.2.3.4/24). This option can be specified multiple times", ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpcauth=<userpw>", "Username and HMAC-SHA-256 hashed password for JSON-RPC connections. The field <userpw> comes in the format: <USERNAME>:<SALT>$<HASH>. A canonical python script is included in share/rpcauth. The client then connects normally using the rpcuser=<USERNAME>/rpcpassword=<PASSWORD> pair of arguments. This option can be specified multiple times", ArgsManager::ALLOW_ANY | ArgsManager::SENSITIVE, OptionsCategory::RPC);
@@ -654,6 +684,9 @@ void SetupServerArgs(NodeContext& node)
     argsman.AddArg("-staticrpcport=<port>", strprintf("Listen for static JSON-RPC connections on <port> (default: %u, testnet: %u, regtest: %u)", defaultBaseParams->StaticRPCPort(), testnetBaseParams->StaticRPCPort(), regtestBaseParams->StaticRPCPort()), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-restport=<port>", strprintf("Listen for static REST connections on <port> (default: %u, testnet: %u, regtest: %u)", defaultBaseParams->RestPort(), testnetBaseParams->RestPort(), regtestBaseParams->RestPort()), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpcserialversion", strprintf("Sets the serialization of raw transaction or block hex returned in non-verbose mode, non-segwit(0) or segwit(1) (default: %d)", DEFAULT_RPC_SERIALIZE_VERSION), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-rpcqueuedeadline=<n>", strprintf("Reject HTTP requests with 503 when predicted wait in work queue exceeds <n> milliseconds, 0 to disable (default: %d)", DEFAULT_HTTP_QUEUE_DEADLINE), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-rpcclientconcurrency=<n>", strprintf("Limit of concurrent requests from one address to public sockets, 0 to disable. Keep disabled behind a reverse proxy - all requests come from its address (default: %d)", DEFAULT_HTTP_CLIENT_CONCURRENCY), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    argsman.AddArg("-httpcompression", strprintf("Compress HTTP replies with gzip, deflate or brotli if accepted by client (default: %u)", DEFAULT_HTTP_COMPRESSION), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpcservertimeout=<n>", strprintf("Timeout during HTTP requests (default: %d)", DEFAULT_HTTP_SERVER_TIMEOUT), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::RPC);
     argsman.AddArg("-rpcthreads=<n>", strprintf("Set the number of threads to service RPC (MAIN) calls (default: %d)", DEFAULT_HTTP_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     argsman.AddArg("-rpcpublicthreads=<n>", strprintf("Set the number of threads to service RPC (PUBLIC) calls (default: %d)", DEFAULT_HTTP_PUBLIC_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
@@ -678,6 +711,18 @@ void SetupServerArgs(NodeContext& node)
     argsman.AddArg("-sqltimeout", strprintf("Timeout for ReadOnly sql querys (default: %ds)", 10), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
     argsman.AddArg("-sqlsharedcache", strprintf("Experimental: Enable shared cache for sqlite connections (default: disabled)"), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
     argsman.AddArg("-sqlcachesize", strprintf("Experimental: Cache size for SQLite connection in megabytes (default: %d mb)", 5), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
+    argsman.AddArg("-sqlpoolsize=<n>", strprintf("Number of read-only SQLite connections shared between all RPC work queues (default: %d)", DEFAULT_SQL_POOL_SIZE), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
+    argsman.AddArg("-sqlbulkload", strprintf("Do not maintain web-only indexes of the main database during reindex and initial sync, build them once the chain tip is reached (default: %u)", DEFAULT_SQL_BULK_LOAD), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
+    argsman.AddArg("-sqlgroupcommitblocks=<n>", strprintf("Number of blocks indexed in one database transaction during initial sync, 1 disables group commit (default: %d)", DEFAULT_SQL_GROUP_COMMIT_BLOCKS), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
+    argsman.AddArg("-sqlgroupcommittime=<n>", strprintf("Maximum time in milliseconds blocks are accumulated in one database transaction during initial sync (default: %d)", DEFAULT_SQL_GROUP_COMMIT_TIME), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
+    argsman.AddArg("-registrycachesize=<n>", strprintf("Memory limit of the shared Registry strings and ids cache in megabytes (default: %d)", DEFAULT_REGISTRY_CACHE_SIZE), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
+    argsman.AddArg("-blockpayloadcachesize=<n>", strprintf("Memory limit of the cache of serialized Pocket block payloads sent to peers in megabytes (default: %d)", DEFAULT_BLOCK_PAYLOAD_CACHE_SIZE), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
+    argsman.AddArg("-blockpayloadstore", strprintf("Persist compact Pocket block payloads in pld?????.dat files of blocks directory to serve historical blocks without database (default: %u)", DEFAULT_BLOCK_PAYLOAD_STORE), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
+    argsman.AddArg("-repairaccountstatistic", "Recompute web account statistic from the whole chain on startup, normally it is maintained by each block (default: 0)", ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
+    argsman.AddArg("-sqlwalcontroller", strprintf("Run WAL checkpoints of main and web databases in background thread instead of commits of writers (default: %u)", DEFAULT_SQL_WAL_CONTROLLER), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
+    argsman.AddArg("-sqlwalcheckpointpages=<n>", strprintf("Number of WAL pages after commit that start background PASSIVE checkpoint (default: %d)", DEFAULT_SQL_WAL_CHECKPOINT_PAGES), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
+    argsman.AddArg("-sqlwaltruncatesize=<n>", strprintf("WAL file size in megabytes truncated by background checkpoint when no RPC readers are active (default: %d)", DEFAULT_SQL_WAL_TRUNCATE_SIZE), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
+    argsman.AddArg("-sqlstmtcachesize=<n>", strprintf("Maximum number of prepared statements cached per SQLite connection (default: %d, min: %d)", 256, 64), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
     argsman.AddArg("-sqltempstore", strprintf("Experimental: Type of temporary storage (memory|file, default: memory)"), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
     argsman.AddArg("-sqltempstorepath", strprintf("Experimental: Directory path of temporary storage, only for 'sqltempstore = file' (default: empty)"), ArgsManager::ALLOW_ANY, OptionsCategory::SQLITE);
 
@@ -873,6 +918,7 @@ static void ThreadImport(ChainstateManager& chainman, const util::Ref& context,
                     }
 
                     PocketServices::ChainPostProcessing::Index(block, pblockindex->nHeight);
+                    PocketServices::ChainPostProcessing::GroupCommit(pblockindex->nHeight, true);
 
                     LogPrint(BCLog::SYNC, "Indexing pocketnet part at height %d\n", pblockindex->nHeight);
                     i += 1;
@@ -884,6 +930,9 @@ static void ThreadImport(ChainstateManager& chainman, const util::Ref& context,
                     break;
                 }
             }
+
+            // Commit the rest of accumulated blocks
+            PocketServices::ChainPostProcessing::GroupCommit(i - 1, false);
         }
 
         // .. only web DB
@@ -955,11 +1004,18 @@ static void ThreadImport(ChainstateManager& chainman, const util::Ref& context,
         Staker::getInstance()->startWorkers(threadGroup, context, chainparams);
     #endif
 
+    // WAL checkpoints out of writers commit, before other writer connections are opened
+    if (args.GetBoolArg("-sqlwalcontroller", DEFAULT_SQL_WAL_CONTROLLER))
+        PocketServices::WalControllerInst.Start(threadGroup);
+
     // Start Web database building thread after loading chainActive
     if (args.GetBoolArg("-api", DEFAULT_API_ENABLE))
         PocketServices::WebPostProcessorInst.Start(threadGroup);
 
-    // PocketServices::WalControllerInst.Start(threadGroup);
+    // Build web-only indexes skipped during initial sync
+    if (args.GetBoolArg("-sqlbulkload", DEFAULT_SQL_BULK_LOAD))
+        PocketServices::IndexBuilderInst.Start(threadGroup);
+
 }
 
 /** Sanity checks
@@ -1495,10 +1551,10 @@ static void StartWSS()
 
 static void InitWS()
 {
-    WSConnections = std::make_shared<ProtectedMap<std::string, WSUser>>();
+    WSConnections = std::make_shared<WSConnectionRegistry>();
     auto notifyProcessor = std::make_shared<NotifyBlockProcessor>(WSConnections);
-    notifyClientsQueue = std::make_shared<Queue<std::pair<CBlock, CBlockIndex*>>>();
-    notifyClientsThread = std::make_shared<QueueEventLoopThread<std::pair<CBlock, CBlockIndex*>>>(notifyClientsQueue, notifyProcessor);
+    notifyClientsQueue = std::make_shared<Queue<NotifyBlockEntry>>();
+    notifyClientsThread = std::make_shared<QueueEventLoopThread<NotifyBlockEntry>>(notifyClientsQueue, notifyProcessor);
     notifyClientsThread->Start("notifyClientsThread");
     std::thread server_thread(&StartWS);
     server_thread.detach();
@@ -1606,8 +1662,24 @@ bool AppInitMain(const util::Ref& context, NodeContext& node, interfaces::BlockA
 
     // ********************************************************* Step 4b: Start PocketDB
     uiInterface.InitMessage(_("Loading Pocket DB...").translated);
+    PocketDb::RegistryCacheInst.SetMaxSize(args.GetArg("-registrycachesize", DEFAULT_REGISTRY_CACHE_SIZE));
+    PocketServices::BlockPayloadCacheInst.SetMaxSize(args.GetArg("-blockpayloadcachesize", DEFAULT_BLOCK_PAYLOAD_CACHE_SIZE));
+    if (args.GetBoolArg("-blockpayloadstore", DEFAULT_BLOCK_PAYLOAD_STORE))
+        PocketServices::BlockPayloadCacheInst.OpenStore(GetBlocksDir(), chainparams.MessageStart());
     PocketDb::InitSQLite(GetDataDir() / "pocketdb");
+    PocketServices::MempoolMirrorInst.Start();
+    node.scheduler->scheduleEvery([]{
+        PocketServices::ChainPostProcessing::CommitExpiredBatch();
+    }, std::chrono::seconds{1});
+    PocketWeb::PocketFrontendInst.SetMaxSize(args.GetArg("-staticcachesize", DEFAULT_STATIC_CACHE_SIZE));
     PocketWeb::PocketFrontendInst.Init();
+    if (int watchInterval = args.GetArg("-staticwatchinterval", DEFAULT_STATIC_WATCH_INTERVAL); watchInterval > 0)
+    {
+        node.scheduler->scheduleEvery([]{
+            PocketWeb::PocketFrontendInst.CheckChanges();
+        }, std::chrono::seconds{watchInterval});
+    }
+    PocketConsensus::SocialValidationPoolInst.Start(args.GetArg("-pocketvalidationthreads", DEFAULT_POCKET_VALIDATION_THREADS));
 
     if (ShutdownRequested())
     {
@@ -1671,6 +1743,10 @@ bool AppInitMain(const util::Ref& context, NodeContext& node, interfaces::BlockA
     node.peerman.reset(new PeerManager(chainparams, *node.connman, node.banman.get(), *node.scheduler, chainman, *node.mempool));
     RegisterValidationInterface(node.peerman.get());
 
+    PocketConsensus::PayloadCheckQueueInst.Start(args.GetArg("-pocketpayloadthreads", DEFAULT_POCKET_PAYLOAD_THREADS), [&connman = *node.connman]() {
+        connman.WakeMessageHandler();
+    });
+
     // sanitize comments per BIP-0014, format user agent and check total size
     std::vector<std::string> uacomments;
     for (const std::string& cmt : args.GetArgs("-uacomment")) {
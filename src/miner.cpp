@@ -21,6 +21,7 @@
 #include <timedata.h>
 #include <util/moneystr.h>
 #include <util/system.h>
+#include "pocketdb/services/MempoolMirror.h"
 
 #include <algorithm>
 #include <utility>
@@ -106,6 +107,9 @@ std::unique_ptr<CBlockTemplate> BlockAssembler::CreateNewBlock(const Optional<CS
 {
     int64_t nTimeStart = GetTimeMicros();
 
+    // Pocket part of mempool transactions is validated against Mempool table
+    PocketServices::MempoolMirrorInst.Flush();
+
     resetBlock();
     pblocktemplate = std::make_unique<CBlockTemplate>();
 
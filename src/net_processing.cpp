@@ -34,6 +34,8 @@
 #include <typeinfo>
 
 #include "pocketdb/services/Accessor.h"
+#include "pocketdb/services/BlockPayloadCache.h"
+#include "pocketdb/consensus/PayloadCheckQueue.h"
 
 /** Expiration time for orphan transactions in seconds */
 static constexpr int64_t ORPHAN_TX_EXPIRE_TIME = 20 * 60;
@@ -1480,16 +1482,26 @@ void PeerManager::NewPoSValidBlock(const CBlockIndex *pindex, const std::shared_
     uint256 hashBlock(pblock->GetHash());
 
     // Get PocketData for transactions from this block
-    std::string pocketBlockData;
-    if (pocketBlock)
-        pocketBlockData = PocketServices::Serializer::SerializeBlock(*pocketBlock)->write();
-
-    if (pocketBlockData.empty() && !PocketServices::Accessor::GetBlock(*pblock, pocketBlockData))
+    PocketBlockRef pocketBlockRef = pocketBlock;
+    if (!pocketBlockRef && !PocketServices::Accessor::GetBlock(*pblock, pocketBlockRef))
     {
         LogPrintf("Error: Failed get block payload from sqlite db %s\n", pblock->GetHash().GetHex());
         return;
     }
 
+    // Old peers receive JSON payload, others - compact binary
+    std::string pocketBlockData;
+    std::string pocketBlockDataCompact;
+    if (pocketBlockRef)
+    {
+        pocketBlockData = PocketServices::Serializer::SerializeBlock(*pocketBlockRef)->write();
+        pocketBlockDataCompact = PocketServices::Serializer::SerializeBlockCompact(*pocketBlockRef);
+    }
+
+    // Following getdata requests for this block are served without database
+    PocketServices::BlockPayloadCacheInst.Put(hashBlock, false, pocketBlockData);
+    PocketServices::BlockPayloadCacheInst.Put(hashBlock, true, pocketBlockDataCompact);
+
     {
         LOCK(cs_most_recent_block);
         most_recent_block_hash = hashBlock;
@@ -1497,7 +1509,7 @@ void PeerManager::NewPoSValidBlock(const CBlockIndex *pindex, const std::shared_
         most_recent_compact_block = pcmpctblock;
     }
 
-    m_connman.ForEachNode([this, &pcmpctblock, pindex, &msgMaker, &hashBlock, pocketBlockData](CNode* pnode) EXCLUSIVE_LOCKS_REQUIRED(::cs_main) {
+    m_connman.ForEachNode([this, &pcmpctblock, pindex, &msgMaker, &hashBlock, &pocketBlockData, &pocketBlockDataCompact](CNode* pnode) EXCLUSIVE_LOCKS_REQUIRED(::cs_main) {
         AssertLockHeld(::cs_main);
 
         // TODO: Avoid the repeated-serialization here
@@ -1512,7 +1524,8 @@ void PeerManager::NewPoSValidBlock(const CBlockIndex *pindex, const std::shared_
             LogPrint(BCLog::NET, "%s: sending header-and-ids %s to peer=%d%s\n", "PeerManager::NewPoSValidBlock",
                     hashBlock.ToString(), pnode->GetId(), fLogIPs ? ", peeraddr=" + pnode->addr.ToString() : "");
 
-            m_connman.PushMessage(pnode, msgMaker.Make(NetMsgType::CMPCTBLOCK, *pcmpctblock, pocketBlockData));
+            bool compactPayload = pnode->GetCommonVersion() >= POCKET_COMPACT_PAYLOAD_VERSION;
+            m_connman.PushMessage(pnode, msgMaker.Make(NetMsgType::CMPCTBLOCK, *pcmpctblock, compactPayload ? pocketBlockDataCompact : pocketBlockData));
             state.pindexBestHeaderSent = pindex;
         }
     });
@@ -1770,7 +1783,7 @@ void static ProcessGetBlockData(CNode& pfrom, const CChainParams& chainparams, c
             }
 
             std::string pocketBlockData;
-            if (!PocketServices::Accessor::GetBlock(block, pocketBlockData))
+            if (!PocketServices::Accessor::GetBlock(block, pocketBlockData, pfrom.GetCommonVersion() >= POCKET_COMPACT_PAYLOAD_VERSION))
             {
                 LogPrintf("WARNING! Cannot load block payload from sqlite db: %s\n", block.GetHash().GetHex());
                 return;
@@ -1787,7 +1800,7 @@ void static ProcessGetBlockData(CNode& pfrom, const CChainParams& chainparams, c
         }
         if (pblock) {
             std::string pocketBlockData;
-            if (!PocketServices::Accessor::GetBlock(*pblock, pocketBlockData))
+            if (!PocketServices::Accessor::GetBlock(*pblock, pocketBlockData, pfrom.GetCommonVersion() >= POCKET_COMPACT_PAYLOAD_VERSION))
             {
                 LogPrintf("WARNING! Cannot load block payload from sqlite db: %s\n", pblock->GetHash().GetHex());
                 return;
@@ -2006,7 +2019,7 @@ void PeerManager::SendBlockTransactions(CNode& pfrom, const CBlock& block, const
     }
 
     std::string pocketBlockData;
-    if (!PocketServices::Accessor::GetBlock(block, pocketBlockData))
+    if (!PocketServices::Accessor::GetBlock(block, pocketBlockData, pfrom.GetCommonVersion() >= POCKET_COMPACT_PAYLOAD_VERSION))
     {
         LogPrintf("Error get block data for %s from sqlite db\n", block.GetHash().GetHex());
         return;
@@ -3830,6 +3843,21 @@ void PeerManager::ProcessMessage(CNode& pfrom, const std::string& msg_type, CDat
         LogPrint(BCLog::NET, "%s: received block %s peer=%d%s\n",
            __func__, pblock->GetHash().ToString(), pfrom.GetId(), (fLogIPs ? strprintf(", peeraddr=%s", pfrom.addr.ToString()) : ""));
 
+        // During initial sync Pocket payload is deserialized and checked ahead on worker threads,
+        // the block is received and connected later in ProcessCheckedPayloads
+        if (::ChainstateActive().IsInitialBlockDownload())
+        {
+            const CBlockIndex* pindex = WITH_LOCK(cs_main, return LookupBlockIndex(pblock->GetHash()));
+            if (pindex)
+            {
+                auto job = std::make_shared<PocketConsensus::PayloadCheckJob>(pfrom.GetId(), pblock, std::move(vRecv), pindex->nHeight);
+                if (PocketConsensus::PayloadCheckQueueInst.Push(job))
+                    return;
+
+                vRecv = std::move(job->Payload);
+            }
+        }
+
         bool forceProcessing = false;
         const uint256 hash(pblock->GetHash());
         {
@@ -4156,10 +4184,43 @@ bool PeerManager::MaybeDiscourageAndDisconnect(CNode& pnode)
     return true;
 }
 
+void PeerManager::ProcessCheckedPayloads()
+{
+    for (const auto& job : PocketConsensus::PayloadCheckQueueInst.TakeCompleted())
+    {
+        bool forceProcessing = false;
+        const uint256 hash(job->Block->GetHash());
+        {
+            LOCK(cs_main);
+            forceProcessing |= MarkBlockAsReceived(hash);
+            mapBlockSource.emplace(hash, std::make_pair(job->NodeId, true));
+        }
+
+        bool fNewBlock = false;
+        BlockValidationState state;
+        m_chainman.ProcessNewBlock(state, m_chainparams, job->Block, job->PocketBlock, forceProcessing, &fNewBlock);
+
+        // Check result is not needed if ProcessNewBlock failed before Check
+        PocketConsensus::PayloadCheckQueueInst.Forget(hash);
+
+        if (fNewBlock) {
+            m_connman.ForNode(job->NodeId, [](CNode* pnode) {
+                pnode->nLastBlockTime = GetTime();
+                return true;
+            });
+        } else {
+            LOCK(cs_main);
+            mapBlockSource.erase(hash);
+        }
+    }
+}
+
 bool PeerManager::ProcessMessages(CNode* pfrom, std::atomic<bool>& interruptMsgProc)
 {
     bool fMoreWork = false;
 
+    ProcessCheckedPayloads();
+
     PeerRef peer = GetPeerRef(pfrom->GetId());
     if (peer == nullptr) return false;
 
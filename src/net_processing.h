@@ -130,6 +130,9 @@ private:
 
     void SendBlockTransactions(CNode& pfrom, const CBlock& block, const BlockTransactionsRequest& req);
 
+    /** Receive and connect blocks with Pocket payloads checked ahead on PayloadCheckQueue workers. */
+    void ProcessCheckedPayloads();
+
     /** Register with TxRequestTracker that an INV has been received from a
      *  peer. The announcement parameters are decided in PeerManager and then
      *  passed to TxRequestTracker. */
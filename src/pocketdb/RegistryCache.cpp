@@ -0,0 +1,130 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include "pocketdb/RegistryCache.h"
+
+#include <functional>
+
+namespace PocketDb
+{
+    RegistryCache RegistryCacheInst;
+
+    void RegistryCache::SetMaxSize(int megabytes)
+    {
+        m_maxShardBytes = (size_t) std::max(megabytes, 0) * 1024 * 1024 / (SHARDS * 2);
+    }
+
+    bool RegistryCache::GetId(const string& value, int64_t& id)
+    {
+        auto& shard = m_ids[hash<string>{}(value) % SHARDS];
+
+        LOCK(shard.mutex);
+        if (auto it = shard.values.find(value); it != shard.values.end())
+        {
+            id = it->second;
+            m_hits++;
+            return true;
+        }
+
+        m_misses++;
+        return false;
+    }
+
+    bool RegistryCache::GetId(string_view value, int64_t& id)
+    {
+        static thread_local string key;
+        key.assign(value.data(), value.size());
+        return GetId(key, id);
+    }
+
+    bool RegistryCache::GetString(int64_t id, string& value)
+    {
+        auto& shard = m_strings[(size_t) id % SHARDS];
+
+        LOCK(shard.mutex);
+        if (auto it = shard.values.find(id); it != shard.values.end())
+        {
+            value = it->second;
+            m_hits++;
+            return true;
+        }
+
+        m_misses++;
+        return false;
+    }
+
+    void RegistryCache::Put(const string& value, int64_t id)
+    {
+        auto size = EntrySize(value);
+        Put(m_ids[hash<string>{}(value) % SHARDS], value, id, size);
+        Put(m_strings[(size_t) id % SHARDS], id, value, size);
+    }
+
+    template<typename K, typename V>
+    void RegistryCache::Put(Shard<K, V>& shard, const K& key, const V& value, size_t size)
+    {
+        size_t maxBytes = m_maxShardBytes;
+        if (size > maxBytes)
+            return;
+
+        LOCK(shard.mutex);
+        if (!shard.values.emplace(key, value).second)
+            return;
+
+        shard.order.push_back(key);
+        shard.bytes += size;
+
+        while (shard.bytes > maxBytes && !shard.order.empty())
+        {
+            auto it = shard.values.find(shard.order.front());
+            if (it != shard.values.end())
+            {
+                if constexpr (is_same<K, string>::value)
+                    shard.bytes -= EntrySize(it->first);
+                else
+                    shard.bytes -= EntrySize(it->second);
+
+                shard.values.erase(it);
+            }
+
+            shard.order.pop_front();
+        }
+    }
+
+    UniValue RegistryCache::Statistic()
+    {
+        size_t ids = 0;
+        size_t strings = 0;
+        size_t bytes = 0;
+
+        for (auto& shard : m_ids)
+        {
+            LOCK(shard.mutex);
+            ids += shard.values.size();
+            bytes += shard.bytes;
+        }
+
+        for (auto& shard : m_strings)
+        {
+            LOCK(shard.mutex);
+            strings += shard.values.size();
+            bytes += shard.bytes;
+        }
+
+        int64_t hits = m_hits;
+        int64_t misses = m_misses;
+
+        UniValue result(UniValue::VOBJ);
+        result.pushKV("ids", (int64_t) ids);
+        result.pushKV("strings", (int64_t) strings);
+        result.pushKV("memory", (int64_t) bytes);
+        result.pushKV("maxmemory", (int64_t) (m_maxShardBytes * SHARDS * 2));
+        result.pushKV("hits", hits);
+        result.pushKV("misses", misses);
+        result.pushKV("hitrate", hits + misses > 0 ? (double) hits / (hits + misses) : 0.0);
+
+        return result;
+    }
+
+} // namespace PocketDb
@@ -0,0 +1,74 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETDB_REGISTRYCACHE_H
+#define POCKETDB_REGISTRYCACHE_H
+
+#include "sync.h"
+#include "univalue.h"
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+static const int DEFAULT_REGISTRY_CACHE_SIZE = 64;
+
+namespace PocketDb
+{
+    using namespace std;
+
+    /**
+    * Process-wide cache of Registry values in both directions (String -> RowId and RowId -> String).
+    * Registry is append-only, so a committed pair never changes. Values written in an open
+    * transaction must be published only after commit - rolled back RowIds can be reused.
+    * Memory is bounded per shard, the oldest values are evicted first.
+    */
+    class RegistryCache
+    {
+    private:
+        static const size_t SHARDS = 16;
+
+        template<typename K, typename V>
+        struct Shard
+        {
+            Mutex mutex;
+            unordered_map<K, V> values;
+            deque<K> order;
+            size_t bytes = 0;
+        };
+
+        array<Shard<string, int64_t>, SHARDS> m_ids;
+        array<Shard<int64_t, string>, SHARDS> m_strings;
+
+        atomic<size_t> m_maxShardBytes{(size_t) DEFAULT_REGISTRY_CACHE_SIZE * 1024 * 1024 / (SHARDS * 2)};
+        atomic<int64_t> m_hits{0};
+        atomic<int64_t> m_misses{0};
+
+        static size_t EntrySize(const string& value) { return value.capacity() + 2 * sizeof(void*) + 64; }
+
+        template<typename K, typename V>
+        void Put(Shard<K, V>& shard, const K& key, const V& value, size_t size);
+
+    public:
+        // Limit of memory for all values in megabytes
+        void SetMaxSize(int megabytes);
+
+        bool GetId(const string& value, int64_t& id);
+        // Without allocation for each lookup - key is copied to reused per-thread buffer
+        bool GetId(string_view value, int64_t& id);
+        bool GetString(int64_t id, string& value);
+
+        void Put(const string& value, int64_t id);
+
+        UniValue Statistic();
+    };
+
+    extern RegistryCache RegistryCacheInst;
+
+} // namespace PocketDb
+
+#endif // POCKETDB_REGISTRYCACHE_H
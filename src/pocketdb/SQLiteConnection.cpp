@@ -14,15 +14,15 @@ namespace PocketDb
         SQLiteDbInst->Init(dbBasePath, "main");
         SQLiteDbInst->AttachDatabase("web");
 
-        WebRpcRepoInst = make_shared<WebRpcRepository>(*SQLiteDbInst, true);
-        ExplorerRepoInst = make_shared<ExplorerRepository>(*SQLiteDbInst, true);
-        SearchRepoInst = make_shared<SearchRepository>(*SQLiteDbInst, true);
-        ModerationRepoInst = make_shared<ModerationRepository>(*SQLiteDbInst, true);
-        BarteronRepoInst = make_shared<BarteronRepository>(*SQLiteDbInst, true);
-        NotifierRepoInst = make_shared<NotifierRepository>(*SQLiteDbInst, true);
-        AppRepoInst = make_shared<AppRepository>(*SQLiteDbInst, true);
-        TransactionRepoInst = make_shared<TransactionRepository>(*SQLiteDbInst, true);
-        ConsensusRepoInst = make_shared<ConsensusRepository>(*SQLiteDbInst, true);
+        WebRpcRepoInst = make_shared<WebRpcRepository>(*SQLiteDbInst, timeouted);
+        ExplorerRepoInst = make_shared<ExplorerRepository>(*SQLiteDbInst, timeouted);
+        SearchRepoInst = make_shared<SearchRepository>(*SQLiteDbInst, timeouted);
+        ModerationRepoInst = make_shared<ModerationRepository>(*SQLiteDbInst, timeouted);
+        BarteronRepoInst = make_shared<BarteronRepository>(*SQLiteDbInst, timeouted);
+        NotifierRepoInst = make_shared<NotifierRepository>(*SQLiteDbInst, timeouted);
+        AppRepoInst = make_shared<AppRepository>(*SQLiteDbInst, timeouted);
+        TransactionRepoInst = make_shared<TransactionRepository>(*SQLiteDbInst, timeouted);
+        ConsensusRepoInst = make_shared<ConsensusRepository>(*SQLiteDbInst, timeouted);
     }
 
     SQLiteConnection::~SQLiteConnection()
@@ -45,5 +45,10 @@ namespace PocketDb
         SQLiteDbInst->m_connection_mutex.unlock();
     }
 
+    StmtCache& SQLiteConnection::Statements()
+    {
+        return SQLiteDbInst->Statements();
+    }
+
 
 } // namespace PocketDb
\ No newline at end of file
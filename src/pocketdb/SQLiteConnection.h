@@ -46,6 +46,7 @@ namespace PocketDb
         TransactionRepositoryRef TransactionRepoInst;
         ConsensusRepositoryRef ConsensusRepoInst;
 
+        StmtCache& Statements();
     };
 
 } // namespace PocketDb
@@ -0,0 +1,145 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include "pocketdb/SQLiteConnectionPool.h"
+#include "util/system.h"
+#include "util/time.h"
+
+namespace PocketDb
+{
+    void SQLiteConnectionPool::Start(int size)
+    {
+        LOCK(m_mutex);
+        m_maxSize = (size_t) std::max(size, 1);
+        m_running = true;
+
+        LogPrintf("SQLite connection pool started with %d connections\n", m_maxSize);
+    }
+
+    void SQLiteConnectionPool::Stop()
+    {
+        {
+            LOCK(m_mutex);
+            m_running = false;
+
+            // Connections that are still checked out will be closed on release
+            m_idle.clear();
+            m_connections.clear();
+        }
+
+        m_cv.notify_all();
+    }
+
+    DbConnectionRef SQLiteConnectionPool::Acquire()
+    {
+        shared_ptr<SQLiteConnection> connection;
+        int64_t nTime1 = GetTimeMicros();
+        bool waited = false;
+
+        {
+            WAIT_LOCK(m_mutex, lock);
+
+            auto deadline = chrono::steady_clock::now() + chrono::seconds(gArgs.GetArg("-sqltimeout", 10));
+
+            while (m_running && m_idle.empty() && m_connections.size() >= m_maxSize)
+            {
+                waited = true;
+                if (m_cv.wait_until(lock, deadline) == cv_status::timeout && m_idle.empty())
+                {
+                    m_timeouts++;
+                    throw runtime_error("SQLite connection pool wait timeout");
+                }
+            }
+
+            if (!m_running)
+                throw runtime_error("SQLite connection pool stopped");
+
+            if (!m_idle.empty())
+            {
+                connection = m_idle.back();
+                m_idle.pop_back();
+            }
+            else
+            {
+                connection = make_shared<SQLiteConnection>(true);
+                m_connections.push_back(connection);
+            }
+        }
+
+        if (waited)
+        {
+            int64_t waitTime = GetTimeMicros() - nTime1;
+            m_waited++;
+            m_waitTimeUs += waitTime;
+
+            int64_t maxWait = m_maxWaitTimeUs;
+            while (waitTime > maxWait && !m_maxWaitTimeUs.compare_exchange_weak(maxWait, waitTime)) { }
+        }
+
+        m_acquired++;
+
+        // Connection returns to the pool when the last reference is released
+        return DbConnectionRef(connection.get(), [this, connection](SQLiteConnection*) { Release(connection); });
+    }
+
+    void SQLiteConnectionPool::Release(const shared_ptr<SQLiteConnection>& connection)
+    {
+        {
+            LOCK(m_mutex);
+            if (!m_running)
+                return;
+
+            m_idle.push_back(connection);
+        }
+
+        m_cv.notify_one();
+    }
+
+    size_t SQLiteConnectionPool::InUse()
+    {
+        LOCK(m_mutex);
+        return m_connections.size() - m_idle.size();
+    }
+
+    UniValue SQLiteConnectionPool::Statistic()
+    {
+        vector<shared_ptr<SQLiteConnection>> connections;
+        size_t idle = 0;
+        size_t maxSize = 0;
+        {
+            LOCK(m_mutex);
+            connections = m_connections;
+            idle = m_idle.size();
+            maxSize = m_maxSize;
+        }
+
+        int64_t hits = 0;
+        int64_t misses = 0;
+        size_t statements = 0;
+        for (const auto& connection : connections)
+        {
+            hits += connection->Statements().Hits();
+            misses += connection->Statements().Misses();
+            statements += connection->Statements().Size();
+        }
+
+        int64_t acquired = m_acquired;
+        int64_t waited = m_waited;
+
+        UniValue result(UniValue::VOBJ);
+        result.pushKV("size", (int64_t) maxSize);
+        result.pushKV("open", (int64_t) connections.size());
+        result.pushKV("inuse", (int64_t) (connections.size() - idle));
+        result.pushKV("acquired", acquired);
+        result.pushKV("waited", waited);
+        result.pushKV("timeouts", (int64_t) m_timeouts);
+        result.pushKV("avgwaitms", waited > 0 ? 0.001 * m_waitTimeUs / waited : 0.0);
+        result.pushKV("maxwaitms", 0.001 * m_maxWaitTimeUs);
+        result.pushKV("stmtcached", (int64_t) statements);
+        result.pushKV("stmthitrate", hits + misses > 0 ? (double) hits / (hits + misses) : 0.0);
+
+        return result;
+    }
+
+} // namespace PocketDb
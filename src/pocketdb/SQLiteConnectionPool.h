@@ -0,0 +1,60 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETDB_SQLITECONNECTIONPOOL_H
+#define POCKETDB_SQLITECONNECTIONPOOL_H
+
+#include "pocketdb/SQLiteConnection.h"
+#include "univalue.h"
+
+#include <condition_variable>
+
+static const int DEFAULT_SQL_POOL_SIZE = 16;
+
+namespace PocketDb
+{
+    using namespace std;
+
+    /**
+    * Pool of read-only connections shared between all HTTP work queues.
+    * Connections are opened lazily up to the configured size and returned
+    * to the pool automatically when the last reference to the checked out
+    * DbConnectionRef is released.
+    */
+    class SQLiteConnectionPool
+    {
+    private:
+        Mutex m_mutex;
+        condition_variable m_cv;
+
+        vector<shared_ptr<SQLiteConnection>> m_connections;
+        vector<shared_ptr<SQLiteConnection>> m_idle;
+        size_t m_maxSize = 0;
+        bool m_running = false;
+
+        atomic<int64_t> m_acquired{0};
+        atomic<int64_t> m_waited{0};
+        atomic<int64_t> m_waitTimeUs{0};
+        atomic<int64_t> m_maxWaitTimeUs{0};
+        atomic<int64_t> m_timeouts{0};
+
+        void Release(const shared_ptr<SQLiteConnection>& connection);
+
+    public:
+        void Start(int size);
+        void Stop();
+
+        // Check out connection. Blocks until a connection is available
+        // and throws if the pool is stopped or the wait exceeds -sqltimeout.
+        DbConnectionRef Acquire();
+
+        // Number of checked out connections
+        size_t InUse();
+
+        UniValue Statistic();
+    };
+
+} // namespace PocketDb
+
+#endif // POCKETDB_SQLITECONNECTIONPOOL_H
@@ -3,6 +3,7 @@
 // https://www.apache.org/licenses/LICENSE-2.0
 
 #include "pocketdb/SQLiteDatabase.h"
+#include "pocketdb/stmt.h"
 #include "pocketdb/migrations/old_minimal.h"
 #include "util/system.h"
 #include "pocketdb/pocketnet.h"
@@ -10,6 +11,11 @@
 #include "validation.h"
 #include <node/ui_interface.h>
 
+#include <memory>
+#include <regex>
+#include <set>
+#include <unordered_map>
+
 namespace PocketDb
 {
     static void ErrorLogCallback(void* arg, int code, const char* msg)
@@ -48,6 +54,35 @@ namespace PocketDb
                 strprintf("%s: %d; Failed to initialize SQLite: %s\n", __func__, ret, sqlite3_errstr(ret)));
     }
 
+    // Deferred indexes of main database not built yet
+    static Mutex missingIndexesMutex;
+    static set<string> missingIndexes GUARDED_BY(missingIndexesMutex);
+    static std::shared_ptr<const std::regex> missingIndexesHints GUARDED_BY(missingIndexesMutex);
+    static std::atomic<bool> hasMissingIndexes{false};
+    // Changed with every change of missing indexes - prepared statements of older generation are outdated
+    static std::atomic<uint64_t> missingIndexesGeneration{0};
+    // Original SQL -> SQL without hints to missing indexes
+    static std::unordered_map<string, string> missingIndexesStripped GUARDED_BY(missingIndexesMutex);
+    static const size_t MAX_MISSING_INDEXES_STRIPPED = 4096;
+
+    static void UpdateMissingIndexes() EXCLUSIVE_LOCKS_REQUIRED(missingIndexesMutex)
+    {
+        missingIndexesStripped.clear();
+        missingIndexesGeneration++;
+        hasMissingIndexes = !missingIndexes.empty();
+        if (missingIndexes.empty())
+        {
+            missingIndexesHints.reset();
+            return;
+        }
+
+        string names;
+        for (const auto& name : missingIndexes)
+            names += (names.empty() ? "" : "|") + name;
+
+        missingIndexesHints = std::make_shared<const std::regex>(R"(indexed\s+by\s+()" + names + R"()\b)", std::regex::icase);
+    }
+
     void InitSQLite(fs::path path)
     {
         auto dbBasePath = path.string();
@@ -58,7 +93,9 @@ namespace PocketDb
 
         PocketDbMigrationRef mainDbMigration = std::make_shared<PocketDbMainMigration>();
         PocketDb::SQLiteDbInst.Init(dbBasePath, "main", mainDbMigration);
-        SQLiteDbInst.CreateStructure();
+
+        // In bulk load mode web-only indexes are built by IndexBuilder after initial sync
+        SQLiteDbInst.CreateStructure(true, !gArgs.GetBoolArg("-sqlbulkload", DEFAULT_SQL_BULK_LOAD));
         
         TransRepoInst.Init();
         ChainRepoInst.Init();
@@ -214,6 +251,12 @@ namespace PocketDb
 
     bool SQLiteDatabase::IsReadOnly() const { return isReadOnlyConnect; }
 
+    StmtCache& SQLiteDatabase::Statements()
+    {
+        assert(m_statements);
+        return *m_statements;
+    }
+
     void SQLiteDatabase::Init(const std::string& dbBasePath, const std::string& dbName, const PocketDbMigrationRef& migration, bool drop)
     {
         m_db_migration = migration;
@@ -285,6 +328,9 @@ namespace PocketDb
                         __func__, ret, sqlite3_errstr(ret)));
             }
 
+            if (!m_statements)
+                m_statements = make_shared<StmtCache>(std::max((int64_t)gArgs.GetArg("-sqlstmtcachesize", 256), (int64_t)64));
+
             if (!isReadOnlyConnect && sqlite3_db_readonly(m_db, dbName.c_str()) == 1)
                 throw std::runtime_error("Database opened in readonly");
 
@@ -325,7 +371,7 @@ namespace PocketDb
         }
     }
 
-    void SQLiteDatabase::CreateStructure(bool includeIndexes)
+    void SQLiteDatabase::CreateStructure(bool includeIndexes, bool includeDeferredIndexes)
     {
         assert(m_db && m_db_migration);
 
@@ -358,8 +404,14 @@ namespace PocketDb
             if (includeIndexes && !BulkExecute(m_db_migration->Indexes()))
                 throw std::runtime_error(strprintf("%s: Failed to create database `%s` structure (Indexes)\n", __func__, m_file_path));
 
+            if (includeIndexes && includeDeferredIndexes && !BulkExecute(m_db_migration->DeferredIndexes()))
+                throw std::runtime_error(strprintf("%s: Failed to create database `%s` structure (DeferredIndexes)\n", __func__, m_file_path));
+
             if (!BulkExecute(m_db_migration->PostProcessing()))
                 throw std::runtime_error(strprintf("%s: Failed to create database `%s` structure (PostProcessing)\n", __func__, m_file_path));
+
+            if (includeIndexes && !m_db_migration->DeferredIndexes().empty())
+                SetMissingIndexes(GetMissingDeferredIndexes());
         }
         catch (const std::exception& ex)
         {
@@ -403,8 +455,155 @@ namespace PocketDb
             throw std::runtime_error(strprintf("%s: Failed drop indexes\n", __func__));
     }
 
+    vector<pair<string, string>> SQLiteDatabase::GetMissingDeferredIndexes()
+    {
+        assert(m_db && m_db_migration);
+
+        set<string> existing;
+
+        try
+        {
+            std::string sql = "SELECT name FROM sqlite_master WHERE type == 'index'";
+
+            BeginTransaction();
+
+            sqlite3_stmt* stmt;
+            int res = sqlite3_prepare_v2(m_db, sql.c_str(), (int) sql.size(), &stmt, nullptr);
+            if (res != SQLITE_OK)
+                throw std::runtime_error(strprintf("SQLiteDatabase: Failed to setup SQL statements: %s\nSql: %s\n",
+                    sqlite3_errstr(res), sql));
+
+            while (sqlite3_step(stmt) == SQLITE_ROW)
+                existing.emplace(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
+
+            sqlite3_finalize(stmt);
+            CommitTransaction();
+        }
+        catch (const std::exception& ex)
+        {
+            AbortTransaction();
+            throw std::runtime_error(ex.what());
+        }
+
+        vector<pair<string, string>> result;
+
+        static const std::regex nameRegex(R"(index\s+if\s+not\s+exists\s+(\w+))", std::regex::icase);
+        std::string sql = m_db_migration->DeferredIndexes();
+        size_t pos;
+        while ((pos = sql.find(';')) != std::string::npos)
+        {
+            auto token = sql.substr(0, pos + 1);
+            sql.erase(0, pos + 1);
+
+            std::smatch match;
+            if (std::regex_search(token, match, nameRegex) && existing.find(match[1]) == existing.end())
+                result.emplace_back(match[1], token);
+        }
+
+        return result;
+    }
+
+    void SQLiteDatabase::SetMissingIndexes(const vector<pair<string, string>>& indexes)
+    {
+        LOCK(missingIndexesMutex);
+        missingIndexes.clear();
+        for (const auto& [name, sql] : indexes)
+            missingIndexes.emplace(name);
+        UpdateMissingIndexes();
+    }
+
+    bool SQLiteDatabase::HasMissingIndexes()
+    {
+        return hasMissingIndexes;
+    }
+
+    uint64_t SQLiteDatabase::MissingIndexesGeneration()
+    {
+        return missingIndexesGeneration;
+    }
+
+    string SQLiteDatabase::RemoveMissingIndexHints(const string& sql)
+    {
+        std::shared_ptr<const std::regex> hints;
+        {
+            LOCK(missingIndexesMutex);
+            if (!missingIndexesHints)
+                return sql;
+
+            if (auto itr = missingIndexesStripped.find(sql); itr != missingIndexesStripped.end())
+                return itr->second;
+
+            hints = missingIndexesHints;
+        }
+
+        auto stripped = std::regex_replace(sql, *hints, "");
+
+        LOCK(missingIndexesMutex);
+        // Set of missing indexes changed while replacing
+        if (hints == missingIndexesHints)
+        {
+            if (missingIndexesStripped.size() >= MAX_MISSING_INDEXES_STRIPPED)
+                missingIndexesStripped.clear();
+
+            missingIndexesStripped.emplace(sql, stripped);
+        }
+
+        return stripped;
+    }
+
+    bool SQLiteDatabase::CreateIndex(const string& name, const string& sql, int threads, bool yield)
+    {
+        std::lock_guard<std::mutex> lock(m_connection_mutex);
+
+        // Interrupt rolls back the whole open transaction, so batch is never mixed with index build
+        if (!m_db || m_batch || sqlite3_get_autocommit(m_db) == 0)
+            return false;
+
+        // Building yields the connection to waiting block processing
+        if (yield)
+        {
+            sqlite3_progress_handler(m_db, 10000, [](void* arg) {
+                return static_cast<std::atomic<int>*>(arg)->load() > 0 ? 1 : 0;
+            }, &m_waiting);
+        }
+
+        auto pragma = strprintf("PRAGMA threads = %d;", threads);
+        int res = sqlite3_exec(m_db, pragma.c_str(), nullptr, nullptr, nullptr);
+        if (res == SQLITE_OK)
+            res = sqlite3_exec(m_db, "BEGIN TRANSACTION", nullptr, nullptr, nullptr);
+        if (res == SQLITE_OK)
+            res = sqlite3_exec(m_db, sql.c_str(), nullptr, nullptr, nullptr);
+        if (res == SQLITE_OK)
+            res = sqlite3_exec(m_db, "COMMIT TRANSACTION", nullptr, nullptr, nullptr);
+
+        string error = res == SQLITE_OK ? "" : sqlite3_errmsg(m_db);
+
+        // Interrupted statement already rolled back the transaction
+        if (sqlite3_get_autocommit(m_db) == 0)
+            sqlite3_exec(m_db, "ROLLBACK TRANSACTION", nullptr, nullptr, nullptr);
+
+        sqlite3_progress_handler(m_db, 0, nullptr, nullptr);
+        sqlite3_exec(m_db, "PRAGMA threads = 0;", nullptr, nullptr, nullptr);
+
+        if (res == SQLITE_INTERRUPT)
+            return false;
+
+        if (res != SQLITE_OK)
+            throw std::runtime_error(strprintf("%s: Failed create index %s: %s\n", __func__, name, error));
+
+        LOCK(missingIndexesMutex);
+        missingIndexes.erase(name);
+        UpdateMissingIndexes();
+
+        return true;
+    }
+
     void SQLiteDatabase::Close()
     {
+        // All prepared statements must be finalized before closing connection
+        if (m_statements)
+            m_statements->Clear();
+
         int res = sqlite3_close(m_db);
         if (res != SQLITE_OK)
             LogPrintf("Error: %s: %d; Failed to close database %s: %s\n", __func__, res, m_file_path, sqlite3_errstr(res));
@@ -414,7 +613,13 @@ namespace PocketDb
 
     bool SQLiteDatabase::BeginTransaction()
     {
+        m_waiting++;
         m_connection_mutex.lock();
+        m_waiting--;
+
+        // Inside group commit every transaction is a savepoint of the open batch
+        if (m_batch)
+            return m_db && sqlite3_exec(m_db, "SAVEPOINT tx", nullptr, nullptr, nullptr) == SQLITE_OK;
 
         if (!m_db || sqlite3_get_autocommit(m_db) == 0) return false;
         int res = sqlite3_exec(m_db, "BEGIN TRANSACTION", nullptr, nullptr, nullptr);
@@ -427,10 +632,14 @@ namespace PocketDb
     bool SQLiteDatabase::CommitTransaction()
     {
         if (!m_db || sqlite3_get_autocommit(m_db) != 0) return false;
-        int res = sqlite3_exec(m_db, "COMMIT TRANSACTION", nullptr, nullptr, nullptr);
+        int res = sqlite3_exec(m_db, m_batch ? "RELEASE tx" : "COMMIT TRANSACTION", nullptr, nullptr, nullptr);
         if (res != SQLITE_OK)
             LogPrintf("%s: %d; Failed to commit the transaction: %s\n", __func__, res, sqlite3_errstr(res));
 
+        // Statements of finished transaction are not referenced by repositories anymore
+        if (m_statements)
+            m_statements->Unpin();
+
         m_connection_mutex.unlock();
 
         return res == SQLITE_OK;
@@ -439,15 +648,84 @@ namespace PocketDb
     bool SQLiteDatabase::AbortTransaction()
     {
         if (!m_db || sqlite3_get_autocommit(m_db) != 0) return false;
-        int res = sqlite3_exec(m_db, "ROLLBACK TRANSACTION", nullptr, nullptr, nullptr);
+        int res = sqlite3_exec(m_db, m_batch ? "ROLLBACK TO tx; RELEASE tx;" : "ROLLBACK TRANSACTION", nullptr, nullptr, nullptr);
         if (res != SQLITE_OK)
             LogPrintf("%s: %d; Failed to abort the transaction: %s\n", __func__, res, sqlite3_errstr(res));
 
+        // Statements of finished transaction are not referenced by repositories anymore
+        if (m_statements)
+            m_statements->Unpin();
+
         m_connection_mutex.unlock();
 
         return res == SQLITE_OK;
     }
 
+    void SQLiteDatabase::BeginBatch()
+    {
+        m_waiting++;
+        std::lock_guard<std::mutex> lock(m_connection_mutex);
+        m_waiting--;
+
+        if (m_batch || !m_db)
+            return;
+
+        int res = sqlite3_exec(m_db, "BEGIN TRANSACTION", nullptr, nullptr, nullptr);
+        if (res != SQLITE_OK)
+            throw std::runtime_error(strprintf("%s: %d; Failed to begin the batch: %s\n", __func__, res, sqlite3_errstr(res)));
+
+        m_batch = true;
+    }
+
+    void SQLiteDatabase::CommitBatch()
+    {
+        m_waiting++;
+        std::lock_guard<std::mutex> lock(m_connection_mutex);
+        m_waiting--;
+
+        if (!m_batch)
+            return;
+
+        int res = sqlite3_exec(m_db, "COMMIT TRANSACTION", nullptr, nullptr, nullptr);
+        if (res != SQLITE_OK)
+            throw std::runtime_error(strprintf("%s: %d; Failed to commit the batch: %s\n", __func__, res, sqlite3_errstr(res)));
+
+        m_batch = false;
+        if (m_batchHeight >= 0)
+            m_committedHeight = m_batchHeight;
+        m_batchHeight = -1;
+    }
+
+    bool SQLiteDatabase::InBatch()
+    {
+        m_waiting++;
+        std::lock_guard<std::mutex> lock(m_connection_mutex);
+        m_waiting--;
+        return m_batch;
+    }
+
+    void SQLiteDatabase::SetIndexedHeight(int height)
+    {
+        m_waiting++;
+        std::lock_guard<std::mutex> lock(m_connection_mutex);
+        m_waiting--;
+        if (m_batch)
+            m_batchHeight = height;
+        else
+            m_committedHeight = height;
+    }
+
+    int SQLiteDatabase::VisibleHeight(int height)
+    {
+        m_waiting++;
+        std::lock_guard<std::mutex> lock(m_connection_mutex);
+        m_waiting--;
+        if (!m_batch)
+            return height;
+
+        return std::min(height, m_committedHeight);
+    }
+
     void SQLiteDatabase::InterruptQuery()
     {
         if (m_db)
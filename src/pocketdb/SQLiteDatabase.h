@@ -11,12 +11,17 @@
 #include "fs.h"
 
 #include <sqlite3.h>
+#include <atomic>
 #include <iostream>
 
 #include "pocketdb/migrations/base.h"
 #include "pocketdb/migrations/main.h"
 #include "pocketdb/migrations/web.h"
 
+static const bool DEFAULT_SQL_BULK_LOAD = true;
+static const int DEFAULT_SQL_GROUP_COMMIT_BLOCKS = 100;
+static const int DEFAULT_SQL_GROUP_COMMIT_TIME = 5000;
+
 namespace PocketDb
 {
     using namespace std;
@@ -25,6 +30,8 @@ namespace PocketDb
 
     void MaybeMigrate0_22(const fs::path& pocketPath);
 
+    class StmtCache;
+
     class SQLiteDatabase
     {
     private:
@@ -32,6 +39,13 @@ namespace PocketDb
         string m_file_path;
         string m_db_path;
         bool isReadOnlyConnect;
+        shared_ptr<StmtCache> m_statements;
+        bool m_batch = false;
+        // Threads waiting for the connection mutex
+        std::atomic<int> m_waiting{0};
+        // Last indexed height written in open batch and last height visible to other connections
+        int m_batchHeight = -1;
+        int m_committedHeight = -1;
 
         bool BulkExecute(string sql);
 
@@ -43,12 +57,29 @@ namespace PocketDb
 
         bool IsReadOnly() const;
 
+        // Prepared statements cache of this connection
+        StmtCache& Statements();
+
         void Init(const std::string& dbBasePath, const string& dbName, const PocketDbMigrationRef& migration = nullptr, bool drop = false);
 
-        void CreateStructure(bool includeIndexes = true);
+        void CreateStructure(bool includeIndexes = true, bool includeDeferredIndexes = true);
 
         void DropIndexes();
 
+        // Deferred indexes of migration not present in database as pairs of name and sql
+        vector<pair<string, string>> GetMissingDeferredIndexes();
+
+        // Build one index, sorting is spread over `threads` SQLite worker threads.
+        // With `yield` the build is interrupted and rolled back as soon as other thread waits for
+        // the connection, returns false if index was not created.
+        bool CreateIndex(const string& name, const string& sql, int threads, bool yield);
+
+        // Deferred indexes not built yet - queries are prepared without hints to them
+        static void SetMissingIndexes(const vector<pair<string, string>>& indexes);
+        static bool HasMissingIndexes();
+        static uint64_t MissingIndexesGeneration();
+        static string RemoveMissingIndexHints(const string& sql);
+
         void Cleanup() noexcept;
         
         /* void InitMigration(bool& cleanMempool); */
@@ -61,6 +92,18 @@ namespace PocketDb
 
         bool AbortTransaction();
 
+        // Group commit: all transactions until CommitBatch become savepoints
+        // of one outer transaction and are made durable together
+        void BeginBatch();
+        void CommitBatch();
+        bool InBatch();
+
+        // Top of indexed chain data after block connect or rollback, becomes visible
+        // to other connections immediately or with CommitBatch
+        void SetIndexedHeight(int height);
+        // Height no greater than data committed for readers on other connections
+        int VisibleHeight(int height);
+
         void InterruptQuery();
 
         void DetachDatabase(const string& dbName);
@@ -10,6 +10,7 @@
 #include "pocketdb/pocketnet.h"
 #include "pocketdb/SQLiteDatabase.h"
 #include "pocketdb/models/base/Base.h"
+#include "pocketdb/consensus/Context.h"
 
 namespace PocketConsensus
 {
@@ -772,6 +773,22 @@ namespace PocketConsensus
 
 
 
+    /*********************************************************************************************/
+    // Connection used by consensus rules in the current thread.
+    // Parallel block validation workers bind their own read-only connection,
+    // all other threads work with the main database instance.
+    inline thread_local DbConnectionRef ConsensusConnection = nullptr;
+
+    inline ConsensusRepository& ConsensusRepo()
+    {
+        return ConsensusConnection ? *ConsensusConnection->ConsensusRepoInst : PocketDb::ConsensusRepoInst;
+    }
+
+    inline TransactionRepository& TransRepo()
+    {
+        return ConsensusConnection ? *ConsensusConnection->TransactionRepoInst : PocketDb::TransRepoInst;
+    }
+
     /*********************************************************************************************/
     typedef tuple<bool, SocialConsensusResult> ConsensusValidateResult;
 
@@ -811,7 +828,7 @@ namespace PocketConsensus
 
         static int64_t GetConsensusLimit(ConsensusLimit type, int height)
         {
-            return (--m_consensus_limits[type][Params().NetworkID()].upper_bound(height))->second;
+            return (--m_consensus_limits.at(type).at(Params().NetworkID()).upper_bound(height))->second;
         }
 
         void Initialize(int height)
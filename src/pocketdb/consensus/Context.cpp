@@ -0,0 +1,139 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include "pocketdb/consensus/Context.h"
+#include "pocketdb/consensus/Base.h"
+
+namespace PocketConsensus
+{
+    // Types of social entities requested with GetLastContent by consensus rules
+    static const vector<TxType> ContextContentTypes = {
+        CONTENT_POST, CONTENT_VIDEO, CONTENT_ARTICLE, CONTENT_STREAM, CONTENT_AUDIO, CONTENT_COLLECTION, APP,
+        BARTERON_OFFER, CONTENT_DELETE, CONTENT_COMMENT, CONTENT_COMMENT_EDIT, CONTENT_COMMENT_DELETE
+    };
+
+    void ConsensusContext::Prefetch(const PocketBlockRef& pBlock)
+    {
+        if (!pBlock || pBlock->empty())
+            return;
+
+        int64_t nTime1 = GetTimeMicros();
+
+        // Account addresses and hashes of referenced contents and comments
+        for (const auto& ptx : *pBlock)
+        {
+            for (const auto& address : { ptx->GetString1(), ptx->GetString2() })
+                if (address && !address->empty())
+                    m_addresses.emplace(*address);
+
+            for (const auto& hash : { ptx->GetString2(), ptx->GetString3(), ptx->GetString4(), ptx->GetString5() })
+                if (hash && !hash->empty())
+                    m_roots.emplace(*hash);
+
+            if ((*ptx->GetType() == ACTION_SCORE_CONTENT || *ptx->GetType() == ACTION_SCORE_COMMENT) && ptx->GetString1() && ptx->GetString2())
+                m_scoreKeys.emplace((int) *ptx->GetType(), *ptx->GetString1(), *ptx->GetString2());
+        }
+
+        if (!m_addresses.empty())
+        {
+            vector<string> addresses(m_addresses.begin(), m_addresses.end());
+            m_registered = ConsensusRepo().GetRegisteredAddresses(addresses);
+            m_reputations = ConsensusRepo().GetUserReputations(addresses);
+            m_balances = ConsensusRepo().GetUserBalances(addresses);
+            m_blockings = ConsensusRepo().GetBlockings(addresses);
+        }
+
+        if (!m_scoreKeys.empty())
+            m_scores = ConsensusRepo().GetExistingScores({ m_scoreKeys.begin(), m_scoreKeys.end() });
+
+        if (!m_roots.empty())
+        {
+            auto[ok, txs] = ConsensusRepo().GetLastContents({ m_roots.begin(), m_roots.end() }, ContextContentTypes);
+            for (const auto& tx : txs)
+                m_contents[*tx->GetString2()].push_back(tx);
+        }
+
+        LogPrint(BCLog::BENCH, "    - Consensus context prefetch: %d addresses, %d roots, %d scores: %.2fms\n",
+            m_addresses.size(), m_roots.size(), m_scoreKeys.size(), 0.001 * (double)(GetTimeMicros() - nTime1));
+    }
+
+    bool ConsensusContext::ExistsUserRegistrations(vector<string>& addresses) const
+    {
+        if (addresses.empty())
+            return false;
+
+        unordered_set<string> distinct;
+        for (const auto& address : addresses)
+        {
+            if (m_addresses.find(address) == m_addresses.end())
+                return ConsensusRepo().ExistsUserRegistrations(addresses);
+
+            distinct.emplace(address);
+        }
+
+        // Same result as count of registrations compared with addresses count in repository
+        size_t count = 0;
+        for (const auto& address : distinct)
+            if (m_registered.find(address) != m_registered.end())
+                count++;
+
+        return count == addresses.size();
+    }
+
+    tuple<bool, PTransactionRef> ConsensusContext::GetLastContent(const string& rootHash, const vector<TxType>& types) const
+    {
+        bool covered = m_roots.find(rootHash) != m_roots.end();
+        for (const auto& type : types)
+            covered = covered && find(ContextContentTypes.begin(), ContextContentTypes.end(), type) != ContextContentTypes.end();
+
+        if (!covered)
+            return ConsensusRepo().GetLastContent(rootHash, types);
+
+        if (auto it = m_contents.find(rootHash); it != m_contents.end())
+        {
+            for (const auto& tx : it->second)
+                if (find(types.begin(), types.end(), *tx->GetType()) != types.end())
+                    return {true, tx};
+        }
+
+        return {false, nullptr};
+    }
+
+    int ConsensusContext::GetUserReputation(const string& address) const
+    {
+        if (m_addresses.find(address) == m_addresses.end())
+            return ConsensusRepo().GetUserReputation(address);
+
+        auto it = m_reputations.find(address);
+        return it != m_reputations.end() ? it->second : 0;
+    }
+
+    int64_t ConsensusContext::GetUserBalance(const string& address) const
+    {
+        if (m_addresses.find(address) == m_addresses.end())
+            return ConsensusRepo().GetUserBalance(address);
+
+        auto it = m_balances.find(address);
+        return it != m_balances.end() ? it->second : 0;
+    }
+
+    bool ConsensusContext::ExistBlocking(const string& address, const string& addressTo) const
+    {
+        // All blockings from or to block addresses are loaded
+        if (m_addresses.find(address) == m_addresses.end() && m_addresses.find(addressTo) == m_addresses.end())
+            return ConsensusRepo().ExistBlocking(address, addressTo);
+
+        return m_blockings.find({address, addressTo}) != m_blockings.end();
+    }
+
+    bool ConsensusContext::ExistsScore(const string& address, const string& contentHash, TxType type, bool mempool) const
+    {
+        tuple<int, string, string> key((int) type, address, contentHash);
+        if (mempool || m_scoreKeys.find(key) == m_scoreKeys.end())
+            return ConsensusRepo().ExistsScore(address, contentHash, type, mempool);
+
+        return m_scores.find(key) != m_scores.end();
+    }
+
+} // namespace PocketConsensus
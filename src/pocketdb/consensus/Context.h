@@ -0,0 +1,83 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETCONSENSUS_CONTEXT_H
+#define POCKETCONSENSUS_CONTEXT_H
+
+#include "pocketdb/helpers/TransactionHelper.h"
+
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace PocketConsensus
+{
+    using namespace std;
+    using namespace PocketTx;
+    using namespace PocketHelpers;
+
+    /**
+    * Consensus facts of one block loaded with a few set-based queries before validation.
+    * Lookups not covered by prefetch fall back to the consensus repository,
+    * so rules return the same results with or without a prefetched context.
+    */
+    class ConsensusContext
+    {
+    private:
+        unordered_set<string> m_addresses;
+        unordered_set<string> m_registered;
+
+        unordered_map<string, int> m_reputations;
+        unordered_map<string, int64_t> m_balances;
+        set<pair<string, string>> m_blockings;
+
+        unordered_set<string> m_roots;
+        unordered_map<string, vector<PTransactionRef>> m_contents;
+
+        set<tuple<int, string, string>> m_scoreKeys;
+        set<tuple<int, string, string>> m_scores;
+
+    public:
+        // Load registrations, reputations, balances and blockings of all block addresses,
+        // last versions of all contents and comments referenced by block transactions
+        // and existing scores for score transactions of block
+        void Prefetch(const PocketBlockRef& pBlock);
+
+        bool ExistsUserRegistrations(vector<string>& addresses) const;
+        tuple<bool, PTransactionRef> GetLastContent(const string& rootHash, const vector<TxType>& types) const;
+        int GetUserReputation(const string& address) const;
+        int64_t GetUserBalance(const string& address) const;
+        bool ExistBlocking(const string& address, const string& addressTo) const;
+        bool ExistsScore(const string& address, const string& contentHash, TxType type, bool mempool) const;
+    };
+
+    // Context of the block being validated in the current thread
+    inline thread_local const ConsensusContext* CurrentConsensusContext = nullptr;
+
+    inline const ConsensusContext& ConsensusCtx()
+    {
+        static const ConsensusContext empty;
+        return CurrentConsensusContext ? *CurrentConsensusContext : empty;
+    }
+
+    class ConsensusContextScope
+    {
+    private:
+        const ConsensusContext* m_prev;
+
+    public:
+        explicit ConsensusContextScope(const ConsensusContext* context) : m_prev(CurrentConsensusContext)
+        {
+            CurrentConsensusContext = context;
+        }
+
+        ~ConsensusContextScope()
+        {
+            CurrentConsensusContext = m_prev;
+        }
+    };
+
+} // namespace PocketConsensus
+
+#endif // POCKETCONSENSUS_CONTEXT_H
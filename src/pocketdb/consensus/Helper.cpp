@@ -8,6 +8,16 @@ namespace PocketConsensus
 {
     tuple<bool, SocialConsensusResult> SocialConsensusHelper::Validate(const CBlock& block, const PocketBlockRef& pBlock, int height)
     {
+        // Load frequently requested facts for all block transactions at once
+        ConsensusContext context;
+        context.Prefetch(pBlock);
+        ConsensusContextScope scope(&context);
+
+        // Workers read through their own connections and do not see uncommitted rows
+        // of the open group commit batch, so while it is open validation stays serial
+        if (SocialValidationPoolInst.Size() > 0 && !PocketDb::SQLiteDbInst.InBatch())
+            return validateParallel(block, pBlock, height, context);
+
         for (const auto& tx : block.vtx)
         {
             // We have to verify all transactions using consensus
@@ -273,6 +283,91 @@ namespace PocketConsensus
         }
     }
 
+    // Called only when the main connection has no open batch, so worker connections see
+    // the same database state as the main one. Transactions are validated against this state
+    // and the immutable block payload, so the result does not depend on the order of validation.
+    // Transactions are grouped by author to keep related lookups on one connection.
+    tuple<bool, SocialConsensusResult> SocialConsensusHelper::validateParallel(const CBlock& block, const PocketBlockRef& pBlock, int height, const ConsensusContext& context)
+    {
+        int64_t nTime1 = GetTimeMicros();
+
+        unordered_map<string, PTransactionRef> payloads;
+        for (const auto& ptx : *pBlock)
+            payloads.emplace(*ptx->GetHash(), ptx);
+
+        vector<pair<CTransactionRef, PTransactionRef>> txs;
+        for (const auto& tx : block.vtx)
+        {
+            if (auto it = payloads.find(tx->GetHash().GetHex()); it != payloads.end())
+                txs.emplace_back(tx, it->second);
+        }
+
+        map<string, size_t> groupsIndex;
+        vector<vector<size_t>> groups;
+        for (size_t i = 0; i < txs.size(); i++)
+        {
+            auto& address = txs[i].second->GetString1();
+            auto[it, inserted] = groupsIndex.emplace(address ? *address : "", groups.size());
+            if (inserted)
+                groups.emplace_back();
+
+            groups[it->second].push_back(i);
+        }
+
+        vector<SocialConsensusResult> results(txs.size(), ConsensusResult_Success);
+        vector<exception_ptr> errors(groups.size());
+        atomic<bool> failed{false};
+
+        SocialValidationPoolInst.Run(groups.size(), [&](size_t g)
+        {
+            ConsensusContextScope scope(&context);
+
+            try
+            {
+                for (size_t i : groups[g])
+                {
+                    // Block already rejected - skip remaining work
+                    if (failed)
+                        return;
+
+                    if (auto[ok, result] = validate(txs[i].first, txs[i].second, pBlock, height); !ok)
+                    {
+                        results[i] = result;
+                        failed = true;
+                        return;
+                    }
+                }
+            }
+            catch (...)
+            {
+                errors[g] = current_exception();
+                failed = true;
+            }
+        });
+
+        for (const auto& error : errors)
+            if (error)
+                rethrow_exception(error);
+
+        LogPrint(BCLog::BENCH, "    - Parallel social consensus: %d txs in %d groups: %.2fms _ %d\n",
+            txs.size(), groups.size(), 0.001 * (double)(GetTimeMicros() - nTime1), height);
+
+        // Report first failed transaction in block order
+        for (size_t i = 0; i < txs.size(); i++)
+        {
+            if (results[i] == ConsensusResult_Success)
+                continue;
+
+            LogPrint(BCLog::CONSENSUS,
+                "Warning: SocialConsensus type:%d validate tx:%s blk:%s failed with result:%d at height:%d\n",
+                (int) *txs[i].second->GetType(), txs[i].first->GetHash().GetHex(), block.GetHash().GetHex(), (int) results[i], height);
+
+            return {false, results[i]};
+        }
+
+        return {true, ConsensusResult_Success};
+    }
+
     bool SocialConsensusHelper::isConsensusable(TxType txType)
     {
         switch (txType)
@@ -8,6 +8,7 @@
 #include "pocketdb/helpers/TransactionHelper.h"
 #include "pocketdb/models/base/Transaction.h"
 #include "pocketdb/consensus/Reputation.h"
+#include "pocketdb/consensus/SocialValidationPool.h"
 
 #include "pocketdb/consensus/social/Blocking.hpp"
 #include "pocketdb/consensus/social/BlockingCancel.hpp"
@@ -58,6 +59,7 @@ namespace PocketConsensus
     protected:
 
         static tuple<bool, SocialConsensusResult> validate(const CTransactionRef& tx, const PTransactionRef& ptx, const PocketBlockRef& pBlock, int height);
+        static tuple<bool, SocialConsensusResult> validateParallel(const CBlock& block, const PocketBlockRef& pBlock, int height, const ConsensusContext& context);
         static tuple<bool, SocialConsensusResult> check(const CTransactionRef& tx, const PTransactionRef& ptx, int height);
         static bool isConsensusable(TxType txType);
 
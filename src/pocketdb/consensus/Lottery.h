@@ -100,7 +100,7 @@ namespace PocketConsensus
         {
             auto reputationConsensus = PocketConsensus::ConsensusFactoryInst_Reputation.Instance(Height);
 
-            auto scoresData = ConsensusRepoInst.GetScoresData(
+            auto scoresData = ConsensusRepo().GetScoresData(
                 Height,
                 reputationConsensus->GetConsensusLimit(ConsensusLimit_scores_one_to_one_depth)
             );
@@ -108,7 +108,7 @@ namespace PocketConsensus
             vector<string> accountsAddresses;
             for (auto& scoreData : scoresData)
                 accountsAddresses.push_back(reputationConsensus->SelectAddressScoreContent(scoreData.second, true));
-            auto accountsData = ConsensusRepoInst.GetAccountsData(accountsAddresses);
+            auto accountsData = ConsensusRepo().GetAccountsData(accountsAddresses);
 
             LotteryWinners _winners;
 
@@ -207,7 +207,7 @@ namespace PocketConsensus
             if (refs.find(scoreData->ContentAddressHash) != refs.end())
                 return;
 
-            auto[ok, referrer] = PocketDb::ConsensusRepoInst.GetReferrer(scoreData->ContentAddressHash);
+            auto[ok, referrer] = ConsensusRepo().GetReferrer(scoreData->ContentAddressHash);
             if (!ok || referrer == scoreData->ScoreAddressHash) return;
 
             refs.emplace(scoreData->ContentAddressHash, referrer);
@@ -227,10 +227,10 @@ namespace PocketConsensus
             if (refs.find(scoreData->ContentAddressHash) != refs.end())
                 return;
 
-            auto regTime = PocketDb::ConsensusRepoInst.GetAccountRegistrationTime(scoreData->ContentAddressHash);
+            auto regTime = ConsensusRepo().GetAccountRegistrationTime(scoreData->ContentAddressHash);
             if (regTime < (scoreData->ScoreTime - GetConsensusLimit(ConsensusLimit_lottery_referral_depth))) return;
 
-            auto[ok, referrer] = PocketDb::ConsensusRepoInst.GetReferrer(scoreData->ContentAddressHash);
+            auto[ok, referrer] = ConsensusRepo().GetReferrer(scoreData->ContentAddressHash);
             if (!ok || referrer == scoreData->ScoreAddressHash) return;
 
             refs.emplace(scoreData->ContentAddressHash, referrer);
@@ -322,7 +322,7 @@ namespace PocketConsensus
         }
     };
 
-    static LotteryConsensusFactory ConsensusFactoryInst_Lottery;
+    static thread_local LotteryConsensusFactory ConsensusFactoryInst_Lottery;
 }
 
 #endif // POCKETCONSENSUS_LOTTERY_H
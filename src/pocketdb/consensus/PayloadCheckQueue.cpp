@@ -0,0 +1,154 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include "pocketdb/consensus/PayloadCheckQueue.h"
+#include "pocketdb/consensus/Helper.h"
+#include "pocketdb/services/Serializer.h"
+
+#include "util/threadnames.h"
+
+namespace PocketConsensus
+{
+    PayloadCheckQueue PayloadCheckQueueInst;
+
+    void PayloadCheckQueue::Start(int threads, function<void()> notify)
+    {
+        LOCK(m_mutex);
+        if (m_running)
+            return;
+
+        threads = min(threads, MAX_POCKET_PAYLOAD_THREADS);
+        if (threads <= 0)
+            return;
+
+        m_running = true;
+        m_notify = move(notify);
+        for (int i = 0; i < threads; i++)
+            m_threads.emplace_back([this, i]() { Worker(i); });
+
+        LogPrintf("Pocket payload check of downloaded blocks uses %d threads\n", threads);
+    }
+
+    void PayloadCheckQueue::Stop()
+    {
+        {
+            LOCK(m_mutex);
+            m_running = false;
+        }
+
+        m_cv.notify_all();
+
+        for (auto& thr : m_threads)
+            thr.join();
+
+        m_threads.clear();
+
+        // Not connected blocks will be downloaded again
+        LOCK(m_mutex);
+        m_jobs.clear();
+        m_pending.clear();
+        m_checked.clear();
+    }
+
+    bool PayloadCheckQueue::Push(const shared_ptr<PayloadCheckJob>& job)
+    {
+        {
+            LOCK(m_mutex);
+            if (!m_running || m_jobs.size() >= MAX_POCKET_PAYLOAD_QUEUE)
+                return false;
+
+            m_jobs.push_back(job);
+            m_pending.push_back(job);
+        }
+
+        m_cv.notify_one();
+        return true;
+    }
+
+    vector<shared_ptr<PayloadCheckJob>> PayloadCheckQueue::TakeCompleted()
+    {
+        vector<shared_ptr<PayloadCheckJob>> result;
+
+        LOCK(m_mutex);
+        while (!m_jobs.empty() && m_jobs.front()->Done)
+        {
+            result.push_back(move(m_jobs.front()));
+            m_jobs.pop_front();
+        }
+
+        return result;
+    }
+
+    bool PayloadCheckQueue::TakeChecked(const uint256& hash, int height, const PocketBlockRef& pocketBlock)
+    {
+        LOCK(m_mutex);
+
+        auto it = m_checked.find(hash);
+        if (it == m_checked.end())
+            return false;
+
+        // Same block can be received from other peer with other payload
+        bool checked = it->second.first == height && it->second.second == pocketBlock;
+        m_checked.erase(it);
+        return checked;
+    }
+
+    void PayloadCheckQueue::Forget(const uint256& hash)
+    {
+        LOCK(m_mutex);
+        m_checked.erase(hash);
+    }
+
+    void PayloadCheckQueue::Process(PayloadCheckJob& job)
+    {
+        try
+        {
+            auto[ok, pocketBlock] = PocketServices::Serializer::DeserializeBlock(*job.Block, job.Payload);
+            job.PocketBlock = make_shared<PocketHelpers::PocketBlock>(move(pocketBlock));
+
+            if (ok)
+                job.Checked = get<0>(SocialConsensusHelper::Check(*job.Block, job.PocketBlock, job.Height));
+        }
+        catch (const std::exception& e)
+        {
+            LogPrintf("Error: PayloadCheckQueue::Process (%s) - %s\n", job.Block->GetHash().GetHex(), e.what());
+            job.PocketBlock = make_shared<PocketHelpers::PocketBlock>();
+            job.Checked = false;
+        }
+    }
+
+    void PayloadCheckQueue::Worker(int num)
+    {
+        util::ThreadRename(strprintf("pocketpld.%d", num));
+
+        while (true)
+        {
+            shared_ptr<PayloadCheckJob> job;
+            {
+                WAIT_LOCK(m_mutex, lock);
+                m_cv.wait(lock, [&]() { return !m_running || !m_pending.empty(); });
+
+                if (!m_running)
+                    break;
+
+                job = move(m_pending.front());
+                m_pending.pop_front();
+            }
+
+            Process(*job);
+
+            {
+                LOCK(m_mutex);
+                if (job->Checked)
+                    m_checked[job->Block->GetHash()] = { job->Height, job->PocketBlock };
+
+                job->Done = true;
+            }
+
+            if (m_notify)
+                m_notify();
+        }
+    }
+
+} // namespace PocketConsensus
@@ -0,0 +1,99 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETCONSENSUS_PAYLOADCHECKQUEUE_H
+#define POCKETCONSENSUS_PAYLOADCHECKQUEUE_H
+
+#include "primitives/block.h"
+#include "streams.h"
+#include "sync.h"
+#include "uint256.h"
+
+#include "pocketdb/helpers/TransactionHelper.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+
+static const int DEFAULT_POCKET_PAYLOAD_THREADS = 0;
+static const int MAX_POCKET_PAYLOAD_THREADS = 16;
+// Downloaded blocks waiting for check, above this limit blocks are processed inline
+static const size_t MAX_POCKET_PAYLOAD_QUEUE = 256;
+
+namespace PocketConsensus
+{
+    using namespace std;
+    using PocketHelpers::PocketBlockRef;
+
+    // Downloaded block with not yet deserialized Pocket payload
+    struct PayloadCheckJob
+    {
+        int64_t NodeId;
+        shared_ptr<const CBlock> Block;
+        CDataStream Payload;
+        // Height of block from headers chain, consensus rules of Check depend on it
+        int Height;
+
+        PocketBlockRef PocketBlock;
+        bool Checked = false;
+        bool Done = false;
+
+        PayloadCheckJob(int64_t nodeId, shared_ptr<const CBlock> block, CDataStream&& payload, int height)
+            : NodeId(nodeId), Block(move(block)), Payload(move(payload)), Height(height) {}
+    };
+
+    /**
+    * Worker threads for context-free stage of downloaded blocks - payload deserialization
+    * and SocialConsensusHelper::Check. Similar to CCheckQueue, but jobs are whole blocks, so
+    * during initial sync the message handler thread only connects blocks checked ahead.
+    * Completed jobs are returned in submission order. Successful checks are remembered
+    * until ProcessNewBlock consumes them instead of repeating Check under cs_main.
+    */
+    class PayloadCheckQueue
+    {
+    private:
+        Mutex m_mutex;
+        condition_variable m_cv;
+
+        vector<thread> m_threads;
+        bool m_running GUARDED_BY(m_mutex) = false;
+        function<void()> m_notify;
+
+        // All jobs in submission order and jobs not yet taken by workers
+        deque<shared_ptr<PayloadCheckJob>> m_jobs GUARDED_BY(m_mutex);
+        deque<shared_ptr<PayloadCheckJob>> m_pending GUARDED_BY(m_mutex);
+
+        // Successfully checked payloads by block hash
+        map<uint256, pair<int, PocketBlockRef>> m_checked GUARDED_BY(m_mutex);
+
+        void Worker(int num);
+
+    public:
+        // notify is called from workers when a job is completed
+        void Start(int threads, function<void()> notify);
+        void Stop();
+
+        // Returns false if queue is stopped or full, job must be processed by caller
+        bool Push(const shared_ptr<PayloadCheckJob>& job);
+
+        // Completed jobs from the head of queue
+        vector<shared_ptr<PayloadCheckJob>> TakeCompleted();
+
+        // True if this payload of block was already checked at this height, entry is consumed
+        bool TakeChecked(const uint256& hash, int height, const PocketBlockRef& pocketBlock);
+        void Forget(const uint256& hash);
+
+        // Deserialize and check payload of one job
+        static void Process(PayloadCheckJob& job);
+    };
+
+    extern PayloadCheckQueue PayloadCheckQueueInst;
+
+} // namespace PocketConsensus
+
+#endif // POCKETCONSENSUS_PAYLOADCHECKQUEUE_H
@@ -98,8 +98,8 @@ namespace PocketConsensus
 
         virtual tuple<AccountMode, int, int64_t> GetAccountMode(string& address)
         {
-            auto reputation = ConsensusRepoInst.GetUserReputation(address);
-            auto balance = ConsensusRepoInst.GetUserBalance(address);
+            auto reputation = ConsensusCtx().GetUserReputation(address);
+            auto balance = ConsensusCtx().GetUserBalance(address);
 
             return {GetAccountMode(reputation, balance), reputation, balance};
         }
@@ -342,7 +342,7 @@ namespace PocketConsensus
         }
     };
     
-    static ReputationConsensusFactory ConsensusFactoryInst_Reputation;
+    static thread_local ReputationConsensusFactory ConsensusFactoryInst_Reputation;
 }
 
 #endif // POCKETCONSENSUS_REPUTATION_H
\ No newline at end of file
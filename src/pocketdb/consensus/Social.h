@@ -13,6 +13,7 @@
 #include "pocketdb/pocketnet.h"
 #include "pocketdb/models/base/Base.h"
 #include "pocketdb/consensus/Base.h"
+#include "pocketdb/services/MempoolMirror.h"
 #include "pocketdb/helpers/TransactionHelper.h"
 #include "pocketdb/util/Empty.h"
 
@@ -74,7 +75,7 @@ namespace PocketConsensus
                 }
 
                 // Check registrations in DB
-                return (!addressesForCheck.empty() && !PocketDb::ConsensusRepoInst.ExistsUserRegistrations(addressesForCheck));
+                return (!addressesForCheck.empty() && !ConsensusCtx().ExistsUserRegistrations(addressesForCheck));
             });
             if (ResultCode != ConsensusResult_Success) return {false, ResultCode};
 
@@ -85,15 +86,17 @@ namespace PocketConsensus
                 // This is a temporary measure to study the behavior of the system and make a final decision on the issues of the punishment system.
                 return false;
                     
-                return PocketDb::ConsensusRepoInst.ExistsAccountBan(*ptx->GetString1(), Height);
+                return ConsensusRepo().ExistsAccountBan(*ptx->GetString1(), Height);
             });
             if (ResultCode != ConsensusResult_Success) return {false, ResultCode};
 
             // Check limits
             if (block)
                 return ValidateBlock(ptx, block);
-            else
-                return ValidateMempool(ptx);
+
+            // Mempool counts read Mempool table, queued mirror events must be written first
+            PocketServices::MempoolMirrorInst.Flush();
+            return ValidateMempool(ptx);
         }
 
         // Generic transactions validating
@@ -174,10 +177,10 @@ namespace PocketConsensus
             if (address1 == address2)
                 return false;
                 
-            if (PocketDb::ConsensusRepoInst.ExistBlocking(address1, address2))
+            if (ConsensusCtx().ExistBlocking(address1, address2))
                 return true;
             
-            if (PocketDb::ConsensusRepoInst.ExistBlocking(address2, address1))
+            if (ConsensusCtx().ExistBlocking(address2, address1))
                 return true;
 
             return false;
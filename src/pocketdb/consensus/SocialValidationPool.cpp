@@ -0,0 +1,129 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include "pocketdb/consensus/SocialValidationPool.h"
+#include "pocketdb/consensus/Base.h"
+
+#include "util/threadnames.h"
+
+namespace PocketConsensus
+{
+    SocialValidationPool SocialValidationPoolInst;
+
+    void SocialValidationPool::Start(int threads)
+    {
+        LOCK(m_mutex);
+        if (m_running)
+            return;
+
+        threads = min(threads, MAX_POCKET_VALIDATION_THREADS);
+        if (threads <= 0)
+            return;
+
+        m_running = true;
+        for (int i = 0; i < threads; i++)
+            m_threads.emplace_back([this, i]() { Worker(i); });
+
+        LogPrintf("Social consensus validation uses %d additional threads\n", threads);
+    }
+
+    void SocialValidationPool::Stop()
+    {
+        {
+            LOCK(m_mutex);
+            m_running = false;
+        }
+
+        m_cv.notify_all();
+
+        for (auto& thr : m_threads)
+            thr.join();
+
+        m_threads.clear();
+    }
+
+    int SocialValidationPool::Size()
+    {
+        LOCK(m_mutex);
+        return m_running ? (int) m_threads.size() : 0;
+    }
+
+    void SocialValidationPool::Run(size_t count, const function<void(size_t)>& func)
+    {
+        LOCK(m_run_mutex);
+
+        {
+            LOCK(m_mutex);
+            m_job = &func;
+            m_job_size = count;
+            m_next = 0;
+            m_generation++;
+        }
+
+        m_cv.notify_all();
+
+        // Calling thread works with the main connection
+        Process();
+
+        {
+            WAIT_LOCK(m_mutex, lock);
+            m_cv_done.wait(lock, [&]() { return m_active == 0; });
+            m_job = nullptr;
+        }
+    }
+
+    void SocialValidationPool::Worker(int num)
+    {
+        util::ThreadRename(strprintf("pocketval.%d", num));
+
+        try
+        {
+            ConsensusConnection = make_shared<SQLiteConnection>(false);
+        }
+        catch (const exception& ex)
+        {
+            LogPrintf("Error: Social consensus validation thread %d not started: %s\n", num, ex.what());
+            return;
+        }
+
+        uint64_t generation = 0;
+        while (true)
+        {
+            {
+                WAIT_LOCK(m_mutex, lock);
+                m_cv.wait(lock, [&]() { return !m_running || m_generation != generation; });
+
+                if (!m_running)
+                    break;
+
+                generation = m_generation;
+
+                // Job already completed by other threads
+                if (!m_job)
+                    continue;
+
+                m_active++;
+            }
+
+            Process();
+
+            {
+                LOCK(m_mutex);
+                m_active--;
+            }
+
+            m_cv_done.notify_all();
+        }
+
+        ConsensusConnection = nullptr;
+    }
+
+    void SocialValidationPool::Process()
+    {
+        size_t i;
+        while ((i = m_next.fetch_add(1)) < m_job_size)
+            (*m_job)(i);
+    }
+
+} // namespace PocketConsensus
@@ -0,0 +1,66 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETCONSENSUS_SOCIALVALIDATIONPOOL_H
+#define POCKETCONSENSUS_SOCIALVALIDATIONPOOL_H
+
+#include "sync.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <thread>
+#include <vector>
+
+static const int DEFAULT_POCKET_VALIDATION_THREADS = 0;
+static const int MAX_POCKET_VALIDATION_THREADS = 16;
+
+namespace PocketConsensus
+{
+    using namespace std;
+
+    /**
+    * Worker threads for concurrent social consensus validation of block transactions.
+    * Every worker owns a read-only connection bound as ConsensusConnection of its thread.
+    * Worker connections see only committed data, so the pool is used only while the main
+    * connection has no open group commit batch - otherwise blocks are validated serially.
+    */
+    class SocialValidationPool
+    {
+    private:
+        Mutex m_mutex;
+        Mutex m_run_mutex;
+        condition_variable m_cv;
+        condition_variable m_cv_done;
+
+        vector<thread> m_threads;
+        bool m_running = false;
+
+        // Current job
+        const function<void(size_t)>* m_job = nullptr;
+        size_t m_job_size = 0;
+        uint64_t m_generation = 0;
+        int m_active = 0;
+        atomic<size_t> m_next{0};
+
+        void Worker(int num);
+        void Process();
+
+    public:
+        void Start(int threads);
+        void Stop();
+
+        // Workers count, zero means validation is serial
+        int Size();
+
+        // Call func for every index in [0, count) on workers and the calling thread.
+        // Returns when all indexes are processed. func must not throw.
+        void Run(size_t count, const function<void(size_t)>& func);
+    };
+
+    extern SocialValidationPool SocialValidationPoolInst;
+
+} // namespace PocketConsensus
+
+#endif // POCKETCONSENSUS_SOCIALVALIDATIONPOOL_H
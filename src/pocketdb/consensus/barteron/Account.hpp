@@ -27,7 +27,7 @@ namespace PocketConsensus
         ConsensusValidateResult Validate(const CTransactionRef& tx, const BarteronAccountRef& ptx, const PocketBlockRef& block) override
         {
             // Get all the necessary data for transaction validation
-            consensusData = ConsensusRepoInst.BarteronAccount(
+            consensusData = ConsensusRepo().BarteronAccount(
                 *ptx->GetAddress()
             );
 
@@ -65,7 +65,7 @@ namespace PocketConsensus
         }
     };
 
-    static BarteronAccountConsensusFactory ConsensusFactoryInst_BarteronAccount;
+    static thread_local BarteronAccountConsensusFactory ConsensusFactoryInst_BarteronAccount;
 }
 
 #endif // POCKETCONSENSUS_BARTERON_ACCOUNT_HPP
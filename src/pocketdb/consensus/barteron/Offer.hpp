@@ -27,7 +27,7 @@ namespace PocketConsensus
 
         ConsensusValidateResult Validate(const CTransactionRef& tx, const BarteronOfferRef& ptx, const PocketBlockRef& block) override
         {
-            consensusData = ConsensusRepoInst.BarteronOffer(
+            consensusData = ConsensusRepo().BarteronOffer(
                 *ptx->GetAddress(),
                 *ptx->GetRootTxHash()
             );
@@ -118,7 +118,7 @@ namespace PocketConsensus
         }
     };
 
-    static BarteronOfferConsensusFactory ConsensusFactoryInst_BarteronOffer;
+    static thread_local BarteronOfferConsensusFactory ConsensusFactoryInst_BarteronOffer;
 }
 
 #endif // POCKETCONSENSUS_BARTERON_OFFER_HPP
@@ -32,12 +32,12 @@ namespace PocketConsensus
 
             // Only `Shark` account can flag content
             auto reputationConsensus = ConsensusFactoryInst_Reputation.Instance(Height);
-            auto accountData = ConsensusRepoInst.GetAccountsData({ *ptx->GetAddress() });
+            auto accountData = ConsensusRepo().GetAccountsData({ *ptx->GetAddress() });
             if (!reputationConsensus->GetBadges(accountData[*ptx->GetAddress()]).Shark)
                 return {false, ConsensusResult_LowReputation};
 
             // Target transaction must be a exists and is a content and author should be equals ptx->GetContentAddressHash()
-            if (!ConsensusRepoInst.ExistsNotDeleted(
+            if (!ConsensusRepo().ExistsNotDeleted(
                 *ptx->GetContentTxHash(),
                 *ptx->GetContentAddressHash(),
                 { ACCOUNT_USER, CONTENT_POST, CONTENT_ARTICLE, CONTENT_VIDEO, CONTENT_STREAM, CONTENT_AUDIO, APP, CONTENT_COMMENT, CONTENT_COMMENT_EDIT }
@@ -68,11 +68,11 @@ namespace PocketConsensus
         ConsensusValidateResult ValidateBlock(const ModerationFlagRef& ptx, const PocketBlockRef& block) override
         {
             // Check flag from one to one
-            if (ConsensusRepoInst.CountModerationFlag(*ptx->GetAddress(), *ptx->GetContentAddressHash(), false) > 0)
+            if (ConsensusRepo().CountModerationFlag(*ptx->GetAddress(), *ptx->GetContentAddressHash(), false) > 0)
                 return {false, ConsensusResult_Duplicate};
 
             // Count flags in chain
-            int count = ConsensusRepoInst.CountModerationFlag(*ptx->GetAddress(), Height - (int)GetConsensusLimit(ConsensusLimit_depth), false);
+            int count = ConsensusRepo().CountModerationFlag(*ptx->GetAddress(), Height - (int)GetConsensusLimit(ConsensusLimit_depth), false);
 
             // Count flags in block
             for (auto& blockTx : *block)
@@ -97,13 +97,13 @@ namespace PocketConsensus
         ConsensusValidateResult ValidateMempool(const ModerationFlagRef& ptx) override
         {
             // Check flag from one to one
-            if (ConsensusRepoInst.CountModerationFlag(*ptx->GetAddress(), *ptx->GetContentAddressHash(), true) > 0)
+            if (ConsensusRepo().CountModerationFlag(*ptx->GetAddress(), *ptx->GetContentAddressHash(), true) > 0)
                 return {false, ConsensusResult_Duplicate};
 
             // Check limit
             return SocialConsensus::ValidateLimit(
                 moderation_flag_count,
-                ConsensusRepoInst.CountModerationFlag(
+                ConsensusRepo().CountModerationFlag(
                     *ptx->GetAddress(),
                     Height - (int)GetConsensusLimit(ConsensusLimit_depth),
                     true
@@ -129,7 +129,7 @@ namespace PocketConsensus
         }
     };
 
-    static ModerationFlagConsensusFactory ConsensusFactoryInst_ModerationFlag;
+    static thread_local ModerationFlagConsensusFactory ConsensusFactoryInst_ModerationFlag;
 }
 
 #endif // POCKETCONSENSUS_MODERATION_FLAG_HPP
\ No newline at end of file
@@ -79,7 +79,7 @@ namespace PocketConsensus
 
         ConsensusValidateResult ValidateMempool(const shared_ptr<T>& ptx) override
         {
-            if (ConsensusRepoInst.Exists_MS1T(*ptx->GetAddress(), { MODERATOR_REGISTER_SELF, MODERATOR_REGISTER_REQUEST, MODERATOR_REGISTER_CANCEL }))
+            if (ConsensusRepo().Exists_MS1T(*ptx->GetAddress(), { MODERATOR_REGISTER_SELF, MODERATOR_REGISTER_REQUEST, MODERATOR_REGISTER_CANCEL }))
                 return {false, ConsensusResult_ManyTransactions};
 
             return Base::Success;
@@ -28,7 +28,7 @@ namespace PocketConsensus
         ConsensusValidateResult Validate(const CTransactionRef& tx, const ModeratorRegisterRequestRef& ptx, const PocketBlockRef& block) override
         {
             // Check request exists in chain
-            if (!ConsensusRepoInst.Exists_HS2T(*ptx->GetRequestTxHash(), *ptx->GetAddress(), { MODERATOR_REQUEST_SUBS, MODERATOR_REQUEST_COIN }, true))
+            if (!ConsensusRepo().Exists_HS2T(*ptx->GetRequestTxHash(), *ptx->GetAddress(), { MODERATOR_REQUEST_SUBS, MODERATOR_REQUEST_COIN }, true))
                 return {false, ConsensusResult_NotFound};
             
             return ModeratorRegisterConsensus::Validate(tx, ptx, block);
@@ -28,11 +28,11 @@ namespace PocketConsensus
         ConsensusValidateResult Validate(const CTransactionRef& tx, const ModeratorRequestCancelRef& ptx, const PocketBlockRef& block) override
         {
             // Source request exists and address and moderator address equals
-            if (!ConsensusRepoInst.Exists_HS1S2T(*ptx->GetRequestTxHash(), *ptx->GetAddress(), *ptx->GetModeratorAddress(), { MODERATOR_REQUEST_SUBS, MODERATOR_REQUEST_COIN }, false))
+            if (!ConsensusRepo().Exists_HS1S2T(*ptx->GetRequestTxHash(), *ptx->GetAddress(), *ptx->GetModeratorAddress(), { MODERATOR_REQUEST_SUBS, MODERATOR_REQUEST_COIN }, false))
                 return {false, ConsensusResult_NotFound};
 
             // Request already canceled
-            if (ConsensusRepoInst.Exists_LS1S2T(*ptx->GetAddress(), *ptx->GetModeratorAddress(), { MODERATOR_REQUEST_CANCEL }))
+            if (ConsensusRepo().Exists_LS1S2T(*ptx->GetAddress(), *ptx->GetModeratorAddress(), { MODERATOR_REQUEST_CANCEL }))
                 return {false, ConsensusResult_ManyTransactions};
 
             return ModeratorRequestConsensus::Validate(tx, ptx, block);
@@ -26,7 +26,7 @@ namespace PocketConsensus
 
         ConsensusValidateResult Validate(const CTransactionRef& tx, const ModeratorRequestCoinRef& ptx, const PocketBlockRef& block) override
         {
-            if (ConsensusRepoInst.Exists_LS1S2T(*ptx->GetAddress(), *ptx->GetModeratorAddress(), { MODERATOR_REQUEST_SUBS, MODERATOR_REQUEST_COIN }))
+            if (ConsensusRepo().Exists_LS1S2T(*ptx->GetAddress(), *ptx->GetModeratorAddress(), { MODERATOR_REQUEST_SUBS, MODERATOR_REQUEST_COIN }))
                 return {false, ConsensusResult_ManyTransactions};
 
             // TODO (moderation): check exists old free outputs
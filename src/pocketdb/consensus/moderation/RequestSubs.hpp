@@ -30,7 +30,7 @@ namespace PocketConsensus
             if (!reputationConsensus->GetBadges(*ptx->GetAddress()).Author)
                 return {false, ConsensusResult_LowReputation};
 
-            if (ConsensusRepoInst.Exists_LS1S2T(*ptx->GetAddress(), *ptx->GetModeratorAddress(), { MODERATOR_REQUEST_SUBS, MODERATOR_REQUEST_COIN }))
+            if (ConsensusRepo().Exists_LS1S2T(*ptx->GetAddress(), *ptx->GetModeratorAddress(), { MODERATOR_REQUEST_SUBS, MODERATOR_REQUEST_COIN }))
                 return {false, ConsensusResult_ManyTransactions};
 
             // TODO (moderation): implement check allowed requests count > 0
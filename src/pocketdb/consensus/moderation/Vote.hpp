@@ -31,7 +31,7 @@ namespace PocketConsensus
                 return {false, baseValidateCode};
 
             auto reputationConsensus = ConsensusFactoryInst_Reputation.Instance(Height);
-            auto accountData = ConsensusRepoInst.GetAccountsData({ *ptx->GetAddress() });
+            auto accountData = ConsensusRepo().GetAccountsData({ *ptx->GetAddress() });
             auto badges = reputationConsensus->GetBadges(accountData[*ptx->GetAddress()]);
 
             // Only moderator can set votes
@@ -39,21 +39,21 @@ namespace PocketConsensus
                 return {false, ConsensusResult_NotAllowed};
 
             // Double vote to one jury not allowed
-            if (ConsensusRepoInst.Exists_S1S2T(*ptx->GetAddress(), *ptx->GetJuryId(), { MODERATION_VOTE }))
+            if (ConsensusRepo().Exists_S1S2T(*ptx->GetAddress(), *ptx->GetJuryId(), { MODERATION_VOTE }))
                 return {false, ConsensusResult_Duplicate};
 
             // The jury must be exists
-            if (!ConsensusRepoInst.ExistsActiveJury(*ptx->GetJuryId()))
+            if (!ConsensusRepo().ExistsActiveJury(*ptx->GetJuryId()))
                 return {false, ConsensusResult_NotFound};
 
             // The moderators' votes should be accepted with a delay, in case the jury gets into the orphan block
-            auto juryFlag = ConsensusRepoInst.Get(*ptx->GetJuryId());
+            auto juryFlag = ConsensusRepo().Get(*ptx->GetJuryId());
             if (!juryFlag || *juryFlag->GetType() != MODERATION_FLAG
                 || !juryFlag->GetHeight() || (Height - *juryFlag->GetHeight() < 10))
                 return {false, ConsensusResult_NotAllowed};
 
             // Votes allowed if moderator requested by system
-            if (!ConsensusRepoInst.AllowJuryModerate(*ptx->GetAddress(), *ptx->GetJuryId()))
+            if (!ConsensusRepo().AllowJuryModerate(*ptx->GetAddress(), *ptx->GetJuryId()))
                 return {false, ConsensusResult_NotAllowed};
 
             return Success;
@@ -94,7 +94,7 @@ namespace PocketConsensus
 
         ConsensusValidateResult ValidateMempool(const ModerationVoteRef& ptx) override
         {
-            if (ConsensusRepoInst.Exists_MS1S2T(*ptx->GetAddress(), *ptx->GetJuryId(), { MODERATION_VOTE }))
+            if (ConsensusRepo().Exists_MS1S2T(*ptx->GetAddress(), *ptx->GetJuryId(), { MODERATION_VOTE }))
                 return {false, ConsensusResult_Duplicate};
 
             return Success;
@@ -113,7 +113,7 @@ namespace PocketConsensus
         }
     };
 
-    static ModerationVoteConsensusFactory ConsensusFactoryInst_ModerationVote;
+    static thread_local ModerationVoteConsensusFactory ConsensusFactoryInst_ModerationVote;
 }
 
 #endif // POCKETCONSENSUS_MODERATION_VOTE_HPP
\ No newline at end of file
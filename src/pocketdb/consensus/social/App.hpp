@@ -34,12 +34,12 @@ namespace PocketConsensus
                 return ValidateEdit(ptx);
 
             // Get count from chain
-            int count = ConsensusRepoInst.CountChainHeight(*ptx->GetType(), *ptx->GetAddress());
+            int count = ConsensusRepo().CountChainHeight(*ptx->GetType(), *ptx->GetAddress());
             if (count >= GetConsensusLimit(ConsensusLimit_app))
                 return { false, ConsensusResult_ContentLimit };
 
             // Check ID for unique
-            if (ConsensusRepoInst.ExistsAnotherByName("", *ptx->GetId(), TxType::APP))
+            if (ConsensusRepo().ExistsAnotherByName("", *ptx->GetId(), TxType::APP))
                 return {false, ConsensusResult_NicknameDouble};
 
             return Success;
@@ -92,7 +92,7 @@ namespace PocketConsensus
         ConsensusValidateResult ValidateMempool(const AppRef& ptx) override
         {
             // Do not allowed multiple txs in mempool
-            if (ConsensusRepoInst.Exists_MS1T(*ptx->GetAddress(), { APP }))
+            if (ConsensusRepo().Exists_MS1T(*ptx->GetAddress(), { APP }))
                 return { false, ConsensusResult_ContentLimit };
 
             return Success;
@@ -100,13 +100,13 @@ namespace PocketConsensus
         
         virtual ConsensusValidateResult ValidateEdit(const AppRef& ptx)
         {
-            auto[lastContentOk, lastContent] = PocketDb::ConsensusRepoInst.GetLastContent(
+            auto[lastContentOk, lastContent] = ConsensusCtx().GetLastContent(
                 *ptx->GetRootTxHash(),
                 { APP }
             );
 
             // First get original transaction
-            auto[originalTxOk, originalTx] = PocketDb::ConsensusRepoInst.GetFirstContent(*ptx->GetRootTxHash());
+            auto[originalTxOk, originalTx] = ConsensusRepo().GetFirstContent(*ptx->GetRootTxHash());
             if (!lastContentOk || !originalTxOk)
                 return {false, ConsensusResult_NotFound};
 
@@ -148,7 +148,7 @@ namespace PocketConsensus
         }
     };
 
-    static AppConsensusFactory ConsensusFactoryInst_App;
+    static thread_local AppConsensusFactory ConsensusFactoryInst_App;
 }
 
 #endif // POCKETCONSENSUS_APP_HPP
\ No newline at end of file
@@ -104,7 +104,7 @@ namespace PocketConsensus
             int count = GetChainCount(ptx);
 
             // Get count from mempool
-            count += ConsensusRepoInst.CountMempoolArticle(*ptx->GetAddress());
+            count += ConsensusRepo().CountMempoolArticle(*ptx->GetAddress());
 
             return ValidateLimit(ptx, count);
         }
@@ -115,7 +115,7 @@ namespace PocketConsensus
 
         virtual tuple<bool, SocialConsensusResult> ValidateEdit(const ArticleRef& ptx)
         {
-            auto[lastContentOk, lastContent] = PocketDb::ConsensusRepoInst.GetLastContent(
+            auto[lastContentOk, lastContent] = ConsensusCtx().GetLastContent(
                 *ptx->GetRootTxHash(),
                 { CONTENT_ARTICLE }
             );
@@ -123,7 +123,7 @@ namespace PocketConsensus
                 return {false, ConsensusResult_NotFound};
 
             // First get original post transaction
-            auto[originalTxOk, originalTx] = PocketDb::ConsensusRepoInst.GetFirstContent(*ptx->GetRootTxHash());
+            auto[originalTxOk, originalTx] = ConsensusRepo().GetFirstContent(*ptx->GetRootTxHash());
             if (!originalTxOk)
                 return {false, ConsensusResult_NotFound};
 
@@ -160,7 +160,7 @@ namespace PocketConsensus
 
         virtual bool AllowEditWindow(const ArticleRef& ptx, const ContentRef& originalPtx)
         {
-            auto[ok, originalPtxHeight] = ConsensusRepoInst.GetTransactionHeight(*originalPtx->GetHash());
+            auto[ok, originalPtxHeight] = ConsensusRepo().GetTransactionHeight(*originalPtx->GetHash());
             if (!ok)
                 return false;
 
@@ -168,7 +168,7 @@ namespace PocketConsensus
         }
         virtual int GetChainCount(const ArticleRef& ptx)
         {
-            return ConsensusRepoInst.CountChainHeight(
+            return ConsensusRepo().CountChainHeight(
                 *ptx->GetType(),
                 *ptx->GetAddress()
             );
@@ -195,7 +195,7 @@ namespace PocketConsensus
         }
         virtual tuple<bool, SocialConsensusResult> ValidateEditMempool(const ArticleRef& ptx)
         {
-            if (ConsensusRepoInst.CountMempoolArticleEdit(*ptx->GetAddress(), *ptx->GetRootTxHash()) > 0)
+            if (ConsensusRepo().CountMempoolArticleEdit(*ptx->GetAddress(), *ptx->GetRootTxHash()) > 0)
                 return {false, ConsensusResult_DoubleContentEdit};
 
             // Check edit limit
@@ -203,7 +203,7 @@ namespace PocketConsensus
         }
         virtual tuple<bool, SocialConsensusResult> ValidateEditOneLimit(const ArticleRef& ptx)
         {
-            int count = ConsensusRepoInst.CountChainArticleEdit(*ptx->GetAddress(), *ptx->GetRootTxHash());
+            int count = ConsensusRepo().CountChainArticleEdit(*ptx->GetAddress(), *ptx->GetRootTxHash());
             if (count >= GetConsensusLimit(ConsensusLimit_article_edit_count))
                 return {false, ConsensusResult_ContentEditLimit};
 
@@ -241,7 +241,7 @@ namespace PocketConsensus
         }
     };
 
-    static ArticleConsensusFactory ConsensusFactoryInst_Article;
+    static thread_local ArticleConsensusFactory ConsensusFactoryInst_Article;
 }
 
 #endif // POCKETCONSENSUS_ARTICLE_H
\ No newline at end of file
@@ -105,7 +105,7 @@ namespace PocketConsensus
             int count = GetChainCount(ptx);
 
             // and from mempool
-            count += ConsensusRepoInst.CountMempoolAudio(*ptx->GetAddress());
+            count += ConsensusRepo().CountMempoolAudio(*ptx->GetAddress());
 
             return ValidateLimit(ptx, count);
         }
@@ -116,7 +116,7 @@ namespace PocketConsensus
 
         virtual ConsensusValidateResult ValidateEdit(const AudioRef& ptx)
         {
-            auto[lastContentOk, lastContent] = PocketDb::ConsensusRepoInst.GetLastContent(
+            auto[lastContentOk, lastContent] = ConsensusCtx().GetLastContent(
                     *ptx->GetRootTxHash(),
                     { CONTENT_POST, CONTENT_VIDEO, CONTENT_DELETE, CONTENT_STREAM, CONTENT_AUDIO }
             );
@@ -124,7 +124,7 @@ namespace PocketConsensus
                 return {false, ConsensusResult_NotAllowed};
 
             // First get original post transaction
-            auto[originalTxOk, originalTx] = PocketDb::ConsensusRepoInst.GetFirstContent(*ptx->GetRootTxHash());
+            auto[originalTxOk, originalTx] = ConsensusRepo().GetFirstContent(*ptx->GetRootTxHash());
             if (!lastContentOk || !originalTxOk)
                 return {false, ConsensusResult_NotFound};
 
@@ -160,7 +160,7 @@ namespace PocketConsensus
         virtual int GetChainCount(const AudioRef& ptx)
         {
 
-            return ConsensusRepoInst.CountChainAudio(
+            return ConsensusRepo().CountChainAudio(
                     *ptx->GetAddress(),
                     Height - (int)GetConsensusLimit(ConsensusLimit_depth)
             );
@@ -189,7 +189,7 @@ namespace PocketConsensus
         virtual ConsensusValidateResult ValidateEditMempool(const AudioRef& ptx)
         {
 
-            if (ConsensusRepoInst.CountMempoolAudioEdit(*ptx->GetAddress(), *ptx->GetRootTxHash()) > 0)
+            if (ConsensusRepo().CountMempoolAudioEdit(*ptx->GetAddress(), *ptx->GetRootTxHash()) > 0)
                 return {false, ConsensusResult_DoubleContentEdit};
 
             // Check edit limit
@@ -198,7 +198,7 @@ namespace PocketConsensus
         virtual ConsensusValidateResult ValidateEditOneLimit(const AudioRef& ptx)
         {
 
-            int count = ConsensusRepoInst.CountChainAudioEdit(*ptx->GetAddress(), *ptx->GetRootTxHash());
+            int count = ConsensusRepo().CountChainAudioEdit(*ptx->GetAddress(), *ptx->GetRootTxHash());
             if (count >= GetConsensusLimit(ConsensusLimit_audio_edit_count))
                 return {false, ConsensusResult_ContentEditLimit};
 
@@ -206,7 +206,7 @@ namespace PocketConsensus
         }
         virtual bool AllowEditWindow(const AudioRef& ptx, const AudioRef& originalTx)
         {
-            auto[ok, originalTxHeight] = ConsensusRepoInst.GetTransactionHeight(*originalTx->GetHash());
+            auto[ok, originalTxHeight] = ConsensusRepo().GetTransactionHeight(*originalTx->GetHash());
             if (!ok)
                 return false;
 
@@ -244,7 +244,7 @@ namespace PocketConsensus
         }
     };
 
-    static AudioConsensusFactory ConsensusFactoryInst_Audio;
+    static thread_local AudioConsensusFactory ConsensusFactoryInst_Audio;
 }
 
 #endif // POCKETCONSENSUS_AUDIO_HPP
@@ -26,7 +26,7 @@ namespace PocketConsensus
         ConsensusValidateResult Validate(const CTransactionRef& tx, const BlockingRef& ptx, const PocketBlockRef& block) override
         {
             // Double blocking in chain
-            if (auto[existsBlocking, blockingType] = PocketDb::ConsensusRepoInst.GetLastBlockingType(
+            if (auto[existsBlocking, blockingType] = ConsensusRepo().GetLastBlockingType(
                     *ptx->GetAddress(),
                     *ptx->GetAddressTo()
                 ); existsBlocking && blockingType == ACTION_BLOCKING)
@@ -74,7 +74,7 @@ namespace PocketConsensus
         }
         ConsensusValidateResult ValidateMempool(const BlockingRef& ptx) override
         {
-            if (ConsensusRepoInst.CountMempoolBlocking(*ptx->GetAddress(), *ptx->GetAddressTo()) > 0)
+            if (ConsensusRepo().CountMempoolBlocking(*ptx->GetAddress(), *ptx->GetAddressTo()) > 0)
                 return {false, ConsensusResult_ManyTransactions};
 
             return Success;
@@ -97,7 +97,7 @@ namespace PocketConsensus
                 return {false, baseValidateCode};
 
             // Double blocking in chain
-            if (PocketDb::ConsensusRepoInst.ExistBlocking(
+            if (ConsensusRepo().ExistBlocking(
                     *ptx->GetAddress(),
                     IsEmpty(ptx->GetAddressTo()) ? "" : *ptx->GetAddressTo(),
                     IsEmpty(ptx->GetAddressesTo()) ? "[]" : *ptx->GetAddressesTo()
@@ -164,7 +164,7 @@ namespace PocketConsensus
         }
         ConsensusValidateResult ValidateMempool(const BlockingRef& ptx) override
         {
-            if (ConsensusRepoInst.CountMempoolBlocking(*ptx->GetAddress(), IsEmpty(ptx->GetAddressTo()) ? "" : *ptx->GetAddressTo()) > 0)
+            if (ConsensusRepo().CountMempoolBlocking(*ptx->GetAddress(), IsEmpty(ptx->GetAddressTo()) ? "" : *ptx->GetAddressTo()) > 0)
                 return {false, ConsensusResult_ManyTransactions};
 
             return Success;
@@ -225,7 +225,7 @@ namespace PocketConsensus
         }
     };
 
-    static BlockingConsensusFactory ConsensusFactoryInst_Blocking;
+    static thread_local BlockingConsensusFactory ConsensusFactoryInst_Blocking;
 }
 
 #endif // POCKETCONSENSUS_BLOCKING_HPP
\ No newline at end of file
@@ -25,7 +25,7 @@ namespace PocketConsensus
 
         ConsensusValidateResult Validate(const CTransactionRef& tx, const BlockingCancelRef& ptx, const PocketBlockRef& block) override
         {
-            if (auto[existsBlocking, blockingType] = PocketDb::ConsensusRepoInst.GetLastBlockingType(
+            if (auto[existsBlocking, blockingType] = ConsensusRepo().GetLastBlockingType(
                     *ptx->GetAddress(),
                     *ptx->GetAddressTo()
                 ); !existsBlocking || blockingType != ACTION_BLOCKING)
@@ -73,7 +73,7 @@ namespace PocketConsensus
         }
         ConsensusValidateResult ValidateMempool(const BlockingCancelRef& ptx) override
         {
-            if (ConsensusRepoInst.CountMempoolBlocking(*ptx->GetAddress(), *ptx->GetAddressTo()) > 0)
+            if (ConsensusRepo().CountMempoolBlocking(*ptx->GetAddress(), *ptx->GetAddressTo()) > 0)
                 return {false, ConsensusResult_ManyTransactions};
 
             return Success;
@@ -95,7 +95,7 @@ namespace PocketConsensus
             if (auto[baseValidate, baseValidateCode] = SocialConsensus::Validate(tx, ptx, block); !baseValidate)
                 return {false, baseValidateCode};
 
-            if (!PocketDb::ConsensusRepoInst.ExistBlocking(
+            if (!ConsensusRepo().ExistBlocking(
                 *ptx->GetAddress(),
                 IsEmpty(ptx->GetAddressTo()) ? "" : *ptx->GetAddressTo(),
                 "[]"
@@ -173,7 +173,7 @@ namespace PocketConsensus
         }
     };
 
-    static BlockingCancelConsensusFactory ConsensusFactoryInst_BlockingCancel;
+    static thread_local BlockingCancelConsensusFactory ConsensusFactoryInst_BlockingCancel;
 }
 
 #endif // POCKETCONSENSUS_BLOCKINGCANCEL_HPP
@@ -26,7 +26,7 @@ namespace PocketConsensus
         ConsensusValidateResult Validate(const CTransactionRef& tx, const BoostContentRef& ptx, const PocketBlockRef& block) override
         {
             // Check exists content transaction
-            auto[contentOk, contentTx] = PocketDb::ConsensusRepoInst.GetLastContent(*ptx->GetContentTxHash(), { CONTENT_POST, CONTENT_VIDEO, CONTENT_ARTICLE, CONTENT_STREAM, CONTENT_AUDIO, APP, CONTENT_DELETE });
+            auto[contentOk, contentTx] = ConsensusCtx().GetLastContent(*ptx->GetContentTxHash(), { CONTENT_POST, CONTENT_VIDEO, CONTENT_ARTICLE, CONTENT_STREAM, CONTENT_AUDIO, APP, CONTENT_DELETE });
             if (!contentOk)
                 return {false, ConsensusResult_NotFound};
 
@@ -82,7 +82,7 @@ namespace PocketConsensus
     protected:
         bool ValidateBlocking(const string& address1, const string& address2) override
         {
-            auto[existsBlocking, blockingType] = PocketDb::ConsensusRepoInst.GetLastBlockingType(address1, address2);
+            auto[existsBlocking, blockingType] = ConsensusRepo().GetLastBlockingType(address1, address2);
             return existsBlocking && blockingType == ACTION_BLOCKING;
         }
     };
@@ -113,7 +113,7 @@ namespace PocketConsensus
         }
     };
 
-    static BoostContentConsensusFactory ConsensusFactoryInst_BoostContent;
+    static thread_local BoostContentConsensusFactory ConsensusFactoryInst_BoostContent;
 }
 
 #endif //POCKETCONSENSUS_BOOSTCONTENT_HPP
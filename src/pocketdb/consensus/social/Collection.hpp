@@ -40,7 +40,7 @@ namespace PocketConsensus
                    return {false, ConsensusResult_Failed};
 
                 // Contents should be exists in chain
-                int count = PocketDb::ConsensusRepoInst.GetLastContentsCount(contentIds, { PocketTx::TxType(*ptx->GetContentTypes()) });
+                int count = ConsensusRepo().GetLastContentsCount(contentIds, { PocketTx::TxType(*ptx->GetContentTypes()) });
                 if((size_t)count != contentIds.size())
                     return {false, ConsensusResult_Failed};
             }
@@ -122,7 +122,7 @@ namespace PocketConsensus
             int count = GetChainCount(ptx);
 
             // Get count from mempool
-            count += ConsensusRepoInst.CountMempoolCollection(*ptx->GetAddress());
+            count += ConsensusRepo().CountMempoolCollection(*ptx->GetAddress());
 
             return ValidateLimit(ptx, count);
         }
@@ -133,7 +133,7 @@ namespace PocketConsensus
 
         virtual tuple<bool, SocialConsensusResult> ValidateEdit(const CollectionRef& ptx)
         {
-            auto[lastContentOk, lastContent] = PocketDb::ConsensusRepoInst.GetLastContent(
+            auto[lastContentOk, lastContent] = ConsensusCtx().GetLastContent(
                     *ptx->GetRootTxHash(),
                     { CONTENT_COLLECTION }
             );
@@ -141,7 +141,7 @@ namespace PocketConsensus
                 return {false, ConsensusResult_NotAllowed};
 
             // First get original collection transaction
-            auto[originalTxOk, originalTx] = PocketDb::ConsensusRepoInst.GetFirstContent(*ptx->GetRootTxHash());
+            auto[originalTxOk, originalTx] = ConsensusRepo().GetFirstContent(*ptx->GetRootTxHash());
             if (!lastContentOk || !originalTxOk)
                 return {false, ConsensusResult_NotFound};
 
@@ -181,7 +181,7 @@ namespace PocketConsensus
         }
         virtual int GetChainCount(const CollectionRef& ptx)
         {
-            return ConsensusRepoInst.CountChainCollection(
+            return ConsensusRepo().CountChainCollection(
                     *ptx->GetAddress(),
                     *ptx->GetTime() - GetConsensusLimit(ConsensusLimit_depth)
             );
@@ -208,7 +208,7 @@ namespace PocketConsensus
         }
         virtual tuple<bool, SocialConsensusResult> ValidateEditMempool(const CollectionRef& ptx)
         {
-            if (ConsensusRepoInst.CountMempoolCollectionEdit(*ptx->GetAddress(), *ptx->GetRootTxHash()) > 0)
+            if (ConsensusRepo().CountMempoolCollectionEdit(*ptx->GetAddress(), *ptx->GetRootTxHash()) > 0)
                 return {false, ConsensusResult_DoubleContentEdit};
 
             // Check edit limit
@@ -216,7 +216,7 @@ namespace PocketConsensus
         }
         virtual tuple<bool, SocialConsensusResult> ValidateEditOneLimit(const CollectionRef& ptx)
         {
-            int count = ConsensusRepoInst.CountChainCollectionEdit(*ptx->GetAddress(), *ptx->GetRootTxHash(), Height, GetConsensusLimit(ConsensusLimit_edit_collection_depth));
+            int count = ConsensusRepo().CountChainCollectionEdit(*ptx->GetAddress(), *ptx->GetRootTxHash(), Height, GetConsensusLimit(ConsensusLimit_edit_collection_depth));
             if (count >= GetConsensusLimit(ConsensusLimit_collection_edit_count))
                 return {false, ConsensusResult_ContentEditLimit};
 
@@ -243,7 +243,7 @@ namespace PocketConsensus
                    return {false, ConsensusResult_Failed};
 
                 // Contents should be exists in chain
-                int count = PocketDb::ConsensusRepoInst.GetLastContentsCount(contentIds, { PocketTx::TxType(*ptx->GetContentTypes()) });
+                int count = ConsensusRepo().GetLastContentsCount(contentIds, { PocketTx::TxType(*ptx->GetContentTypes()) });
                 if((size_t)count != contentIds.size())
                     return {false, ConsensusResult_Failed};
             }
@@ -270,7 +270,7 @@ namespace PocketConsensus
         }
     };
 
-    static CollectionConsensusFactory ConsensusFactoryInst_Collection;
+    static thread_local CollectionConsensusFactory ConsensusFactoryInst_Collection;
 }
 
 #endif // POCKETCONSENSUS_COLLECTION_H
\ No newline at end of file
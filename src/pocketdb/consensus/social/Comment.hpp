@@ -31,7 +31,7 @@ namespace PocketConsensus
             // Parent comment
             if (!IsEmpty(ptx->GetParentTxHash()))
             {
-                auto[ok, parentTx] = ConsensusRepoInst.GetLastContent(*ptx->GetParentTxHash(), { CONTENT_COMMENT, CONTENT_COMMENT_EDIT });
+                auto[ok, parentTx] = ConsensusCtx().GetLastContent(*ptx->GetParentTxHash(), { CONTENT_COMMENT, CONTENT_COMMENT_EDIT });
 
                 if (!ok)
                     return {false, ConsensusResult_InvalidParentComment};
@@ -40,14 +40,14 @@ namespace PocketConsensus
             // Answer comment
             if (!IsEmpty(ptx->GetAnswerTxHash()))
             {
-                auto[ok, answerTx] = ConsensusRepoInst.GetLastContent(*ptx->GetAnswerTxHash(), { CONTENT_COMMENT, CONTENT_COMMENT_EDIT });
+                auto[ok, answerTx] = ConsensusCtx().GetLastContent(*ptx->GetAnswerTxHash(), { CONTENT_COMMENT, CONTENT_COMMENT_EDIT });
 
                 if (!ok)
                     return {false, ConsensusResult_InvalidParentComment};
             }
 
             // Check exists content transaction
-            auto[contentOk, contentTx] = PocketDb::ConsensusRepoInst.GetLastContent(
+            auto[contentOk, contentTx] = ConsensusCtx().GetLastContent(
                 *ptx->GetPostTxHash(),
                 { CONTENT_POST, CONTENT_VIDEO, CONTENT_ARTICLE, CONTENT_STREAM, CONTENT_AUDIO, CONTENT_DELETE, BARTERON_OFFER, APP }
             );
@@ -105,7 +105,7 @@ namespace PocketConsensus
         }
         ConsensusValidateResult ValidateMempool(const CommentRef& ptx) override
         {
-            int count = GetChainCount(ptx) + ConsensusRepoInst.CountMempoolComment(*ptx->GetAddress());
+            int count = GetChainCount(ptx) + ConsensusRepo().CountMempoolComment(*ptx->GetAddress());
             return ValidateLimit(ptx, count);
         }
         vector<string> GetAddressesForCheckRegistration(const CommentRef& ptx) override
@@ -115,7 +115,7 @@ namespace PocketConsensus
 
         virtual bool ValidateBlocking(const string& address1, const string& address2)
         {
-            auto[existsBlocking, blockingType] = PocketDb::ConsensusRepoInst.GetLastBlockingType(address1, address2);
+            auto[existsBlocking, blockingType] = ConsensusRepo().GetLastBlockingType(address1, address2);
             return existsBlocking && blockingType == ACTION_BLOCKING;
         }
         virtual int64_t GetLimit(AccountMode mode) { 
@@ -139,7 +139,7 @@ namespace PocketConsensus
         }
         virtual int GetChainCount(const CommentRef& ptx)
         {
-            return ConsensusRepoInst.CountChainCommentTime(
+            return ConsensusRepo().CountChainCommentTime(
                 *ptx->GetAddress(),
                 *ptx->GetTime() - GetConsensusLimit(ConsensusLimit_depth)
             );
@@ -166,7 +166,7 @@ namespace PocketConsensus
     protected:
         int GetChainCount(const CommentRef& ptx) override
         {
-            return ConsensusRepoInst.CountChainCommentHeight(
+            return ConsensusRepo().CountChainCommentHeight(
                 *ptx->GetAddress(),
                 Height - (int)GetConsensusLimit(ConsensusLimit_depth)
             );
@@ -200,7 +200,7 @@ namespace PocketConsensus
         }
     };
 
-    static CommentConsensusFactory ConsensusFactoryInst_Comment;
+    static thread_local CommentConsensusFactory ConsensusFactoryInst_Comment;
 }
 
 #endif // POCKETCONSENSUS_COMMENT_HPP
\ No newline at end of file
@@ -26,7 +26,7 @@ namespace PocketConsensus
         ConsensusValidateResult Validate(const CTransactionRef& tx, const CommentDeleteRef& ptx, const PocketBlockRef& block) override
         {
             // Actual comment not deleted
-            auto[actuallTxOk, actuallTx] = ConsensusRepoInst.GetLastContent(
+            auto[actuallTxOk, actuallTx] = ConsensusCtx().GetLastContent(
                 *ptx->GetRootTxHash(),
                 { CONTENT_COMMENT, CONTENT_COMMENT_EDIT, CONTENT_COMMENT_DELETE }
             );
@@ -34,7 +34,7 @@ namespace PocketConsensus
                 return {false, ConsensusResult_NotFound};
 
             // Original comment exists
-            auto[originalTxOk, originalTx] = PocketDb::ConsensusRepoInst.GetFirstContent(*ptx->GetRootTxHash());
+            auto[originalTxOk, originalTx] = ConsensusRepo().GetFirstContent(*ptx->GetRootTxHash());
             if (!actuallTxOk || !originalTxOk)
                 return {false, ConsensusResult_NotFound};
 
@@ -49,7 +49,7 @@ namespace PocketConsensus
                     return {false, ConsensusResult_InvalidParentComment};
 
                 if (!IsEmpty(originalPtx->GetParentTxHash()))
-                    if (!PocketDb::TransRepoInst.ExistsLast(origParentTxHash))
+                    if (!TransRepo().ExistsLast(origParentTxHash))
                         return {false, ConsensusResult_InvalidParentComment};
             }
 
@@ -63,12 +63,12 @@ namespace PocketConsensus
                     return {false, ConsensusResult_InvalidAnswerComment};
 
                 if (!IsEmpty(originalPtx->GetAnswerTxHash()))
-                    if (!PocketDb::TransRepoInst.Exists(origAnswerTxHash))
+                    if (!TransRepo().Exists(origAnswerTxHash))
                         return {false, ConsensusResult_InvalidAnswerComment};
             }
 
             // Check exists content transaction
-            auto[contentOk, contentTx] = PocketDb::ConsensusRepoInst.GetLastContent(
+            auto[contentOk, contentTx] = ConsensusCtx().GetLastContent(
                 *ptx->GetPostTxHash(), { CONTENT_POST, CONTENT_VIDEO, CONTENT_ARTICLE, CONTENT_STREAM, CONTENT_AUDIO, CONTENT_DELETE, BARTERON_OFFER, APP });
 
             if (!contentOk)
@@ -113,7 +113,7 @@ namespace PocketConsensus
         }
         ConsensusValidateResult ValidateMempool(const CommentDeleteRef& ptx) override
         {
-            if (ConsensusRepoInst.CountMempoolCommentEdit(*ptx->GetAddress(), *ptx->GetRootTxHash()) > 0)
+            if (ConsensusRepo().CountMempoolCommentEdit(*ptx->GetAddress(), *ptx->GetRootTxHash()) > 0)
                 return {false, ConsensusResult_DoubleCommentDelete};
 
             return Success;
@@ -156,7 +156,7 @@ namespace PocketConsensus
         }
     };
 
-    static CommentDeleteConsensusFactory ConsensusFactoryInst_CommentDelete;
+    static thread_local CommentDeleteConsensusFactory ConsensusFactoryInst_CommentDelete;
 }
 
 #endif // POCKETCONSENSUS_COMMENT_DELETE_HPP
\ No newline at end of file
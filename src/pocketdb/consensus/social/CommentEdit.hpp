@@ -29,7 +29,7 @@ namespace PocketConsensus
         ConsensusValidateResult Validate(const CTransactionRef& tx, const CommentEditRef& ptx, const PocketBlockRef& block) override
         {
             // Actual comment not deleted
-            auto[actuallTxOk, actuallTx] = ConsensusRepoInst.GetLastContent(
+            auto[actuallTxOk, actuallTx] = ConsensusCtx().GetLastContent(
                 *ptx->GetRootTxHash(),
                 { CONTENT_COMMENT, CONTENT_COMMENT_EDIT, CONTENT_COMMENT_DELETE }
             );
@@ -37,7 +37,7 @@ namespace PocketConsensus
                 return {false, ConsensusResult_CommentDeletedEdit};
 
             // Original comment exists
-            auto[originalTxOk, originalTx] = PocketDb::ConsensusRepoInst.GetFirstContent(*ptx->GetRootTxHash());
+            auto[originalTxOk, originalTx] = ConsensusRepo().GetFirstContent(*ptx->GetRootTxHash());
             if (!actuallTxOk || !originalTxOk)
                 return {false, ConsensusResult_NotFound};
 
@@ -57,7 +57,7 @@ namespace PocketConsensus
 
                 if (!origParentTxHash.empty())
                 {
-                    if (auto[ok, origParentTx] = ConsensusRepoInst.GetLastContent(
+                    if (auto[ok, origParentTx] = ConsensusCtx().GetLastContent(
                         origParentTxHash, { CONTENT_COMMENT, CONTENT_COMMENT_EDIT }); !ok)
                         return {false, ConsensusResult_InvalidParentComment};
                 }
@@ -73,7 +73,7 @@ namespace PocketConsensus
 
                 if (!origAnswerTxHash.empty())
                 {
-                    if (auto[ok, origAnswerTx] = ConsensusRepoInst.GetLastContent(
+                    if (auto[ok, origAnswerTx] = ConsensusCtx().GetLastContent(
                         origAnswerTxHash, { CONTENT_COMMENT, CONTENT_COMMENT_EDIT }); !ok)
                         return {false, ConsensusResult_InvalidAnswerComment};
                 }
@@ -84,7 +84,7 @@ namespace PocketConsensus
                 return {false, ConsensusResult_CommentEditLimit};
 
             // Check exists content transaction
-            auto[contentOk, contentTx] = PocketDb::ConsensusRepoInst.GetLastContent(
+            auto[contentOk, contentTx] = ConsensusCtx().GetLastContent(
                 *ptx->GetPostTxHash(), { CONTENT_POST, CONTENT_VIDEO, CONTENT_ARTICLE, CONTENT_STREAM, CONTENT_AUDIO, CONTENT_DELETE, BARTERON_OFFER, APP });
 
             if (!contentOk)
@@ -141,7 +141,7 @@ namespace PocketConsensus
         }
         ConsensusValidateResult ValidateMempool(const CommentEditRef& ptx) override
         {
-            if (ConsensusRepoInst.CountMempoolCommentEdit(*ptx->GetAddress(), *ptx->GetRootTxHash()) > 0)
+            if (ConsensusRepo().CountMempoolCommentEdit(*ptx->GetAddress(), *ptx->GetRootTxHash()) > 0)
                 return {false, ConsensusResult_DoubleCommentEdit};
 
             return Success;
@@ -153,7 +153,7 @@ namespace PocketConsensus
 
         virtual bool ValidateBlocking(const string& address1, const string& address2)
         {
-            auto[existsBlocking, blockingType] = PocketDb::ConsensusRepoInst.GetLastBlockingType(address1, address2);
+            auto[existsBlocking, blockingType] = ConsensusRepo().GetLastBlockingType(address1, address2);
             return existsBlocking && blockingType == ACTION_BLOCKING;
         }
         virtual bool AllowEditWindow(const CommentEditRef& ptx, const CommentEditRef& blockPtx)
@@ -162,7 +162,7 @@ namespace PocketConsensus
         }
         virtual ConsensusValidateResult ValidateEditOneLimit(const CommentEditRef& ptx)
         {
-            int count = ConsensusRepoInst.CountChainCommentEdit(*ptx->GetAddress(), *ptx->GetRootTxHash());
+            int count = ConsensusRepo().CountChainCommentEdit(*ptx->GetAddress(), *ptx->GetRootTxHash());
             if (count >= GetConsensusLimit(ConsensusLimit_comment_edit_count))
                 return {false, ConsensusResult_CommentEditLimit};
 
@@ -182,7 +182,7 @@ namespace PocketConsensus
     protected:
         bool AllowEditWindow(const CommentEditRef& ptx, const CommentEditRef& originalTx) override
         {
-            auto[ok, originalTxHeight] = ConsensusRepoInst.GetTransactionHeight(*originalTx->GetHash());
+            auto[ok, originalTxHeight] = ConsensusRepo().GetTransactionHeight(*originalTx->GetHash());
             if (!ok) return false;
             return (Height - originalTxHeight) <= GetConsensusLimit(ConsensusLimit_edit_comment_depth);
         }
@@ -230,7 +230,7 @@ namespace PocketConsensus
         }
     };
 
-    static CommentEditConsensusFactory ConsensusFactoryInst_CommentEdit;
+    static thread_local CommentEditConsensusFactory ConsensusFactoryInst_CommentEdit;
 }
 
 #endif // POCKETCONSENSUS_COMMENT_EDIT_HPP
\ No newline at end of file
@@ -27,7 +27,7 @@ namespace PocketConsensus
         ConsensusValidateResult Validate(const CTransactionRef& tx, const ComplainRef& ptx, const PocketBlockRef& block) override
         {
             // Author or post must be exists
-            auto[lastContentOk, lastContent] = PocketDb::ConsensusRepoInst.GetLastContent(
+            auto[lastContentOk, lastContent] = ConsensusCtx().GetLastContent(
                 *ptx->GetPostTxHash(),
                 {CONTENT_POST, CONTENT_VIDEO, CONTENT_ARTICLE, CONTENT_STREAM, CONTENT_AUDIO, APP, CONTENT_DELETE}
             );
@@ -59,7 +59,7 @@ namespace PocketConsensus
                 return {false, ConsensusResult_ComplainDeletedContent};
 
             // Check double complain
-            if (PocketDb::ConsensusRepoInst.ExistsComplain(*ptx->GetPostTxHash(), *ptx->GetAddress(), false))
+            if (ConsensusRepo().ExistsComplain(*ptx->GetPostTxHash(), *ptx->GetAddress(), false))
                 return {false, ConsensusResult_DoubleComplain};
 
             return SocialConsensus::Validate(tx, ptx, block);
@@ -113,11 +113,11 @@ namespace PocketConsensus
         ConsensusValidateResult ValidateMempool(const ComplainRef& ptx) override
         {
             // Check double complain
-            if (PocketDb::ConsensusRepoInst.ExistsComplain(*ptx->GetPostTxHash(), *ptx->GetAddress(), true))
+            if (ConsensusRepo().ExistsComplain(*ptx->GetPostTxHash(), *ptx->GetAddress(), true))
                 return {false, ConsensusResult_DoubleComplain};
 
             int count = GetChainCount(ptx);
-            count += ConsensusRepoInst.CountMempoolComplain(*ptx->GetAddress());
+            count += ConsensusRepo().CountMempoolComplain(*ptx->GetAddress());
 
             return ValidateLimit(ptx, count);
         }
@@ -180,7 +180,7 @@ namespace PocketConsensus
     protected:
         int GetChainCount(const ComplainRef& ptx) override
         {
-            return ConsensusRepoInst.CountChainHeight(*ptx->GetType(), *ptx->GetAddress());
+            return ConsensusRepo().CountChainHeight(*ptx->GetType(), *ptx->GetAddress());
         }
     };
 
@@ -199,7 +199,7 @@ namespace PocketConsensus
         }
     };
 
-    static ComplainConsensusFactory ConsensusFactoryInst_Complain;
+    static thread_local ComplainConsensusFactory ConsensusFactoryInst_Complain;
 }
 
 #endif // POCKETCONSENSUS_COMPLAIN_HPP
\ No newline at end of file
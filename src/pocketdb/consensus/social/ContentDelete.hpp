@@ -26,7 +26,7 @@ namespace PocketConsensus
         ConsensusValidateResult Validate(const CTransactionRef& tx, const ContentDeleteRef& ptx, const PocketBlockRef& block) override
         {
             // Actual content not deleted
-            auto[ok, actuallTx] = ConsensusRepoInst.GetLastContent(
+            auto[ok, actuallTx] = ConsensusCtx().GetLastContent(
                 *ptx->GetRootTxHash(),
                 { CONTENT_POST, CONTENT_VIDEO, CONTENT_ARTICLE, CONTENT_STREAM, CONTENT_AUDIO, CONTENT_COLLECTION, BARTERON_OFFER, APP, CONTENT_DELETE }
             );
@@ -76,7 +76,7 @@ namespace PocketConsensus
         }
         ConsensusValidateResult ValidateMempool(const ContentDeleteRef& ptx) override
         {
-            if (ConsensusRepoInst.CountMempoolContentDelete(*ptx->GetAddress(), *ptx->GetRootTxHash()) > 0)
+            if (ConsensusRepo().CountMempoolContentDelete(*ptx->GetAddress(), *ptx->GetRootTxHash()) > 0)
                 return {false, ConsensusResult_ContentDeleteDouble};
 
             return Success;
@@ -122,7 +122,7 @@ namespace PocketConsensus
         }
     };
 
-    static ContentDeleteConsensusFactory ConsensusFactoryInst_ContentDelete;
+    static thread_local ContentDeleteConsensusFactory ConsensusFactoryInst_ContentDelete;
 }
 
 #endif // POCKETCONSENSUS_CONTENT_DELETE_HPP
\ No newline at end of file
@@ -33,7 +33,7 @@ namespace PocketConsensus
             // Check if this post relay another
             if (!IsEmpty(ptx->GetRelayTxHash()))
             {
-                auto[relayOk, relayTx] = PocketDb::ConsensusRepoInst.GetLastContent(
+                auto[relayOk, relayTx] = ConsensusCtx().GetLastContent(
                     *ptx->GetRelayTxHash(),
                     { CONTENT_POST, CONTENT_VIDEO, CONTENT_ARTICLE, CONTENT_STREAM, CONTENT_AUDIO, CONTENT_DELETE }
                 );
@@ -124,7 +124,7 @@ namespace PocketConsensus
             int count = GetChainCount(ptx);
 
             // Get count from mempool
-            count += ConsensusRepoInst.CountMempoolPost(*ptx->GetAddress());
+            count += ConsensusRepo().CountMempoolPost(*ptx->GetAddress());
 
             return ValidateLimit(ptx, count);
         }
@@ -135,7 +135,7 @@ namespace PocketConsensus
 
         virtual ConsensusValidateResult ValidateEdit(const PostRef& ptx)
         {
-            auto[lastContentOk, lastContent] = PocketDb::ConsensusRepoInst.GetLastContent(
+            auto[lastContentOk, lastContent] = ConsensusCtx().GetLastContent(
                 *ptx->GetRootTxHash(),
                 { CONTENT_POST, CONTENT_VIDEO, CONTENT_ARTICLE, CONTENT_STREAM, CONTENT_AUDIO, APP, CONTENT_DELETE }
             );
@@ -143,7 +143,7 @@ namespace PocketConsensus
                 return {false, ConsensusResult_NotAllowed};
 
             // First get original post transaction
-            auto[originalTxOk, originalTx] = PocketDb::ConsensusRepoInst.GetFirstContent(*ptx->GetRootTxHash());
+            auto[originalTxOk, originalTx] = ConsensusRepo().GetFirstContent(*ptx->GetRootTxHash());
             if (!lastContentOk || !originalTxOk)
                 return {false, ConsensusResult_NotFound};
 
@@ -187,7 +187,7 @@ namespace PocketConsensus
         }
         virtual int GetChainCount(const PostRef& ptx)
         {
-            return ConsensusRepoInst.CountChainPostTime(
+            return ConsensusRepo().CountChainPostTime(
                 *ptx->GetAddress(),
                 *ptx->GetTime() - GetConsensusLimit(ConsensusLimit_depth)
             );
@@ -214,7 +214,7 @@ namespace PocketConsensus
         }
         virtual ConsensusValidateResult ValidateEditMempool(const PostRef& ptx)
         {
-            if (ConsensusRepoInst.CountMempoolPostEdit(*ptx->GetAddress(), *ptx->GetRootTxHash()) > 0)
+            if (ConsensusRepo().CountMempoolPostEdit(*ptx->GetAddress(), *ptx->GetRootTxHash()) > 0)
                 return {false, ConsensusResult_DoubleContentEdit};
 
             // Check edit limit
@@ -222,7 +222,7 @@ namespace PocketConsensus
         }
         virtual ConsensusValidateResult ValidateEditOneLimit(const PostRef& ptx)
         {
-            int count = ConsensusRepoInst.CountChainPostEdit(*ptx->GetAddress(), *ptx->GetRootTxHash());
+            int count = ConsensusRepo().CountChainPostEdit(*ptx->GetAddress(), *ptx->GetRootTxHash());
             if (count >= GetConsensusLimit(ConsensusLimit_post_edit_count))
                 return {false, ConsensusResult_ContentEditLimit};
 
@@ -253,14 +253,14 @@ namespace PocketConsensus
     protected:
         int GetChainCount(const PostRef& ptx) override
         {
-            return ConsensusRepoInst.CountChainHeight(
+            return ConsensusRepo().CountChainHeight(
                 *ptx->GetType(),
                 *ptx->GetAddress()
             );
         }
         bool AllowEditWindow(const PostRef& ptx, const ContentRef& originalTx) override
         {
-            auto[ok, originalTxHeight] = ConsensusRepoInst.GetTransactionHeight(*originalTx->GetHash());
+            auto[ok, originalTxHeight] = ConsensusRepo().GetTransactionHeight(*originalTx->GetHash());
             if (!ok)
                 return false;
 
@@ -277,7 +277,7 @@ namespace PocketConsensus
     protected:
         bool ValidateBlocking(const string& address1, const string& address2) override
         {
-            auto[existsBlocking, blockingType] = PocketDb::ConsensusRepoInst.GetLastBlockingType(address1, address2);
+            auto[existsBlocking, blockingType] = ConsensusRepo().GetLastBlockingType(address1, address2);
             return existsBlocking && blockingType == ACTION_BLOCKING;
         }
     };
@@ -297,7 +297,7 @@ namespace PocketConsensus
             // Check if this post relay another
             if (!IsEmpty(ptx->GetRelayTxHash()))
             {
-                auto[relayOk, relayTx] = PocketDb::ConsensusRepoInst.GetLastContent(
+                auto[relayOk, relayTx] = ConsensusCtx().GetLastContent(
                     *ptx->GetRelayTxHash(),
                     { CONTENT_POST, CONTENT_VIDEO, CONTENT_ARTICLE, CONTENT_STREAM, CONTENT_AUDIO, APP, CONTENT_DELETE }
                 );
@@ -351,7 +351,7 @@ namespace PocketConsensus
         }
     };
 
-    static PostConsensusFactory ConsensusFactoryInst_Post;
+    static thread_local PostConsensusFactory ConsensusFactoryInst_Post;
 }
 
 #endif // POCKETCONSENSUS_POST_H
\ No newline at end of file
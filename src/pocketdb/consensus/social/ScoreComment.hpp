@@ -27,12 +27,12 @@ namespace PocketConsensus
         ConsensusValidateResult Validate(const CTransactionRef& tx, const ScoreCommentRef& ptx, const PocketBlockRef& block) override
         {
             // Check already scored content
-            if (PocketDb::ConsensusRepoInst.ExistsScore(
+            if (ConsensusCtx().ExistsScore(
                 *ptx->GetAddress(), *ptx->GetCommentTxHash(), ACTION_SCORE_COMMENT, false))
                 return {false, ConsensusResult_DoubleCommentScore};
 
             // Comment should be exists
-            auto[lastContentOk, lastContent] = PocketDb::ConsensusRepoInst.GetLastContent(
+            auto[lastContentOk, lastContent] = ConsensusCtx().GetLastContent(
                 *ptx->GetCommentTxHash(),
                 { CONTENT_COMMENT, CONTENT_COMMENT_EDIT, CONTENT_COMMENT_DELETE }
             );
@@ -134,7 +134,7 @@ namespace PocketConsensus
         ConsensusValidateResult ValidateMempool(const ScoreCommentRef& ptx) override
         {
             // Check already scored content
-            if (PocketDb::ConsensusRepoInst.ExistsScore(
+            if (ConsensusRepo().ExistsScore(
                 *ptx->GetAddress(), *ptx->GetCommentTxHash(), ACTION_SCORE_COMMENT, true))
                 return {false, ConsensusResult_DoubleCommentScore};
 
@@ -142,7 +142,7 @@ namespace PocketConsensus
             int count = GetChainCount(ptx);
 
             // and from mempool
-            count += ConsensusRepoInst.CountMempoolScoreComment(*ptx->GetAddress());
+            count += ConsensusRepo().CountMempoolScoreComment(*ptx->GetAddress());
 
             return ValidateLimit(ptx, count);
         }
@@ -176,7 +176,7 @@ namespace PocketConsensus
         virtual int GetChainCount(const ScoreCommentRef& ptx)
         {
 
-            return ConsensusRepoInst.CountChainScoreCommentTime(
+            return ConsensusRepo().CountChainScoreCommentTime(
                 *ptx->GetAddress(),
                 *ptx->GetTime() - GetConsensusLimit(ConsensusLimit_depth)
             );
@@ -193,7 +193,7 @@ namespace PocketConsensus
     protected:
         bool ValidateBlocking(const string& address1, const string& address2) override
         {
-            auto[existsBlocking, blockingType] = PocketDb::ConsensusRepoInst.GetLastBlockingType(address1, address2);
+            auto[existsBlocking, blockingType] = ConsensusRepo().GetLastBlockingType(address1, address2);
             return existsBlocking && blockingType == ACTION_BLOCKING;
         }
     };
@@ -232,7 +232,7 @@ namespace PocketConsensus
     protected:
         int GetChainCount(const ScoreCommentRef& ptx) override
         {
-            return ConsensusRepoInst.CountChainHeight(
+            return ConsensusRepo().CountChainHeight(
                 *ptx->GetType(),
                 *ptx->GetAddress()
             );
@@ -247,7 +247,7 @@ namespace PocketConsensus
     protected:
         bool ValidateBlocking(const string& address1, const string& address2) override
         {
-            auto[existsBlocking, blockingType] = PocketDb::ConsensusRepoInst.GetLastBlockingType(address1, address2);
+            auto[existsBlocking, blockingType] = ConsensusRepo().GetLastBlockingType(address1, address2);
             return existsBlocking && blockingType == ACTION_BLOCKING;
         }
     };
@@ -281,7 +281,7 @@ namespace PocketConsensus
         }
     };
 
-    static ScoreCommentConsensusFactory ConsensusFactoryInst_ScoreComment;
+    static thread_local ScoreCommentConsensusFactory ConsensusFactoryInst_ScoreComment;
 }
 
 #endif // POCKETCONSENSUS_SCORECOMMENT_HPP
\ No newline at end of file
@@ -27,11 +27,11 @@ namespace PocketConsensus
         ConsensusValidateResult Validate(const CTransactionRef& tx, const ScoreContentRef& ptx, const PocketBlockRef& block) override
         {
             // Check already scored content
-            if (PocketDb::ConsensusRepoInst.ExistsScore(*ptx->GetAddress(), *ptx->GetContentTxHash(), ACTION_SCORE_CONTENT, false))
+            if (ConsensusCtx().ExistsScore(*ptx->GetAddress(), *ptx->GetContentTxHash(), ACTION_SCORE_CONTENT, false))
                 return {false, ConsensusResult_DoubleScore};
 
             // Content should be exists in chain
-            auto[lastContentOk, lastContent] = PocketDb::ConsensusRepoInst.GetLastContent(
+            auto[lastContentOk, lastContent] = ConsensusCtx().GetLastContent(
                 *ptx->GetContentTxHash(),
                 { CONTENT_POST, CONTENT_VIDEO, CONTENT_ARTICLE, CONTENT_STREAM, CONTENT_AUDIO, CONTENT_DELETE, BARTERON_OFFER, APP }
             );
@@ -130,7 +130,7 @@ namespace PocketConsensus
         ConsensusValidateResult ValidateMempool(const ScoreContentRef& ptx) override
         {
             // Check already scored content
-            if (PocketDb::ConsensusRepoInst.ExistsScore(
+            if (ConsensusRepo().ExistsScore(
                 *ptx->GetAddress(), *ptx->GetContentTxHash(), ACTION_SCORE_CONTENT, true))
                 return {false, ConsensusResult_DoubleScore};
 
@@ -138,7 +138,7 @@ namespace PocketConsensus
             int count = GetChainCount(ptx);
 
             // Get count from mempool
-            count += ConsensusRepoInst.CountMempoolScoreContent(*ptx->GetAddress());
+            count += ConsensusRepo().CountMempoolScoreContent(*ptx->GetAddress());
 
             // Check count
             return ValidateLimit(ptx, count);
@@ -179,7 +179,7 @@ namespace PocketConsensus
         }
         virtual int GetChainCount(const ScoreContentRef& ptx)
         {
-            return ConsensusRepoInst.CountChainScoreContentTime(
+            return ConsensusRepo().CountChainScoreContentTime(
                 *ptx->GetAddress(),
                 *ptx->GetTime() - GetConsensusLimit(ConsensusLimit_depth)
             );
@@ -198,7 +198,7 @@ namespace PocketConsensus
     protected:
         bool ValidateBlocking(const string& address1, const string& address2) override
         {
-            auto[existsBlocking, blockingType] = PocketDb::ConsensusRepoInst.GetLastBlockingType(address1, address2);
+            auto[existsBlocking, blockingType] = ConsensusRepo().GetLastBlockingType(address1, address2);
             return existsBlocking && blockingType == ACTION_BLOCKING;
         }
     };
@@ -241,7 +241,7 @@ namespace PocketConsensus
     protected:
         int GetChainCount(const ScoreContentRef& ptx) override
         {
-            return ConsensusRepoInst.CountChainHeight(
+            return ConsensusRepo().CountChainHeight(
                 *ptx->GetType(),
                 *ptx->GetAddress()
             );
@@ -268,7 +268,7 @@ namespace PocketConsensus
     protected:
         bool ValidateBlocking(const string& address1, const string& address2) override
         {
-            auto[existsBlocking, blockingType] = PocketDb::ConsensusRepoInst.GetLastBlockingType(address1, address2);
+            auto[existsBlocking, blockingType] = ConsensusRepo().GetLastBlockingType(address1, address2);
             return existsBlocking && blockingType == ACTION_BLOCKING;
         }
     };
@@ -316,7 +316,7 @@ namespace PocketConsensus
         }
     };
 
-    static ScoreContentConsensusFactory ConsensusFactoryInst_ScoreContent;
+    static thread_local ScoreContentConsensusFactory ConsensusFactoryInst_ScoreContent;
 }
 
 #endif // POCKETCONSENSUS_SCORECONTENT_HPP
\ No newline at end of file
@@ -104,7 +104,7 @@ namespace PocketConsensus
             int count = GetChainCount(ptx);
 
             // and from mempool
-            count += ConsensusRepoInst.CountMempoolStream(*ptx->GetAddress());
+            count += ConsensusRepo().CountMempoolStream(*ptx->GetAddress());
 
             return ValidateLimit(ptx, count);
         }
@@ -115,7 +115,7 @@ namespace PocketConsensus
 
         virtual ConsensusValidateResult ValidateEdit(const StreamRef& ptx)
         {
-            auto[lastContentOk, lastContent] = PocketDb::ConsensusRepoInst.GetLastContent(
+            auto[lastContentOk, lastContent] = ConsensusCtx().GetLastContent(
                     *ptx->GetRootTxHash(),
                     { CONTENT_POST, CONTENT_STREAM, CONTENT_DELETE }
             );
@@ -123,7 +123,7 @@ namespace PocketConsensus
                 return {false, ConsensusResult_NotAllowed};
 
             // First get original post transaction
-            auto[originalTxOk, originalTx] = PocketDb::ConsensusRepoInst.GetFirstContent(*ptx->GetRootTxHash());
+            auto[originalTxOk, originalTx] = ConsensusRepo().GetFirstContent(*ptx->GetRootTxHash());
             if (!lastContentOk || !originalTxOk)
                 return {false, ConsensusResult_NotFound};
 
@@ -159,7 +159,7 @@ namespace PocketConsensus
         virtual int GetChainCount(const StreamRef& ptx)
         {
 
-            return ConsensusRepoInst.CountChainStream(
+            return ConsensusRepo().CountChainStream(
                     *ptx->GetAddress(),
                     Height - (int)GetConsensusLimit(ConsensusLimit_depth)
             );
@@ -188,7 +188,7 @@ namespace PocketConsensus
         virtual ConsensusValidateResult ValidateEditMempool(const StreamRef& ptx)
         {
 
-            if (ConsensusRepoInst.CountMempoolStreamEdit(*ptx->GetAddress(), *ptx->GetRootTxHash()) > 0)
+            if (ConsensusRepo().CountMempoolStreamEdit(*ptx->GetAddress(), *ptx->GetRootTxHash()) > 0)
                 return {false, ConsensusResult_DoubleContentEdit};
 
             // Check edit limit
@@ -197,7 +197,7 @@ namespace PocketConsensus
         virtual ConsensusValidateResult ValidateEditOneLimit(const StreamRef& ptx)
         {
 
-            int count = ConsensusRepoInst.CountChainStreamEdit(*ptx->GetAddress(), *ptx->GetRootTxHash());
+            int count = ConsensusRepo().CountChainStreamEdit(*ptx->GetAddress(), *ptx->GetRootTxHash());
             if (count >= GetConsensusLimit(ConsensusLimit_stream_edit_count))
                 return {false, ConsensusResult_ContentEditLimit};
 
@@ -205,7 +205,7 @@ namespace PocketConsensus
         }
         virtual bool AllowEditWindow(const StreamRef& ptx, const StreamRef& originalTx)
         {
-            auto[ok, originalTxHeight] = ConsensusRepoInst.GetTransactionHeight(*originalTx->GetHash());
+            auto[ok, originalTxHeight] = ConsensusRepo().GetTransactionHeight(*originalTx->GetHash());
             if (!ok)
                 return false;
 
@@ -243,7 +243,7 @@ namespace PocketConsensus
         }
     };
 
-    static StreamConsensusFactory ConsensusFactoryInst_Stream;
+    static thread_local StreamConsensusFactory ConsensusFactoryInst_Stream;
 }
 
 #endif // POCKETCONSENSUS_STREAM_HPP
@@ -26,7 +26,7 @@ namespace PocketConsensus
 
         ConsensusValidateResult Validate(const CTransactionRef& tx, const SubscribeRef& ptx, const PocketBlockRef& block) override
         {
-            auto[subscribeExists, subscribeType] = PocketDb::ConsensusRepoInst.GetLastSubscribeType(
+            auto[subscribeExists, subscribeType] = ConsensusRepo().GetLastSubscribeType(
                 *ptx->GetAddress(),
                 *ptx->GetAddressTo());
 
@@ -83,7 +83,7 @@ namespace PocketConsensus
         }
         ConsensusValidateResult ValidateMempool(const SubscribeRef& ptx) override
         {
-            int mempoolCount = ConsensusRepoInst.CountMempoolSubscribe(
+            int mempoolCount = ConsensusRepo().CountMempoolSubscribe(
                 *ptx->GetAddress(),
                 *ptx->GetAddressTo()
             );
@@ -111,7 +111,7 @@ namespace PocketConsensus
     protected:
         bool ValidateBlocking(const SubscribeRef& ptx) override
         {
-            auto[existsBlocking, blockingType] = PocketDb::ConsensusRepoInst.GetLastBlockingType(*ptx->GetAddressTo(), *ptx->GetAddress());
+            auto[existsBlocking, blockingType] = ConsensusRepo().GetLastBlockingType(*ptx->GetAddressTo(), *ptx->GetAddress());
             return existsBlocking && blockingType == ACTION_BLOCKING;
         }
     };
@@ -142,7 +142,7 @@ namespace PocketConsensus
         }
     };
 
-    static SubscribeConsensusFactory ConsensusFactoryInst_Subscribe;
+    static thread_local SubscribeConsensusFactory ConsensusFactoryInst_Subscribe;
 }
 
 #endif // POCKETCONSENSUS_SUBSCRIBE_HPP
\ No newline at end of file
@@ -27,7 +27,7 @@ namespace PocketConsensus
         ConsensusValidateResult Validate(const CTransactionRef& tx, const SubscribeCancelRef& ptx, const PocketBlockRef& block) override
         {
             // Last record not valid subscribe
-            auto[subscribeExists, subscribeType] = PocketDb::ConsensusRepoInst.GetLastSubscribeType(
+            auto[subscribeExists, subscribeType] = ConsensusRepo().GetLastSubscribeType(
                 *ptx->GetAddress(),
                 *ptx->GetAddressTo());
 
@@ -80,7 +80,7 @@ namespace PocketConsensus
         }
         ConsensusValidateResult ValidateMempool(const SubscribeCancelRef& ptx) override
         {
-            int mempoolCount = ConsensusRepoInst.CountMempoolSubscribe(
+            int mempoolCount = ConsensusRepo().CountMempoolSubscribe(
                 *ptx->GetAddress(),
                 *ptx->GetAddressTo()
             );
@@ -118,7 +118,7 @@ namespace PocketConsensus
         }
     };
 
-    static SubscribeCancelConsensusFactory ConsensusFactoryInst_SubscribeCancel;
+    static thread_local SubscribeCancelConsensusFactory ConsensusFactoryInst_SubscribeCancel;
 }
 
 #endif // POCKETCONSENSUS_SUBSCRIBECANCEL_HPP
\ No newline at end of file
@@ -26,7 +26,7 @@ namespace PocketConsensus
         ConsensusValidateResult Validate(const CTransactionRef& tx, const SubscribePrivateRef& ptx, const PocketBlockRef& block) override
         {
             // Check double subscribe
-            auto[subscribeExists, subscribeType] = PocketDb::ConsensusRepoInst.GetLastSubscribeType(
+            auto[subscribeExists, subscribeType] = ConsensusRepo().GetLastSubscribeType(
                 *ptx->GetAddress(),
                 *ptx->GetAddressTo());
 
@@ -83,7 +83,7 @@ namespace PocketConsensus
         }
         ConsensusValidateResult ValidateMempool(const SubscribePrivateRef& ptx) override
         {
-            int mempoolCount = ConsensusRepoInst.CountMempoolSubscribe(
+            int mempoolCount = ConsensusRepo().CountMempoolSubscribe(
                 *ptx->GetAddress(),
                 *ptx->GetAddressTo()
             );
@@ -112,7 +112,7 @@ namespace PocketConsensus
     protected:
         bool ValidateBlocking(const SubscribePrivateRef& ptx) override
         {
-            auto[existsBlocking, blockingType] = PocketDb::ConsensusRepoInst.GetLastBlockingType(*ptx->GetAddressTo(), *ptx->GetAddress());
+            auto[existsBlocking, blockingType] = ConsensusRepo().GetLastBlockingType(*ptx->GetAddressTo(), *ptx->GetAddress());
             return existsBlocking && blockingType == ACTION_BLOCKING;
         }
     };
@@ -143,7 +143,7 @@ namespace PocketConsensus
         }
     };
 
-    static SubscribePrivateConsensusFactory ConsensusFactoryInst_SubscribePrivate;
+    static thread_local SubscribePrivateConsensusFactory ConsensusFactoryInst_SubscribePrivate;
 }
 
 #endif // POCKETCONSENSUS_SUBSCRIBEPRIVATE_HPP
\ No newline at end of file
@@ -110,7 +110,7 @@ namespace PocketConsensus
             int count = GetChainCount(ptx);
 
             // and from mempool
-            count += ConsensusRepoInst.CountMempoolVideo(*ptx->GetAddress());
+            count += ConsensusRepo().CountMempoolVideo(*ptx->GetAddress());
 
             return ValidateLimit(ptx, count);
         }
@@ -121,7 +121,7 @@ namespace PocketConsensus
 
         virtual ConsensusValidateResult ValidateEdit(const VideoRef& ptx)
         {
-            auto[lastContentOk, lastContent] = PocketDb::ConsensusRepoInst.GetLastContent(
+            auto[lastContentOk, lastContent] = ConsensusCtx().GetLastContent(
                 *ptx->GetRootTxHash(),
                 { CONTENT_POST, CONTENT_VIDEO, CONTENT_DELETE }
             );
@@ -129,7 +129,7 @@ namespace PocketConsensus
                 return {false, ConsensusResult_NotAllowed};
 
             // First get original post transaction
-            auto[originalTxOk, originalTx] = PocketDb::ConsensusRepoInst.GetFirstContent(*ptx->GetRootTxHash());
+            auto[originalTxOk, originalTx] = ConsensusRepo().GetFirstContent(*ptx->GetRootTxHash());
             if (!lastContentOk || !originalTxOk)
                 return {false, ConsensusResult_NotFound};
 
@@ -165,7 +165,7 @@ namespace PocketConsensus
         virtual int GetChainCount(const VideoRef& ptx)
         {
 
-            return ConsensusRepoInst.CountChainHeight(
+            return ConsensusRepo().CountChainHeight(
                 *ptx->GetType(),
                 *ptx->GetAddress()
             );
@@ -194,7 +194,7 @@ namespace PocketConsensus
         virtual ConsensusValidateResult ValidateEditMempool(const VideoRef& ptx)
         {
 
-            if (ConsensusRepoInst.CountMempoolVideoEdit(*ptx->GetAddress(), *ptx->GetRootTxHash()) > 0)
+            if (ConsensusRepo().CountMempoolVideoEdit(*ptx->GetAddress(), *ptx->GetRootTxHash()) > 0)
                 return {false, ConsensusResult_DoubleContentEdit};
 
             // Check edit limit
@@ -203,7 +203,7 @@ namespace PocketConsensus
         virtual ConsensusValidateResult ValidateEditOneLimit(const VideoRef& ptx)
         {
 
-            int count = ConsensusRepoInst.CountChainVideoEdit(*ptx->GetAddress(), *ptx->GetRootTxHash());
+            int count = ConsensusRepo().CountChainVideoEdit(*ptx->GetAddress(), *ptx->GetRootTxHash());
             if (count >= GetConsensusLimit(ConsensusLimit_video_edit_count))
                 return {false, ConsensusResult_ContentEditLimit};
 
@@ -211,7 +211,7 @@ namespace PocketConsensus
         }
         virtual bool AllowEditWindow(const VideoRef& ptx, const VideoRef& originalTx)
         {
-            auto[ok, originalTxHeight] = ConsensusRepoInst.GetTransactionHeight(*originalTx->GetHash());
+            auto[ok, originalTxHeight] = ConsensusRepo().GetTransactionHeight(*originalTx->GetHash());
             if (!ok)
                 return false;
 
@@ -248,7 +248,7 @@ namespace PocketConsensus
         }
     };
 
-    static VideoConsensusFactory ConsensusFactoryInst_Video;
+    static thread_local VideoConsensusFactory ConsensusFactoryInst_Video;
 }
 
 #endif // POCKETCONSENSUS_VIDEO_HPP
\ No newline at end of file
@@ -57,7 +57,7 @@ namespace PocketConsensus
 
         ConsensusValidateResult ValidateMempool(const AccountDeleteRef& ptx) override
         {
-            if (ConsensusRepoInst.Exists_MS1T(*ptx->GetAddress(), { ACCOUNT_USER, ACCOUNT_DELETE }))
+            if (ConsensusRepo().Exists_MS1T(*ptx->GetAddress(), { ACCOUNT_USER, ACCOUNT_DELETE }))
                 return {false, ConsensusResult_ManyTransactions};
 
             return Success;
@@ -76,7 +76,7 @@ namespace PocketConsensus
         }
     };
 
-    static AccountDeleteConsensusFactory ConsensusFactoryInst_AccountDelete;
+    static thread_local AccountDeleteConsensusFactory ConsensusFactoryInst_AccountDelete;
 }
 
 #endif // POCKETCONSENSUS_ACCOUNT_DELETE_HPP
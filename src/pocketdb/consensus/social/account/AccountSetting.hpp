@@ -67,7 +67,7 @@ namespace PocketConsensus
 
         ConsensusValidateResult ValidateMempool(const AccountSettingRef& ptx) override
         {
-            if (ConsensusRepoInst.CountMempoolAccountSetting(*ptx->GetAddress()) > 0)
+            if (ConsensusRepo().CountMempoolAccountSetting(*ptx->GetAddress()) > 0)
                 return {false, ConsensusResult_AccountSettingsDouble};
 
             int count = GetChainCount(ptx);
@@ -83,7 +83,7 @@ namespace PocketConsensus
         virtual int GetChainCount(const AccountSettingRef& ptx)
         {
             return 0;
-            // return ConsensusRepoInst.CountChainAccountSetting(
+            // return ConsensusRepo().CountChainAccountSetting(
             //     *ptx->GetAddress(),
             //     Height - (int)GetConsensusLimit(ConsensusLimit_depth)
             // );
@@ -102,7 +102,7 @@ namespace PocketConsensus
         }
     };
 
-    static AccountSettingConsensusFactory ConsensusFactoryInst_AccountSetting;
+    static thread_local AccountSettingConsensusFactory ConsensusFactoryInst_AccountSetting;
 }
 
 #endif // POCKETCONSENSUS_ACCOUNT_SETTING_HPP
\ No newline at end of file
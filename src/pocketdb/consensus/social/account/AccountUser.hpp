@@ -31,7 +31,7 @@ namespace PocketConsensus
         ConsensusValidateResult Validate(const CTransactionRef& tx, const UserRef& ptx, const PocketBlockRef& block) override
         {
             // Duplicate name
-            if (ConsensusRepoInst.ExistsAnotherByName(*ptx->GetAddress(), *ptx->GetPayloadName(), TxType::ACCOUNT_USER))
+            if (ConsensusRepo().ExistsAnotherByName(*ptx->GetAddress(), *ptx->GetPayloadName(), TxType::ACCOUNT_USER))
             {
                 if (!CheckpointRepoInst.IsSocialCheckpoint(*ptx->GetHash(), *ptx->GetType(), ConsensusResult_NicknameDouble))
                     return {false, ConsensusResult_NicknameDouble};
@@ -100,7 +100,7 @@ namespace PocketConsensus
 
         ConsensusValidateResult ValidateMempool(const UserRef& ptx) override
         {
-            if (ConsensusRepoInst.Exists_MS1T(*ptx->GetAddress(), { ACCOUNT_USER, ACCOUNT_DELETE }))
+            if (ConsensusRepo().Exists_MS1T(*ptx->GetAddress(), { ACCOUNT_USER, ACCOUNT_DELETE }))
                 return {false, ConsensusResult_ChangeInfoDoubleInMempool};
 
             if (GetChainCount(ptx) > Limits.Get("edit_account_daily_count"))
@@ -142,7 +142,7 @@ namespace PocketConsensus
         virtual bool CheckDeleted(const UserRef& ptx)
         {
             // The deleted account cannot be restored
-            if (auto[ok, type] = ConsensusRepoInst.GetLastAccountType(*ptx->GetAddress()); ok)
+            if (auto[ok, type] = ConsensusRepo().GetLastAccountType(*ptx->GetAddress()); ok)
                 if (type == TxType::ACCOUNT_DELETE)
                     return false;
                     
@@ -167,7 +167,7 @@ namespace PocketConsensus
     protected:
         int GetChainCount(const UserRef& ptx) override
         {
-            return ConsensusRepoInst.CountChainAccount(
+            return ConsensusRepo().CountChainAccount(
                 *ptx->GetType(),
                 *ptx->GetAddress(),
                 Height - (int)Limits.Get("edit_account_depth")
@@ -239,7 +239,7 @@ namespace PocketConsensus
         }
     };
 
-    static AccountUserConsensusFactory ConsensusFactoryInst_AccountUser;
+    static thread_local AccountUserConsensusFactory ConsensusFactoryInst_AccountUser;
 }
 
 #endif // POCKETCONSENSUS_USER_HPP
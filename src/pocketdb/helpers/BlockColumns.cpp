@@ -0,0 +1,179 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include "pocketdb/helpers/BlockColumns.h"
+#include "pocketdb/helpers/DbViewHelper.h"
+
+#include <cstring>
+
+namespace PocketHelpers
+{
+    StringArena::~StringArena()
+    {
+        for (const auto& [data, size] : m_chunks)
+            m_resource->deallocate(data, size, 1);
+    }
+
+    char* StringArena::Allocate(size_t size)
+    {
+        if (m_chunks.empty() || m_chunkUsed + size > m_chunkCapacity)
+        {
+            // Large values get own chunk
+            m_chunkCapacity = max(m_chunkSize, size);
+            m_chunks.reserve(m_chunks.size() + 1);
+            m_chunks.emplace_back(static_cast<char*>(m_resource->allocate(m_chunkCapacity, 1)), m_chunkCapacity);
+            m_chunkUsed = 0;
+        }
+
+        char* result = m_chunks.back().first + m_chunkUsed;
+        m_chunkUsed += size;
+        m_bytes += size;
+        return result;
+    }
+
+    uint32_t StringArena::Append(string_view value)
+    {
+        char* data = value.empty() ? nullptr : Allocate(value.size());
+        if (data)
+            memcpy(data, value.data(), value.size());
+
+        m_values.emplace_back(data ? data : "", value.size());
+        return (uint32_t) (m_values.size() - 1);
+    }
+
+    uint32_t StringArena::Append(const optional<string>& value)
+    {
+        return value ? Append(string_view(*value)) : NO_VALUE;
+    }
+
+    uint32_t StringArena::Intern(string_view value)
+    {
+        if (auto it = m_interned.find(value); it != m_interned.end())
+            return it->second;
+
+        uint32_t index = Append(value);
+        m_interned.emplace(m_values[index], index);
+        return index;
+    }
+
+    uint32_t StringArena::Intern(const optional<string>& value)
+    {
+        return value ? Intern(string_view(*value)) : NO_VALUE;
+    }
+
+    uint32_t StringArena::Find(string_view value) const
+    {
+        auto it = m_interned.find(value);
+        return it == m_interned.end() ? NO_VALUE : it->second;
+    }
+
+    optional<string_view> StringArena::TryGet(uint32_t index) const
+    {
+        if (index == NO_VALUE)
+            return nullopt;
+
+        return m_values[index];
+    }
+
+    bool BlockColumns::Build(const PocketBlock& block)
+    {
+        size_t count = block.size();
+        size_t inputs = 0, outputs = 0;
+        for (const auto& ptx : block)
+        {
+            inputs += ptx->Inputs().size();
+            outputs += ptx->OutputsConst().size();
+        }
+
+        Type.reserve(count);
+        Hash.reserve(count);
+        Time.reserve(count);
+        Int1.reserve(count);
+        for (auto& column : String) column.reserve(count);
+        List.reserve(count);
+        HasPayload.reserve(count);
+        PayloadTxHash.reserve(count);
+        for (auto& column : PayloadString) column.reserve(count);
+        PayloadInt1.reserve(count);
+
+        InputsBegin.reserve(count + 1);
+        InputSpentTxHash.reserve(inputs);
+        InputTxHash.reserve(inputs);
+        InputNumber.reserve(inputs);
+
+        OutputsBegin.reserve(count + 1);
+        OutputNumber.reserve(outputs);
+        OutputAddressHash.reserve(outputs);
+        OutputValue.reserve(outputs);
+        OutputScriptPubKey.reserve(outputs);
+
+        for (const auto& ptx : block)
+        {
+            if (!ptx->GetHash())
+                return false;
+
+            TxContextualData data;
+            if (!DbViewHelper::Extract(data, ptx))
+                return false;
+
+            Type.push_back((int) *ptx->GetType());
+            Hash.push_back(Registry.Intern(ptx->GetHash()));
+            Time.push_back(ptx->GetTime());
+            Int1.push_back(data.int1);
+            String[0].push_back(Registry.Intern(data.string1));
+            String[1].push_back(Registry.Intern(data.string2));
+            String[2].push_back(Registry.Intern(data.string3));
+            String[3].push_back(Registry.Intern(data.string4));
+            String[4].push_back(Registry.Intern(data.string5));
+            List.push_back(Texts.Append(data.list));
+
+            // Same condition as for CollectData - empty payload is not written
+            const auto& payload = ptx->GetPayload();
+            bool hasPayload = payload && (
+                payload->GetString1() || payload->GetString2() || payload->GetString3() || payload->GetString4() ||
+                payload->GetString5() || payload->GetString6() || payload->GetString7() || payload->GetInt1());
+
+            HasPayload.push_back(hasPayload);
+            PayloadTxHash.push_back(hasPayload ? Texts.Append(payload->GetTxHash()) : NO_VALUE);
+            PayloadString[0].push_back(hasPayload ? Texts.Append(payload->GetString1()) : NO_VALUE);
+            PayloadString[1].push_back(hasPayload ? Texts.Append(payload->GetString2()) : NO_VALUE);
+            PayloadString[2].push_back(hasPayload ? Texts.Append(payload->GetString3()) : NO_VALUE);
+            PayloadString[3].push_back(hasPayload ? Texts.Append(payload->GetString4()) : NO_VALUE);
+            PayloadString[4].push_back(hasPayload ? Texts.Append(payload->GetString5()) : NO_VALUE);
+            PayloadString[5].push_back(hasPayload ? Texts.Append(payload->GetString6()) : NO_VALUE);
+            PayloadString[6].push_back(hasPayload ? Texts.Append(payload->GetString7()) : NO_VALUE);
+            PayloadInt1.push_back(hasPayload ? payload->GetInt1() : nullopt);
+
+            InputsBegin.push_back((uint32_t) InputNumber.size());
+            for (const auto& input : ptx->Inputs())
+            {
+                InputSpentTxHash.push_back(Registry.Intern(input.GetSpentTxHash()));
+                InputTxHash.push_back(Registry.Intern(input.GetTxHash()));
+                InputNumber.push_back(input.GetNumber());
+
+                // Only written to Registry
+                Registry.Intern(input.GetAddressHash());
+            }
+
+            OutputsBegin.push_back((uint32_t) OutputNumber.size());
+            for (const auto& output : ptx->OutputsConst())
+            {
+                OutputNumber.push_back(output.GetNumber());
+                OutputAddressHash.push_back(Registry.Intern(output.GetAddressHash()));
+                OutputValue.push_back(output.GetValue());
+                OutputScriptPubKey.push_back(Registry.Intern(output.GetScriptPubKey()));
+
+                // Only written to Registry
+                Registry.Intern(output.GetTxHash());
+                Registry.Intern(output.GetSpentTxHash());
+            }
+        }
+
+        InputsBegin.push_back((uint32_t) InputNumber.size());
+        OutputsBegin.push_back((uint32_t) OutputNumber.size());
+
+        return true;
+    }
+
+} // namespace PocketHelpers
@@ -0,0 +1,123 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETHELPERS_BLOCKCOLUMNS_H
+#define POCKETHELPERS_BLOCKCOLUMNS_H
+
+#include "pocketdb/helpers/TransactionHelper.h"
+
+#include <array>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace PocketHelpers
+{
+    using namespace std;
+
+    // Index of absent value in columns
+    static const uint32_t NO_VALUE = numeric_limits<uint32_t>::max();
+
+    /**
+    * Append-only storage of strings with lifetime of one block. Values are copied into
+    * large chunks and referenced by index, views stay valid until the arena is destroyed.
+    * Interned values are stored once. Memory is taken from `resource`, by default
+    * from pmr::get_default_resource() at construction.
+    */
+    class StringArena
+    {
+    public:
+        explicit StringArena(size_t chunkSize = 256 * 1024, pmr::memory_resource* resource = pmr::get_default_resource())
+            : m_chunkSize(chunkSize), m_resource(resource), m_chunks(resource), m_values(resource), m_interned(resource)
+        {
+        }
+        ~StringArena();
+
+        StringArena(const StringArena&) = delete;
+        StringArena& operator=(const StringArena&) = delete;
+
+        uint32_t Append(string_view value);
+        uint32_t Append(const optional<string>& value);
+
+        // Index of equal value if already interned
+        uint32_t Intern(string_view value);
+        uint32_t Intern(const optional<string>& value);
+
+        // Index of interned value or NO_VALUE
+        uint32_t Find(string_view value) const;
+
+        string_view Get(uint32_t index) const { return m_values[index]; }
+        optional<string_view> TryGet(uint32_t index) const;
+
+        size_t Size() const { return m_values.size(); }
+        size_t Bytes() const { return m_bytes; }
+        size_t Chunks() const { return m_chunks.size(); }
+
+    private:
+        size_t m_chunkSize;
+        pmr::memory_resource* m_resource;
+        pmr::vector<pair<char*, size_t>> m_chunks;
+        size_t m_chunkUsed = 0;
+        size_t m_chunkCapacity = 0;
+        size_t m_bytes = 0;
+
+        pmr::vector<string_view> m_values;
+        pmr::unordered_map<string_view, uint32_t> m_interned;
+
+        char* Allocate(size_t size);
+    };
+
+    /**
+    * Column-oriented copy of PocketBlock fields written to the database. Strings are held
+    * by two arenas and columns keep their indexes, so a block is built with a few allocations
+    * instead of copies of every transaction, input, output and payload. Registry holds
+    * distinct strings of Registry table, resolved to ids once per block.
+    * Columns and arenas allocate from pmr::get_default_resource() at construction.
+    */
+    class BlockColumns
+    {
+    public:
+        StringArena Registry;
+        // Payloads and lists - not interned
+        StringArena Texts;
+
+        // Transactions
+        pmr::vector<int> Type;
+        pmr::vector<uint32_t> Hash;
+        pmr::vector<optional<int64_t>> Time;
+        pmr::vector<optional<int>> Int1;
+        array<pmr::vector<uint32_t>, 5> String;
+        pmr::vector<uint32_t> List;
+
+        // Payloads, values of transactions without payload are not used
+        pmr::vector<bool> HasPayload;
+        pmr::vector<uint32_t> PayloadTxHash;
+        array<pmr::vector<uint32_t>, 7> PayloadString;
+        pmr::vector<optional<int64_t>> PayloadInt1;
+
+        // Inputs and outputs of transaction i are in [Begin[i], Begin[i + 1])
+        pmr::vector<uint32_t> InputsBegin;
+        pmr::vector<uint32_t> InputSpentTxHash;
+        pmr::vector<uint32_t> InputTxHash;
+        pmr::vector<optional<int64_t>> InputNumber;
+
+        pmr::vector<uint32_t> OutputsBegin;
+        pmr::vector<optional<int64_t>> OutputNumber;
+        pmr::vector<uint32_t> OutputAddressHash;
+        pmr::vector<optional<int64_t>> OutputValue;
+        pmr::vector<uint32_t> OutputScriptPubKey;
+
+        size_t Count() const { return Type.size(); }
+
+        // Returns false if transaction has no hash or can not be mapped to database view
+        bool Build(const PocketBlock& block);
+    };
+
+} // namespace PocketHelpers
+
+#endif // POCKETHELPERS_BLOCKCOLUMNS_H
@@ -0,0 +1,144 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include "pocketdb/helpers/JsonWriter.h"
+
+namespace PocketHelpers
+{
+    JsonWriter::JsonWriter(size_t reserve)
+    {
+        m_buffer.reserve(reserve);
+    }
+
+    void JsonWriter::Separate()
+    {
+        if (m_afterKey)
+        {
+            m_afterKey = false;
+            return;
+        }
+
+        if (m_levels.empty())
+            return;
+
+        if (m_levels.back()++ > 0)
+            m_buffer += ',';
+    }
+
+    // Same escaping as univalue json_escape
+    void JsonWriter::Escape(std::string_view value)
+    {
+        static const char hex[] = "0123456789abcdef";
+
+        m_buffer += '"';
+        for (unsigned char ch : value)
+        {
+            switch (ch)
+            {
+                case '"': m_buffer += "\\\""; break;
+                case '\\': m_buffer += "\\\\"; break;
+                case '\b': m_buffer += "\\b"; break;
+                case '\t': m_buffer += "\\t"; break;
+                case '\n': m_buffer += "\\n"; break;
+                case '\f': m_buffer += "\\f"; break;
+                case '\r': m_buffer += "\\r"; break;
+                default:
+                    if (ch < 0x20 || ch == 0x7f)
+                    {
+                        m_buffer += "\\u00";
+                        m_buffer += hex[ch >> 4];
+                        m_buffer += hex[ch & 0x0f];
+                    }
+                    else
+                    {
+                        m_buffer += (char) ch;
+                    }
+                    break;
+            }
+        }
+        m_buffer += '"';
+    }
+
+    JsonWriter& JsonWriter::BeginObject()
+    {
+        Separate();
+        m_buffer += '{';
+        m_levels.push_back(0);
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::EndObject()
+    {
+        m_levels.pop_back();
+        m_buffer += '}';
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::BeginArray()
+    {
+        Separate();
+        m_buffer += '[';
+        m_levels.push_back(0);
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::EndArray()
+    {
+        m_levels.pop_back();
+        m_buffer += ']';
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::Key(std::string_view key)
+    {
+        Separate();
+        Escape(key);
+        m_buffer += ':';
+        m_afterKey = true;
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::String(std::string_view value)
+    {
+        Separate();
+        Escape(value);
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::Int(int64_t value)
+    {
+        Separate();
+        m_buffer += std::to_string(value);
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::Bool(bool value)
+    {
+        Separate();
+        m_buffer += value ? "true" : "false";
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::Null()
+    {
+        Separate();
+        m_buffer += "null";
+        return *this;
+    }
+
+    JsonWriter& JsonWriter::Raw(std::string_view json)
+    {
+        Separate();
+        m_buffer += json;
+        return *this;
+    }
+
+    std::string JsonWriter::Release()
+    {
+        m_levels.clear();
+        m_afterKey = false;
+        return std::move(m_buffer);
+    }
+
+} // namespace PocketHelpers
@@ -0,0 +1,70 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETHELPERS_JSONWRITER_H
+#define POCKETHELPERS_JSONWRITER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+namespace PocketHelpers
+{
+    /**
+    * Streaming JSON writer over a single output buffer.
+    * Used for large web RPC results to write columns of sqlite cursor directly
+    * without building intermediate UniValue trees.
+    * Output is byte-identical to UniValue::write() without indentation.
+    */
+    class JsonWriter
+    {
+    public:
+        explicit JsonWriter(size_t reserve = 4096);
+
+        JsonWriter& BeginObject();
+        JsonWriter& EndObject();
+        JsonWriter& BeginArray();
+        JsonWriter& EndArray();
+
+        JsonWriter& Key(std::string_view key);
+
+        JsonWriter& String(std::string_view value);
+        JsonWriter& Int(int64_t value);
+        JsonWriter& Bool(bool value);
+        JsonWriter& Null();
+        // Already serialized JSON value
+        JsonWriter& Raw(std::string_view json);
+
+        // Shortcuts for object members
+        template <class T>
+        JsonWriter& Member(std::string_view key, const T& value)
+        {
+            Key(key);
+            return Value(value);
+        }
+
+        const std::string& Buffer() const { return m_buffer; }
+        std::string Release();
+
+    private:
+        std::string m_buffer;
+        // Count of values written on each nesting level
+        std::vector<int> m_levels;
+        bool m_afterKey = false;
+
+        void Separate();
+        void Escape(std::string_view value);
+
+        JsonWriter& Value(std::string_view value) { return String(value); }
+        JsonWriter& Value(const std::string& value) { return String(value); }
+        JsonWriter& Value(const char* value) { return String(value); }
+        JsonWriter& Value(bool value) { return Bool(value); }
+        JsonWriter& Value(int value) { return Int(value); }
+        JsonWriter& Value(int64_t value) { return Int(value); }
+    };
+
+} // namespace PocketHelpers
+
+#endif // POCKETHELPERS_JSONWRITER_H
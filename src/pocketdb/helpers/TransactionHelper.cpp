@@ -22,6 +22,18 @@ namespace PocketHelpers
         return "";
     }
 
+    // Address saved to TxOutputs - last of the script destinations
+    std::string TransactionHelper::ExtractOutputAddress(const CScript& scriptPubKey)
+    {
+        TxoutType type;
+        std::vector<CTxDestination> vDest;
+        int nRequired;
+        if (!ExtractDestinations(scriptPubKey, type, vDest, nRequired) || vDest.empty())
+            return "";
+
+        return EncodeDestination(vDest.back());
+    }
+
     tuple<bool, string> TransactionHelper::GetPocketAuthorAddress(const CTransactionRef& tx)
     {
         if (tx->vout.size() < 2)
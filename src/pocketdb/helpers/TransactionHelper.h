@@ -70,6 +70,7 @@ namespace PocketHelpers
     public:
         static TxoutType ScriptType(const CScript& scriptPubKey);
         static std::string ExtractDestination(const CScript& scriptPubKey);
+        static std::string ExtractOutputAddress(const CScript& scriptPubKey);
         static tuple<bool, string> GetPocketAuthorAddress(const CTransactionRef& tx);
         static TxType ConvertOpReturnToType(const string& op);
         static string ParseAsmType(const CTransactionRef& tx, vector<string>& vasm);
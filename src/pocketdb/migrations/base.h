@@ -21,6 +21,7 @@ namespace PocketDb
         string _preProcessing;
         string _indexes;
         string _requiredIndexes;
+        string _deferredIndexes;
         string _postProcessing;
 
     public:
@@ -32,6 +33,7 @@ namespace PocketDb
         string& PreProcessing() { return _preProcessing; }
         string& Indexes() { return _indexes; }
         string& RequiredIndexes() { return _requiredIndexes; }
+        string& DeferredIndexes() { return _deferredIndexes; }
         string& PostProcessing() { return _postProcessing; }
     };
 
@@ -249,6 +249,16 @@ namespace PocketDb
             );
         )sql");
 
+        _tables.emplace_back(R"sql(
+            create table if not exists BalancesJournal
+            (
+                Height      int not null,
+                AddressId   int not null,
+                Value       int not null,
+                primary key (Height, AddressId)
+            );
+        )sql");
+
         _tables.emplace_back(R"sql(
             create table if not exists BlockingLists
             (
@@ -323,6 +333,27 @@ namespace PocketDb
             ) without rowid;
         )sql");
 
+        // Materialized feed - one record per content with state of the last content version.
+        // Updated incrementally with connecting and disconnecting blocks.
+        _tables.emplace_back(R"sql(
+            create table if not exists Feed
+            (
+                -- Chain.Uid of content
+                Uid         integer primary key,
+                -- Transactions.RowId of last content version
+                TxId        int     not null,
+                Type        int     not null,
+                -- Payload.String1 of last content version
+                Lang        text    not null,
+                -- Height of last content version
+                Height      int     not null,
+                -- Height of first content version
+                OrigHeight  int     not null,
+                -- Ratings.Value for content (Type = 2) or null if content not rated
+                Rating      int     null
+            );
+        )sql");
+
         _views.emplace_back(R"sql(
             drop view if exists vBadges;
 
@@ -406,31 +437,26 @@ namespace PocketDb
             create index if not exists Chain_Height_BlockNum on Chain (Height desc, BlockNum desc);
             create index if not exists Chain_BlockId_Height on Chain (BlockId, Height);
             create index if not exists Chain_TxId_Height on Chain (TxId, Height);
-            create index if not exists Chain_HeightByDay on Chain (Height / 1440 desc);
-            create index if not exists Chain_HeightByHour on Chain (Height / 60 desc);
-
 
             create index if not exists Transactions_Type_RegId1_RegId2_RegId3 on Transactions (Type, RegId1, RegId2, RegId3);
             create index if not exists Transactions_Type_RegId1_RegId3 on Transactions (Type, RegId1, RegId3);
             create index if not exists Transactions_Type_RegId2_RegId1 on Transactions (Type, RegId2, RegId1);
             create index if not exists Transactions_Type_RegId3_RegId1 on Transactions (Type, RegId3, RegId1);
-            create index if not exists Transactions_Type_RegId5_RegId1 on Transactions (Type, RegId5, RegId1);
-            create index if not exists Transactions_Type_RegId4_RegId1 on Transactions (Type, RegId4, RegId1);
             create index if not exists Transactions_Type_RegId1_Int1_Time on Transactions (Type, RegId1, Int1, Time);
             create index if not exists Transactions_Type_RegId1_Time on Transactions (Type, RegId1, Time);
-            create index if not exists Transactions_Type_RegId3_RegId4_RegId5 on Transactions(Type, RegId3, RegId4, RegId5);
-            create index if not exists Transactions_RowId_desc_Type on Transactions(RowId desc, Type);
 
             create index if not exists TxInputs_SpentTxId_Number_TxId on TxInputs (SpentTxId, Number, TxId);
             create index if not exists TxInputs_TxId_Number_SpentTxId on TxInputs (TxId, Number, SpentTxId);
 
             create index if not exists TxOutputs_TxId_Number_AddressId on TxOutputs (TxId, Number, AddressId);
-            create index if not exists TxOutputs_AddressId_TxIdDesc_Number on TxOutputs (AddressId, TxId desc, Number);
 
             create unique index if not exists Lists_TxId_OrderIndex_RegId on Lists (TxId, OrderIndex asc, RegId);
 
             create index if not exists BlockingLists_IdTarget_IdSource on BlockingLists (IdTarget, IdSource);
 
+            -- Consensus checks of unique account names
+            create index if not exists Payload_String2_nocase on Payload (String2 collate nocase);
+
             ------------------------------
 
             create index if not exists Ratings_Last_Uid_Height on Ratings (Last, Uid, Height);
@@ -440,12 +466,6 @@ namespace PocketDb
             create index if not exists Ratings_Type_Uid_Last_Value on Ratings (Type, Uid, Last, Value);
             create index if not exists Ratings_Type_Uid_Height_Value on Ratings (Type, Uid, Height, Value);
 
-            create index if not exists Balances_Value on Balances (Value);
-
-            create index if not exists Payload_String2_nocase on Payload (String2 collate nocase);
-            create index if not exists Payload_String7 on Payload (String7);
-            create index if not exists Payload_String1 on Payload (String1);
-
             create index if not exists Jury_AccountId_Reason on Jury (AccountId, Reason);
             create index if not exists JuryBan_AccountId_Ending on JuryBan (AccountId, Ending);
             create index if not exists JuryVerdict_VoteRowId_FlagRowId_Verdict on JuryVerdict (VoteRowId, FlagRowId, Verdict);
@@ -455,12 +475,69 @@ namespace PocketDb
 
             create index if not exists SocialRegistry_Type_AddressId on SocialRegistry (Type, AddressId);
             create index if not exists SocialRegistry_Height on SocialRegistry (Height);
+        )sql";
+
+        // Indexes used only by web queries.
+        // In bulk load mode they are skipped during initial sync and built after the chain tip is reached.
+        _deferredIndexes = R"sql(
+            create index if not exists Chain_HeightByDay on Chain (Height / 1440 desc);
+            create index if not exists Chain_HeightByHour on Chain (Height / 60 desc);
+
+            create index if not exists Transactions_Type_RegId5_RegId1 on Transactions (Type, RegId5, RegId1);
+            create index if not exists Transactions_Type_RegId4_RegId1 on Transactions (Type, RegId4, RegId1);
+            create index if not exists Transactions_Type_RegId3_RegId4_RegId5 on Transactions(Type, RegId3, RegId4, RegId5);
+            create index if not exists Transactions_RowId_desc_Type on Transactions(RowId desc, Type);
+
+            create index if not exists TxOutputs_AddressId_TxIdDesc_Number on TxOutputs (AddressId, TxId desc, Number);
+
+            create index if not exists Balances_Value on Balances (Value);
 
+            create index if not exists Payload_String7 on Payload (String7);
+            create index if not exists Payload_String1 on Payload (String1);
 
+            create index if not exists Feed_Height_Lang on Feed (Height, Lang);
+            create index if not exists Feed_Lang_Height on Feed (Lang, Height);
+            create index if not exists Feed_TxId on Feed (TxId);
+            create index if not exists Feed_Lang_TxId on Feed (Lang, TxId);
         )sql";
 
         _postProcessing = R"sql(
-
+            -- Fill materialized feed for databases created before Feed table
+            insert or ignore into Feed (Uid, TxId, Type, Lang, Height, OrigHeight, Rating)
+            select
+                c.Uid,
+                t.RowId,
+                t.Type,
+                ifnull(p.String1, ''),
+                c.Height,
+                corig.Height,
+                (
+                    select
+                        r.Value
+                    from
+                        Ratings r
+                    where
+                        r.Type = 2 and
+                        r.Uid = c.Uid and
+                        r.Last = 1
+                )
+            from
+                Last l
+            cross join
+                Transactions t on
+                    t.RowId = l.TxId and
+                    t.Type in (200, 201, 202, 209, 210, 220)
+            cross join
+                Chain c on
+                    c.TxId = t.RowId
+            cross join
+                Chain corig on
+                    corig.TxId = t.RegId2
+            left join
+                Payload p on
+                    p.TxId = t.RowId
+            where
+                not exists (select 1 from Feed);
         )sql";
     }
 }
\ No newline at end of file
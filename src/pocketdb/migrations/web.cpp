@@ -97,6 +97,26 @@ namespace PocketDb
             );
         )sql");
 
+        _tables.emplace_back(R"sql(
+            create table if not exists AccountStatisticJournal
+            (
+                Height int not null,
+                AccountRegId int not null,
+                Type int not null,
+                -- Value before block, null if not exists
+                Data any null,
+                primary key (Height, AccountRegId, Type)
+            );
+        )sql");
+
+        _tables.emplace_back(R"sql(
+            create table if not exists ProcessedBlocks
+            (
+                Height int primary key,
+                Hash text not null
+            );
+        )sql");
+
         //
         // INDEXES
         //
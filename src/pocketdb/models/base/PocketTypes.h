@@ -169,6 +169,8 @@ namespace PocketTx
         int64_t Time;
         TxType Type;
         vector<pair<string, int>> Inputs;
+        // Address and value of each output
+        vector<pair<string, int64_t>> Outputs;
 
         bool IsAccount() const
         {
@@ -16,6 +16,8 @@ namespace PocketDb
     MigrationRepository MigrationRepoInst(SQLiteDbInst, false);
 
     CheckpointRepository CheckpointRepoInst;
+
+    SQLiteConnectionPool SQLiteConnectionPoolInst;
 } // PocketDb
 
 namespace PocketWeb
@@ -26,5 +28,5 @@ namespace PocketWeb
 namespace PocketServices
 {
     WebPostProcessor WebPostProcessorInst;
-    // WalController WalControllerInst;
+    IndexBuilder IndexBuilderInst;
 } // namespace PocketServices
\ No newline at end of file
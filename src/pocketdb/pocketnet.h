@@ -26,8 +26,11 @@
 #include "pocketdb/repositories/web/ExplorerRepository.h"
 #include "pocketdb/repositories/web/NotifierRepository.h"
 
+#include "pocketdb/SQLiteConnectionPool.h"
+
 #include "pocketdb/web/PocketFrontend.h"
 #include "pocketdb/services/WebPostProcessing.h"
+#include "pocketdb/services/IndexBuilder.h"
 #include "pocketdb/services/WalController.h"
 
 namespace PocketDb
@@ -42,13 +45,15 @@ namespace PocketDb
     extern ExplorerRepository ExplorerRepoInst;
 
     extern CheckpointRepository CheckpointRepoInst;
+
+    extern SQLiteConnectionPool SQLiteConnectionPoolInst;
     
 } // namespace PocketDb
 
 namespace PocketServices
 {
     extern WebPostProcessor WebPostProcessorInst;
-    // extern WalController WalControllerInst;
+    extern IndexBuilder IndexBuilderInst;
 } // namespace PocketServices
 
 namespace PocketWeb
@@ -23,21 +23,14 @@ namespace PocketDb
 
     Stmt& BaseRepository::Sql(const string& sql)
     {
-        auto itr = _statements.find(sql);
-        if (itr == _statements.end())
-        {
-            auto stmt = make_shared<Stmt>();
-            stmt->Init(m_database, sql);
-            itr = _statements.emplace(sql, std::move(stmt)).first;
-        }
-
-        return *itr->second;
+        return m_database.Statements().Get(m_database, sql);
     }
 
     Stmt BaseRepository::SqlSingleton(const string& sql)
     {
+        // Hints to deferred indexes that are not built yet fail the prepare
         Stmt stmt;
-        stmt.Init(m_database, sql);
+        stmt.Init(m_database, SQLiteDatabase::HasMissingIndexes() ? SQLiteDatabase::RemoveMissingIndexHints(sql) : sql);
         return stmt;
     }
 
@@ -51,5 +44,140 @@ namespace PocketDb
         return sqlite3_last_insert_rowid(m_database.m_db);
     }
 
+    unordered_map<string, int64_t> BaseRepository::SelectRegistryIds(const vector<string>& strings, bool publish)
+    {
+        unordered_map<string, int64_t> result;
+
+        UniValue missed(UniValue::VARR);
+        for (const auto& str : strings)
+        {
+            int64_t id;
+            if (RegistryCacheInst.GetId(str, id))
+                result.emplace(str, id);
+            else
+                missed.push_back(str);
+        }
+
+        if (missed.empty())
+            return result;
+
+        Sql(R"sql(
+            select
+                r.String,
+                r.RowId
+            from
+                Registry r indexed by Registry_String
+            where
+                r.String in (select value from json_each(?))
+        )sql")
+        .Bind(missed.write())
+        .Select([&](Cursor& cursor) {
+            while (cursor.Step())
+            {
+                auto[ok0, str] = cursor.TryGetColumnString(0);
+                auto[ok1, id] = cursor.TryGetColumnInt64(1);
+                if (!ok0 || !ok1)
+                    continue;
+
+                if (publish)
+                    RegistryCacheInst.Put(str, id);
+
+                result.emplace(str, id);
+            }
+        });
+
+        return result;
+    }
+
+    vector<optional<int64_t>> BaseRepository::SelectRegistryIds(const StringArena& strings, vector<uint32_t>& selected)
+    {
+        vector<optional<int64_t>> result(strings.Size());
+
+        UniValue missed(UniValue::VARR);
+        for (uint32_t i = 0; i < strings.Size(); i++)
+        {
+            int64_t id;
+            if (RegistryCacheInst.GetId(strings.Get(i), id))
+                result[i] = id;
+            else
+                missed.push_back(string(strings.Get(i)));
+        }
+
+        if (missed.empty())
+            return result;
+
+        Sql(R"sql(
+            select
+                r.String,
+                r.RowId
+            from
+                Registry r indexed by Registry_String
+            where
+                r.String in (select value from json_each(?))
+        )sql")
+        .Bind(missed.write())
+        .Select([&](Cursor& cursor) {
+            while (cursor.Step())
+            {
+                auto[ok0, str] = cursor.TryGetColumnStringView(0);
+                auto[ok1, id] = cursor.TryGetColumnInt64(1);
+                if (!ok0 || !ok1)
+                    continue;
+
+                if (auto index = strings.Find(str); index != NO_VALUE)
+                {
+                    result[index] = id;
+                    selected.push_back(index);
+                }
+            }
+        });
+
+        return result;
+    }
+
+    unordered_map<int64_t, string> BaseRepository::SelectRegistryStrings(const vector<int64_t>& ids, bool publish)
+    {
+        unordered_map<int64_t, string> result;
+
+        UniValue missed(UniValue::VARR);
+        for (const auto& id : ids)
+        {
+            string str;
+            if (RegistryCacheInst.GetString(id, str))
+                result.emplace(id, str);
+            else
+                missed.push_back(id);
+        }
+
+        if (missed.empty())
+            return result;
+
+        Sql(R"sql(
+            select
+                r.RowId,
+                r.String
+            from
+                Registry r
+            where
+                r.RowId in (select value from json_each(?))
+        )sql")
+        .Bind(missed.write())
+        .Select([&](Cursor& cursor) {
+            while (cursor.Step())
+            {
+                auto[ok0, id] = cursor.TryGetColumnInt64(0);
+                auto[ok1, str] = cursor.TryGetColumnString(1);
+                if (!ok0 || !ok1)
+                    continue;
+
+                if (publish)
+                    RegistryCacheInst.Put(str, id);
+
+                result.emplace(id, str);
+            }
+        });
+
+        return result;
+    }
 
 } // namespace PocketDb
@@ -12,7 +12,9 @@
 
 #include "shutdown.h"
 #include "pocketdb/SQLiteDatabase.h"
+#include "pocketdb/RegistryCache.h"
 #include "pocketdb/helpers/TransactionHelper.h"
+#include "pocketdb/helpers/BlockColumns.h"
 #include "pocketdb/stmt.h"
 
 namespace PocketDb
@@ -30,9 +32,6 @@ namespace PocketDb
 
     class BaseRepository
     {
-    private:
-        unordered_map<string, shared_ptr<Stmt>> _statements;
-
     protected:
         SQLiteDatabase& m_database;
         bool m_timeouted;
@@ -153,6 +152,14 @@ namespace PocketDb
 
         void BenchLog(const string& func, double time);
 
+        // Registry ids of strings and strings of ids, RegistryCacheInst is checked first.
+        // Must be called inside SqlTransaction. Values selected from the database are published
+        // to the cache only with `publish` - a writer must not publish its own uncommitted inserts.
+        unordered_map<string, int64_t> SelectRegistryIds(const vector<string>& strings, bool publish);
+        unordered_map<int64_t, string> SelectRegistryStrings(const vector<int64_t>& ids, bool publish);
+        // Ids of all arena values by index of value, new ids are returned in `selected`
+        vector<optional<int64_t>> SelectRegistryIds(const StringArena& strings, vector<uint32_t>& selected);
+
     public:
 
         explicit BaseRepository(SQLiteDatabase& db, bool timeouted) : m_database(db), m_timeouted(timeouted)
@@ -163,10 +170,8 @@ namespace PocketDb
 
         virtual void Init() { }
 
-        virtual void Destroy()
-        {
-            _statements.clear();
-        }
+        // Prepared statements are owned by the connection and finalized in SQLiteDatabase::Close
+        virtual void Destroy() { }
     };
 }
 
@@ -49,12 +49,28 @@ namespace PocketDb
 {
     void ChainRepository::IndexBlock(const string& blockHash, int height, vector<TransactionIndexingInfo>& txs)
     {
+        unordered_map<string, int64_t> ids;
+
         SqlTransaction(__func__, [&]()
         {
             int64_t nTime1 = GetTimeMicros();
 
             IndexBlockData(blockHash);
 
+            // Ids of block and transactions hashes with one query, published to cache after commit
+            vector<string> hashes { blockHash };
+            for (const auto& txInfo : txs)
+                hashes.push_back(txInfo.Hash);
+
+            ids = SelectRegistryIds(hashes, false);
+            auto registryId = [&](const string& hash) -> optional<int64_t> {
+                if (auto it = ids.find(hash); it != ids.end())
+                    return it->second;
+                return nullopt;
+            };
+
+            auto blockId = registryId(blockHash);
+
             // Each transaction is processed individually
             for (const auto& txInfo : txs)
             {
@@ -75,29 +91,32 @@ namespace PocketDb
                 // if not 'lastTxId' means that this is first tx for this id
                 if (id && !lastTxId)
                 {
-                    SetFirst(txInfo.Hash);
+                    SetFirst(registryId(txInfo.Hash));
                 }
 
                 IndexSocialRegistryTx(txInfo, height, !lastTxId.has_value());
 
                 // All transactions must have a blockHash & height relation
                 InsertTransactionChainData(
-                    blockHash,
+                    blockId,
                     txInfo.BlockNumber,
                     height,
-                    txInfo.Hash,
+                    registryId(txInfo.Hash),
                     id
                 );
             }
 
             // After set height and mark inputs as spent we need recalculcate balances
-            IndexBalances(height);
+            IndexBalances(height, txs, ids);
 
             EnsureAndTrimSocialRegistry(height + 1); // Count for next block
 
             int64_t nTime2 = GetTimeMicros();
             LogPrint(BCLog::BENCH, "    - IndexBlock: %.2fms\n", 0.001 * double(nTime2 - nTime1));
         });
+
+        for (const auto& [hash, id] : ids)
+            RegistryCacheInst.Put(hash, id);
     }
 
     tuple<bool, bool> ChainRepository::ExistsBlock(const string& blockHash, int height)
@@ -184,35 +203,20 @@ namespace PocketDb
         .Run();
     }
 
-    void ChainRepository::InsertTransactionChainData(const string& blockHash, int blockNumber, int height, const string& txHash, const optional<int64_t>& id)
+    void ChainRepository::InsertTransactionChainData(const optional<int64_t>& blockId, int blockNumber, int height, const optional<int64_t>& txId, const optional<int64_t>& id)
     {
         Sql(R"sql(
-            with
-                block as (
-                    select
-                        RowId
-                    from
-                        Registry
-                    where
-                        String = ?
-                ),
-                tx as (
-                    select
-                        t.RowId
-                    from
-                        vTx t
-                    where
-                        t.Hash = ?
-                )
             insert or fail into Chain
                 (TxId, BlockId, BlockNum, Height, Uid)
             select
-                tx.RowId, block.RowId, ?, ?, ?
+                t.RowId, ?, ?, ?, ?
             from
-                tx,
-                block
+                Transactions t
+            where
+                t.RowId = ? and
+                ? is not null
         )sql")
-        .Bind(blockHash, txHash, blockNumber, height, id)
+        .Bind(blockId, blockNumber, height, id, txId, blockId)
         .Run();
 
         if (id.has_value())
@@ -223,16 +227,16 @@ namespace PocketDb
                 select
                     t.RowId
                 from
-                    vTx t
+                    Transactions t
                 where
-                    t.Hash = ?
+                    t.RowId = ?
             )sql")
-            .Bind(txHash)
+            .Bind(txId)
             .Run();
         }
     }
 
-    void ChainRepository::SetFirst(const string& txHash)
+    void ChainRepository::SetFirst(const optional<int64_t>& txId)
     {
         Sql(R"sql(
             insert or ignore into First
@@ -240,76 +244,128 @@ namespace PocketDb
             select
                 t.RowId
             from
-                vTx t
+                Transactions t
             where
-                t.Hash = ?
+                t.RowId = ?
         )sql")
-        .Bind(txHash)
+        .Bind(txId)
         .Run();
     }
 
-    void ChainRepository::IndexBalances(int height)
+    void ChainRepository::IndexBalances(int height, const vector<TransactionIndexingInfo>& txs, unordered_map<string, int64_t>& ids)
     {
-        // Generate new balance records
-        Sql(R"sql(
-            with
-                height as (
-                    select ? as value
-                ),
-                outs as (
-                    select
-                        o.TxId,
-                        o.Number,
-                        o.AddressId,
-                        (+o.Value)val
-                    from
-                        height,
-                        Chain c indexed by Chain_Height_Uid
-                        cross join TxOutputs o indexed by TxOutputs_TxId_Number_AddressId
-                            on o.TxId = c.TxId
-                    where
-                        c.Height = height.value
+        // Outputs addresses and spent transactions resolved with one query
+        vector<string> strings;
+        for (const auto& txInfo : txs)
+        {
+            for (const auto& [address, value] : txInfo.Outputs)
+                strings.push_back(address);
+            for (const auto& [txHash, number] : txInfo.Inputs)
+                strings.push_back(txHash);
+        }
 
-                    union
+        for (auto& [str, id] : SelectRegistryIds(strings, false))
+            ids.emplace(str, id);
 
-                    select
-                        o.TxId,
-                        o.Number,
-                        o.AddressId,
-                        (-o.Value)val
-                    from
-                        height,
-                        Chain ci indexed by Chain_Height_Uid
-                        cross join TxInputs i indexed by TxInputs_SpentTxId_Number_TxId
-                            on i.SpentTxId = ci.TxId
-                        cross join TxOutputs o indexed by TxOutputs_TxId_Number_AddressId
-                            on o.TxId = i.TxId and o.Number = i.Number
-                    where
-                        ci.Height = height.value
-                ),
-                saldo as (
-                    select
-                        outs.AddressId,
-                        sum(outs.val)Amount
-                    from
-                        outs
-                    group by
-                        outs.AddressId
-                )
+        map<int64_t, int64_t> deltas;
+
+        // Received amounts are taken from block as is
+        for (const auto& txInfo : txs)
+        {
+            for (const auto& [address, value] : txInfo.Outputs)
+            {
+                if (auto it = ids.find(address); it != ids.end())
+                    deltas[it->second] += value;
+            }
+        }
+
+        // Spent amounts are selected from outputs of previous transactions
+        UniValue spent(UniValue::VARR);
+        for (const auto& txInfo : txs)
+        {
+            for (const auto& [txHash, number] : txInfo.Inputs)
+            {
+                if (auto it = ids.find(txHash); it != ids.end())
+                {
+                    UniValue inp(UniValue::VARR);
+                    inp.push_back(it->second);
+                    inp.push_back(number);
+                    spent.push_back(inp);
+                }
+            }
+        }
+
+        if (!spent.empty())
+        {
+            Sql(R"sql(
+                select
+                    o.AddressId,
+                    o.Value
+                from
+                    json_each(?) j
+                    cross join TxOutputs o indexed by TxOutputs_TxId_Number_AddressId
+                        on o.TxId = json_extract(j.value, '$[0]') and o.Number = json_extract(j.value, '$[1]')
+            )sql")
+            .Bind(spent.write())
+            .Select([&](Cursor& cursor) {
+                while (cursor.Step())
+                {
+                    auto[ok0, addressId] = cursor.TryGetColumnInt64(0);
+                    auto[ok1, value] = cursor.TryGetColumnInt64(1);
+                    if (ok0 && ok1)
+                        deltas[addressId] -= value;
+                }
+            });
+        }
 
+        UniValue journal(UniValue::VARR);
+        for (const auto& [addressId, value] : deltas)
+        {
+            if (value == 0)
+                continue;
+
+            UniValue delta(UniValue::VARR);
+            delta.push_back(addressId);
+            delta.push_back(value);
+            journal.push_back(delta);
+        }
+
+        // Save deltas of block for rollback
+        Sql(R"sql(
+            replace into BalancesJournal (Height, AddressId, Value)
+            select
+                ?,
+                json_extract(j.value, '$[0]'),
+                json_extract(j.value, '$[1]')
+            from
+                json_each(?) j
+        )sql")
+        .Bind(height, journal.write())
+        .Run();
+
+        // Apply deltas with one statement
+        Sql(R"sql(
             replace into Balances (AddressId, Value)
             select
-                saldo.AddressId,
-                ifnull(b.Value, 0) + saldo.Amount
+                j.AddressId,
+                ifnull(b.Value, 0) + j.Value
             from
-                saldo
+                BalancesJournal j
                 left join Balances b
-                    on b.AddressId = saldo.AddressId
+                    on b.AddressId = j.AddressId
             where
-                saldo.Amount != 0
+                j.Height = ?
         )sql")
         .Bind(height)
         .Run();
+
+        // Journal is needed only for the depth of possible rollback
+        Sql(R"sql(
+            delete from BalancesJournal
+            where Height <= ?
+        )sql")
+        .Bind(height - BALANCES_JOURNAL_DEPTH)
+        .Run();
     }
 
     void ChainRepository::IndexSocialRegistryTx(const TransactionIndexingInfo& txInfo, int height, bool isFirst)
@@ -1367,6 +1423,133 @@ namespace PocketDb
         .Run();
     }
 
+    void ChainRepository::IndexFeed(int height)
+    {
+        SqlTransaction(__func__, [&]()
+        {
+            RebuildFeed(height, height + 1);
+        });
+    }
+
+    void ChainRepository::RestoreFeed(int height)
+    {
+        RebuildFeed(height, height);
+    }
+
+    void ChainRepository::RebuildFeed(int height, int actualHeight)
+    {
+        string uidsSql = R"sql(
+            select
+                c.Uid
+            from
+                height,
+                Chain c indexed by Chain_Height_Uid
+            where
+                c.Height >= height.value and
+                c.Uid is not null
+
+            union
+
+            select
+                r.Uid
+            from
+                height,
+                Ratings r indexed by Ratings_Height_Last
+            where
+                r.Height >= height.value and
+                r.Type = 2
+        )sql";
+
+        Sql(R"sql(
+            with
+                height as (
+                    select ? as value
+                ),
+                uids as (
+                    )sql" + uidsSql + R"sql(
+                )
+            delete from Feed
+            where
+                Uid in (select Uid from uids)
+        )sql")
+        .Bind(height)
+        .Run();
+
+        // Feed record is built from last content version and last content rating
+        // existing before actualHeight
+        Sql(R"sql(
+            with
+                height as (
+                    select ? as value
+                ),
+                actual as (
+                    select ? as value
+                ),
+                uids as (
+                    )sql" + uidsSql + R"sql(
+                ),
+                last as (
+                    select
+                        uids.Uid,
+                        (
+                            select
+                                c.TxId
+                            from
+                                Chain c indexed by Chain_Uid_Height
+                            where
+                                c.Uid = uids.Uid and
+                                c.Height < actual.value
+                            order by
+                                c.Height desc
+                            limit 1
+                        ) as TxId
+                    from
+                        actual,
+                        uids
+                )
+            insert into
+                Feed (Uid, TxId, Type, Lang, Height, OrigHeight, Rating)
+            select
+                last.Uid,
+                t.RowId,
+                t.Type,
+                ifnull(p.String1, ''),
+                c.Height,
+                corig.Height,
+                (
+                    select
+                        r.Value
+                    from
+                        Ratings r indexed by Ratings_Type_Uid_Height_Value
+                    where
+                        r.Type = 2 and
+                        r.Uid = last.Uid and
+                        r.Height < actual.value
+                    order by
+                        r.Height desc
+                    limit 1
+                )
+            from
+                actual,
+                last
+            cross join
+                Transactions t on
+                    t.RowId = last.TxId and
+                    t.Type in (200, 201, 202, 209, 210, 220)
+            cross join
+                Chain c on
+                    c.TxId = t.RowId
+            cross join
+                Chain corig on
+                    corig.TxId = t.RegId2
+            left join
+                Payload p on
+                    p.TxId = t.RowId
+        )sql")
+        .Bind(height, actualHeight)
+        .Run();
+    }
+
     bool ChainRepository::ClearDatabase()
     {
         LogPrintf("Start clean database..\n");
@@ -1383,17 +1566,20 @@ namespace PocketDb
                 Sql(R"sql( delete from First )sql").Run();
                 Sql(R"sql( delete from Ratings )sql").Run();
                 Sql(R"sql( delete from Balances )sql").Run();
+                Sql(R"sql( delete from BalancesJournal )sql").Run();
                 Sql(R"sql( delete from Chain )sql").Run();
                 Sql(R"sql( delete from Jury )sql").Run();
                 Sql(R"sql( delete from JuryModerators )sql").Run();
                 Sql(R"sql( delete from JuryVerdict )sql").Run();
                 Sql(R"sql( delete from JuryBan )sql").Run();
                 Sql(R"sql( delete from Badges )sql").Run();
+                Sql(R"sql( delete from Feed )sql").Run();
                 Sql(R"sql( delete from BlockingLists )sql").Run();
                 Sql(R"sql( delete from SocialRegistry )sql").Run();
             });
 
-            m_database.CreateStructure();
+            // Web-only indexes are not maintained while chain is indexed again in bulk load mode
+            m_database.CreateStructure(true, !gArgs.GetBoolArg("-sqlbulkload", DEFAULT_SQL_BULK_LOAD));
 
             return true;
         }
@@ -1408,6 +1594,10 @@ namespace PocketDb
     {
         SqlTransaction(__func__, [&]()
         {
+            // Feed is rebuilt from Chain and Ratings records below height
+            // so it must be restored before them
+            RestoreFeed(height);
+
             RestoreLast(height);
             RestoreRatings(height);
             RestoreBalances(height);
@@ -1521,6 +1711,54 @@ namespace PocketDb
     }
 
     void ChainRepository::RestoreBalances(int height)
+    {
+        // Journal covers heights starting from the first saved record
+        bool journaled = false;
+        Sql(R"sql(
+            select 1
+            from BalancesJournal
+            where Height <= ?
+            limit 1
+        )sql")
+        .Bind(height)
+        .Select([&](Cursor& cursor) {
+            journaled = cursor.Step();
+        });
+
+        if (journaled)
+        {
+            // Rollback replays only changed addresses
+            Sql(R"sql(
+                replace into Balances (AddressId, Value)
+                select
+                    j.AddressId,
+                    ifnull(b.Value, 0) - sum(j.Value)
+                from
+                    BalancesJournal j
+                    left join Balances b
+                        on b.AddressId = j.AddressId
+                where
+                    j.Height >= ?
+                group by
+                    j.AddressId
+            )sql")
+            .Bind(height)
+            .Run();
+        }
+        else
+        {
+            RestoreBalancesFromOutputs(height);
+        }
+
+        Sql(R"sql(
+            delete from BalancesJournal
+            where Height >= ?
+        )sql")
+        .Bind(height)
+        .Run();
+    }
+
+    void ChainRepository::RestoreBalancesFromOutputs(int height)
     {
         Sql(R"sql(
             with
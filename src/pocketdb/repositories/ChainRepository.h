@@ -24,6 +24,9 @@ namespace PocketDb
 
     using namespace PocketTx;
 
+    // Depth of per-height balance deltas kept for rollback, deeper rollback recalculates deltas from TxOutputs
+    static const int BALANCES_JOURNAL_DEPTH = 1440;
+
     class ChainRepository : public BaseRepository
     {
     public:
@@ -33,8 +36,9 @@ namespace PocketDb
         // Also spent outputs
         void IndexBlock(const string& blockHash, int height, vector<TransactionIndexingInfo>& txs);
 
-        // Precalculate address balances from TxOutputs
-        void IndexBalances(int height);
+        // Apply address balances deltas of block outputs and spent inputs
+        // Deltas are saved to journal for rollback
+        void IndexBalances(int height, const vector<TransactionIndexingInfo>& txs, unordered_map<string, int64_t>& ids);
 
         void Restore(int height);
 
@@ -44,6 +48,9 @@ namespace PocketDb
         void IndexModerationJury(const string& flagTxHash, int flagsDepth, int flagsMinCount, int juryModeratorsCount);
         void IndexModerationBan(const string& voteTxHash, int votesCount, int ban1Time, int ban2Time, int ban3Time);
         void IndexBadges(int height, const BadgeConditions& conditions);
+
+        // Update materialized feed for contents changed or rated in block
+        void IndexFeed(int height);
         
         // Check block exist in db
         tuple<bool, bool> ExistsBlock(const string& blockHash, int height);
@@ -54,11 +61,11 @@ namespace PocketDb
 
     private:
 
-        void SetFirst(const string& txHash);
+        void SetFirst(const optional<int64_t>& txId);
 
         // Returns blockId
         void IndexBlockData(const std::string& blockHash);
-        void InsertTransactionChainData(const string& blockHash, int blockNumber, int height, const string& txHash, const optional<int64_t>& id);
+        void InsertTransactionChainData(const optional<int64_t>& blockId, int blockNumber, int height, const optional<int64_t>& txId, const optional<int64_t>& id);
 
         void IndexSocialRegistryTx(const TransactionIndexingInfo& txInfo, int height, bool isFirst);
         // Trims the SocialRegistry by limit and restores missing rows in case limit growth
@@ -78,12 +85,17 @@ namespace PocketDb
         void RestoreLast(int height);
         void RestoreRatings(int height);
         void RestoreBalances(int height);
+        void RestoreBalancesFromOutputs(int height);
         void RestoreChain(int height);
         void RestoreSocialRegistry(int height);
         void RollbackBlockingList(int height);
         void RestoreModerationJury(int height);
         void RestoreModerationBan(int height);
         void RestoreBadges(int height);
+        void RestoreFeed(int height);
+
+        // Rebuild feed records for contents changed since height with state before actualHeight
+        void RebuildFeed(int height, int actualHeight);
 
     };
 
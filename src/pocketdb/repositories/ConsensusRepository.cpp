@@ -192,6 +192,232 @@ namespace PocketDb
         return result;
     }
 
+    unordered_set<string> ConsensusRepository::GetRegisteredAddresses(const vector<string>& addresses)
+    {
+        unordered_set<string> result;
+
+        if (addresses.empty())
+            return result;
+
+        SqlTransaction(__func__, [&]()
+        {
+            Sql(R"sql(
+                select
+                    r.String
+                from
+                    Registry r
+                    cross join Transactions t on
+                        t.Type in (100) and t.RegId1 = r.RowId
+                    cross join Last l on
+                        l.TxId = t.RowId
+                where
+                    r.String in ( )sql" + join(vector<string>(addresses.size(), "?"), ",") + R"sql( )
+            )sql")
+            .Bind(addresses)
+            .Select([&](Cursor& cursor) {
+                while (cursor.Step())
+                {
+                    if (auto[ok, value] = cursor.TryGetColumnString(0); ok)
+                        result.emplace(value);
+                }
+            });
+        });
+
+        return result;
+    }
+
+    unordered_map<string, int> ConsensusRepository::GetUserReputations(const vector<string>& addresses)
+    {
+        unordered_map<string, int> result;
+
+        if (addresses.empty())
+            return result;
+
+        SqlTransaction(__func__, [&]()
+        {
+            Sql(R"sql(
+                select
+                    a.String,
+                    r.Value
+
+                from Registry a
+
+                cross join Transactions u indexed by Transactions_Type_RegId1_RegId2_RegId3
+                    on u.Type in (100, 170) and u.RegId1 = a.RowId
+
+                cross join Last lu
+                    on lu.TxId = u.RowId
+
+                cross join Chain cu
+                    on cu.TxId = u.RowId
+
+                cross join Ratings r indexed by Ratings_Type_Uid_Last_Value
+                    on r.Type = 0 and r.Uid = cu.Uid and r.Last = 1
+
+                where
+                    a.String in ( )sql" + join(vector<string>(addresses.size(), "?"), ",") + R"sql( )
+            )sql")
+            .Bind(addresses)
+            .Select([&](Cursor& cursor) {
+                while (cursor.Step())
+                {
+                    auto[okAddress, address] = cursor.TryGetColumnString(0);
+                    auto[okValue, value] = cursor.TryGetColumnInt(1);
+                    if (okAddress && okValue)
+                        result.emplace(address, value);
+                }
+            });
+        });
+
+        return result;
+    }
+
+    unordered_map<string, int64_t> ConsensusRepository::GetUserBalances(const vector<string>& addresses)
+    {
+        unordered_map<string, int64_t> result;
+
+        if (addresses.empty())
+            return result;
+
+        SqlTransaction(__func__, [&]()
+        {
+            Sql(R"sql(
+                select
+                    a.String,
+                    b.Value
+                from
+                    Registry a
+                    cross join Balances b on
+                        b.AddressId = a.RowId
+                where
+                    a.String in ( )sql" + join(vector<string>(addresses.size(), "?"), ",") + R"sql( )
+            )sql")
+            .Bind(addresses)
+            .Select([&](Cursor& cursor) {
+                while (cursor.Step())
+                {
+                    auto[okAddress, address] = cursor.TryGetColumnString(0);
+                    auto[okValue, value] = cursor.TryGetColumnInt64(1);
+                    if (okAddress && okValue)
+                        result.emplace(address, value);
+                }
+            });
+        });
+
+        return result;
+    }
+
+    set<tuple<int, string, string>> ConsensusRepository::GetExistingScores(const vector<tuple<int, string, string>>& keys)
+    {
+        set<tuple<int, string, string>> result;
+
+        if (keys.empty())
+            return result;
+
+        UniValue jKeys(UniValue::VARR);
+        for (const auto& [type, address, contentHash] : keys)
+        {
+            UniValue jKey(UniValue::VARR);
+            jKey.push_back(type);
+            jKey.push_back(address);
+            jKey.push_back(contentHash);
+            jKeys.push_back(jKey);
+        }
+
+        SqlTransaction(__func__, [&]()
+        {
+            Sql(R"sql(
+                with
+                    keys as (
+                        select
+                            json_extract(k.value, '$[0]') as type,
+                            json_extract(k.value, '$[1]') as address,
+                            json_extract(k.value, '$[2]') as hash
+                        from
+                            json_each(?) k
+                    )
+                select distinct
+                    keys.type,
+                    keys.address,
+                    keys.hash
+                from
+                    keys
+                    cross join Registry ra on
+                        ra.String = keys.address
+                    cross join Registry rh on
+                        rh.String = keys.hash
+                    cross join Transactions t indexed by Transactions_Type_RegId1_RegId2_RegId3 on
+                        t.Type = keys.type and
+                        t.RegId1 = ra.RowId and
+                        t.RegId2 = rh.RowId
+                where
+                    exists (select 1 from Chain c where c.TxId = t.RowId)
+            )sql")
+            .Bind(jKeys.write())
+            .Select([&](Cursor& cursor) {
+                while (cursor.Step())
+                {
+                    auto[okType, type] = cursor.TryGetColumnInt(0);
+                    auto[okAddress, address] = cursor.TryGetColumnString(1);
+                    auto[okHash, hash] = cursor.TryGetColumnString(2);
+                    if (okType && okAddress && okHash)
+                        result.emplace(type, address, hash);
+                }
+            });
+        });
+
+        return result;
+    }
+
+    set<pair<string, string>> ConsensusRepository::GetBlockings(const vector<string>& addresses)
+    {
+        set<pair<string, string>> result;
+
+        if (addresses.empty())
+            return result;
+
+        SqlTransaction(__func__, [&]()
+        {
+            Sql(R"sql(
+                with
+                    addr as (
+                        select
+                            r.RowId as id
+                        from
+                            Registry r
+                        where
+                            r.String in ( )sql" + join(vector<string>(addresses.size(), "?"), ",") + R"sql( )
+                    ),
+                    blockings as (
+                        select b.IdSource, b.IdTarget
+                        from addr
+                        cross join BlockingLists b on b.IdSource = addr.id
+                        union
+                        select b.IdSource, b.IdTarget
+                        from addr
+                        cross join BlockingLists b indexed by BlockingLists_IdTarget_IdSource on b.IdTarget = addr.id
+                    )
+                select
+                    (select r.String from Registry r where r.RowId = blockings.IdSource),
+                    (select r.String from Registry r where r.RowId = blockings.IdTarget)
+                from
+                    blockings
+            )sql")
+            .Bind(addresses)
+            .Select([&](Cursor& cursor) {
+                while (cursor.Step())
+                {
+                    auto[okSource, source] = cursor.TryGetColumnString(0);
+                    auto[okTarget, target] = cursor.TryGetColumnString(1);
+                    if (okSource && okTarget)
+                        result.emplace(source, target);
+                }
+            });
+        });
+
+        return result;
+    }
+
     bool ConsensusRepository::ExistsAccountBan(const string& address, int height)
     {
         auto result = false;
@@ -14,6 +14,7 @@
 #include <boost/algorithm/string/join.hpp>
 #include <boost/range/adaptor/transformed.hpp>
 #include <timedata.h>
+#include <unordered_set>
 
 namespace PocketDb
 {
@@ -142,6 +143,15 @@ namespace PocketDb
         bool ExistsComplain(const string& postHash, const string& address, bool mempool);
         bool ExistsScore(const string& address, const string& contentHash, TxType type, bool mempool);
         bool ExistsUserRegistrations(vector<string>& addresses);
+        // Returns addresses with actual (not deleted) account registration
+        unordered_set<string> GetRegisteredAddresses(const vector<string>& addresses);
+        // Reputations and balances of addresses, missing addresses have zero values
+        unordered_map<string, int> GetUserReputations(const vector<string>& addresses);
+        unordered_map<string, int64_t> GetUserBalances(const vector<string>& addresses);
+        // Returns keys (type, address, content hash) of scores already in chain
+        set<tuple<int, string, string>> GetExistingScores(const vector<tuple<int, string, string>>& keys);
+        // Returns blocking pairs (source, target) where source or target is one of addresses
+        set<pair<string, string>> GetBlockings(const vector<string>& addresses);
         bool ExistsAccountBan(const string& address, int height);
         bool ExistsAnotherByName(const string& address, const string& name, TxType type);
         bool ExistsNotDeleted(const string& txHash, const string& address, const vector<TxType>& types);
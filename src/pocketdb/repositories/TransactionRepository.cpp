@@ -9,39 +9,6 @@ namespace PocketDb
     class CollectDataToModelConverter
     {
     public:
-        // TODO (optimization): consider remove `repository` parameter from here.
-        static optional<CollectData> ModelToCollectData(const PTransactionRef& ptx)
-        {
-            if (!ptx->GetHash()) return nullopt;
-            TxContextualData txData;
-            optional<CollectData> res;
-            if (!DbViewHelper::Extract(txData, ptx)) {
-                return nullopt;
-            }
-
-            CollectData collectData(*ptx->GetHash());
-            collectData.txContextData = move(txData);
-            collectData.inputs = ptx->Inputs();
-            collectData.outputs = ptx->OutputsConst();
-            collectData.ptx = ptx;
-
-            if (ptx->GetPayload()) {
-                if (ptx->GetPayload()->GetString1() ||
-                    ptx->GetPayload()->GetString2() ||
-                    ptx->GetPayload()->GetString3() ||
-                    ptx->GetPayload()->GetString4() ||
-                    ptx->GetPayload()->GetString5() ||
-                    ptx->GetPayload()->GetString6() ||
-                    ptx->GetPayload()->GetString7() ||
-                    ptx->GetPayload()->GetInt1()
-                ) {
-                    collectData.payload = ptx->GetPayload();
-                }
-            }
-
-            return collectData;
-        }
-
         static PTransactionRef CollectDataToModel(const CollectData& collectData)
         {
             auto ptx = collectData.ptx;
@@ -243,82 +210,72 @@ namespace PocketDb
         }
     };
 
-    static auto _findStringsAndListsToBeInserted(const vector<CollectData>& collectDataVec)
+    static optional<int64_t> RegistryId(const vector<optional<int64_t>>& ids, uint32_t index)
     {
-        set<string> stringsToBeInserted;
-        set<string> listsToBeInserted;
-        for (const auto& collectData: collectDataVec)
-        {
-            stringsToBeInserted.insert(collectData.txHash);
-
-            const auto& txData = collectData.txContextData;
-            if (txData.string1) stringsToBeInserted.insert(*txData.string1);
-            if (txData.string2) stringsToBeInserted.insert(*txData.string2);
-            if (txData.string3) stringsToBeInserted.insert(*txData.string3);
-            if (txData.string4) stringsToBeInserted.insert(*txData.string4);
-            if (txData.string5) stringsToBeInserted.insert(*txData.string5);
+        if (index == NO_VALUE)
+            return nullopt;
 
-            if (txData.list) listsToBeInserted.insert(*txData.list);
-            
-            for (const auto& output: collectData.outputs) {
-                if (output.GetAddressHash()) stringsToBeInserted.insert(*output.GetAddressHash());
-                if (output.GetScriptPubKey()) stringsToBeInserted.insert(*output.GetScriptPubKey());
-                if (output.GetTxHash()) stringsToBeInserted.insert(*output.GetTxHash());
-                if (output.GetSpentTxHash()) stringsToBeInserted.insert(*output.GetSpentTxHash());
-            }
-
-            for (const auto& input: collectData.inputs) {
-                if (input.GetSpentTxHash()) stringsToBeInserted.insert(*input.GetSpentTxHash());
-                if (input.GetTxHash()) stringsToBeInserted.insert(*input.GetTxHash());
-                if (input.GetAddressHash()) stringsToBeInserted.insert(*input.GetAddressHash());
-            }
-        }
-
-        return pair { stringsToBeInserted, listsToBeInserted };
+        return ids[index];
     }
 
     void TransactionRepository::InsertTransactions(PocketBlock& pocketBlock)
     {
-        vector<CollectData> collectDataVec;
-        for (const auto& ptx: pocketBlock)
-        {
-            auto collectData = CollectDataToModelConverter::ModelToCollectData(ptx);
-            assert(collectData);
-            
-            collectDataVec.emplace_back(move(*collectData));
-        }
+        // Block-scoped columns instead of copies of transactions, inputs, outputs and payloads
+        BlockColumns columns;
+        bool built = columns.Build(pocketBlock);
+        assert(built);
 
-        set<string> registyStrings;
-        set<string> lists;
-        tie(registyStrings, lists) = _findStringsAndListsToBeInserted(collectDataVec);
+        vector<optional<int64_t>> ids;
+        vector<uint32_t> selected;
 
         SqlTransaction(__func__, [&]()
         {
-            InsertRegistry(registyStrings);
-            InsertRegistryLists(lists);
+            InsertRegistry(columns.Registry);
+            InsertRegistryLists(columns);
 
-            for (const auto& collectData: collectDataVec)
+            // Ids of all strings with one query, new values are published to cache only after commit
+            ids = SelectRegistryIds(columns.Registry, selected);
+
+            for (size_t i = 0; i < columns.Count(); i++)
             {
                 // Insert general transaction
-                InsertTransactionModel(collectData);
+                InsertTransactionModel(columns, i, ids);
 
                 // Insert lists for transaction
-                if (collectData.txContextData.list)
-                    InsertList(*collectData.txContextData.list, collectData.txHash);
+                if (auto list = columns.Texts.TryGet(columns.List[i]); list)
+                    InsertList(*list, columns.Registry.Get(columns.Hash[i]));
 
                 // Inputs
-                InsertTransactionInputs(collectData.inputs, collectData.txHash);
+                InsertTransactionInputs(columns, i, ids);
 
                 // Outputs
-                InsertTransactionOutputs(collectData.outputs, collectData.txHash);
+                InsertTransactionOutputs(columns, i, ids);
 
                 // Also need insert payload of transaction
                 // But need get new rowId
                 // If last id equal 0 - insert ignored - or already exists or error -> paylod not inserted
-                if (collectData.payload)
-                    InsertTransactionPayload(*collectData.payload);
-                }
+                if (columns.HasPayload[i])
+                    InsertTransactionPayload(columns, i);
+            }
+        });
+
+        for (auto index : selected)
+            RegistryCacheInst.Put(string(columns.Registry.Get(index)), *ids[index]);
+    }
+
+    unordered_map<string, int64_t> TransactionRepository::ResolveIds(const vector<string>& strings)
+    {
+        unordered_map<string, int64_t> result;
+
+        if (strings.empty())
+            return result;
+
+        SqlTransaction(__func__, [&]()
+        {
+            result = SelectRegistryIds(strings, true);
         });
+
+        return result;
     }
 
     PocketBlockRef TransactionRepository::List(const vector<string>& txHashes, bool includePayload, bool includeInputs, bool includeOutputs)
@@ -630,6 +587,52 @@ namespace PocketDb
         return make_shared<StakeKernelHashTx>(result);
     }
 
+    map<pair<string, int>, StakeKernelHashTx> TransactionRepository::GetStakeKernelHashTxs(const vector<string>& txHashes)
+    {
+        map<pair<string, int>, StakeKernelHashTx> result;
+
+        // Keep number of variables below SQLite limit
+        const size_t chunkSize = 500;
+        for (size_t begin = 0; begin < txHashes.size(); begin += chunkSize)
+        {
+            vector<string> chunk(txHashes.begin() + begin, txHashes.begin() + min(begin + chunkSize, txHashes.size()));
+
+            SqlTransaction(__func__, [&]()
+            {
+                Sql(R"sql(
+                    select
+                        t.Hash,
+                        o.Number,
+                        t.Time,
+                        o.Value,
+                        (select r.String from Registry r where r.RowId = c.BlockId)Block
+                    from
+                        vTx t
+                        cross join Chain c
+                            on c.TxId = t.RowId
+                        cross join TxOutputs o
+                            on o.TxId = t.RowId
+                    where
+                        t.Hash in ( )sql" + join(vector<string>(chunk.size(), "?"), ",") + R"sql( )
+                )sql")
+                .Bind(chunk)
+                .Select([&](Cursor& cursor) {
+                    while (cursor.Step())
+                    {
+                        string hash;
+                        int64_t number = 0;
+                        StakeKernelHashTx tx{"", 0, 0};
+                        cursor.CollectAll(hash, number, tx.TxTime, tx.OutValue, tx.BlockHash);
+
+                        result.emplace(make_pair(move(hash), (int) number), move(tx));
+                    }
+                });
+            });
+        }
+
+        return result;
+    }
+
     bool TransactionRepository::Exists(const string& hash)
     {
         bool result = false;
@@ -753,21 +756,7 @@ namespace PocketDb
     {
         SqlTransaction(__func__, [&]()
         {
-            Sql(R"sql(
-                insert or fail into Mempool
-                (
-                    TxId
-                )
-                select
-                    RowId
-                from
-                    vTx
-                where
-                    Hash = ? and
-                    not exists (select 1 from Mempool m where m.TxId = vTx.RowId)
-            )sql")
-            .Bind(hash)
-            .Run();
+            InsertMempool(hash);
         });
     }
 
@@ -775,13 +764,7 @@ namespace PocketDb
     {
         SqlTransaction(__func__, [&]()
         {
-            Sql(R"sql(
-                delete from Mempool
-                where
-                    TxId = (select RowId from vTx where Hash = ?)
-            )sql")
-            .Bind(hash)
-            .Run();
+            DeleteMempool(hash);
         });
     }
 
@@ -789,10 +772,7 @@ namespace PocketDb
     {
         SqlTransaction(__func__, [&]()
         {
-            Sql(R"sql(
-                delete from Mempool
-            )sql")
-            .Run();
+            DeleteMempoolAll();
         });
     }
 
@@ -800,180 +780,240 @@ namespace PocketDb
     {
         SqlTransaction(__func__, [&]()
         {
-            // Clear Mempool table
-            Sql(R"sql(
-                with
-                    tx as (
-                        select
-                            t.RowId
-                        from
-                            vTx t
-                        where
-                            t.Hash = ?
-                    )
-                delete from Mempool
-                where
-                    TxId = (select RowId from tx) and
-                    not exists (
-                        select
-                            1
-                        from
-                            tx,
-                            Chain c
-                        where
-                            c.TxId = tx.RowId
-                    )
-            )sql")
-            .Bind(hash)
-            .Run();
+            DeleteTransaction(hash);
+        });
+    }
 
-            // Clear Last table
-            Sql(R"sql(
-                with
-                    tx as (
-                        select
-                            t.RowId
-                        from
-                            vTx t
-                        where
-                            t.Hash = ?
-                    )
-                delete from Last
-                where
-                    TxId = (select RowId from tx) and
-                    not exists (
-                        select
-                            1
-                        from
-                            tx,
-                            Chain c
-                        where
-                            c.TxId = tx.RowId
-                    )
-            )sql")
-            .Bind(hash)
-            .Run();
+    void TransactionRepository::MempoolApply(const vector<pair<MempoolOp, string>>& ops)
+    {
+        SqlTransaction(__func__, [&]()
+        {
+            for (const auto& [op, hash] : ops)
+            {
+                switch (op)
+                {
+                    case MempoolOp::Insert: InsertMempool(hash); break;
+                    case MempoolOp::Remove: DeleteMempool(hash); break;
+                    case MempoolOp::RemoveTransaction: DeleteTransaction(hash); break;
+                    case MempoolOp::Clear: DeleteMempoolAll(); break;
+                }
+            }
+        });
+    }
 
-            // Clear First table
-            Sql(R"sql(
-                with
-                    tx as (
-                        select
-                            t.RowId
-                        from
-                            vTx t
-                        where
-                            t.Hash = ?
-                    )
-                delete from First
-                where
-                    TxId = (select RowId from tx) and
-                    not exists (
-                        select
-                            1
-                        from
-                            tx,
-                            Chain c
-                        where
-                            c.TxId = tx.RowId
-                    )
-            )sql")
-            .Bind(hash)
-            .Run();
+    void TransactionRepository::InsertMempool(const string& hash)
+    {
+        Sql(R"sql(
+            insert or fail into Mempool
+            (
+                TxId
+            )
+            select
+                RowId
+            from
+                vTx
+            where
+                Hash = ? and
+                not exists (select 1 from Mempool m where m.TxId = vTx.RowId)
+        )sql")
+        .Bind(hash)
+        .Run();
+    }
 
-            // Clear Payload tablew
-            Sql(R"sql(
-                with
-                    tx as (
-                        select
-                            t.RowId
-                        from
-                            vTx t
-                        where
-                            t.Hash = ?
-                    )
-                delete from Payload
-                where
-                    TxId = (select RowId from tx) and
-                    not exists (
-                        select
-                            1
-                        from
-                            tx,
-                            Chain c
-                        where
-                            c.TxId = tx.RowId
-                    )
-            )sql")
-            .Bind(hash)
-            .Run();
+    void TransactionRepository::DeleteMempool(const string& hash)
+    {
+        Sql(R"sql(
+            delete from Mempool
+            where
+                TxId = (select RowId from vTx where Hash = ?)
+        )sql")
+        .Bind(hash)
+        .Run();
+    }
 
-            // TODO (aok, losty): Clear TxInputs table
+    void TransactionRepository::DeleteMempoolAll()
+    {
+        Sql(R"sql(
+            delete from Mempool
+        )sql")
+        .Run();
+    }
 
-            // Clear TxOutputs table
-            Sql(R"sql(
-                with
-                    tx as (
-                        select
-                            t.RowId
-                        from
-                            vTx t
-                        where
-                            t.Hash = ?
-                    )
-                delete from TxOutputs
-                where
-                    TxId = (select RowId from tx) and
-                    not exists (
-                        select
-                            1
-                        from
-                            tx,
-                            Chain c
-                        where
-                            c.TxId = tx.RowId
-                    )
-            )sql")
-            .Bind(hash)
-            .Run();
+    void TransactionRepository::DeleteTransaction(const string& hash)
+    {
+        // Clear Mempool table
+        Sql(R"sql(
+            with
+                tx as (
+                    select
+                        t.RowId
+                    from
+                        vTx t
+                    where
+                        t.Hash = ?
+                )
+            delete from Mempool
+            where
+                TxId = (select RowId from tx) and
+                not exists (
+                    select
+                        1
+                    from
+                        tx,
+                        Chain c
+                    where
+                        c.TxId = tx.RowId
+                )
+        )sql")
+        .Bind(hash)
+        .Run();
 
-            // Clear Transactions table
-            Sql(R"sql(
-                with
-                    tx as (
-                        select
-                            t.RowId
-                        from
-                            vTx t
-                        where
-                            t.Hash = ?
-                    )
-                delete from Transactions
-                where
-                    RowId = (select RowId from tx) and
-                    not exists (
-                        select
-                            1
-                        from
-                            tx,
-                            Chain c
-                        where
-                            c.TxId = tx.RowId
-                    )
-            )sql")
-            .Bind(hash)
-            .Run();
-        });
+        // Clear Last table
+        Sql(R"sql(
+            with
+                tx as (
+                    select
+                        t.RowId
+                    from
+                        vTx t
+                    where
+                        t.Hash = ?
+                )
+            delete from Last
+            where
+                TxId = (select RowId from tx) and
+                not exists (
+                    select
+                        1
+                    from
+                        tx,
+                        Chain c
+                    where
+                        c.TxId = tx.RowId
+                )
+        )sql")
+        .Bind(hash)
+        .Run();
+
+        // Clear First table
+        Sql(R"sql(
+            with
+                tx as (
+                    select
+                        t.RowId
+                    from
+                        vTx t
+                    where
+                        t.Hash = ?
+                )
+            delete from First
+            where
+                TxId = (select RowId from tx) and
+                not exists (
+                    select
+                        1
+                    from
+                        tx,
+                        Chain c
+                    where
+                        c.TxId = tx.RowId
+                )
+        )sql")
+        .Bind(hash)
+        .Run();
+
+        // Clear Payload tablew
+        Sql(R"sql(
+            with
+                tx as (
+                    select
+                        t.RowId
+                    from
+                        vTx t
+                    where
+                        t.Hash = ?
+                )
+            delete from Payload
+            where
+                TxId = (select RowId from tx) and
+                not exists (
+                    select
+                        1
+                    from
+                        tx,
+                        Chain c
+                    where
+                        c.TxId = tx.RowId
+                )
+        )sql")
+        .Bind(hash)
+        .Run();
+
+        // TODO (aok, losty): Clear TxInputs table
+
+        // Clear TxOutputs table
+        Sql(R"sql(
+            with
+                tx as (
+                    select
+                        t.RowId
+                    from
+                        vTx t
+                    where
+                        t.Hash = ?
+                )
+            delete from TxOutputs
+            where
+                TxId = (select RowId from tx) and
+                not exists (
+                    select
+                        1
+                    from
+                        tx,
+                        Chain c
+                    where
+                        c.TxId = tx.RowId
+                )
+        )sql")
+        .Bind(hash)
+        .Run();
+
+        // Clear Transactions table
+        Sql(R"sql(
+            with
+                tx as (
+                    select
+                        t.RowId
+                    from
+                        vTx t
+                    where
+                        t.Hash = ?
+                )
+            delete from Transactions
+            where
+                RowId = (select RowId from tx) and
+                not exists (
+                    select
+                        1
+                    from
+                        tx,
+                        Chain c
+                    where
+                        c.TxId = tx.RowId
+                )
+        )sql")
+        .Bind(hash)
+        .Run();
     }
 
-    void TransactionRepository::InsertTransactionInputs(const vector<TransactionInput>& inputs, const string& txHash)
+    void TransactionRepository::InsertTransactionInputs(const BlockColumns& columns, size_t tx, const vector<optional<int64_t>>& ids)
     {
         auto& stmt = Sql(R"sql(
             with
                 data as (
                     select
-                        (select RowId from Registry where String = ?) as spentTx,
-                        (select RowId from Registry where String = ?) as tx,
+                        ? as spentTx,
+                        ? as tx,
                         ? as number
                 )
 
@@ -1000,17 +1040,17 @@ namespace PocketDb
                 )
         )sql");
 
-        for (const auto& input: inputs)
+        for (auto i = columns.InputsBegin[tx]; i < columns.InputsBegin[tx + 1]; i++)
         {
             stmt.Bind(
-                input.GetSpentTxHash(),
-                input.GetTxHash(),
-                input.GetNumber()
+                RegistryId(ids, columns.InputSpentTxHash[i]),
+                RegistryId(ids, columns.InputTxHash[i]),
+                columns.InputNumber[i]
             ).Run();
         }
     }
-    
-    void TransactionRepository::InsertTransactionOutputs(const vector<TransactionOutput>& outputs, const string& txHash)
+
+    void TransactionRepository::InsertTransactionOutputs(const BlockColumns& columns, size_t tx, const vector<optional<int64_t>>& ids)
     {
         auto& stmt = Sql(R"sql(
             with
@@ -1018,9 +1058,9 @@ namespace PocketDb
                     select
                         RowId
                     from
-                        vTx
+                        Transactions
                     where
-                        Hash = ?
+                        RowId = ?
                 )
             insert or fail into
                 TxOutputs (
@@ -1033,17 +1073,9 @@ namespace PocketDb
             select
                 tx.RowId,
                 ?,
-                (
-                    select RowId
-                    from Registry
-                    where String = ?
-                ),
                 ?,
-                (
-                    select RowId
-                    from Registry
-                    where String = ?
-                )
+                ?,
+                ?
             from tx
             where
                 not exists(
@@ -1053,24 +1085,25 @@ namespace PocketDb
                     TxOutputs indexed by TxOutputs_TxId_Number_AddressId
                 where
                     TxId = tx.RowId and
-                    Number = ?           
+                    Number = ?
                 )
         )sql");
 
-        for (const auto& output: outputs)
+        auto txId = RegistryId(ids, columns.Hash[tx]);
+        for (auto i = columns.OutputsBegin[tx]; i < columns.OutputsBegin[tx + 1]; i++)
         {
             stmt.Bind(
-                txHash,
-                output.GetNumber(),
-                output.GetAddressHash(),
-                output.GetValue(),
-                output.GetScriptPubKey(),
-                output.GetNumber()
+                txId,
+                columns.OutputNumber[i],
+                RegistryId(ids, columns.OutputAddressHash[i]),
+                columns.OutputValue[i],
+                RegistryId(ids, columns.OutputScriptPubKey[i]),
+                columns.OutputNumber[i]
             ).Run();
         }
     }
 
-    void TransactionRepository::InsertTransactionPayload(const Payload& payload)
+    void TransactionRepository::InsertTransactionPayload(const BlockColumns& columns, size_t tx)
     {
         Sql(R"sql(
             with
@@ -1116,27 +1149,25 @@ namespace PocketDb
                         p.TxId = tx.RowId
                 )
         )sql").Bind(
-            payload.GetTxHash(),
-            payload.GetString1(),
-            payload.GetString2(),
-            payload.GetString3(),
-            payload.GetString4(),
-            payload.GetString5(),
-            payload.GetString6(),
-            payload.GetString7(),
-            payload.GetInt1()
+            columns.Texts.TryGet(columns.PayloadTxHash[tx]),
+            columns.Texts.TryGet(columns.PayloadString[0][tx]),
+            columns.Texts.TryGet(columns.PayloadString[1][tx]),
+            columns.Texts.TryGet(columns.PayloadString[2][tx]),
+            columns.Texts.TryGet(columns.PayloadString[3][tx]),
+            columns.Texts.TryGet(columns.PayloadString[4][tx]),
+            columns.Texts.TryGet(columns.PayloadString[5][tx]),
+            columns.Texts.TryGet(columns.PayloadString[6][tx]),
+            columns.PayloadInt1[tx]
         ).Run();
     }
 
-    void TransactionRepository::InsertTransactionModel(const CollectData& collectData)
+    void TransactionRepository::InsertTransactionModel(const BlockColumns& columns, size_t tx, const vector<optional<int64_t>>& ids)
     {
+        auto txId = RegistryId(ids, columns.Hash[tx]);
+        if (!txId)
+            return;
+
         Sql(R"sql(
-            with
-                h as (
-                    select RowId as TxId
-                    from Registry
-                    where String = ?
-                )
             insert or fail into 
                 Transactions (
                     RowId,
@@ -1150,37 +1181,15 @@ namespace PocketDb
                     RegId5
                 )
             select
-                h.TxId,
                 ?,
                 ?,
                 ?,
-                (
-                    select RowId
-                    from Registry
-                    where String = ?
-                ),
-                (
-                    select RowId
-                    from Registry
-                    where String = ?
-                ),
-                (
-                    select RowId
-                    from Registry
-                    where String = ?
-                ),
-                (
-                    select RowId
-                    from Registry
-                    where String = ?
-                ),
-                (
-                    select RowId
-                    from Registry
-                    where String = ?
-                )
-            from
-                h
+                ?,
+                ?,
+                ?,
+                ?,
+                ?,
+                ?
             where
                 not exists(
                     select
@@ -1188,19 +1197,20 @@ namespace PocketDb
                     from
                         Transactions a
                     where
-                        a.RowId = h.TxId
+                        a.RowId = ?
                 )
         )sql")
         .Bind(
-            collectData.txHash,
-            (int)*collectData.ptx->GetType(),
-            collectData.ptx->GetTime(),
-            collectData.txContextData.int1,
-            collectData.txContextData.string1,
-            collectData.txContextData.string2,
-            collectData.txContextData.string3,
-            collectData.txContextData.string4,
-            collectData.txContextData.string5)
+            txId,
+            columns.Type[tx],
+            columns.Time[tx],
+            columns.Int1[tx],
+            RegistryId(ids, columns.String[0][tx]),
+            RegistryId(ids, columns.String[1][tx]),
+            RegistryId(ids, columns.String[2][tx]),
+            RegistryId(ids, columns.String[3][tx]),
+            RegistryId(ids, columns.String[4][tx]),
+            txId)
         .Run();
     }
 
@@ -1280,37 +1290,44 @@ namespace PocketDb
         return res;
     }
 
-    void TransactionRepository::InsertRegistry(const set<string> &strings)
+    void TransactionRepository::InsertRegistry(const StringArena& strings)
     {
-        if (strings.empty())
+        if (strings.Size() == 0)
             return;
 
-        auto& stmt = Sql(R"sql(
-            insert or ignore into Registry (String)
-            values (?)
-        )sql");
-
-        for (const auto& str: strings) {
-            stmt.Bind(str).Run();
+        // Values from cache are already committed to Registry
+        UniValue missed(UniValue::VARR);
+        for (uint32_t i = 0; i < strings.Size(); i++) {
+            int64_t id;
+            if (!RegistryCacheInst.GetId(strings.Get(i), id))
+                missed.push_back(string(strings.Get(i)));
         }
-    }
 
-    void TransactionRepository::InsertRegistryLists(const set<string> &lists)
-    {
-        if (lists.empty())
+        if (missed.empty())
             return;
 
+        Sql(R"sql(
+            insert or ignore into Registry (String)
+            select value from json_each(?)
+        )sql")
+        .Bind(missed.write())
+        .Run();
+    }
+
+    void TransactionRepository::InsertRegistryLists(const BlockColumns& columns)
+    {
         auto& stmt = Sql(R"sql(
             insert or ignore into Registry (string)
             select value from json_each(?)
         )sql");
 
-        for (const auto& list: lists) {
-            stmt.Bind(list).Run();
+        for (auto index : columns.List) {
+            if (auto list = columns.Texts.TryGet(index); list)
+                stmt.Bind(*list).Run();
         }
     }
 
-    void TransactionRepository::InsertList(const string &list, const string& txHash)
+    void TransactionRepository::InsertList(string_view list, string_view txHash)
     {
         Sql(R"sql(
             with
@@ -47,6 +47,15 @@ namespace PocketDb
         int64_t OutValue;
     };
 
+    // Operations of Mempool table mirror in order of mempool events
+    enum class MempoolOp
+    {
+        Insert,
+        Remove,
+        RemoveTransaction,
+        Clear
+    };
+
     class TransactionRepository : public BaseRepository
     {
     public:
@@ -54,10 +63,15 @@ namespace PocketDb
 
         //  Base transaction operations
         void InsertTransactions(PocketBlock& pocketBlock);
+
+        // Registry ids of strings with one query for values missed in RegistryCacheInst
+        unordered_map<string, int64_t> ResolveIds(const vector<string>& strings);
         PocketBlockRef List(const vector<string>& txHashes, bool includePayload = false, bool includeInputs = false, bool includeOutputs = false);
         PTransactionRef Get(const string& hash, bool includePayload = false, bool includeInputs = false, bool includeOutputs = false);
         PTransactionOutputRef GetTxOutput(const string& txHash, int number);
         shared_ptr<StakeKernelHashTx> GetStakeKernelHashTx(const string& txHash, int number);
+        // Kernel data of all outputs of transactions in chain, by hash and output number
+        map<pair<string, int>, StakeKernelHashTx> GetStakeKernelHashTxs(const vector<string>& txHashes);
 
         bool Exists(const string& hash);
         bool Exists(vector<string>& txHashes);
@@ -71,14 +85,22 @@ namespace PocketDb
 
         void RemoveTransaction(const string& hash);
 
+        // Several mirror operations in one database transaction
+        void MempoolApply(const vector<pair<MempoolOp, string>>& ops);
+
     private:
-        void InsertRegistry(const set<string>& strings);
-        void InsertRegistryLists(const set<string>& lists);
-        void InsertList(const std::string& list, const std::string& txHash);
-        void InsertTransactionInputs(const vector<TransactionInput>& intputs, const string& txHash);
-        void InsertTransactionOutputs(const vector<TransactionOutput>& outputs, const string& txHash);
-        void InsertTransactionPayload(const Payload& payload);
-        void InsertTransactionModel(const CollectData& ptx);
+        void InsertMempool(const string& hash);
+        void DeleteMempool(const string& hash);
+        void DeleteMempoolAll();
+        void DeleteTransaction(const string& hash);
+        void InsertRegistry(const StringArena& strings);
+        void InsertRegistryLists(const BlockColumns& columns);
+        void InsertList(string_view list, string_view txHash);
+        // Rows of transaction `tx` of block columns
+        void InsertTransactionInputs(const BlockColumns& columns, size_t tx, const vector<optional<int64_t>>& ids);
+        void InsertTransactionOutputs(const BlockColumns& columns, size_t tx, const vector<optional<int64_t>>& ids);
+        void InsertTransactionPayload(const BlockColumns& columns, size_t tx);
+        void InsertTransactionModel(const BlockColumns& columns, size_t tx, const vector<optional<int64_t>>& ids);
 
         map<string,int64_t> GetTxIds(const vector<string>& txHashes);
 
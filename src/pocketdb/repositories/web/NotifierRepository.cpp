@@ -56,9 +56,11 @@ namespace PocketDb
         return result;
     }
 
-    UniValue NotifierRepository::GetPostLang(const string &postHash)
+    map<string, string> NotifierRepository::GetPostLangs(const vector<string>& postHashes)
     {
-        UniValue result(UniValue::VOBJ);
+        map<string, string> result;
+        if (postHashes.empty())
+            return result;
 
         SqlTransaction(
             __func__,
@@ -72,9 +74,10 @@ namespace PocketDb
                         from
                             Registry r
                         where
-                            r.String = ?
+                            r.String in ( )sql" + join(vector<string>(postHashes.size(), "?"), ",") + R"sql( )
                     )
                     select
+                        tx.hash,
                         p.String1 Lang
                     from
                         tx
@@ -84,13 +87,15 @@ namespace PocketDb
                     cross join Payload p on
                         p.TxId = t.RowId
                 )sql")
-                .Bind(postHash);
+                .Bind(postHashes);
             },
             [&](Stmt& stmt) {
                 stmt.Select([&](Cursor& cursor) {
-                    if (cursor.Step())
+                    while (cursor.Step())
                     {
-                        if (auto[ok, value] = cursor.TryGetColumnString(0); ok) result.pushKV("lang", value);
+                        auto[okHash, hash] = cursor.TryGetColumnString(0);
+                        auto[okLang, lang] = cursor.TryGetColumnString(1);
+                        if (okHash && okLang) result.emplace(hash, lang);
                     }
                 });
             }
@@ -99,9 +104,11 @@ namespace PocketDb
         return result;
     }
 
-    UniValue NotifierRepository::GetPostInfo(const string& postHash)
+    map<string, UniValue> NotifierRepository::GetPostInfos(const vector<string>& postHashes)
     {
-        UniValue result(UniValue::VOBJ);
+        map<string, UniValue> result;
+        if (postHashes.empty())
+            return result;
 
         SqlTransaction(
             __func__,
@@ -115,7 +122,7 @@ namespace PocketDb
                         from
                             Registry r
                         where
-                            r.String = ?
+                            r.String in ( )sql" + join(vector<string>(postHashes.size(), "?"), ",") + R"sql( )
                     )
                     select
                         tx.hash,
@@ -125,14 +132,17 @@ namespace PocketDb
                         join Transactions t on
                             t.RowId = tx.id and t.Type in (200, 201, 202, 209, 210, 203)
                 )sql")
-                .Bind(postHash);
+                .Bind(postHashes);
             },
             [&](Stmt& stmt) {
                 stmt.Select([&](Cursor& cursor) {
-                    if (cursor.Step())
+                    while (cursor.Step())
                     {
-                        if (auto[ok, value] = cursor.TryGetColumnString(0); ok) result.pushKV("hash", value);
-                        if (auto[ok, value] = cursor.TryGetColumnString(1); ok) result.pushKV("rootHash", value);
+                        UniValue record(UniValue::VOBJ);
+                        auto[okHash, hash] = cursor.TryGetColumnString(0);
+                        if (okHash) record.pushKV("hash", hash);
+                        if (auto[ok, value] = cursor.TryGetColumnString(1); ok) record.pushKV("rootHash", value);
+                        if (okHash) result.emplace(hash, record);
                     }
                 });
             }
@@ -141,9 +151,11 @@ namespace PocketDb
         return result;
     }
 
-    UniValue NotifierRepository::GetBoostInfo(const string& boostHash)
+    map<string, UniValue> NotifierRepository::GetBoostInfos(const vector<string>& boostHashes)
     {
-        UniValue result(UniValue::VOBJ);
+        map<string, UniValue> result;
+        if (boostHashes.empty())
+            return result;
 
         SqlTransaction(
             __func__,
@@ -157,7 +169,7 @@ namespace PocketDb
                         from
                             Registry r
                         where
-                            r.String = ?
+                            r.String in ( )sql" + join(vector<string>(boostHashes.size(), "?"), ",") + R"sql( )
                     )
                     select
                         tx.hash,
@@ -182,19 +194,22 @@ namespace PocketDb
                         join Payload p on
                             p.TxId = u.RowId
                 )sql")
-                .Bind(boostHash);
+                .Bind(boostHashes);
             },
             [&](Stmt& stmt) {
                 stmt.Select([&](Cursor& cursor) {
-                    if (cursor.Step())
+                    while (cursor.Step())
                     {
-                        if (auto[ok, value] = cursor.TryGetColumnString(0); ok) result.pushKV("hash", value);
-                        if (auto[ok, value] = cursor.TryGetColumnString(1); ok) result.pushKV("boostAddress", value);
-                        if (auto[ok, value] = cursor.TryGetColumnInt(2); ok) result.pushKV("boostAmount", to_string(value));
-                        if (auto[ok, value] = cursor.TryGetColumnString(3); ok) result.pushKV("boostName", value);
-                        if (auto[ok, value] = cursor.TryGetColumnString(4); ok) result.pushKV("boostAvatar", value);
-                        if (auto[ok, value] = cursor.TryGetColumnString(5); ok) result.pushKV("contentAddress", value);
-                        if (auto[ok, value] = cursor.TryGetColumnString(6); ok) result.pushKV("contentHash", value);
+                        UniValue record(UniValue::VOBJ);
+                        auto[okHash, hash] = cursor.TryGetColumnString(0);
+                        if (okHash) record.pushKV("hash", hash);
+                        if (auto[ok, value] = cursor.TryGetColumnString(1); ok) record.pushKV("boostAddress", value);
+                        if (auto[ok, value] = cursor.TryGetColumnInt(2); ok) record.pushKV("boostAmount", to_string(value));
+                        if (auto[ok, value] = cursor.TryGetColumnString(3); ok) record.pushKV("boostName", value);
+                        if (auto[ok, value] = cursor.TryGetColumnString(4); ok) record.pushKV("boostAvatar", value);
+                        if (auto[ok, value] = cursor.TryGetColumnString(5); ok) record.pushKV("contentAddress", value);
+                        if (auto[ok, value] = cursor.TryGetColumnString(6); ok) record.pushKV("contentHash", value);
+                        if (okHash) result.emplace(hash, record);
                     }
                 });
             }
@@ -203,9 +218,11 @@ namespace PocketDb
         return result;
     }
 
-    UniValue NotifierRepository::GetOriginalPostAddressByRepost(const string &repostHash)
+    map<string, UniValue> NotifierRepository::GetOriginalPostAddressesByReposts(const vector<string>& repostHashes)
     {
-        UniValue result(UniValue::VOBJ);
+        map<string, UniValue> result;
+        if (repostHashes.empty())
+            return result;
 
         SqlTransaction(
             __func__,
@@ -219,9 +236,10 @@ namespace PocketDb
                         from
                             Registry r
                         where
-                            r.String = ?
+                            r.String in ( )sql" + join(vector<string>(repostHashes.size(), "?"), ",") + R"sql( )
                     )
                     select
+                        tx.hash,
                         (select r.String from Registry r where r.RowId = t.RegId2) as RootTxHash,
                         (select r.String from Registry r where r.RowId = t.RegId1) as address,
                         (select r.String from Registry r where r.RowId = tRepost.RegId1) as addressRepost,
@@ -240,17 +258,23 @@ namespace PocketDb
                         join Payload p on
                             p.TxId = u.RowId
                 )sql")
-                .Bind(repostHash);
+                .Bind(repostHashes);
             },
             [&](Stmt& stmt) {
                 stmt.Select([&](Cursor& cursor) {
-                    if (cursor.Step())
+                    while (cursor.Step())
                     {
-                        if (auto[ok, value] = cursor.TryGetColumnString(0); ok) result.pushKV("hash", value);
-                        if (auto[ok, value] = cursor.TryGetColumnString(1); ok) result.pushKV("address", value);
-                        if (auto[ok, value] = cursor.TryGetColumnString(2); ok) result.pushKV("addressRepost", value);
-                        if (auto[ok, value] = cursor.TryGetColumnString(3); ok) result.pushKV("nameRepost", value);
-                        if (auto[ok, value] = cursor.TryGetColumnString(4); ok) result.pushKV("avatarRepost", value);
+                        auto[okKey, key] = cursor.TryGetColumnString(0);
+                        if (!okKey)
+                            continue;
+
+                        UniValue record(UniValue::VOBJ);
+                        if (auto[ok, value] = cursor.TryGetColumnString(1); ok) record.pushKV("hash", value);
+                        if (auto[ok, value] = cursor.TryGetColumnString(2); ok) record.pushKV("address", value);
+                        if (auto[ok, value] = cursor.TryGetColumnString(3); ok) record.pushKV("addressRepost", value);
+                        if (auto[ok, value] = cursor.TryGetColumnString(4); ok) record.pushKV("nameRepost", value);
+                        if (auto[ok, value] = cursor.TryGetColumnString(5); ok) record.pushKV("avatarRepost", value);
+                        result.emplace(key, record);
                     }
                 });
             }
@@ -259,9 +283,11 @@ namespace PocketDb
         return result;
     }
 
-    UniValue NotifierRepository::GetPrivateSubscribeAddressesByAddressTo(const string &addressTo)
+    map<string, UniValue> NotifierRepository::GetPrivateSubscribeAddressesByAddressesTo(const vector<string>& addressesTo)
     {
-        UniValue result(UniValue::VARR);
+        map<string, UniValue> result;
+        if (addressesTo.empty())
+            return result;
 
         SqlTransaction(
             __func__,
@@ -275,9 +301,10 @@ namespace PocketDb
                         from
                             Registry r
                         where
-                            r.String = ?
+                            r.String in ( )sql" + join(vector<string>(addressesTo.size(), "?"), ",") + R"sql( )
                     )
                     select
+                        addr.hash,
                         (select r.String from Registry r where r.RowId = s.RegId1) as addressTo,
                         p.String2 as nameFrom,
                         p.String3 as avatarFrom
@@ -294,17 +321,23 @@ namespace PocketDb
                         join Payload p on
                             p.TxId = u.RowId
                 )sql")
-                .Bind(addressTo);
+                .Bind(addressesTo);
             },
             [&](Stmt& stmt) {
                 stmt.Select([&](Cursor& cursor) {
                     while (cursor.Step())
                     {
+                        auto[okKey, key] = cursor.TryGetColumnString(0);
+                        if (!okKey)
+                            continue;
+
                         UniValue record(UniValue::VOBJ);
-                        if (auto[ok, value] = cursor.TryGetColumnString(0); ok) record.pushKV("addressTo", value);
-                        if (auto[ok, value] = cursor.TryGetColumnString(1); ok) record.pushKV("nameFrom", value);
-                        if (auto[ok, value] = cursor.TryGetColumnString(2); ok) record.pushKV("avatarFrom", value);
-                        result.push_back(record);
+                        if (auto[ok, value] = cursor.TryGetColumnString(1); ok) record.pushKV("addressTo", value);
+                        if (auto[ok, value] = cursor.TryGetColumnString(2); ok) record.pushKV("nameFrom", value);
+                        if (auto[ok, value] = cursor.TryGetColumnString(3); ok) record.pushKV("avatarFrom", value);
+
+                        auto it = result.emplace(key, UniValue(UniValue::VARR)).first;
+                        it->second.push_back(record);
                     }
                 });
             }
@@ -313,9 +346,11 @@ namespace PocketDb
         return result;
     }
 
-    UniValue NotifierRepository::GetPostInfoAddressByScore(const string &postScoreHash)
+    map<string, UniValue> NotifierRepository::GetPostInfoAddressesByScores(const vector<string>& postScoreHashes)
     {
-        UniValue result(UniValue::VOBJ);
+        map<string, UniValue> result;
+        if (postScoreHashes.empty())
+            return result;
 
         SqlTransaction(
             __func__,
@@ -329,9 +364,10 @@ namespace PocketDb
                         from
                             Registry r
                         where
-                            r.String = ?
+                            r.String in ( )sql" + join(vector<string>(postScoreHashes.size(), "?"), ",") + R"sql( )
                     )
                     select
+                        tx.hash,
                         (select r.String from Registry r where r.RowId = score.RegId2) as postTxHash,
                         score.Int1 value,
                         (select r.String from Registry r where r.RowId = post.RegId1) as postAddress,
@@ -350,17 +386,23 @@ namespace PocketDb
                         join Payload p on
                             p.TxId = u.RowId
                 )sql")
-                .Bind(postScoreHash);
+                .Bind(postScoreHashes);
             },
             [&](Stmt& stmt) {
                 stmt.Select([&](Cursor& cursor) {
-                    if (cursor.Step())
+                    while (cursor.Step())
                     {
-                        if (auto[ok, value] = cursor.TryGetColumnString(0); ok) result.pushKV("postTxHash", value);
-                        if (auto[ok, value] = cursor.TryGetColumnInt(1); ok) result.pushKV("value", to_string(value));
-                        if (auto[ok, value] = cursor.TryGetColumnString(2); ok) result.pushKV("postAddress", value);
-                        if (auto[ok, value] = cursor.TryGetColumnString(3); ok) result.pushKV("scoreName", value);
-                        if (auto[ok, value] = cursor.TryGetColumnString(4); ok) result.pushKV("scoreAvatar", value);
+                        auto[okKey, key] = cursor.TryGetColumnString(0);
+                        if (!okKey)
+                            continue;
+
+                        UniValue record(UniValue::VOBJ);
+                        if (auto[ok, value] = cursor.TryGetColumnString(1); ok) record.pushKV("postTxHash", value);
+                        if (auto[ok, value] = cursor.TryGetColumnInt(2); ok) record.pushKV("value", to_string(value));
+                        if (auto[ok, value] = cursor.TryGetColumnString(3); ok) record.pushKV("postAddress", value);
+                        if (auto[ok, value] = cursor.TryGetColumnString(4); ok) record.pushKV("scoreName", value);
+                        if (auto[ok, value] = cursor.TryGetColumnString(5); ok) record.pushKV("scoreAvatar", value);
+                        result.emplace(key, record);
                     }
                 });
             }
@@ -369,9 +411,11 @@ namespace PocketDb
         return result;
     }
 
-    UniValue NotifierRepository::GetSubscribeAddressTo(const string &subscribeHash)
+    map<string, UniValue> NotifierRepository::GetSubscribesAddressesTo(const vector<string>& subscribeHashes)
     {
-        UniValue result(UniValue::VOBJ);
+        map<string, UniValue> result;
+        if (subscribeHashes.empty())
+            return result;
 
         SqlTransaction(
             __func__,
@@ -385,9 +429,10 @@ namespace PocketDb
                         from
                             Registry r
                         where
-                            r.String = ?
+                            r.String in ( )sql" + join(vector<string>(subscribeHashes.size(), "?"), ",") + R"sql( )
                     )
                     select
+                        tx.hash,
                         (select r.String from Registry r where r.RowId = s.RegId2) addressTo,
                         p.String2 as nameFrom,
                         p.String3 as avatarFrom
@@ -402,15 +447,21 @@ namespace PocketDb
                         join Payload p on
                             p.TxId = u.RowId
                 )sql")
-                .Bind(subscribeHash);
+                .Bind(subscribeHashes);
             },
             [&](Stmt& stmt) {
                 stmt.Select([&](Cursor& cursor) {
-                    if (cursor.Step())
+                    while (cursor.Step())
                     {
-                        if (auto[ok, value] = cursor.TryGetColumnString(0); ok) result.pushKV("addressTo", value);
-                        if (auto[ok, value] = cursor.TryGetColumnString(1); ok) result.pushKV("nameFrom", value);
-                        if (auto[ok, value] = cursor.TryGetColumnString(2); ok) result.pushKV("avatarFrom", value);
+                        auto[okKey, key] = cursor.TryGetColumnString(0);
+                        if (!okKey)
+                            continue;
+
+                        UniValue record(UniValue::VOBJ);
+                        if (auto[ok, value] = cursor.TryGetColumnString(1); ok) record.pushKV("addressTo", value);
+                        if (auto[ok, value] = cursor.TryGetColumnString(2); ok) record.pushKV("nameFrom", value);
+                        if (auto[ok, value] = cursor.TryGetColumnString(3); ok) record.pushKV("avatarFrom", value);
+                        result.emplace(key, record);
                     }
                 });
             }
@@ -419,9 +470,11 @@ namespace PocketDb
         return result;
     }
 
-    UniValue NotifierRepository::GetCommentInfoAddressByScore(const string &commentScoreHash)
+    map<string, UniValue> NotifierRepository::GetCommentInfoAddressesByScores(const vector<string>& commentScoreHashes)
     {
-        UniValue result(UniValue::VOBJ);
+        map<string, UniValue> result;
+        if (commentScoreHashes.empty())
+            return result;
 
         SqlTransaction(
             __func__,
@@ -435,9 +488,10 @@ namespace PocketDb
                         from
                             Registry r
                         where
-                            r.String = ?
+                            r.String in ( )sql" + join(vector<string>(commentScoreHashes.size(), "?"), ",") + R"sql( )
                     )
                     select
+                        tx.hash,
                         (select r.String from Registry r where r.RowId = score.RegId2) as commentHash,
                         score.Int1 value,
                         (select r.String from Registry r where r.RowId = comment.RegId1) as commentAddress,
@@ -456,17 +510,23 @@ namespace PocketDb
                         join Payload p on
                             p.TxId = u.RowId
                 )sql")
-                .Bind(commentScoreHash);
+                .Bind(commentScoreHashes);
             },
             [&](Stmt& stmt) {
                 stmt.Select([&](Cursor& cursor) {
-                    if (cursor.Step())
+                    while (cursor.Step())
                     {
-                        if (auto[ok, value] = cursor.TryGetColumnString(0); ok) result.pushKV("commentHash", value);
-                        if (auto[ok, value] = cursor.TryGetColumnInt(1); ok) result.pushKV("value", to_string(value));
-                        if (auto[ok, value] = cursor.TryGetColumnString(2); ok) result.pushKV("commentAddress", value);
-                        if (auto[ok, value] = cursor.TryGetColumnString(3); ok) result.pushKV("scoreCommentName", value);
-                        if (auto[ok, value] = cursor.TryGetColumnString(4); ok) result.pushKV("scoreCommentAvatar", value);
+                        auto[okKey, key] = cursor.TryGetColumnString(0);
+                        if (!okKey)
+                            continue;
+
+                        UniValue record(UniValue::VOBJ);
+                        if (auto[ok, value] = cursor.TryGetColumnString(1); ok) record.pushKV("commentHash", value);
+                        if (auto[ok, value] = cursor.TryGetColumnInt(2); ok) record.pushKV("value", to_string(value));
+                        if (auto[ok, value] = cursor.TryGetColumnString(3); ok) record.pushKV("commentAddress", value);
+                        if (auto[ok, value] = cursor.TryGetColumnString(4); ok) record.pushKV("scoreCommentName", value);
+                        if (auto[ok, value] = cursor.TryGetColumnString(5); ok) record.pushKV("scoreCommentAvatar", value);
+                        result.emplace(key, record);
                     }
                 });
             }
@@ -475,9 +535,11 @@ namespace PocketDb
         return result;
     }
 
-    UniValue NotifierRepository::GetFullCommentInfo(const string &commentHash)
+    map<string, UniValue> NotifierRepository::GetFullCommentInfos(const vector<string>& commentHashes)
     {
-        UniValue result(UniValue::VOBJ);
+        map<string, UniValue> result;
+        if (commentHashes.empty())
+            return result;
 
         SqlTransaction(
             __func__,
@@ -491,10 +553,11 @@ namespace PocketDb
                         from
                             Registry r
                         where
-                            r.String = ?
+                            r.String in ( )sql" + join(vector<string>(commentHashes.size(), "?"), ",") + R"sql( )
                     )
 
                     select
+                        tx.hash,
                         (select r.String from Registry r where r.RowId = comment.RegId3) as PostHash,
                         (select r.String from Registry r where r.RowId = comment.RegId4) as ParentHash,
                         (select r.String from Registry r where r.RowId = comment.RegId5) as AnswerHash,
@@ -529,25 +592,32 @@ namespace PocketDb
                         left join Transactions answer indexed by Transactions_Type_RegId2_RegId1 on
                             answer.Type in (204, 205) and answer.RegId2 = comment.RegId5
                 )sql")
-                .Bind(commentHash);
+                .Bind(commentHashes);
             },
             [&](Stmt& stmt) {
                 stmt.Select([&](Cursor& cursor) {
-                    if (cursor.Step())
+                    while (cursor.Step())
                     {
-                        if (auto[ok, value] = cursor.TryGetColumnString(0); ok) result.pushKV("postHash", value);
-                        if (auto[ok, value] = cursor.TryGetColumnString(1); ok) result.pushKV("parentHash", value); else result.pushKV("parentHash", "");
-                        if (auto[ok, value] = cursor.TryGetColumnString(2); ok) result.pushKV("answerHash", value); else result.pushKV("answerHash", "");
-                        if (auto[ok, value] = cursor.TryGetColumnString(3); ok) result.pushKV("rootHash", value);
-                        if (auto[ok, value] = cursor.TryGetColumnString(4); ok) result.pushKV("postAddress", value);
-                        if (auto[ok, value] = cursor.TryGetColumnString(5); ok) result.pushKV("answerAddress", value);
-                        if (auto[ok, value] = cursor.TryGetColumnString(6); ok) result.pushKV("commentName", value);
-                        if (auto[ok, value] = cursor.TryGetColumnString(7); ok) result.pushKV("commentAvatar", value);
-                        if (auto[ok, value] = cursor.TryGetColumnInt64(8); ok)
+                        // First row for each comment, as before
+                        auto[okKey, key] = cursor.TryGetColumnString(0);
+                        if (!okKey || result.count(key))
+                            continue;
+
+                        UniValue record(UniValue::VOBJ);
+                        if (auto[ok, value] = cursor.TryGetColumnString(1); ok) record.pushKV("postHash", value);
+                        if (auto[ok, value] = cursor.TryGetColumnString(2); ok) record.pushKV("parentHash", value); else record.pushKV("parentHash", "");
+                        if (auto[ok, value] = cursor.TryGetColumnString(3); ok) record.pushKV("answerHash", value); else record.pushKV("answerHash", "");
+                        if (auto[ok, value] = cursor.TryGetColumnString(4); ok) record.pushKV("rootHash", value);
+                        if (auto[ok, value] = cursor.TryGetColumnString(5); ok) record.pushKV("postAddress", value);
+                        if (auto[ok, value] = cursor.TryGetColumnString(6); ok) record.pushKV("answerAddress", value);
+                        if (auto[ok, value] = cursor.TryGetColumnString(7); ok) record.pushKV("commentName", value);
+                        if (auto[ok, value] = cursor.TryGetColumnString(8); ok) record.pushKV("commentAvatar", value);
+                        if (auto[ok, value] = cursor.TryGetColumnInt64(9); ok)
                         {
-                            result.pushKV("donation", "true");
-                            result.pushKV("amount", value);
+                            record.pushKV("donation", "true");
+                            record.pushKV("amount", value);
                         }
+                        result.emplace(key, record);
                     }
                 });
             }
@@ -556,9 +626,11 @@ namespace PocketDb
         return result;
     }
 
-    UniValue NotifierRepository::GetPostCountFromMySubscribes(const string& address, int height)
+    map<string, UniValue> NotifierRepository::GetPostCountsFromMySubscribes(const vector<string>& addresses, int height)
     {
-        UniValue result(UniValue::VOBJ);
+        map<string, UniValue> result;
+        if (addresses.empty())
+            return result;
 
         SqlTransaction(
             __func__,
@@ -572,10 +644,11 @@ namespace PocketDb
                         from
                             Registry r
                         where
-                            r.String = ?
+                            r.String in ( )sql" + join(vector<string>(addresses.size(), "?"), ",") + R"sql( )
                     )
 
                     select
+                        addr.hash,
                         count() as cntTotal,
                         sum(ifnull((case when post.Type = 200 then 1 else 0 end),0)) as cntPost,
                         sum(ifnull((case when post.Type = 201 then 1 else 0 end),0)) as cntVideo,
@@ -594,19 +667,27 @@ namespace PocketDb
                             post.RowId = cpost.TxId and post.Type in (200, 201, 202, 209, 210, 203) and post.RegId1 = sub.RegId2
                         cross join Last lpost on
                             lpost.TxId = post.RowId
+                    group by
+                        addr.hash
                 )sql")
-                .Bind(address, height);
+                .Bind(addresses, height);
             },
             [&](Stmt& stmt) {
                 stmt.Select([&](Cursor& cursor) {
-                    if (cursor.Step())
+                    while (cursor.Step())
                     {
-                        if (auto[ok, value] = cursor.TryGetColumnInt(0); ok) result.pushKV("cntTotal", value);
-                        if (auto[ok, value] = cursor.TryGetColumnInt(1); ok) result.pushKV("cntPost", value);
-                        if (auto[ok, value] = cursor.TryGetColumnInt(2); ok) result.pushKV("cntVideo", value);
-                        if (auto[ok, value] = cursor.TryGetColumnInt(3); ok) result.pushKV("cntArticle", value);
-                        if (auto[ok, value] = cursor.TryGetColumnInt(4); ok) result.pushKV("cntStream", value);
-                        if (auto[ok, value] = cursor.TryGetColumnInt(5); ok) result.pushKV("cntAudio", value);
+                        auto[okKey, key] = cursor.TryGetColumnString(0);
+                        if (!okKey)
+                            continue;
+
+                        UniValue record(UniValue::VOBJ);
+                        if (auto[ok, value] = cursor.TryGetColumnInt(1); ok) record.pushKV("cntTotal", value);
+                        if (auto[ok, value] = cursor.TryGetColumnInt(2); ok) record.pushKV("cntPost", value);
+                        if (auto[ok, value] = cursor.TryGetColumnInt(3); ok) record.pushKV("cntVideo", value);
+                        if (auto[ok, value] = cursor.TryGetColumnInt(4); ok) record.pushKV("cntArticle", value);
+                        if (auto[ok, value] = cursor.TryGetColumnInt(5); ok) record.pushKV("cntStream", value);
+                        if (auto[ok, value] = cursor.TryGetColumnInt(6); ok) record.pushKV("cntAudio", value);
+                        result.emplace(key, record);
                     }
                 });
             }
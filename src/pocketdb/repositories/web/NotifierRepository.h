@@ -22,16 +22,19 @@ namespace PocketDb
         explicit NotifierRepository(SQLiteDatabase& db, bool timeouted) : BaseRepository(db, timeouted) {}
 
         UniValue GetAccountInfoByAddress(const string& address);
-        UniValue GetPostLang(const string& postHash);
-        UniValue GetPostInfo(const string& postHash);
-        UniValue GetBoostInfo(const string& boostHash);
-        UniValue GetOriginalPostAddressByRepost(const string& repostHash);
-        UniValue GetPrivateSubscribeAddressesByAddressTo(const string& addressTo);
-        UniValue GetPostInfoAddressByScore(const string& postScoreHash);
-        UniValue GetSubscribeAddressTo(const string& subscribeHash);
-        UniValue GetCommentInfoAddressByScore(const string& commentScoreHash);
-        UniValue GetFullCommentInfo(const string& commentHash);
-        UniValue GetPostCountFromMySubscribes(const string& address, int height);
+
+        // Set-based lookups for all transactions of one block, results are keyed by requested hash or address
+        map<string, string> GetPostLangs(const vector<string>& postHashes);
+        map<string, UniValue> GetPostInfos(const vector<string>& postHashes);
+        map<string, UniValue> GetBoostInfos(const vector<string>& boostHashes);
+        map<string, UniValue> GetOriginalPostAddressesByReposts(const vector<string>& repostHashes);
+        map<string, UniValue> GetPrivateSubscribeAddressesByAddressesTo(const vector<string>& addressesTo);
+        map<string, UniValue> GetPostInfoAddressesByScores(const vector<string>& postScoreHashes);
+        map<string, UniValue> GetSubscribesAddressesTo(const vector<string>& subscribeHashes);
+        map<string, UniValue> GetCommentInfoAddressesByScores(const vector<string>& commentScoreHashes);
+        map<string, UniValue> GetFullCommentInfos(const vector<string>& commentHashes);
+        // Addresses without subscribed content in block are missing in result
+        map<string, UniValue> GetPostCountsFromMySubscribes(const vector<string>& addresses, int height);
 
 
         /**
@@ -32,6 +32,38 @@ namespace PocketDb
         return result;
     }
 
+    bool WebRepository::ExistsBlock(const string& blockHash, int height)
+    {
+        bool result = false;
+
+        SqlTransaction(__func__, [&]()
+        {
+            Sql(R"sql(
+                select
+                    1
+                from
+                    Chain c indexed by Chain_BlockId_Height
+                where
+                    c.BlockId = (
+                        select
+                            r.RowId
+                        from
+                            Registry r
+                        where
+                            r.String = ?
+                    ) and
+                    c.Height = ?
+                limit 1
+            )sql")
+            .Bind(blockHash, height)
+            .Select([&](Cursor& cursor) {
+                result = cursor.Step();
+            });
+        });
+
+        return result;
+    }
+
     void WebRepository::SetCurrentHeight(int height)
     {
         SqlTransaction(__func__, [&]()
@@ -46,13 +78,13 @@ namespace PocketDb
         });
     }
 
-    vector<WebTag> WebRepository::GetContentTags(int height)
+    vector<WebTag> WebRepository::GetContentTags(int heightFrom, int heightTo)
     {
         vector<WebTag> result;
 
         string sql = R"sql(
             with
-                height as ( select ? as value )
+                height as ( select ? as fromValue, ? as toValue )
             select
                 distinct
                 p.RowId,
@@ -62,7 +94,7 @@ namespace PocketDb
                 height
             cross join
                 Chain c on
-                    c.Height = height.value
+                    c.Height between height.fromValue and height.toValue
             cross join
                 Transactions p on
                     p.RowId = c.TxId and
@@ -80,7 +112,7 @@ namespace PocketDb
         SqlTransaction(
             __func__,
             [&]() -> Stmt& {
-                return Sql(sql).Bind(height);
+                return Sql(sql).Bind(heightFrom, heightTo);
             },
             [&] (Stmt& stmt) {
                 stmt.Select([&](Cursor& cursor) {
@@ -104,13 +136,13 @@ namespace PocketDb
         return result;
     }
 
-    vector<WebTag> WebRepository::GetAppTags(int height)
+    vector<WebTag> WebRepository::GetAppTags(int heightFrom, int heightTo)
     {
         vector<WebTag> result;
 
         string sql = R"sql(
             with
-                height as ( select ? as value )
+                height as ( select ? as fromValue, ? as toValue )
             select
                 distinct
                 p.RowId,
@@ -119,7 +151,7 @@ namespace PocketDb
                 height
             cross join
                 Chain c on
-                    c.Height = height.value
+                    c.Height between height.fromValue and height.toValue
             cross join
                 Transactions p on
                     p.RowId = c.TxId and
@@ -137,7 +169,7 @@ namespace PocketDb
         SqlTransaction(
             __func__,
             [&]() -> Stmt& {
-                return Sql(sql).Bind(height);
+                return Sql(sql).Bind(heightFrom, heightTo);
             },
             [&] (Stmt& stmt) {
                 stmt.Select([&](Cursor& cursor) {
@@ -233,13 +265,13 @@ namespace PocketDb
         });
     }
 
-    vector<WebContent> WebRepository::GetContent(int height)
+    vector<WebContent> WebRepository::GetContent(int heightFrom, int heightTo)
     {
         vector<WebContent> result;
 
         string sql = R"sql(
             with
-                height as ( select ? as value )
+                height as ( select ? as fromValue, ? as toValue )
             select
                 t.Type,
                 c.Uid,
@@ -254,7 +286,7 @@ namespace PocketDb
                 height
             cross join
                 Chain c on
-                    c.Height = height.value
+                    c.Height between height.fromValue and height.toValue
             cross join
                 Transactions t on
                     t.RowId = c.TxId and
@@ -262,12 +294,19 @@ namespace PocketDb
             cross join
                 Payload p on
                     p.TxId = t.RowId
+            where
+                -- Only last version of content edited several times in range
+                not exists (
+                    select 1
+                    from Chain cn indexed by Chain_Uid_Height
+                    where cn.Uid = c.Uid and cn.Height > c.Height and cn.Height <= height.toValue
+                )
         )sql";
        
         SqlTransaction(
             __func__,
             [&]() -> Stmt& {
-                return Sql(sql).Bind(height);
+                return Sql(sql).Bind(heightFrom, heightTo);
             },
             [&] (Stmt& stmt) {
                 stmt.Select([&](Cursor& cursor) {
@@ -610,498 +649,659 @@ namespace PocketDb
         });
     }
 
-    void WebRepository::CollectAccountStatistic()
+    // Queries of full recompute by statistic type. Every query selects account and value,
+    // `{accounts}` in condition on accounts is replaced to recompute only some of them.
+    struct AccountStatisticQuery
     {
+        int Type;
+        string AccountColumn;
+        string Sql;
+    };
+
+    static const vector<AccountStatisticQuery> accountStatisticQueries = {
         // PostsCount
-        {
-            unordered_map<int64_t, int64_t> _map;
-            SqlTransaction(
-                "CollectAccountStatistic_PostsCount_Get",
-                [&]() -> Stmt& {
-                    return Sql(R"sql(
-                        select
-                            t.RegId1,
-                            count()
-                        from
-                            Transactions t
-                        cross join
-                            Last l on
-                                l.TxId = t.RowId
-                        cross join
-                            Transactions po indexed by Transactions_Type_RegId1_RegId2_RegId3 on
-                                po.Type in (200,201,202,209,210) and
-                                po.RegId1 = t.RegId1
-                        cross join
-                            Last lpo
-                                on lpo.TxId = po.RowId
-                        where
-                            t.Type = 100
-                        group by
-                            t.RegId1
-                    )sql");
-                },
-                [&] (Stmt& stmt) {
-                    stmt.Select([&](Cursor& cursor) {
-                        while (cursor.Step())
-                        {
-                            int64_t regId1, count;
-                            if (cursor.CollectAll(regId1, count))
-                                _map.emplace(regId1, count);
-                        }
-                    });
-                }
-            );
+        { 1, "t.RegId1", R"sql(
+            select
+                t.RegId1,
+                count()
+            from
+                Transactions t
+            cross join
+                Last l on
+                    l.TxId = t.RowId
+            cross join
+                Transactions po indexed by Transactions_Type_RegId1_RegId2_RegId3 on
+                    po.Type in (200,201,202,209,210) and
+                    po.RegId1 = t.RegId1
+            cross join
+                Last lpo
+                    on lpo.TxId = po.RowId
+            where
+                t.Type = 100
+                {accounts}
+            group by
+                t.RegId1
+        )sql" },
 
-            SqlTransaction("CollectAccountStatistic_PostsCount_Set", [&]()
-            {
-                Sql(R"sql(
-                    delete from web.AccountStatistic where Type = 1
-                )sql").Run();
+        // DelCount
+        { 2, "t.RegId1", R"sql(
+            select
+                t.RegId1,
+                count()
+            from
+                Transactions t
+            cross join
+                Last l on
+                    l.TxId = t.RowId
+            cross join
+                Transactions po indexed by Transactions_Type_RegId1_RegId2_RegId3 on
+                    po.Type in (207) and
+                    po.RegId1 = t.RegId1
+            cross join
+                Last lpo
+                    on lpo.TxId = po.RowId
+            where
+                t.Type = 100
+                {accounts}
+            group by
+                t.RegId1
+        )sql" },
 
-                for (auto& x : _map) {
-                    Sql(R"sql(
-                        insert into web.AccountStatistic (AccountRegId, Type, Data)
-                        values (?, 1, ?)
-                    )sql").Bind(x.first, x.second).Run();
-                }
-            });
-        }
+        // SubscribesCount
+        { 3, "t.RegId1", R"sql(
+            select
+                t.RegId1,
+                count()
+            from
+                Transactions t
+            cross join
+                Last l on
+                    l.TxId = t.RowId
+            cross join
+                Transactions subs indexed by Transactions_Type_RegId1_RegId2_RegId3 on
+                    subs.Type in (302, 303) and
+                    subs.RegId1 = t.RegId1
+            cross join
+                Last lsubs
+                    on lsubs.TxId = subs.RowId
+            cross join
+                Transactions uas indexed by Transactions_Type_RegId1_RegId2_RegId3
+                    on uas.Type in (100) and uas.RegId1 = subs.RegId2
+            cross join
+                Last luas
+                    on luas.TxId = uas.RowId
+            where
+                t.Type = 100
+                {accounts}
+            group by
+                t.RegId1
+        )sql" },
 
-        // DelCount
-        {
-            unordered_map<int64_t, int64_t> _map;
-            SqlTransaction(
-                "CollectAccountStatistic_DelCount_Get",
-                [&]() -> Stmt& {
-                    return Sql(R"sql(
-                        select
-                            t.RegId1,
-                            count()
-                        from
-                            Transactions t
-                        cross join
-                            Last l on
-                                l.TxId = t.RowId
-                        cross join
-                            Transactions po indexed by Transactions_Type_RegId1_RegId2_RegId3 on
-                                po.Type in (207) and
-                                po.RegId1 = t.RegId1
-                        cross join
-                            Last lpo
-                                on lpo.TxId = po.RowId
-                        where
-                            t.Type = 100
-                        group by
-                            t.RegId1
-                    )sql");
-                },
-                [&] (Stmt& stmt) {
-                    stmt.Select([&](Cursor& cursor) {
-                        while (cursor.Step())
-                        {
-                            int64_t regId1, count;
-                            if (cursor.CollectAll(regId1, count))
-                                _map.emplace(regId1, count);
-                        }
-                    });
-                }
-            );
+        // SubscribersCount
+        { 4, "t.RegId1", R"sql(
+            select
+                t.RegId1,
+                count()
+            from
+                Transactions t
+            cross join
+                Last l on
+                    l.TxId = t.RowId
+            cross join
+                Transactions subs indexed by Transactions_Type_RegId2_RegId1 on
+                    subs.Type in (302, 303) and
+                    subs.RegId2 = t.RegId1
+            cross join
+                Last lsubs
+                    on lsubs.TxId = subs.RowId
+            cross join
+                Transactions uas indexed by Transactions_Type_RegId1_RegId2_RegId3
+                    on uas.Type in (100) and uas.RegId1 = subs.RegId1
+            cross join
+                Last luas
+                    on luas.TxId = uas.RowId
+            where
+                t.Type = 100
+                {accounts}
+            group by
+                t.RegId1
+        )sql" },
 
-            SqlTransaction("CollectAccountStatistic_DelCount_Set", [&]()
-            {
-                Sql(R"sql(
-                    delete from web.AccountStatistic where Type = 2
-                )sql").Run();
+        // FlagsJson
+        { 5, "t.RegId1", R"sql(
+            select
+                gr.AccId,
+                json_group_object(gr.Type, gr.Cnt)
+            from (
+                select
+                    t.RegId1 as AccId,
+                    f.Int1 as Type,
+                    count() as Cnt
+                from
+                    Transactions t
+                cross join
+                    Last l on
+                        l.TxId = t.RowId
+                cross join
+                    Transactions f indexed by Transactions_Type_RegId3_RegId1 on
+                        f.Type in (410) and
+                        f.RegId3 = t.RegId1
+                cross join
+                    Chain c on
+                        c.TxId = f.RowId
+                where
+                    t.Type = 100
+                    {accounts}
+                group by
+                    t.RegId1, f.Int1
+            )gr
+            group by
+                gr.AccId
+        )sql" },
 
-                for (auto& x : _map) {
-                    Sql(R"sql(
-                        insert into web.AccountStatistic (AccountRegId, Type, Data)
-                        values (?, 2, ?)
-                    )sql").Bind(x.first, x.second).Run();
-                }
-            });
-        }
+        // FirstFlagsCount
+        { 6, "f.RegId3", R"sql(
+            select
+                gr.AccRegId,
+                json_group_object(gr.Type, gr.Cnt)
+            from (
+                select
+                    gr.AccRegId,
+                    gr.Type,
+                    count() as Cnt
+                from (
+                    select
+                        f.RegId3 as AccRegId,
+                        f.Int1 as Type,
+                        cf.Height,
+                        min(cfp.Height) as minHeight
+                    from
+                        Transactions f indexed by Transactions_Type_RegId3_RegId1
+                    cross join
+                        Transactions fp indexed by Transactions_Type_RegId1_RegId2_RegId3 on
+                            fp.Type in (200, 201, 202, 209, 210) and
+                            fp.RegId1 = f.RegId3
+                    cross join
+                        First ffp
+                            on ffp.TxId = fp.RowId
+                    cross join
+                        Chain cfp indexed by Chain_TxId_Height
+                            on cfp.TxId = fp.RowId
+                    cross join
+                        Chain cf indexed by Chain_TxId_Height
+                            on cf.TxId = f.RowId
+                    where
+                        f.Type in (410)
+                        {accounts}
+                    group by
+                        f.RegId3, f.Int1
+                )gr
+                where
+                    gr.Height >= gr.minHeight and
+                    gr.Height <= (gr.minHeight + (14 * 1440))
+                group by
+                    gr.AccRegId,
+                    gr.Type
+            )gr
+            group by
+                gr.AccRegId
+        )sql" },
+
+        // ActionsCount - all social transactions including mempool
+        { 7, "t.RegId1", R"sql(
+            select
+                t.RegId1,
+                count()
+            from
+                Transactions t
+            where
+                t.Type in (100,103,104,170,200,201,202,204,205,206,207,208,209,210,211,220,221,300,301,302,303,304,305,306,307,410,420)
+                {accounts}
+            group by
+                t.RegId1
+        )sql" },
 
-        // SubscribesCount
+        // Last 5 Contents
+        { 8, "t.RegId1", R"sql(
+            select
+                t.RegId1,
+                ifnull((
+                    select sum(ifnull(ptr.Value,0))
+                    from (
+                        select cpt.Uid
+                        from Transactions pt indexed by Transactions_Type_RegId1_RegId2_RegId3
+                        join Chain cpt on cpt.TxId = pt.RowId
+                        join Last lpt on lpt.TxId = pt.RowId
+                        where pt.Type in ( 200,201,202,209,210,211 )
+                            and pt.RegId1 = t.RegId1
+                            and cpt.Height < ctml.Height
+                            and cpt.Height > (ctml.Height - 43200)
+                        order by cpt.Height desc
+                        limit 5
+                    )q
+                    left join Ratings ptr indexed by Ratings_Type_Uid_Last_Height
+                        on ptr.Type = 2 and ptr.Uid = q.Uid and ptr.Last = 1
+                ), 0)SumRating
+            from
+                Transactions t
+            cross join
+                Last l on
+                    l.TxId = t.RowId
+            cross join
+                Transactions tm on
+                    tm.Type in ( 200,201,202,209,210,211 ) and
+                    tm.RegId1 = t.RegId1 and
+                    tm.RowId = (select max(tml.RowId) from Transactions tml where tml.Type in ( 200,201,202,209,210,211 ) and tml.RegId1 = t.RegId1)
+            cross join
+                Chain ctml on
+                    ctml.TxId = tm.RowId
+            where
+                t.Type in (100)
+                {accounts}
+        )sql" },
+    };
+
+    void WebRepository::InsertAccountStatistic(const string& accounts)
+    {
+        for (const auto& query : accountStatisticQueries)
         {
-            unordered_map<int64_t, int64_t> _map;
-            SqlTransaction(
-                "CollectAccountStatistic_SubscribesCount_Get",
-                [&]() -> Stmt& {
-                    return Sql(R"sql(
-                        select
-                            t.RegId1,
-                            count()
-                        from
-                            Transactions t
-                        cross join
-                            Last l on
-                                l.TxId = t.RowId
-                        cross join
-                            Transactions subs indexed by Transactions_Type_RegId1_RegId2_RegId3 on
-                                subs.Type in (302, 303) and
-                                subs.RegId1 = t.RegId1
-                        cross join
-                            Last lsubs
-                                on lsubs.TxId = subs.RowId
-                        cross join
-                            Transactions uas indexed by Transactions_Type_RegId1_RegId2_RegId3
-                                on uas.Type in (100) and uas.RegId1 = subs.RegId2
-                        cross join
-                            Last luas
-                                on luas.TxId = uas.RowId
-                        where
-                            t.Type = 100
-                        group by
-                            t.RegId1
-                    )sql");
-                },
-                [&] (Stmt& stmt) {
-                    stmt.Select([&](Cursor& cursor) {
-                        while (cursor.Step())
-                        {
-                            int64_t regId1, count;
-                            if (cursor.CollectAll(regId1, count))
-                                _map.emplace(regId1, count);
-                        }
-                    });
-                }
-            );
+            auto filter = accounts.empty() ? "" : "and " + query.AccountColumn + " in (select value from json_each(?))";
 
-            SqlTransaction("CollectAccountStatistic_SubscribesCount_Set", [&]()
-            {
-                Sql(R"sql(
-                    delete from web.AccountStatistic where Type = 3
-                )sql").Run();
+            auto& stmt = Sql(R"sql(
+                with
+                    q (AccountRegId, Data) as (
+                        )sql" + boost::replace_all_copy(query.Sql, "{accounts}", filter) + R"sql(
+                    )
+                insert into web.AccountStatistic (AccountRegId, Type, Data)
+                select
+                    q.AccountRegId,
+                    )sql" + to_string(query.Type) + R"sql(,
+                    q.Data
+                from
+                    q
+            )sql");
 
-                for (auto& x : _map) {
-                    Sql(R"sql(
-                        insert into web.AccountStatistic (AccountRegId, Type, Data)
-                        values (?, 3, ?)
-                    )sql").Bind(x.first, x.second).Run();
-                }
-            });
+            if (!accounts.empty())
+                stmt.Bind(accounts);
+
+            stmt.Run();
         }
+    }
 
-        // SubscribersCount
+    void WebRepository::CollectAccountStatistic()
+    {
+        SqlTransaction(__func__, [&]()
         {
-            unordered_map<int64_t, int64_t> _map;
-            SqlTransaction(
-                "CollectAccountStatistic_SubscribersCount_Get",
-                [&]() -> Stmt& {
-                    return Sql(R"sql(
-                        select
-                            t.RegId1,
-                            count()
-                        from
-                            Transactions t
-                        cross join
-                            Last l on
-                                l.TxId = t.RowId
-                        cross join
-                            Transactions subs indexed by Transactions_Type_RegId2_RegId1 on
-                                subs.Type in (302, 303) and
-                                subs.RegId2 = t.RegId1
-                        cross join
-                            Last lsubs
-                                on lsubs.TxId = subs.RowId
-                        cross join
-                            Transactions uas indexed by Transactions_Type_RegId1_RegId2_RegId3
-                                on uas.Type in (100) and uas.RegId1 = subs.RegId1
-                        cross join
-                            Last luas
-                                on luas.TxId = uas.RowId
-                        where
-                            t.Type = 100
-                        group by
-                            t.RegId1
-                    )sql");
-                },
-                [&] (Stmt& stmt) {
-                    stmt.Select([&](Cursor& cursor) {
-                        while (cursor.Step())
-                        {
-                            int64_t regId1, count;
-                            if (cursor.CollectAll(regId1, count))
-                                _map.emplace(regId1, count);
-                        }
-                    });
-                }
-            );
+            Sql(R"sql(
+                delete from web.AccountStatistic
+            )sql").Run();
 
-            SqlTransaction("CollectAccountStatistic_SubscribersCount_Set", [&]()
-            {
-                Sql(R"sql(
-                    delete from web.AccountStatistic where Type = 4
-                )sql").Run();
+            InsertAccountStatistic("");
+        });
+    }
 
-                for (auto& x : _map) {
-                    Sql(R"sql(
-                        insert into web.AccountStatistic (AccountRegId, Type, Data)
-                        values (?, 4, ?)
-                    )sql").Bind(x.first, x.second).Run();
-                }
-            });
-        }
+    int WebRepository::GetAccountStatisticHeight()
+    {
+        int result = -1;
 
-        // FlagsJson
+        SqlTransaction(__func__, [&]()
         {
-            unordered_map<int64_t, string> _map;
-            SqlTransaction(
-                "CollectAccountStatistic_FlagsJson_Get",
-                [&]() -> Stmt& {
-                    return Sql(R"sql(
-                        select
-                            gr.AccId,
-                            json_group_object(gr.Type, gr.Cnt)
-                        from (
-                            select
-                                t.RegId1 as AccId,
-                                f.Int1 as Type,
-                                count() as Cnt
-                            from
-                                Transactions t
-                            cross join
-                                Last l on
-                                    l.TxId = t.RowId
-                            cross join
-                                Transactions f indexed by Transactions_Type_RegId3_RegId1 on
-                                    f.Type in (410) and
-                                    f.RegId3 = t.RegId1
-                            cross join
-                                Chain c on
-                                    c.TxId = f.RowId
-                            where
-                                t.Type = 100
-                            group by
-                                t.RegId1, f.Int1
-                        )gr
-                        group by
-                            gr.AccId
-                    )sql");
-                },
-                [&] (Stmt& stmt) {
-                    stmt.Select([&](Cursor& cursor) {
-                        while (cursor.Step())
-                        {
-                            int64_t regId1;
-                            string value;
-                            if (cursor.CollectAll(regId1, value))
-                                _map.emplace(regId1, value);
-                        }
-                    });
-                }
-            );
+            Sql(R"sql(
+                select
+                    Value
+                from
+                    web.System
+                where
+                    Key = 'AccountStatisticHeight'
+                limit 1
+            )sql")
+            .Select([&](Cursor& cursor) {
+                if (cursor.Step())
+                    cursor.CollectAll(result);
+            });
+        });
 
-            SqlTransaction("CollectAccountStatistic_FlagsJson_Set", [&]()
-            {
-                Sql(R"sql(
-                    delete from web.AccountStatistic where Type = 5
-                )sql").Run();
+        return result;
+    }
 
-                for (auto& x : _map) {
-                    Sql(R"sql(
-                        insert into web.AccountStatistic (AccountRegId, Type, Data)
-                        values (?, 5, ?)
-                    )sql").Bind(x.first, x.second).Run();
-                }
-            });
-        }
+    int WebRepository::RepairAccountStatistic()
+    {
+        int height = 0;
 
-        // FirstFlagsCount
+        // Recompute and its height are taken from one state of chain
+        SqlTransaction(__func__, [&]()
         {
-            unordered_map<int64_t, string> _map;
-            SqlTransaction(
-                "CollectAccountStatistic_FirstFlagsCount_Get",
-                [&]() -> Stmt& {
-                    return Sql(R"sql(
-                        select
-                            gr.AccRegId,
-                            json_group_object(gr.Type, gr.Cnt)
-                        from (
-                            select
-                                gr.AccRegId,
-                                gr.Type,
-                                count() as Cnt
-                            from (
-                                select
-                                    f.RegId3 as AccRegId,
-                                    f.Int1 as Type,
-                                    cf.Height,
-                                    min(cfp.Height) as minHeight
-                                from
-                                    Transactions f indexed by Transactions_Type_RegId3_RegId1
-                                cross join
-                                    Transactions fp indexed by Transactions_Type_RegId1_RegId2_RegId3 on
-                                        fp.Type in (200, 201, 202, 209, 210) and
-                                        fp.RegId1 = f.RegId3
-                                cross join
-                                    First ffp
-                                        on ffp.TxId = fp.RowId
-                                cross join
-                                    Chain cfp indexed by Chain_TxId_Height
-                                        on cfp.TxId = fp.RowId
-                                cross join
-                                    Chain cf indexed by Chain_TxId_Height
-                                        on cf.TxId = f.RowId
-                                where
-                                    f.Type in (410)
-                                group by
-                                    f.RegId3, f.Int1
-                            )gr
-                            where
-                                gr.Height >= gr.minHeight and
-                                gr.Height <= (gr.minHeight + (14 * 1440))
-                            group by
-                                gr.AccRegId,
-                                gr.Type
-                        )gr
-                        group by
-                            gr.AccRegId
-                    )sql");
-                },
-                [&] (Stmt& stmt) {
-                    stmt.Select([&](Cursor& cursor) {
-                        while (cursor.Step())
-                        {
-                            int64_t regId1;
-                            string value;
-                            if (cursor.CollectAll(regId1, value))
-                                _map.emplace(regId1, value);
-                        }
-                    });
-                }
-            );
+            Sql(R"sql(
+                select ifnull(max(Height), 0) from Chain
+            )sql")
+            .Select([&](Cursor& cursor) {
+                if (cursor.Step())
+                    cursor.CollectAll(height);
+            });
 
-            SqlTransaction("CollectAccountStatistic_FirstFlagsCount_Set", [&]()
-            {
-                Sql(R"sql(
-                    delete from web.AccountStatistic where Type = 6
-                )sql").Run();
+            Sql(R"sql(
+                delete from web.AccountStatistic
+            )sql").Run();
 
-                for (auto& x : _map) {
-                    Sql(R"sql(
-                        insert into web.AccountStatistic (AccountRegId, Type, Data)
-                        values (?, 6, ?)
-                    )sql").Bind(x.first, x.second).Run();
-                }
+            InsertAccountStatistic("");
+
+            // Values changed before repair can not be restored
+            Sql(R"sql( delete from web.AccountStatisticJournal )sql").Run();
+
+            // Blocks above recompute are processed again
+            Sql(R"sql( delete from web.ProcessedBlocks where Height > ? )sql")
+                .Bind(height)
+                .Run();
+
+            Sql(R"sql(
+                insert into web.System (Key, Value) values ('AccountStatisticHeight', ?)
+                on conflict (Key) do update set Value = ? where Key = 'AccountStatisticHeight'
+            )sql")
+            .Bind(height, height)
+            .Run();
+        });
+
+        return height;
+    }
+
+    string WebRepository::GetProcessedBlock(int height)
+    {
+        string result;
+
+        SqlTransaction(__func__, [&]()
+        {
+            Sql(R"sql(
+                select
+                    Hash
+                from
+                    web.ProcessedBlocks
+                where
+                    Height = ?
+            )sql")
+            .Bind(height)
+            .Select([&](Cursor& cursor) {
+                if (cursor.Step())
+                    cursor.CollectAll(result);
             });
-        }
+        });
+
+        return result;
+    }
+
+    bool WebRepository::UpdateAccountStatistic(int height, const string& blockHash)
+    {
+        bool visible = true;
 
-        // ActionsCount
+        SqlTransaction(__func__, [&]()
         {
-            unordered_map<int64_t, int64_t> _map;
-            SqlTransaction(
-                "CollectAccountStatistic_ActionsCount_Get",
-                [&]() -> Stmt& {
-                    return Sql(R"sql(
+            // Same block can be processed again after crash before SetCurrentHeight
+            bool processed = false;
+            Sql(R"sql(
+                select 1 from web.ProcessedBlocks where Height = ? and Hash = ?
+            )sql")
+            .Bind(height, blockHash)
+            .Select([&](Cursor& cursor) {
+                processed = cursor.Step();
+            });
+
+            if (processed)
+                return;
+
+            // Block must be committed to the main database before its statistic is applied
+            Sql(R"sql(
+                select
+                    1
+                from
+                    Chain c indexed by Chain_BlockId_Height
+                where
+                    c.BlockId = (
                         select
-                            t.RegId1,
-                            count()
+                            r.RowId
                         from
-                            Transactions t
+                            Registry r
                         where
-                            t.Type >= 100
-                        group by
-                            t.RegId1
-                    )sql");
-                },
-                [&] (Stmt& stmt) {
-                    stmt.Select([&](Cursor& cursor) {
-                        while (cursor.Step())
-                        {
-                            int64_t regId1, count;
-                            if (cursor.CollectAll(regId1, count))
-                                _map.emplace(regId1, count);
-                        }
-                    });
-                }
-            );
+                            r.String = ?
+                    ) and
+                    c.Height = ?
+                limit 1
+            )sql")
+            .Bind(blockHash, height)
+            .Select([&](Cursor& cursor) {
+                visible = cursor.Step();
+            });
 
-            SqlTransaction("CollectAccountStatistic_ActionsCount_Set", [&]()
-            {
-                Sql(R"sql(
-                    delete from web.AccountStatistic where Type = 7
-                )sql").Run();
+            if (!visible)
+                return;
 
-                for (auto& x : _map) {
-                    Sql(R"sql(
-                        insert into web.AccountStatistic (AccountRegId, Type, Data)
-                        values (?, 7, ?)
-                    )sql").Bind(x.first, x.second).Run();
-                }
+            Sql(R"sql(
+                insert or replace into web.ProcessedBlocks (Height, Hash) values (?, ?)
+            )sql")
+            .Bind(height, blockHash)
+            .Run();
+
+            Sql(R"sql(
+                delete from web.ProcessedBlocks where Height <= ?
+            )sql")
+            .Bind(height - WEB_STATISTIC_JOURNAL_DEPTH)
+            .Run();
+
+            Sql(R"sql(
+                delete from web.AccountStatisticJournal where Height <= ?
+            )sql")
+            .Bind(height - WEB_STATISTIC_JOURNAL_DEPTH)
+            .Run();
+
+            // Block is already included in last full recompute
+            int statisticHeight = -1;
+            Sql(R"sql(
+                select Value from web.System where Key = 'AccountStatisticHeight'
+            )sql")
+            .Select([&](Cursor& cursor) {
+                if (cursor.Step())
+                    cursor.CollectAll(statisticHeight);
             });
-        }
 
-        // Last 5 Contents
-        {
-            unordered_map<int64_t, int64_t> _map;
-            SqlTransaction(
-                "CollectAccountStatistic_Last5Content_Get",
-                [&]() -> Stmt& {
-                    return Sql(R"sql(
+            if (height <= statisticHeight)
+                return;
+
+            // Accounts which statistic can be changed by block
+            UniValue accounts(UniValue::VARR);
+            Sql(R"sql(
+                with
+                    block as (
                         select
+                            c.Height,
+                            c.BlockNum,
+                            t.Type,
                             t.RegId1,
-                            ifnull((
-                                select sum(ifnull(ptr.Value,0))
-                                from (
-                                    select cpt.Uid
-                                    from Transactions pt indexed by Transactions_Type_RegId1_RegId2_RegId3
-                                    join Chain cpt on cpt.TxId = pt.RowId
-                                    join Last lpt on lpt.TxId = pt.RowId
-                                    where pt.Type in ( 200,201,202,209,210,211 )
-                                        and pt.RegId1 = t.RegId1
-                                        and cpt.Height < ctml.Height
-                                        and cpt.Height > (ctml.Height - 43200)
-                                    order by cpt.Height desc
-                                    limit 5
-                                )q
-                                left join Ratings ptr indexed by Ratings_Type_Uid_Last_Height
-                                    on ptr.Type = 2 and ptr.Uid = q.Uid and ptr.Last = 1
-                            ), 0)SumRating
+                            t.RegId2,
+                            t.RegId3
                         from
-                            Transactions t
-                        cross join
-                            Last l on
-                                l.TxId = t.RowId
-                        cross join
-                            Transactions tm on
-                                tm.Type in ( 200,201,202,209,210,211 ) and
-                                tm.RegId1 = t.RegId1 and
-                                tm.RowId = (select max(tml.RowId) from Transactions tml where tml.Type in ( 200,201,202,209,210,211 ) and tml.RegId1 = t.RegId1)
+                            Chain c
                         cross join
-                            Chain ctml on
-                                ctml.TxId = tm.RowId
+                            Transactions t on
+                                t.RowId = c.TxId and
+                                t.Type >= 100
                         where
-                            t.Type in (100)
-                    )sql");
-                },
-                [&] (Stmt& stmt) {
-                    stmt.Select([&](Cursor& cursor) {
-                        while (cursor.Step())
-                        {
-                            int64_t regId1, count;
-                            if (cursor.CollectAll(regId1, count))
-                                _map.emplace(regId1, count);
-                        }
-                    });
-                }
-            );
+                            c.Height = ?
+                    ),
+                    -- Registered or deleted accounts change subscriptions counters of both sides
+                    accounts as (
+                        select
+                            b.RegId1
+                        from
+                            block b
+                        where
+                            b.Type = 170 or (
+                                b.Type = 100 and
+                                ifnull((
+                                    select
+                                        pa.Type
+                                    from
+                                        Transactions pa indexed by Transactions_Type_RegId1_RegId2_RegId3
+                                    cross join
+                                        Chain cpa on
+                                            cpa.TxId = pa.RowId
+                                    where
+                                        pa.Type in (100, 170) and
+                                        pa.RegId1 = b.RegId1 and
+                                        (cpa.Height < b.Height or (cpa.Height = b.Height and cpa.BlockNum < b.BlockNum))
+                                    order by
+                                        cpa.Height desc,
+                                        cpa.BlockNum desc
+                                    limit 1
+                                ), 170) = 170
+                            )
+                    )
 
-            SqlTransaction("CollectAccountStatistic_Last5Content_Set", [&]()
-            {
-                Sql(R"sql(
-                    delete from web.AccountStatistic where Type = 8
-                )sql").Run();
+                -- Authors of all actions
+                select b.RegId1 from block b
 
-                for (auto& x : _map) {
-                    Sql(R"sql(
-                        insert into web.AccountStatistic (AccountRegId, Type, Data)
-                        values (?, 8, ?)
-                    )sql").Bind(x.first, x.second).Run();
+                union
+
+                -- Subscribed accounts
+                select b.RegId2 from block b where b.Type in (302, 303, 304)
+
+                union
+
+                -- Flagged accounts
+                select b.RegId3 from block b where b.Type in (410)
+
+                union
+
+                -- Authors of scored contents - ratings of last contents
+                select
+                    p.RegId1
+                from
+                    block b
+                cross join
+                    Transactions p on
+                        p.RowId = b.RegId2
+                where
+                    b.Type in (300)
+
+                union
+
+                select
+                    subs.RegId2
+                from
+                    accounts a
+                cross join
+                    Transactions subs indexed by Transactions_Type_RegId1_RegId2_RegId3 on
+                        subs.Type in (302, 303) and
+                        subs.RegId1 = a.RegId1
+                cross join
+                    Last l on
+                        l.TxId = subs.RowId
+
+                union
+
+                select
+                    subs.RegId1
+                from
+                    accounts a
+                cross join
+                    Transactions subs indexed by Transactions_Type_RegId2_RegId1 on
+                        subs.Type in (302, 303) and
+                        subs.RegId2 = a.RegId1
+                cross join
+                    Last l on
+                        l.TxId = subs.RowId
+            )sql")
+            .Bind(height)
+            .Select([&](Cursor& cursor) {
+                while (cursor.Step())
+                {
+                    int64_t acc;
+                    if (cursor.CollectAll(acc))
+                        accounts.push_back(acc);
                 }
             });
-        }
+
+            if (accounts.empty())
+                return;
+
+            auto accountsJson = accounts.write();
+
+            // Previous values of all types are saved once per height for rollback, null if value not exists
+            Sql(R"sql(
+                insert or ignore into web.AccountStatisticJournal (Height, AccountRegId, Type, Data)
+                select
+                    ?,
+                    a.value,
+                    t.value,
+                    (select s.Data from web.AccountStatistic s where s.AccountRegId = a.value and s.Type = t.value)
+                from
+                    json_each(?) a,
+                    json_each('[1,2,3,4,5,6,7,8]') t
+            )sql")
+            .Bind(height, accountsJson)
+            .Run();
+
+            Sql(R"sql(
+                delete from web.AccountStatistic where AccountRegId in (select value from json_each(?))
+            )sql")
+            .Bind(accountsJson)
+            .Run();
+
+            InsertAccountStatistic(accountsJson);
+        });
+
+        return visible;
     }
 
+    bool WebRepository::RollbackAccountStatistic(int height)
+    {
+        bool restored = false;
+
+        SqlTransaction(__func__, [&]()
+        {
+            // Values of blocks included in full recompute are not journaled
+            int statisticHeight = -1;
+            Sql(R"sql(
+                select Value from web.System where Key = 'AccountStatisticHeight'
+            )sql")
+            .Select([&](Cursor& cursor) {
+                if (cursor.Step())
+                    cursor.CollectAll(statisticHeight);
+            });
+
+            if (height <= statisticHeight)
+                return;
+
+            Sql(R"sql(
+                delete from web.AccountStatistic
+                where exists (
+                    select 1
+                    from web.AccountStatisticJournal j
+                    where j.Height = ? and
+                          j.AccountRegId = web.AccountStatistic.AccountRegId and
+                          j.Type = web.AccountStatistic.Type
+                )
+            )sql")
+            .Bind(height)
+            .Run();
+
+            Sql(R"sql(
+                insert into web.AccountStatistic (AccountRegId, Type, Data)
+                select j.AccountRegId, j.Type, j.Data
+                from web.AccountStatisticJournal j
+                where j.Height = ? and j.Data is not null
+            )sql")
+            .Bind(height)
+            .Run();
+
+            Sql(R"sql( delete from web.AccountStatisticJournal where Height = ? )sql")
+                .Bind(height)
+                .Run();
+
+            Sql(R"sql( delete from web.ProcessedBlocks where Height = ? )sql")
+                .Bind(height)
+                .Run();
+
+            restored = true;
+        });
+
+        return restored;
+    }
 }
\ No newline at end of file
@@ -15,6 +15,9 @@
 #include "pocketdb/models/web/WebTag.h"
 #include "pocketdb/models/web/WebContent.h"
 
+// Heights of web account statistic changes kept for rollback on reorganization
+static const int WEB_STATISTIC_JOURNAL_DEPTH = 1440;
+
 namespace PocketDb
 {
     using namespace PocketDbWeb;
@@ -31,17 +34,41 @@ namespace PocketDb
         int GetCurrentHeight();
         void SetCurrentHeight(int height);
 
-        vector<WebTag> GetContentTags(int height);
-        vector<WebTag> GetAppTags(int height);
+        // Block is indexed in Chain and visible for this connection
+        bool ExistsBlock(const string& blockHash, int height);
+
+        // Heights range is inclusive
+        vector<WebTag> GetContentTags(int heightFrom, int heightTo);
+        vector<WebTag> GetAppTags(int heightFrom, int heightTo);
         void UpsertContentTags(const vector<WebTag>& contentTags);
 
-        vector<WebContent> GetContent(int height);
+        vector<WebContent> GetContent(int heightFrom, int heightTo);
         void UpsertContent(const vector<WebContent>& contentList);
 
         void UpsertBarteronAccounts(int height);
         void UpsertBarteronOffers(int height);
 
+        // Full recompute of account statistic
         void CollectAccountStatistic();
+        // Full recompute with clean journal, returns chain height included in the recompute
+        int RepairAccountStatistic();
+        // Height of last full recompute or -1 if statistic was never collected
+        int GetAccountStatisticHeight();
+
+        // Recompute statistic of accounts changed by block at height, previous values are journaled.
+        // Values reflect committed chain at the moment of update, so they are equal to full recompute
+        // once the processing reaches the chain tip. Returns false if block is not committed yet.
+        bool UpdateAccountStatistic(int height, const string& blockHash);
+        // Restore statistic values changed by block at height.
+        // Returns false if block is included in full recompute and can not be restored.
+        bool RollbackAccountStatistic(int height);
+        // Hash of block processed at height or empty string
+        string GetProcessedBlock(int height);
+
+    private:
+        // Insert full recompute values of accounts from JSON array or of all accounts for empty string.
+        // Must be called inside SqlTransaction
+        void InsertAccountStatistic(const string& accounts);
     };
 
     typedef shared_ptr<WebRepository> WebRepositoryRef;
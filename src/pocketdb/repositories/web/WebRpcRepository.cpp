@@ -1449,9 +1449,10 @@ namespace PocketDb
         return result;
     }
 
-    UniValue WebRpcRepository::GetCommentsByPost(const string& postHash, const string& parentHash, const string& addressHash)
+    string WebRpcRepository::GetCommentsByPost(const string& postHash, const string& parentHash, const string& addressHash)
     {
-        auto result = UniValue(UniValue::VARR);
+        JsonWriter result;
+        result.BeginArray();
 
         string parentWhere = " and c.RegId4 is null ";
         if (!parentHash.empty())
@@ -1605,73 +1606,71 @@ namespace PocketDb
                 stmt.Select([&](Cursor& cursor) {
                     while (cursor.Step())
                     {
-                        UniValue record(UniValue::VOBJ);
-
-                        auto[ok1, rootTxHash] = cursor.TryGetColumnString(2);
-                        record.pushKV("id", rootTxHash);
-
-                        if (auto[ok, value] = cursor.TryGetColumnString(3); ok)
-                            record.pushKV("postid", value);
-
-                        if (auto[ok, value] = cursor.TryGetColumnString(4); ok) record.pushKV("address", value);
-                        if (auto[ok, value] = cursor.TryGetColumnInt64(5); ok) record.pushKV("time", to_string(value));
-                        if (auto[ok, value] = cursor.TryGetColumnInt64(6); ok) record.pushKV("timeUpd", to_string(value));
-                        if (auto[ok, value] = cursor.TryGetColumnInt64(7); ok) record.pushKV("block", to_string(value));
-                        if (auto[ok, value] = cursor.TryGetColumnString(8); ok) record.pushKV("msg", value);
-                        if (auto[ok, value] = cursor.TryGetColumnString(9); ok) record.pushKV("parentid", value);
-                        if (auto[ok, value] = cursor.TryGetColumnString(10); ok) record.pushKV("answerid", value);
-                        if (auto[ok, value] = cursor.TryGetColumnInt64(11); ok) record.pushKV("scoreUp", to_string(value));
-                        if (auto[ok, value] = cursor.TryGetColumnInt64(12); ok) record.pushKV("scoreDown", to_string(value));
-                        if (auto[ok, value] = cursor.TryGetColumnInt64(13); ok) record.pushKV("reputation", to_string(value));
-                        if (auto[ok, value] = cursor.TryGetColumnInt64(14); ok && !addressHash.empty()) record.pushKV("myScore", to_string(value));
-                        if (auto[ok, value] = cursor.TryGetColumnInt64(15); ok) record.pushKV("children", to_string(value));
+                        result.BeginObject();
+
+                        auto[ok1, rootTxHash] = cursor.TryGetColumnStringView(2);
+                        result.Member("id", rootTxHash);
+
+                        if (auto[ok, value] = cursor.TryGetColumnStringView(3); ok)
+                            result.Member("postid", value);
+
+                        if (auto[ok, value] = cursor.TryGetColumnStringView(4); ok) result.Member("address", value);
+                        if (auto[ok, value] = cursor.TryGetColumnInt64(5); ok) result.Member("time", to_string(value));
+                        if (auto[ok, value] = cursor.TryGetColumnInt64(6); ok) result.Member("timeUpd", to_string(value));
+                        if (auto[ok, value] = cursor.TryGetColumnInt64(7); ok) result.Member("block", to_string(value));
+                        if (auto[ok, value] = cursor.TryGetColumnStringView(8); ok) result.Member("msg", value);
+                        if (auto[ok, value] = cursor.TryGetColumnStringView(9); ok) result.Member("parentid", value);
+                        if (auto[ok, value] = cursor.TryGetColumnStringView(10); ok) result.Member("answerid", value);
+                        if (auto[ok, value] = cursor.TryGetColumnInt64(11); ok) result.Member("scoreUp", to_string(value));
+                        if (auto[ok, value] = cursor.TryGetColumnInt64(12); ok) result.Member("scoreDown", to_string(value));
+                        if (auto[ok, value] = cursor.TryGetColumnInt64(13); ok) result.Member("reputation", to_string(value));
+                        if (auto[ok, value] = cursor.TryGetColumnInt64(14); ok && !addressHash.empty()) result.Member("myScore", to_string(value));
+                        if (auto[ok, value] = cursor.TryGetColumnInt64(15); ok) result.Member("children", to_string(value));
 
                         if (auto[ok, value] = cursor.TryGetColumnInt64(16); ok)
                         {
-                            record.pushKV("amount", value);
-                            record.pushKV("donation", "true");
+                            result.Member("amount", value);
+                            result.Member("donation", "true");
                         }
 
                         if (auto[ok, value] = cursor.TryGetColumnInt(17); ok && value > 0)
-                            record.pushKV("blck_cnt_cmt", 1);
+                            result.Member("blck_cnt_cmt", 1);
                         if (auto[ok, value] = cursor.TryGetColumnInt(18); ok && value > 0)
-                            record.pushKV("blck_cmt_cnt", 1);
+                            result.Member("blck_cmt_cnt", 1);
 
-                        if (auto[ok, value] = cursor.TryGetColumnString(19); ok)
-                        {
-                            UniValue flags(UniValue::VOBJ);
-                            flags.read(value);
-                            record.pushKV("flags", flags);
-                        };
+                        // Object built by json_group_object written as is
+                        if (auto[ok, value] = cursor.TryGetColumnStringView(19); ok)
+                            result.Key("flags").Raw(value);
 
                         if (auto[ok, value] = cursor.TryGetColumnInt(0); ok)
                         {
                             switch (static_cast<TxType>(value))
                             {
                                 case PocketTx::CONTENT_COMMENT:
-                                    record.pushKV("deleted", false);
-                                    record.pushKV("edit", false);
+                                    result.Member("deleted", false);
+                                    result.Member("edit", false);
                                     break;
                                 case PocketTx::CONTENT_COMMENT_EDIT:
-                                    record.pushKV("deleted", false);
-                                    record.pushKV("edit", true);
+                                    result.Member("deleted", false);
+                                    result.Member("edit", true);
                                     break;
                                 case PocketTx::CONTENT_COMMENT_DELETE:
-                                    record.pushKV("deleted", true);
-                                    record.pushKV("edit", true);
+                                    result.Member("deleted", true);
+                                    result.Member("edit", true);
                                     break;
                                 default:
                                     break;
                             }
                         }
 
-                        result.push_back(record);
+                        result.EndObject();
                     }
                 });
             }
         );
 
-        return result;
+        result.EndArray();
+        return result.Release();
     }
 
     map<string, UniValue> WebRpcRepository::GetCommentsByHashes(const vector<string>& cmntHashes, const string& addressHash)
@@ -2446,9 +2445,10 @@ namespace PocketDb
         return result;
     }
 
-    UniValue WebRpcRepository::GetSubscribersAddresses(const string& address, const vector<TxType>& types, const string& orderBy, bool orderDesc, int offset, int limit)
+    string WebRpcRepository::GetSubscribersAddresses(const string& address, const vector<TxType>& types, const string& orderBy, bool orderDesc, int offset, int limit)
     {
-        UniValue result(UniValue::VARR);
+        JsonWriter result;
+        result.BeginArray();
 
         string sql = R"sql(
             with
@@ -2519,27 +2519,28 @@ namespace PocketDb
                 stmt.Select([&](Cursor& cursor) {
                     while (cursor.Step())
                     {
-                        UniValue record(UniValue::VOBJ);
+                        result.BeginObject();
 
-                        if (auto[ok, value] = cursor.TryGetColumnString(0); ok)
-                            record.pushKV("address", value);
+                        if (auto[ok, value] = cursor.TryGetColumnStringView(0); ok)
+                            result.Member("address", value);
 
                         if (auto[ok, value] = cursor.TryGetColumnInt(1); ok)
-                            record.pushKV("private", value);
+                            result.Member("private", value);
 
                         if (auto[ok, value] = cursor.TryGetColumnInt(2); ok)
-                            record.pushKV("reputation", value);
+                            result.Member("reputation", value);
 
                         if (auto[ok, value] = cursor.TryGetColumnInt(3); ok)
-                            record.pushKV("height", value);
+                            result.Member("height", value);
 
-                        result.push_back(record);
+                        result.EndObject();
                     }
                 });
             }
         );
 
-        return result;
+        result.EndArray();
+        return result.Release();
     }
 
     UniValue WebRpcRepository::GetBlockings(const string& address, bool useAddresses)
@@ -2843,30 +2844,19 @@ namespace PocketDb
         SqlTransaction(
             __func__,
             [&]() -> Stmt&  {
-                return Sql(R"sql(
-                    with
-                    tx as (
-                        select
-                            r.RowId as id,
-                            r.String as hash
-                        from
-                            Registry r
-                        where
-                            r.String in ( )sql" + join(vector<string>(txHashes.size(), "?"), ",") + R"sql( )
-                    )
+                UniValue txIds(UniValue::VARR);
+                for (const auto& [hash, id] : SelectRegistryIds(txHashes, true))
+                    txIds.push_back(id);
 
+                return Sql(R"sql(
                     select
                         c.Uid
                     from
-                        tx
-                    cross join
-                        Transactions t
-                            on t.RowId = tx.id
-                    cross join
                         Chain c
-                            on c.TxId = t.RowId
+                    where
+                        c.TxId in (select value from json_each(?))
                 )sql")
-                .Bind(txHashes);
+                .Bind(txIds.write());
             },
             [&] (Stmt& stmt) {
                 stmt.Select([&](Cursor& cursor) {
@@ -2889,45 +2879,54 @@ namespace PocketDb
         if (txHashes.empty())
             return result;
 
+        unordered_map<int64_t, string> hashes;
+
         SqlTransaction(
             __func__,
             [&]() -> Stmt& {
-                return Sql(R"sql(
-                    with
-                    tx as (
-                        select
-                            r.RowId as id,
-                            r.String as hash
-                        from
-                            Registry r
-                        where
-                            r.String in ( )sql" + join(vector<string>(txHashes.size(), "?"), ",") + R"sql( )
-                    )
+                UniValue txIds(UniValue::VARR);
+                for (const auto& [hash, id] : SelectRegistryIds(txHashes, true))
+                {
+                    hashes.emplace(id, hash);
+                    txIds.push_back(id);
+                }
 
+                return Sql(R"sql(
                     select
-                        tx.hash,
-                        (select r.String from Registry r where r.RowId = t.RegId1)
+                        t.RowId,
+                        t.RegId1
                     from
-                        tx
+                        Chain c
                     cross join
                         Transactions t
-                            on t.RowId = tx.id
-                    cross join
-                        Chain c
-                            on c.TxId = t.RowId
+                            on t.RowId = c.TxId
+                    where
+                        c.TxId in (select value from json_each(?))
                 )sql")
-                .Bind(txHashes);
+                .Bind(txIds.write());
             },
             [&] (Stmt& stmt) {
+                vector<pair<int64_t, int64_t>> rows;
                 stmt.Select([&](Cursor& cursor) {
                     while (cursor.Step())
                     {
-                        auto[ok0, contenthash] = cursor.TryGetColumnString(0);
-                        auto[ok1, contentaddress] = cursor.TryGetColumnString(1);
-                        if(ok0 && ok1)
-                            result.emplace(contenthash,contentaddress);
+                        auto[ok0, txId] = cursor.TryGetColumnInt64(0);
+                        auto[ok1, addressId] = cursor.TryGetColumnInt64(1);
+                        if (ok0 && ok1)
+                            rows.emplace_back(txId, addressId);
                     }
                 });
+
+                vector<int64_t> addressIds;
+                for (const auto& row : rows)
+                    addressIds.push_back(row.second);
+
+                auto addresses = SelectRegistryStrings(addressIds, true);
+                for (const auto& [txId, addressId] : rows)
+                {
+                    if (auto it = addresses.find(addressId); it != addresses.end())
+                        result.emplace(hashes[txId], it->second);
+                }
             }
         );
 
@@ -4197,31 +4196,14 @@ namespace PocketDb
             __func__,
             [&]() -> Stmt& {
                 return Sql(R"sql(
-                    with
-                        lang as ( select ? as value)
                     select
-                        ct.Uid
+                        f.Uid
                     from
-                        lang
-                    cross join
-                        Chain ct indexed by Chain_Height_Uid on
-                            ct.Height <= ? and
-                            ct.Height > ?
+                        Feed f indexed by Feed_Lang_Height
                     cross join
                         Transactions t on
-                            t.RowId = ct.TxId and
-                            t.Type in ( )sql" + join(vector<string>(contentTypes.size(), "?"), ",") + R"sql( ) and
+                            t.RowId = f.TxId and
                             t.RegId3 is null
-                    cross join
-                        Payload p  on
-                            p.TxId = t.RowId and
-                            p.String1 = lang.value
-                    cross join
-                        Last lt on
-                            lt.TxId = t.RowId
-                    cross join
-                        Ratings r indexed by Ratings_Type_Uid_Last_Value on
-                            r.Type = 2 and r.Uid = ct.Uid and r.Last = 1
                     cross join
                         Transactions u indexed by Transactions_Type_RegId1_RegId2_RegId3 on
                             u.Type in (100) and u.RegId1 = t.RegId1
@@ -4245,22 +4227,27 @@ namespace PocketDb
                         JuryVerdict jv on
                             jv.FlagRowId = j.FlagRowId
                     where
+                        f.Lang = ?
+                        and f.Height <= ?
+                        and f.Height > ?
+                        and f.Type in ( )sql" + join(vector<string>(contentTypes.size(), "?"), ",") + R"sql( )
+                        and f.Rating is not null
                         -- Do not show posts from users with low reputation
-                        ifnull(ur.Value,0) > ?
+                        and ifnull(ur.Value,0) > ?
                         -- Do not show posts from banned users
                         and jb.AccountId is null
                         -- Do not show posts from users with active jury
                         and jv.FlagRowId is null
                     order by
-                        r.Value desc
+                        f.Rating desc
                     limit ?
                 )sql")
                 .Bind(
+                    nHeight,
                     lang,
                     nHeight,
                     nHeight - depth,
                     contentTypes,
-                    nHeight,
                     badReputationLimit,
                     countOut
                 );
@@ -4739,28 +4726,20 @@ namespace PocketDb
 
         // ---------------------------------------------------
 
+        string langSql = "";
+        if (!lang.empty())
+            langSql = R"sql( and f.Lang = ? )sql";
+
+        // ---------------------------------------------------
+
         string sql = R"sql(
             select
-                ct.Uid
+                f.Uid
             from
-                Chain ct
+                Feed f indexed by )sql" + string(lang.empty() ? "Feed_Height_Lang" : "Feed_Lang_Height") + R"sql(
             cross join
                 Transactions t on
-                    t.RowId = ct.TxId and
-                    t.Type in ( )sql" + join(vector<string>(contentTypes.size(), "?"), ",") + R"sql( )
-            cross join
-                Last lt on
-                    lt.TxId = t.RowId
-            cross join
-                Payload p on
-                    p.TxId = t.RowId and
-                    ( ? or p.String1 = ? )
-            cross join
-                Ratings cr indexed by Ratings_Type_Uid_Last_Value on
-                    cr.Type = 2 and
-                    cr.Uid = ct.Uid and
-                    cr.Last = 1 and
-                    cr.Value > 0
+                    t.RowId = f.TxId
             cross join
                 Transactions u indexed by Transactions_Type_RegId1_RegId2_RegId3 on
                     u.Type in (100) and u.RegId1 = t.RegId1
@@ -4787,8 +4766,11 @@ namespace PocketDb
                     jv.FlagRowId = j.FlagRowId
             where
 
-                    ct.Height > ?
-                and ct.Height <= ?
+                    f.Height > ?
+                and f.Height <= ?
+                )sql" + langSql + R"sql(
+                and f.Type in ( )sql" + join(vector<string>(contentTypes.size(), "?"), ",") + R"sql( )
+                and f.Rating > 0
 
                 -- Do not show posts from users with low reputation
                 and ifnull(ur.Value,0) > ?
@@ -4837,7 +4819,7 @@ namespace PocketDb
                 )sql" + tagsExcludedSql + R"sql(
 
             order by
-                cr.Value desc
+                f.Rating desc
 
             limit ?
         )sql";
@@ -4850,12 +4832,20 @@ namespace PocketDb
                 auto& stmt = Sql(sql);
 
                 stmt.Bind(
-                    contentTypes,
-                    lang.empty(),
-                    lang,
                     topHeight,
                     topHeight - depth,
-                    topHeight,
+                    topHeight
+                );
+
+                if (!lang.empty())
+                {
+                    stmt.Bind(
+                        lang
+                    );
+                }
+
+                stmt.Bind(
+                    contentTypes,
                     badReputationLimit
                 );
 
@@ -5644,23 +5634,21 @@ namespace PocketDb
 
         // ---------------------------------------------------
 
+        string langSql = "";
+        if (!lang.empty())
+            langSql = R"sql( and f.Lang = ? )sql";
+
+        // ---------------------------------------------------
+
         string sql = R"sql(
             select
-                ct.Uid
+                f.Uid
             from
-                Transactions t indexed by Transactions_RowId_desc_Type
-            cross join
-                Payload p on
-                    p.TxId = t.RowId and
-                    ( ? or p.String1 = ? )
-            cross join
-                Last lt on
-                    lt.TxId = t.RowId
+                Feed f indexed by )sql" + string(lang.empty() ? "Feed_TxId" : "Feed_Lang_TxId") + R"sql(
             cross join
-                Chain ct indexed by Chain_TxId_Height on
-                    ct.TxId = t.RowId and
-                    ct.Height > ? and
-                    ct.Height <= ?
+                Transactions t on
+                    t.RowId = f.TxId and
+                    t.RegId3 is null
             cross join
                 Transactions u indexed by Transactions_Type_RegId1_RegId2_RegId3 on
                     u.Type in (100) and u.RegId1 = t.RegId1
@@ -5686,8 +5674,9 @@ namespace PocketDb
                 JuryVerdict jv on
                     jv.FlagRowId = j.FlagRowId
             where
-                t.Type in ( )sql" + join(vector<string>(contentTypes.size(), "?"), ",") + R"sql( )
-                and t.RegId3 is null
+                f.Height <= ?
+                )sql" + langSql + R"sql(
+                and f.Type in ( )sql" + join(vector<string>(contentTypes.size(), "?"), ",") + R"sql( )
 
                 -- Do not show posts from users with low reputation
                 and ifnull(ur.Value,0) > ?
@@ -5735,6 +5724,9 @@ namespace PocketDb
 
                 )sql" + tagsExcludedSql + R"sql(
 
+            order by
+                f.TxId desc
+
             limit ?
         )sql";
 
@@ -5746,11 +5738,18 @@ namespace PocketDb
                 auto& stmt = Sql(sql);
 
                 stmt.Bind(
-                    lang.empty(),
-                    lang,
-                    0,
-                    topHeight,
                     topHeight,
+                    topHeight
+                );
+
+                if (!lang.empty())
+                {
+                    stmt.Bind(
+                        lang
+                    );
+                }
+
+                stmt.Bind(
                     contentTypes,
                     badReputationLimit
                 );
@@ -5858,33 +5857,23 @@ namespace PocketDb
             )sql";
         }
 
+        string langSql = "";
+        if (!lang.empty())
+            langSql = R"sql( and f.Lang = ? )sql";
+
         string sql = R"sql(
             select
-                ct.Uid,
-                ifnull(pr.Value, 0) as ContentRating,
+                f.Uid,
+                ifnull(f.Rating, 0) as ContentRating,
                 ifnull(ur.Value, 0) as AccountRating,
-                ctorig.Height,
+                f.OrigHeight,
                 ifnull((select Data from AccountStatistic a where a.AccountRegId = t.RegId1 and a.Type = 8), 0) as SumRatingsLast5Contents
             from
-                Chain ct indexed by Chain_Height_Uid
+                Feed f indexed by )sql" + string(lang.empty() ? "Feed_Height_Lang" : "Feed_Lang_Height") + R"sql(
             cross join
                 Transactions t on
-                    t.RowId = ct.TxId and
-                    t.Type in ( )sql" + join(vector<string>(contentTypes.size(), "?"), ",") + R"sql( ) and
+                    t.RowId = f.TxId and
                     t.RegId3 is null
-            cross join
-                Payload p on
-                    p.TxId = t.RowId and
-                    ( ? or p.String1 = ? )
-            cross join
-                Last lt on
-                    lt.TxId = t.RowId
-            cross join
-                Transactions torig on
-                    torig.RowId = t.RegId2
-            cross join
-                Chain ctorig on
-                    ctorig.TxId = torig.RowId
             cross join
                 Transactions u indexed by Transactions_Type_RegId1_RegId2_RegId3 on
                     u.Type in (100) and u.RegId1 = t.RegId1
@@ -5894,11 +5883,6 @@ namespace PocketDb
             cross join
                 Chain cu on
                     cu.TxId = u.RowId
-            left join
-                Ratings pr indexed by Ratings_Type_Uid_Last_Height on
-                    pr.Type = 2 and
-                    pr.Uid = ct.Uid and
-                    pr.Last = 1
             left join
                 Ratings ur indexed by Ratings_Type_Uid_Last_Value on
                     ur.Type = 0 and
@@ -5915,8 +5899,10 @@ namespace PocketDb
                 JuryVerdict jv on
                     jv.FlagRowId = j.FlagRowId
             where
-                ct.Height > ?
-                and ct.Height <= ?
+                f.Height > ?
+                and f.Height <= ?
+                )sql" + langSql + R"sql(
+                and f.Type in ( )sql" + join(vector<string>(contentTypes.size(), "?"), ",") + R"sql( )
 
                 -- Do not show posts from users with low reputation
                 and ifnull(ur.Value,0) > ?
@@ -5972,12 +5958,20 @@ namespace PocketDb
                 auto& stmt = Sql(sql);
 
                 stmt.Bind(
-                    contentTypes,
-                    lang.empty(),
-                    lang,
                     topHeight,
                     topHeight - cntBlocksForResult,
-                    topHeight,
+                    topHeight
+                );
+
+                if (!lang.empty())
+                {
+                    stmt.Bind(
+                        lang
+                    );
+                }
+
+                stmt.Bind(
+                    contentTypes,
                     badReputationLimit,
                     txidsExcluded,
                     addrsExcluded,
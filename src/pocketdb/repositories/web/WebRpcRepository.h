@@ -7,6 +7,7 @@
 
 #include "pocketdb/helpers/PocketnetHelper.h"
 #include "pocketdb/helpers/TransactionHelper.h"
+#include "pocketdb/helpers/JsonWriter.h"
 #include "pocketdb/repositories/BaseRepository.h"
 
 #include <boost/algorithm/string/join.hpp>
@@ -72,7 +73,8 @@ namespace PocketDb
         // Get account tx id for signer of specified transactions (using RegId1)
         vector<string> GetAddresses(const vector<string>& txHashes);
         vector<string> GetAccountsIds(const vector<string>& addresses);
-        UniValue GetCommentsByPost(const string& postHash, const string& parentHash, const string& addressHash);
+        // Serialized JSON array of comments written directly from cursor
+        string GetCommentsByPost(const string& postHash, const string& parentHash, const string& addressHash);
         map<string, UniValue> GetCommentsByHashes(const vector<string>& cmntHashes, const string& addressHash);
         map<int64_t, UniValue> GetCommentsByIds(const vector<int64_t>& cmntIds, const string& addressHash);
 
@@ -91,7 +93,8 @@ namespace PocketDb
         UniValue GetSubscribesAddresses(
             const string& address, const vector<TxType>& types = {ACTION_SUBSCRIBE, ACTION_SUBSCRIBE_PRIVATE },
             const string& orderBy = "height", bool orderDesc = true, int offset = 0, int limit = 10);
-        UniValue GetSubscribersAddresses(
+        // Serialized JSON array of subscribers written directly from cursor
+        string GetSubscribersAddresses(
             const string& address, const vector<TxType>& types = {ACTION_SUBSCRIBE, ACTION_SUBSCRIBE_PRIVATE },
             const string& orderBy = "height", bool orderDesc = true, int offset = 0, int limit = 10);
         UniValue GetBlockings(const string& address, bool useAddresses);
@@ -3,6 +3,7 @@
 // https://www.apache.org/licenses/LICENSE-2.0
 
 #include "pocketdb/services/Accessor.h"
+#include "pocketdb/services/BlockPayloadCache.h"
 
 namespace PocketServices
 {
@@ -33,19 +34,53 @@ namespace PocketServices
     }
 
     // Read block data for send via network
-    bool Accessor::GetBlock(const CBlock& block, string& data)
+    bool Accessor::GetBlock(const CBlock& block, string& data, bool compact)
     {
+        auto hash = block.GetHash();
+        if (BlockPayloadCacheInst.Get(hash, compact, data))
+            return true;
+
+        // JSON for old peers can be restored from stored compact payload without database
+        string compactData;
+        if (!compact && BlockPayloadCacheInst.Get(hash, true, compactData))
+        {
+            CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+            stream << compactData;
+
+            if (auto[ok, pocketBlock] = Serializer::DeserializeBlock(block, stream); ok)
+            {
+                // Failed serialization is not cached - next request tries again
+                auto dataPtr = Serializer::SerializeBlock(pocketBlock);
+                data = dataPtr ? dataPtr->write() : "";
+                if (dataPtr)
+                    BlockPayloadCacheInst.Put(hash, false, data);
+                return true;
+            }
+        }
+
         PocketBlockRef pocketBlock;
         if (!GetBlock(block, pocketBlock))
             return false;
 
-        if (!pocketBlock)
-            return true;
+        // Block without pocket transactions has empty payload
+        string jsonData;
+        bool jsonOk = true;
+        if (pocketBlock)
+        {
+            auto dataPtr = Serializer::SerializeBlock(*pocketBlock);
+            jsonOk = (bool) dataPtr;
+            if (dataPtr)
+                jsonData = dataPtr->write();
 
-        auto dataPtr = PocketServices::Serializer::SerializeBlock(*pocketBlock);
-        if (dataPtr)
-            data = dataPtr->write();
+            compactData = Serializer::SerializeBlockCompact(*pocketBlock);
+        }
+
+        // Failed serialization is not cached - next request tries again
+        if (jsonOk)
+            BlockPayloadCacheInst.Put(hash, false, jsonData);
+        BlockPayloadCacheInst.Put(hash, true, compactData);
 
+        data = compact ? std::move(compactData) : std::move(jsonData);
         return true;
     }
 
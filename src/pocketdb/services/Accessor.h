@@ -27,7 +27,8 @@ namespace PocketServices
     {
     public:
         static bool GetBlock(const CBlock& block, PocketBlockRef& pocketBlock);
-        static bool GetBlock(const CBlock& block, string& data);
+        // Payload of block for network, compact binary form for peers supporting it
+        static bool GetBlock(const CBlock& block, string& data, bool compact = false);
         static bool GetTransaction(const CTransaction& tx, PTransactionRef& pocketTx);
         static bool GetTransaction(const CTransaction& tx, string& data);
         static bool ExistsTransaction(const string& hash);
@@ -0,0 +1,254 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include "pocketdb/services/BlockPayloadCache.h"
+
+#include "crypto/common.h"
+#include "hash.h"
+#include "logging.h"
+#include "streams.h"
+#include "clientversion.h"
+
+#include <cstring>
+
+namespace PocketServices
+{
+    BlockPayloadCache BlockPayloadCacheInst;
+
+    // Same limits as for blk?????.dat files
+    static const unsigned int MAX_PAYLOAD_FILE_SIZE = 0x8000000; // 128 MiB
+    static const unsigned int PAYLOAD_FILE_CHUNK_SIZE = 0x1000000; // 16 MiB
+
+    static uint64_t StoreKey(const uint256& hash)
+    {
+        return ReadLE64(hash.begin());
+    }
+
+    static uint32_t Checksum(const string& data)
+    {
+        uint256 hash = Hash(data);
+        return ReadLE32(hash.begin());
+    }
+
+    void BlockPayloadCache::SetMaxSize(int megabytes)
+    {
+        LOCK(m_mutex);
+        m_maxBytes = (size_t) std::max(megabytes, 0) * 1024 * 1024;
+
+        while (m_bytes > m_maxBytes && !m_lru.empty())
+        {
+            m_bytes -= m_lru.back().second.size();
+            m_index.erase(m_lru.back().first);
+            m_lru.pop_back();
+        }
+    }
+
+    void BlockPayloadCache::OpenStore(const fs::path& dir, const unsigned char (&messageStart)[4])
+    {
+        LOCK(m_mutex);
+        memcpy(m_messageStart, messageStart, sizeof(m_messageStart));
+        m_store = make_unique<FlatFileSeq>(dir, "pld", PAYLOAD_FILE_CHUNK_SIZE);
+        m_stored.clear();
+        m_storeEnd = FlatFilePos(0, 0);
+
+        IndexStore();
+
+        LogPrintf("Block payload store: %d payloads indexed, write position %d:%u\n",
+            m_stored.size(), m_storeEnd.nFile, m_storeEnd.nPos);
+    }
+
+    void BlockPayloadCache::CloseStore()
+    {
+        LOCK(m_mutex);
+        if (m_store)
+            m_store->Flush(m_storeEnd);
+
+        m_store.reset();
+        m_stored.clear();
+    }
+
+    bool BlockPayloadCache::Get(const uint256& hash, bool compact, string& data)
+    {
+        LOCK(m_mutex);
+
+        Key key{hash, compact};
+        if (auto it = m_index.find(key); it != m_index.end())
+        {
+            m_lru.splice(m_lru.begin(), m_lru, it->second);
+            data = it->second->second;
+            m_hits++;
+            return true;
+        }
+
+        // Only compact payloads are persisted
+        if (compact && ReadStore(hash, data))
+        {
+            PutMemory(key, data);
+            m_hits++;
+            return true;
+        }
+
+        m_misses++;
+        return false;
+    }
+
+    void BlockPayloadCache::Put(const uint256& hash, bool compact, const string& data)
+    {
+        LOCK(m_mutex);
+        PutMemory({hash, compact}, data);
+
+        if (compact && !data.empty())
+            WriteStore(hash, data);
+    }
+
+    UniValue BlockPayloadCache::Statistic()
+    {
+        LOCK(m_mutex);
+
+        UniValue result(UniValue::VOBJ);
+        result.pushKV("entries", (int64_t) m_lru.size());
+        result.pushKV("memory", (int64_t) m_bytes);
+        result.pushKV("maxmemory", (int64_t) m_maxBytes);
+        result.pushKV("stored", (int64_t) m_stored.size());
+        result.pushKV("hits", m_hits);
+        result.pushKV("misses", m_misses);
+        result.pushKV("hitrate", m_hits + m_misses > 0 ? (double) m_hits / (m_hits + m_misses) : 0.0);
+
+        return result;
+    }
+
+    void BlockPayloadCache::PutMemory(const Key& key, const string& data)
+    {
+        if (data.size() > m_maxBytes)
+            return;
+
+        if (auto it = m_index.find(key); it != m_index.end())
+        {
+            m_lru.splice(m_lru.begin(), m_lru, it->second);
+            return;
+        }
+
+        m_lru.emplace_front(key, data);
+        m_index.emplace(key, m_lru.begin());
+        m_bytes += data.size();
+
+        while (m_bytes > m_maxBytes && !m_lru.empty())
+        {
+            m_bytes -= m_lru.back().second.size();
+            m_index.erase(m_lru.back().first);
+            m_lru.pop_back();
+        }
+    }
+
+    // Record: message start | block hash | checksum of data | data
+    bool BlockPayloadCache::ReadStore(const uint256& hash, string& data)
+    {
+        if (!m_store)
+            return false;
+
+        auto it = m_stored.find(StoreKey(hash));
+        if (it == m_stored.end())
+            return false;
+
+        try
+        {
+            CAutoFile filein(m_store->Open(it->second, true), SER_DISK, CLIENT_VERSION);
+            if (filein.IsNull())
+                throw runtime_error("failed open file");
+
+            unsigned char messageStart[4];
+            uint256 recordHash;
+            uint32_t checksum;
+            string recordData;
+            filein >> messageStart >> recordHash >> checksum >> recordData;
+
+            if (memcmp(messageStart, m_messageStart, sizeof(messageStart)) != 0 || recordHash != hash || checksum != Checksum(recordData))
+                throw runtime_error("corrupted record");
+
+            data = std::move(recordData);
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            LogPrintf("Warning: BlockPayloadCache::ReadStore (%s) at %d:%u - %s\n",
+                hash.GetHex(), it->second.nFile, it->second.nPos, e.what());
+            m_stored.erase(it);
+            return false;
+        }
+    }
+
+    void BlockPayloadCache::WriteStore(const uint256& hash, const string& data)
+    {
+        if (!m_store || m_stored.count(StoreKey(hash)))
+            return;
+
+        uint32_t checksum = Checksum(data);
+        size_t size = sizeof(m_messageStart) + sizeof(uint256) + sizeof(checksum) + GetSerializeSize(data, CLIENT_VERSION);
+
+        if (m_storeEnd.nPos > 0 && m_storeEnd.nPos + size > MAX_PAYLOAD_FILE_SIZE)
+        {
+            m_store->Flush(m_storeEnd, true);
+            m_storeEnd = FlatFilePos(m_storeEnd.nFile + 1, 0);
+        }
+
+        bool outOfSpace = false;
+        m_store->Allocate(m_storeEnd, size, outOfSpace);
+        if (outOfSpace)
+        {
+            LogPrintf("Warning: BlockPayloadCache::WriteStore - disk space is low, payload store disabled\n");
+            m_store.reset();
+            m_stored.clear();
+            return;
+        }
+
+        CAutoFile fileout(m_store->Open(m_storeEnd), SER_DISK, CLIENT_VERSION);
+        if (fileout.IsNull())
+        {
+            LogPrintf("Warning: BlockPayloadCache::WriteStore - failed open %s\n", m_store->FileName(m_storeEnd).string());
+            return;
+        }
+
+        fileout << m_messageStart << hash << checksum << data;
+
+        m_stored.emplace(StoreKey(hash), m_storeEnd);
+        m_storeEnd.nPos += size;
+    }
+
+    // Scan all files, in each one the first broken or preallocated (zero) record marks the end.
+    // Writes continue after the last valid record of the last file.
+    void BlockPayloadCache::IndexStore()
+    {
+        for (FlatFilePos pos(0, 0); fs::exists(m_store->FileName(pos)); pos = FlatFilePos(pos.nFile + 1, 0))
+        {
+            CAutoFile filein(m_store->Open(pos, true), SER_DISK, CLIENT_VERSION);
+            if (filein.IsNull())
+                return;
+
+            while (true)
+            {
+                m_storeEnd = pos;
+
+                try
+                {
+                    unsigned char messageStart[4];
+                    uint256 hash;
+                    uint32_t checksum;
+                    string data;
+                    filein >> messageStart >> hash >> checksum >> data;
+
+                    if (memcmp(messageStart, m_messageStart, sizeof(messageStart)) != 0 || checksum != Checksum(data))
+                        break;
+
+                    m_stored.emplace(StoreKey(hash), pos);
+                    pos.nPos = (unsigned int) ftell(filein.Get());
+                }
+                catch (const std::exception&)
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+} // namespace PocketServices
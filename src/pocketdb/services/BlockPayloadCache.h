@@ -0,0 +1,78 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETSERVICES_BLOCKPAYLOADCACHE_H
+#define POCKETSERVICES_BLOCKPAYLOADCACHE_H
+
+#include "flatfile.h"
+#include "sync.h"
+#include "uint256.h"
+#include "univalue.h"
+
+#include <list>
+#include <memory>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+static const int DEFAULT_BLOCK_PAYLOAD_CACHE_SIZE = 32;
+static const bool DEFAULT_BLOCK_PAYLOAD_STORE = false;
+
+namespace PocketServices
+{
+    using namespace std;
+
+    /**
+    * Ready to send Pocket payloads of blocks for network.
+    * Payload of block depends only on its transactions, so entry keyed by block hash never changes.
+    * Recent payloads are kept in memory with LRU eviction, both JSON (old peers) and compact forms.
+    * Optionally compact payloads are persisted in pld?????.dat files next to blk?????.dat,
+    * so serving of historical blocks does not need the database.
+    */
+    class BlockPayloadCache
+    {
+    public:
+        // Limit of memory for all payloads in megabytes
+        void SetMaxSize(int megabytes);
+
+        // Open payload files and index stored records
+        void OpenStore(const fs::path& dir, const unsigned char (&messageStart)[4]);
+        void CloseStore();
+
+        bool Get(const uint256& hash, bool compact, string& data);
+        void Put(const uint256& hash, bool compact, const string& data);
+
+        UniValue Statistic();
+
+    private:
+        using Key = pair<uint256, bool>;
+        using Entry = pair<Key, string>;
+
+        Mutex m_mutex;
+
+        list<Entry> m_lru GUARDED_BY(m_mutex);
+        map<Key, list<Entry>::iterator> m_index GUARDED_BY(m_mutex);
+        size_t m_bytes GUARDED_BY(m_mutex) = 0;
+        size_t m_maxBytes GUARDED_BY(m_mutex) = (size_t) DEFAULT_BLOCK_PAYLOAD_CACHE_SIZE * 1024 * 1024;
+
+        unique_ptr<FlatFileSeq> m_store GUARDED_BY(m_mutex);
+        // Keyed by first 8 bytes of block hash to keep index small, full hash is checked on read
+        unordered_map<uint64_t, FlatFilePos> m_stored GUARDED_BY(m_mutex);
+        FlatFilePos m_storeEnd GUARDED_BY(m_mutex);
+        unsigned char m_messageStart[4] = {};
+
+        int64_t m_hits GUARDED_BY(m_mutex) = 0;
+        int64_t m_misses GUARDED_BY(m_mutex) = 0;
+
+        void PutMemory(const Key& key, const string& data) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+        bool ReadStore(const uint256& hash, string& data) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+        void WriteStore(const uint256& hash, const string& data) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+        void IndexStore() EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    };
+
+    extern BlockPayloadCache BlockPayloadCacheInst;
+
+} // namespace PocketServices
+
+#endif // POCKETSERVICES_BLOCKPAYLOADCACHE_H
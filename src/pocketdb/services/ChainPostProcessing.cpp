@@ -3,11 +3,22 @@
 // https://www.apache.org/licenses/LICENSE-2.0
 
 #include "pocketdb/services/ChainPostProcessing.h"
+#include "pocketdb/services/MempoolMirror.h"
 
 namespace PocketServices
 {
+    // Indexing and rollback hold the lock, so the open batch is committed by timer only between blocks
+    static Mutex cs_group_commit;
+    static int groupCommitBlocks GUARDED_BY(cs_group_commit) = 0;
+    static int64_t groupCommitStart GUARDED_BY(cs_group_commit) = 0;
+
     void ChainPostProcessing::Index(const CBlock& block, int height)
     {
+        LOCK(cs_group_commit);
+
+        // Pending mempool events refer to the same transactions
+        MempoolMirrorInst.Flush();
+
         vector<TransactionIndexingInfo> txs;
         PrepareTransactions(block, txs);
 
@@ -28,10 +39,66 @@ namespace PocketServices
         IndexBadges(height);
         int64_t nTime5 = GetTimeMicros();
         LogPrint(BCLog::BENCH, "    - IndexBadges: %.2fms _ %d\n", 0.001 * (double)(nTime5 - nTime4), height);
+
+        IndexFeed(height);
+        int64_t nTime6 = GetTimeMicros();
+        LogPrint(BCLog::BENCH, "    - IndexFeed: %.2fms _ %d\n", 0.001 * (double)(nTime6 - nTime5), height);
+    }
+
+    void ChainPostProcessing::GroupCommit(int height, bool initialSync)
+    {
+        LOCK(cs_group_commit);
+
+        SQLiteDbInst.SetIndexedHeight(height);
+
+        int maxBlocks = gArgs.GetArg("-sqlgroupcommitblocks", DEFAULT_SQL_GROUP_COMMIT_BLOCKS);
+        int64_t maxTime = gArgs.GetArg("-sqlgroupcommittime", DEFAULT_SQL_GROUP_COMMIT_TIME);
+
+        if (SQLiteDbInst.InBatch())
+        {
+            groupCommitBlocks++;
+
+            if (initialSync && groupCommitBlocks < maxBlocks && GetTimeMillis() - groupCommitStart < maxTime)
+                return;
+
+            int64_t nTime1 = GetTimeMicros();
+            SQLiteDbInst.CommitBatch();
+            LogPrint(BCLog::BENCH, "    - Group commit %d blocks: %.2fms\n", groupCommitBlocks, 0.001 * (double)(GetTimeMicros() - nTime1));
+
+            groupCommitBlocks = 0;
+        }
+
+        if (initialSync && maxBlocks > 1)
+        {
+            SQLiteDbInst.BeginBatch();
+            groupCommitStart = GetTimeMillis();
+        }
+    }
+
+    void ChainPostProcessing::CommitExpiredBatch()
+    {
+        // Block is being indexed - its GroupCommit checks the time
+        TRY_LOCK(cs_group_commit, lockGroupCommit);
+        if (!lockGroupCommit || !SQLiteDbInst.InBatch())
+            return;
+
+        int64_t maxTime = gArgs.GetArg("-sqlgroupcommittime", DEFAULT_SQL_GROUP_COMMIT_TIME);
+        if (GetTimeMillis() - groupCommitStart < maxTime)
+            return;
+
+        int64_t nTime1 = GetTimeMicros();
+        SQLiteDbInst.CommitBatch();
+        LogPrint(BCLog::BENCH, "    - Group commit %d blocks by timer: %.2fms\n", groupCommitBlocks, 0.001 * (double)(GetTimeMicros() - nTime1));
+
+        groupCommitBlocks = 0;
     }
 
     bool ChainPostProcessing::Rollback(int height)
     {
+        LOCK(cs_group_commit);
+
+        MempoolMirrorInst.Flush();
+
         try
         {
             // Loop restore
@@ -46,6 +113,8 @@ namespace PocketServices
             }
             while (curHeight > height);
 
+            SQLiteDbInst.SetIndexedHeight(height - 1);
+
             return true;
         }
         catch (std::exception& ex)
@@ -75,6 +144,10 @@ namespace PocketServices
                     txInfo.Inputs.emplace_back(inp.prevout.hash.GetHex(), inp.prevout.n);
             }
 
+            // Outputs with values used for calculate balances deltas
+            for (const auto& out : tx->vout)
+                txInfo.Outputs.emplace_back(PocketHelpers::TransactionHelper::ExtractOutputAddress(out.scriptPubKey), out.nValue);
+
             txs.emplace_back(txInfo);
         }
     }
@@ -327,4 +400,10 @@ namespace PocketServices
         }
     }
 
+    // Feed must be indexed after ratings for contents in block were calculated
+    void ChainPostProcessing::IndexFeed(int height)
+    {
+        ChainRepoInst.IndexFeed(height);
+    }
+
 } // namespace PocketServices
\ No newline at end of file
@@ -40,12 +40,22 @@ namespace PocketServices
         static void Index(const CBlock& block, int height);
         static bool Rollback(int height);
 
+        // Called after every indexed block. During initial sync blocks are accumulated
+        // in one database transaction committed every N blocks or T milliseconds.
+        // Readers on other connections see only heights of committed batches - see VisibleHeight.
+        static void GroupCommit(int height, bool initialSync);
+
+        // Called by scheduler - commits the batch open longer than -sqlgroupcommittime
+        // when sync stalls and no next block reaches GroupCommit.
+        static void CommitExpiredBatch();
+
     protected:
         static void PrepareTransactions(const CBlock& block, vector<TransactionIndexingInfo>& txs);
         static void IndexChain(const string& blockHash, int height, vector<TransactionIndexingInfo>& txs);
         static void IndexRatings(int height, vector<TransactionIndexingInfo>& txs);
         static void IndexModeration(int height, vector<TransactionIndexingInfo>& txs);
         static void IndexBadges(int height);
+        static void IndexFeed(int height);
 
         static ModerationCondition GetConditions(int height, int accountLikers);
         static void IndexModerationFlag(const TransactionIndexingInfo& txInfo, int height);
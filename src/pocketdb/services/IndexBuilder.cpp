@@ -0,0 +1,94 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include "pocketdb/services/IndexBuilder.h"
+#include "pocketdb/pocketnet.h"
+#include "validation.h"
+#include "shutdown.h"
+
+namespace PocketServices
+{
+    void IndexBuilder::Start(boost::thread_group& threadGroup)
+    {
+        shutdown = false;
+        threadGroup.create_thread([this] { Worker(); });
+    }
+
+    void IndexBuilder::Stop()
+    {
+        shutdown = true;
+
+        // Wait current index completed
+        LOCK(_running_mutex);
+    }
+
+    void IndexBuilder::Worker()
+    {
+        LOCK(_running_mutex);
+
+        // Indexes are not needed by consensus, so they wait for the chain tip
+        while (!shutdown && !ShutdownRequested() && ::ChainstateActive().IsInitialBlockDownload())
+            UninterruptibleSleep(std::chrono::milliseconds{10000});
+
+        if (shutdown || ShutdownRequested())
+            return;
+
+        try
+        {
+            Build();
+        }
+        catch (const std::exception& ex)
+        {
+            LogPrintf("IndexBuilder: failed with message: %s\n", ex.what());
+        }
+    }
+
+    void IndexBuilder::Build()
+    {
+        auto indexes = SQLiteDbInst.GetMissingDeferredIndexes();
+        if (indexes.empty())
+            return;
+
+        int threads = std::max(GetNumCores(), 1);
+        LogPrintf("IndexBuilder: building %d deferred indexes with %d threads\n", indexes.size(), threads);
+
+        int64_t nTimeStart = GetTimeMicros();
+        for (size_t i = 0; i < indexes.size(); i++)
+        {
+            if (shutdown || ShutdownRequested())
+            {
+                LogPrintf("IndexBuilder: stopped, %d indexes left for next start\n", indexes.size() - i);
+                return;
+            }
+
+            const auto& [name, sql] = indexes[i];
+
+            // Build is restarted after block processing took the connection, and after too many restarts
+            // the index is built without yielding with block processing paused until it is created
+            int64_t nTime1 = GetTimeMicros();
+            int attempt = 0;
+            while (!SQLiteDbInst.CreateIndex(name, sql, threads, attempt < MAX_YIELDS))
+            {
+                if (++attempt == MAX_YIELDS)
+                    LogPrintf("IndexBuilder: index %s interrupted %d times, block processing is paused until it is created\n", name, attempt);
+
+                for (int pause = 0; pause < attempt && !shutdown && !ShutdownRequested(); pause++)
+                    UninterruptibleSleep(std::chrono::milliseconds{1000});
+
+                if (shutdown || ShutdownRequested())
+                {
+                    LogPrintf("IndexBuilder: stopped, %d indexes left for next start\n", indexes.size() - i);
+                    return;
+                }
+            }
+            int64_t nTime2 = GetTimeMicros();
+
+            LogPrintf("IndexBuilder: %d%% (%d/%d) index %s created in %.2fs\n",
+                (int) (100 * (i + 1) / indexes.size()), i + 1, indexes.size(), name, 0.000001 * (nTime2 - nTime1));
+        }
+
+        LogPrintf("IndexBuilder: all deferred indexes created in %.2fm\n", 0.000001 * (GetTimeMicros() - nTimeStart) / 60.0);
+    }
+
+} // namespace PocketServices
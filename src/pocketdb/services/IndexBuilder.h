@@ -0,0 +1,43 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETDB_INDEX_BUILDER_H
+#define POCKETDB_INDEX_BUILDER_H
+
+#include <boost/thread.hpp>
+#include "sync.h"
+
+#include "pocketdb/SQLiteDatabase.h"
+
+namespace PocketServices
+{
+    using namespace PocketDb;
+
+    /**
+    * Builds deferred (web-only) indexes of the main database in bulk load mode.
+    * Waits until the node leaves initial block download and creates missing indexes one by one,
+    * each in its own transaction of the main connection. SQLite allows one writer per file, so
+    * a build is interrupted and restarted later when block processing waits for the connection.
+    * Until an index is created queries are prepared without hints to it.
+    */
+    class IndexBuilder
+    {
+    public:
+        void Start(boost::thread_group& threadGroup);
+        void Stop();
+
+    private:
+        // Interrupted builds before the index is built without yielding
+        static constexpr int MAX_YIELDS = 10;
+
+        bool shutdown = false;
+        Mutex _running_mutex;
+
+        void Worker();
+        void Build();
+    };
+
+} // PocketServices
+
+#endif // POCKETDB_INDEX_BUILDER_H
@@ -0,0 +1,219 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include "pocketdb/services/MempoolMirror.h"
+#include "pocketdb/pocketnet.h"
+
+#include "util/threadnames.h"
+#include "util/time.h"
+
+namespace PocketServices
+{
+    MempoolMirror MempoolMirrorInst;
+
+    void MempoolMirror::Start()
+    {
+        LOCK(m_mutex);
+        if (m_running)
+            return;
+
+        m_running = true;
+        m_thread = thread([this]() { Worker(); });
+    }
+
+    void MempoolMirror::Stop()
+    {
+        {
+            LOCK(m_mutex);
+            if (!m_running)
+                return;
+
+            m_running = false;
+        }
+
+        m_cv.notify_all();
+        if (m_thread.joinable())
+            m_thread.join();
+
+        // Events enqueued while the thread was stopping
+        while (WriteBatch()) {}
+    }
+
+    void MempoolMirror::Insert(const string& hash)
+    {
+        Push(MempoolOp::Insert, hash);
+    }
+
+    void MempoolMirror::Remove(const string& hash)
+    {
+        Push(MempoolOp::Remove, hash);
+    }
+
+    void MempoolMirror::RemoveTransaction(const string& hash)
+    {
+        Push(MempoolOp::RemoveTransaction, hash);
+    }
+
+    void MempoolMirror::Clear()
+    {
+        Push(MempoolOp::Clear, "");
+    }
+
+    void MempoolMirror::Flush()
+    {
+        uint64_t target;
+        {
+            LOCK(m_mutex);
+            target = m_enqueued;
+            if (m_written >= target)
+                return;
+
+            m_flushes++;
+        }
+
+        // Write by calling thread instead of waiting for the worker wakeup
+        while (true)
+        {
+            {
+                LOCK(m_mutex);
+                if (m_written >= target)
+                    return;
+            }
+
+            if (!WriteBatch())
+            {
+                // Last events are written by other thread right now
+                WAIT_LOCK(m_mutex, lock);
+                m_cv_written.wait(lock, [&]() { return m_written >= target; });
+                return;
+            }
+        }
+    }
+
+    bool MempoolMirror::Pending(const string& hash)
+    {
+        LOCK(m_mutex);
+        for (const auto& [op, opHash] : m_queue)
+            if (op == MempoolOp::Clear || opHash == hash)
+                return true;
+
+        return false;
+    }
+
+    UniValue MempoolMirror::Statistic()
+    {
+        LOCK(m_mutex);
+
+        UniValue result(UniValue::VOBJ);
+        result.pushKV("depth", (int64_t) m_queue.size());
+        result.pushKV("maxdepth", (int64_t) m_maxDepth);
+        result.pushKV("written", (int64_t) m_written);
+        result.pushKV("batches", m_batches);
+        result.pushKV("flushes", m_flushes);
+        result.pushKV("errors", m_errors);
+        result.pushKV("lastlatency", m_lastLatency);
+        result.pushKV("maxlatency", m_maxLatency);
+        result.pushKV("avglatency", m_batches > 0 ? m_totalLatency / m_batches : 0);
+        return result;
+    }
+
+    void MempoolMirror::Push(MempoolOp op, const string& hash)
+    {
+        {
+            LOCK(m_mutex);
+            if (m_running)
+            {
+                m_queue.emplace_back(op, hash);
+                m_enqueued++;
+                m_maxDepth = max(m_maxDepth, m_queue.size());
+                m_cv.notify_one();
+                return;
+            }
+        }
+
+        // Without thread - write through as before
+        LOCK(m_write_mutex);
+        Write({{op, hash}});
+    }
+
+    void MempoolMirror::Worker()
+    {
+        util::ThreadRename("pocketmempool");
+
+        while (true)
+        {
+            {
+                WAIT_LOCK(m_mutex, lock);
+                m_cv.wait(lock, [&]() { return !m_running || !m_queue.empty(); });
+
+                if (!m_running)
+                    break;
+            }
+
+            WriteBatch();
+        }
+    }
+
+    bool MempoolMirror::WriteBatch()
+    {
+        LOCK(m_write_mutex);
+
+        vector<pair<MempoolOp, string>> ops;
+        {
+            LOCK(m_mutex);
+            size_t count = min(m_queue.size(), MAX_MEMPOOL_MIRROR_BATCH);
+            if (count == 0)
+                return false;
+
+            ops.reserve(count);
+            for (size_t i = 0; i < count; i++)
+            {
+                ops.push_back(move(m_queue.front()));
+                m_queue.pop_front();
+            }
+        }
+
+        int64_t nTime1 = GetTimeMicros();
+        Write(ops);
+        int64_t latency = GetTimeMicros() - nTime1;
+
+        {
+            LOCK(m_mutex);
+            m_written += ops.size();
+            m_batches++;
+            m_lastLatency = latency;
+            m_maxLatency = max(m_maxLatency, latency);
+            m_totalLatency += latency;
+        }
+
+        m_cv_written.notify_all();
+
+        LogPrint(BCLog::MEMPOOL, "SQL Mempool mirror: %d events written in %.2fms\n", ops.size(), 0.001 * latency);
+        return true;
+    }
+
+    void MempoolMirror::Write(const vector<pair<MempoolOp, string>>& ops)
+    {
+        try
+        {
+            PocketDb::TransRepoInst.MempoolApply(ops);
+            return;
+        }
+        catch (...)
+        {
+            if (ops.size() == 1)
+            {
+                LogPrintf("Error: MempoolMirror failed write event %d for %s\n", (int) ops[0].first, ops[0].second);
+                LOCK(m_mutex);
+                m_errors++;
+                return;
+            }
+        }
+
+        // One failed event must not discard the others
+        for (const auto& op : ops)
+            Write({op});
+    }
+
+} // namespace PocketServices
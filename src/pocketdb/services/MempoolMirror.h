@@ -0,0 +1,88 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETSERVICES_MEMPOOLMIRROR_H
+#define POCKETSERVICES_MEMPOOLMIRROR_H
+
+#include "sync.h"
+#include "univalue.h"
+
+#include "pocketdb/repositories/TransactionRepository.h"
+
+#include <condition_variable>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Operations written by one database transaction
+static const size_t MAX_MEMPOOL_MIRROR_BATCH = 1000;
+
+namespace PocketServices
+{
+    using namespace std;
+    using PocketDb::MempoolOp;
+
+    /**
+    * Write-behind queue of Mempool table updates.
+    * CTxMemPool events are enqueued under mempool locks and written in order by a background
+    * thread, several events in one database transaction. Code reading the Mempool table for
+    * consensus must call Flush before. Until Start and after Stop events are written synchronously.
+    */
+    class MempoolMirror
+    {
+    public:
+        void Start();
+        // Writes all queued events and stops the thread
+        void Stop();
+
+        void Insert(const string& hash);
+        void Remove(const string& hash);
+        void RemoveTransaction(const string& hash);
+        void Clear();
+
+        // Barrier: returns when all events enqueued before the call are written
+        void Flush();
+        // Event for transaction is enqueued and not written yet
+        bool Pending(const string& hash);
+
+        UniValue Statistic();
+
+    private:
+        Mutex m_mutex;
+        condition_variable m_cv;
+        condition_variable m_cv_written;
+
+        // Only one batch is written at a time to keep events order
+        Mutex m_write_mutex;
+
+        thread m_thread;
+        bool m_running GUARDED_BY(m_mutex) = false;
+
+        deque<pair<MempoolOp, string>> m_queue GUARDED_BY(m_mutex);
+        // Sequence numbers of the last enqueued and the last written event
+        uint64_t m_enqueued GUARDED_BY(m_mutex) = 0;
+        uint64_t m_written GUARDED_BY(m_mutex) = 0;
+
+        // Metrics
+        size_t m_maxDepth GUARDED_BY(m_mutex) = 0;
+        int64_t m_batches GUARDED_BY(m_mutex) = 0;
+        int64_t m_flushes GUARDED_BY(m_mutex) = 0;
+        int64_t m_errors GUARDED_BY(m_mutex) = 0;
+        int64_t m_lastLatency GUARDED_BY(m_mutex) = 0;
+        int64_t m_maxLatency GUARDED_BY(m_mutex) = 0;
+        int64_t m_totalLatency GUARDED_BY(m_mutex) = 0;
+
+        void Push(MempoolOp op, const string& hash);
+        void Worker();
+        // Writes queued events, returns false if queue was empty
+        bool WriteBatch() LOCKS_EXCLUDED(m_mutex);
+        void Write(const vector<pair<MempoolOp, string>>& ops);
+    };
+
+    extern MempoolMirror MempoolMirrorInst;
+
+} // namespace PocketServices
+
+#endif // POCKETSERVICES_MEMPOOLMIRROR_H
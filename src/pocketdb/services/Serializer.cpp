@@ -10,7 +10,18 @@ namespace PocketServices
     tuple<bool, PocketBlock> Serializer::DeserializeBlock(const CBlock& block, CDataStream& stream)
     {
         // Get Serialized data from stream
-        auto pocketData = parseStream(stream);
+        string src;
+        if (!stream.empty())
+            stream >> src;
+
+        // Peers with compact payload support send binary data
+        if (!src.empty() && (uint8_t) src[0] == POCKET_BLOCK_COMPACT_MARKER)
+            return deserializeBlockCompact(block, src);
+
+        UniValue pocketData(UniValue::VOBJ);
+        if (!src.empty())
+            pocketData.read(src);
+
         return deserializeBlock(block, pocketData);
     }
     tuple<bool, PocketBlock> Serializer::DeserializeBlock(const CBlock& block)
@@ -55,6 +66,31 @@ namespace PocketServices
         return result;
     }
 
+    string Serializer::SerializeBlockCompact(const PocketBlock& block)
+    {
+        vector<tuple<uint256, string, string>> entries;
+        for (const auto& transaction : block)
+        {
+            auto type = transaction->GetType();
+            if (!type || !PocketHelpers::TransactionHelper::IsPocketTransaction(*type))
+                continue;
+
+            entries.emplace_back(
+                uint256S(*transaction->GetHash()),
+                PocketHelpers::TransactionHelper::ConvertToReindexerTable(*transaction),
+                transaction->Serialize()->write()
+            );
+        }
+
+        CDataStream stream(SER_NETWORK, PROTOCOL_VERSION);
+        stream << POCKET_BLOCK_COMPACT_MARKER;
+        WriteCompactSize(stream, entries.size());
+        for (const auto& [hash, table, data] : entries)
+            stream << hash << table << data;
+
+        return string(stream.begin(), stream.end());
+    }
+
     // Serialize protocol compatible with Reindexer
     // It makes sense to serialize only Pocket transactions that contain a payload.
     optional<UniValue> Serializer::SerializeTransaction(const Transaction& transaction)
@@ -75,6 +111,19 @@ namespace PocketServices
     }
 
     shared_ptr<Transaction> Serializer::buildInstance(const CTransactionRef& tx, const UniValue& src)
+    {
+        string table;
+        if (src.exists("t"))
+            table = src["t"].get_str();
+
+        optional<string> data;
+        if (src.exists("d"))
+            data = DecodeBase64(src["d"].get_str());
+
+        return buildInstance(tx, table, data);
+    }
+
+    shared_ptr<Transaction> Serializer::buildInstance(const CTransactionRef& tx, const string& table, const optional<string>& data)
     {
         TxType txType;
         if (!PocketHelpers::TransactionHelper::IsPocketSupportedTransaction(tx, txType))
@@ -93,14 +142,12 @@ namespace PocketServices
             return nullptr;
 
         // Deserialize payload if exists
-        if (src.exists("d"))
+        if (data)
         {
             UniValue txDataSrc(UniValue::VOBJ);
-            auto txDataBase64 = src["d"].get_str();
-            auto txJson = DecodeBase64(txDataBase64);
-            txDataSrc.read(txJson);
+            txDataSrc.read(*data);
 
-            if (src.exists("t") && src["t"].get_str() == "Mempool" && txDataSrc.exists("data"))
+            if (table == "Mempool" && txDataSrc.exists("data"))
             {
                 auto txMempoolDataBase64 = txDataSrc["data"].get_str();
                 auto txMempoolJson = DecodeBase64(txMempoolDataBase64);
@@ -169,18 +216,7 @@ namespace PocketServices
             out.SetValue(txout.nValue);
             out.SetScriptPubKey(HexStr(txout.scriptPubKey));
 
-            TxoutType type;
-            std::vector <CTxDestination> vDest;
-            int nRequired;
-            if (ExtractDestinations(txout.scriptPubKey, type, vDest, nRequired))
-            {
-                for (const auto& dest : vDest)
-                    out.SetAddressHash(EncodeDestination(dest));
-            }
-            else
-            {
-                out.SetAddressHash("");
-            }
+            out.SetAddressHash(PocketHelpers::TransactionHelper::ExtractOutputAddress(txout.scriptPubKey));
 
             ptx->Outputs().push_back(out);
         }
@@ -234,6 +270,51 @@ namespace PocketServices
         return { true, pocketBlock };
     }
 
+    tuple<bool, PocketBlock> Serializer::deserializeBlockCompact(const CBlock& block, const string& src)
+    {
+        map<uint256, pair<string, string>> entries;
+
+        try
+        {
+            CDataStream stream(src.data() + 1, src.data() + src.size(), SER_NETWORK, PROTOCOL_VERSION);
+
+            uint64_t count = ReadCompactSize(stream);
+            if (count > block.vtx.size())
+                throw std::ios_base::failure("too many transactions");
+
+            for (uint64_t i = 0; i < count; i++)
+            {
+                uint256 hash;
+                string table;
+                string data;
+                stream >> hash >> table >> data;
+
+                entries.emplace(hash, make_pair(move(table), move(data)));
+            }
+        }
+        catch (std::exception& ex)
+        {
+            LogPrintf("Error deserialize compact block payload: %s: %s\n", block.GetHash().GetHex(), ex.what());
+            entries.clear();
+        }
+
+        // Restore pocket transaction instance
+        PocketBlock pocketBlock;
+        for (const auto& tx : block.vtx)
+        {
+            shared_ptr<Transaction> ptx;
+            if (auto it = entries.find(tx->GetHash()); it != entries.end())
+                ptx = buildInstance(tx, it->second.first, it->second.second);
+            else
+                ptx = buildInstance(tx, "", nullopt);
+
+            if (ptx)
+                pocketBlock.push_back(ptx);
+        }
+
+        return { true, pocketBlock };
+    }
+
     tuple<bool, shared_ptr<Transaction>> Serializer::deserializeTransaction(const CTransactionRef& tx, UniValue& pocketData)
     {
         auto ptx = buildInstance(tx, pocketData);
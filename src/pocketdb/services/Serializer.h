@@ -21,6 +21,9 @@ namespace PocketServices
     using namespace PocketTx;
     using namespace PocketHelpers;
 
+    // First byte of compact block payload - JSON payload always starts with '{'
+    static const uint8_t POCKET_BLOCK_COMPACT_MARKER = 0x01;
+
     class Serializer
     {
     public:
@@ -32,15 +35,21 @@ namespace PocketServices
         static tuple<bool, PTransactionRef> DeserializeTransaction(const CTransactionRef& tx);
 
         static optional<UniValue> SerializeBlock(const PocketBlock& block);
+        // Binary block payload for peers with POCKET_COMPACT_PAYLOAD_VERSION:
+        // marker, count and (hash, table, data) of every pocket transaction.
+        // Transaction data is the same JSON as in SerializeBlock but without base64 and outer JSON wrapping.
+        static string SerializeBlockCompact(const PocketBlock& block);
         static optional<UniValue> SerializeTransaction(const Transaction& transaction);
 
     private:
         static shared_ptr<Transaction> buildInstance(const CTransactionRef& tx, const UniValue& src);
+        static shared_ptr<Transaction> buildInstance(const CTransactionRef& tx, const string& table, const optional<string>& data);
         static shared_ptr<Transaction> buildInstanceRpc(const CTransactionRef& tx, const UniValue& src);
         static bool buildInputs(const CTransactionRef& tx, shared_ptr<Transaction>& ptx);
         static bool buildOutputs(const CTransactionRef& tx, shared_ptr<Transaction>& ptx);
         static UniValue parseStream(CDataStream& stream);
         static tuple<bool, PocketBlock> deserializeBlock(const CBlock& block, UniValue& pocketData);
+        static tuple<bool, PocketBlock> deserializeBlockCompact(const CBlock& block, const string& src);
         static tuple<bool, shared_ptr<Transaction>> deserializeTransaction(const CTransactionRef& tx, UniValue& pocketData);
     };
 
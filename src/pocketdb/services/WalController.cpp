@@ -1,34 +1,42 @@
-
 // Copyright (c) 2018-2022 The Pocketnet developers
 // Distributed under the Apache 2.0 software license, see the accompanying
 // https://www.apache.org/licenses/LICENSE-2.0
 
 #include "pocketdb/services/WalController.h"
+#include "pocketdb/pocketnet.h"
+#include "util/system.h"
+#include "util/threadnames.h"
 #include <fs.h>
 
 namespace {
-    size_t GetFileSize(std::string path)
+    size_t GetWalFileSize(const std::string& dbName)
     {
-        return fs::file_size(path);
-    }
-    
-    const static size_t MAX_WAL_BYTES_SIZE = 100242880;
+        auto path = GetDataDir() / "pocketdb" / (dbName + ".sqlite3-wal");
 
-
-    bool TruncateWAL(PocketDb::SQLiteDatabase& connection)
-    {
-        auto ret = sqlite3_wal_checkpoint_v2(connection.m_db, nullptr, SQLITE_CHECKPOINT_TRUNCATE, nullptr, nullptr);
-        return ret == SQLITE_OK;
+        boost::system::error_code ec;
+        auto size = fs::file_size(path, ec);
+        return ec ? 0 : (size_t) size;
     }
 }
 
 namespace PocketServices
 {
+    WalController WalControllerInst;
+
     WalController::WalController() = default;
 
     void WalController::Start(boost::thread_group& threadGroup)
     {
-        shutdown = false;
+        m_checkpointFrames = std::max((int) gArgs.GetArg("-sqlwalcheckpointpages", DEFAULT_SQL_WAL_CHECKPOINT_PAGES), 1);
+        m_truncateBytes = (size_t) std::max((int) gArgs.GetArg("-sqlwaltruncatesize", DEFAULT_SQL_WAL_TRUNCATE_SIZE), 1) * 1024 * 1024;
+
+        {
+            LOCK(m_mutex);
+            m_running = true;
+        }
+
+        Register(PocketDb::SQLiteDbInst);
+
         threadGroup.create_thread([this] { Worker(); });
     }
 
@@ -36,19 +44,90 @@ namespace PocketServices
     {
         // Signal for complete all tasks
         {
-            LOCK(_queue_mutex);
-
-            shutdown = true;
-            _queue_cond.notify_all();
+            LOCK(m_mutex);
+            m_running = false;
         }
 
+        m_cv.notify_all();
+
         // Wait all tasks completed
         LOCK(_running_mutex);
     }
 
+    void WalController::Register(SQLiteDatabase& db)
+    {
+        {
+            LOCK(m_mutex);
+            if (!m_running)
+                return;
+        }
+
+        // Replaces autocheckpoint of connection
+        sqlite3_wal_hook(db.m_db, &WalController::WalHook, this);
+    }
+
+    int WalController::WalHook(void* arg, sqlite3* db, const char* dbName, int frames)
+    {
+        static_cast<WalController*>(arg)->OnCommit(db, dbName, frames);
+        return SQLITE_OK;
+    }
+
+    // Called by writer after commit - must be fast
+    void WalController::OnCommit(sqlite3* db, const std::string& dbName, int frames)
+    {
+        {
+            LOCK(m_mutex);
+            if (m_running)
+            {
+                auto& state = m_schemas[dbName];
+                state.Frames = frames;
+
+                if (frames >= m_checkpointFrames)
+                {
+                    state.Pending = true;
+                    m_cv.notify_one();
+                }
+
+                return;
+            }
+        }
+
+        // Controller stopped - same as default SQLite autocheckpoint
+        if (frames >= m_checkpointFrames)
+            sqlite3_wal_checkpoint(db, dbName.c_str());
+    }
+
+    UniValue WalController::Statistic()
+    {
+        std::map<std::string, WalSchemaState> schemas;
+        {
+            LOCK(m_mutex);
+            schemas = m_schemas;
+        }
+
+        UniValue result(UniValue::VOBJ);
+        for (const auto& [name, state] : schemas)
+        {
+            UniValue schema(UniValue::VOBJ);
+            schema.pushKV("walsize", (int64_t) GetWalFileSize(name));
+            schema.pushKV("frames", state.Frames);
+            schema.pushKV("checkpointed", state.Checkpointed);
+            schema.pushKV("passive", state.Passive);
+            schema.pushKV("restart", state.Restart);
+            schema.pushKV("truncate", state.Truncate);
+            schema.pushKV("busy", state.Busy);
+            schema.pushKV("lastduration", state.LastDuration);
+            schema.pushKV("maxduration", state.MaxDuration);
+            result.pushKV(name, schema);
+        }
+
+        return result;
+    }
+
     void WalController::Worker()
     {
         LogPrintf("WalController: starting thread worker\n");
+        util::ThreadRename("pocketwal");
 
         LOCK(_running_mutex);
 
@@ -59,25 +138,48 @@ namespace PocketServices
         sqliteDbInst->Init(dbBasePath, "main");
         sqliteDbInst->AttachDatabase("web");
 
-        webRepoInst = make_shared<WebRepository>(*sqliteDbInst, false);
+        sqlite3_busy_timeout(sqliteDbInst->m_db, WAL_CHECKPOINT_BUSY_TIMEOUT);
 
         // Start worker infinity loop
         while (true)
-        { 
-            if (shutdown) break;
-            auto size = GetFileSize((GetDataDir()/"pocketdb/main.sqlite3-wal").string());
-            if (size > MAX_WAL_BYTES_SIZE) {
-                TruncateWAL(*sqliteDbInst);
+        {
+            std::vector<std::string> names;
+            {
+                WAIT_LOCK(m_mutex, lock);
+
+                // Not completed checkpoints are retried by timeout
+                m_cv.wait_for(lock, std::chrono::seconds(1), [&]() {
+                    if (!m_running)
+                        return true;
+
+                    for (const auto& [name, state] : m_schemas)
+                        if (state.Pending)
+                            return true;
+
+                    return false;
+                });
+
+                if (!m_running)
+                    break;
+
+                for (auto& [name, state] : m_schemas)
+                {
+                    if (state.Pending || state.Retry)
+                    {
+                        names.push_back(name);
+                        state.Pending = false;
+                        state.Retry = false;
+                    }
+                }
             }
-            UninterruptibleSleep(std::chrono::seconds(1));
+
+            for (const auto& name : names)
+                Checkpoint(name);
         }
 
         // Shutdown DB
         sqliteDbInst->m_connection_mutex.lock();
 
-        webRepoInst->Destroy();
-        webRepoInst = nullptr;
-
         sqliteDbInst->DetachDatabase("web");
         sqliteDbInst->Close();
 
@@ -86,4 +188,58 @@ namespace PocketServices
 
         LogPrintf("WalController: thread worker exit\n");
     }
+
+    void WalController::Checkpoint(const std::string& dbName)
+    {
+        int frames = 0, checkpointed = 0;
+        int mode = SQLITE_CHECKPOINT_PASSIVE;
+
+        int64_t nTime1 = GetTimeMicros();
+
+        // Copies frames not used by readers, never waits for locks
+        int ret = sqlite3_wal_checkpoint_v2(sqliteDbInst->m_db, dbName.c_str(), SQLITE_CHECKPOINT_PASSIVE, &frames, &checkpointed);
+
+        // Escalate only when nobody reads, otherwise writers would wait for readers
+        if (ret == SQLITE_OK && PocketDb::SQLiteConnectionPoolInst.InUse() == 0)
+        {
+            if (GetWalFileSize(dbName) >= m_truncateBytes)
+                mode = SQLITE_CHECKPOINT_TRUNCATE;
+            else if (frames >= 4 * m_checkpointFrames)
+                mode = SQLITE_CHECKPOINT_RESTART;
+
+            if (mode != SQLITE_CHECKPOINT_PASSIVE)
+                ret = sqlite3_wal_checkpoint_v2(sqliteDbInst->m_db, dbName.c_str(), mode, &frames, &checkpointed);
+        }
+
+        int64_t duration = GetTimeMicros() - nTime1;
+
+        LogPrint(BCLog::BENCH, "    - WalController::Checkpoint (%s, mode %d): %d of %d frames, %.2fms, ret %d\n",
+            dbName, mode, checkpointed, frames, 0.001 * (double) duration, ret);
+
+        LOCK(m_mutex);
+        auto& state = m_schemas[dbName];
+
+        if (mode == SQLITE_CHECKPOINT_PASSIVE)
+            state.Passive++;
+        else if (mode == SQLITE_CHECKPOINT_RESTART)
+            state.Restart++;
+        else
+            state.Truncate++;
+
+        state.LastDuration = duration;
+        state.MaxDuration = std::max(state.MaxDuration, duration);
+
+        if (ret == SQLITE_BUSY)
+            state.Busy++;
+
+        if (ret == SQLITE_OK || ret == SQLITE_BUSY)
+        {
+            state.Frames = std::max(frames, 0);
+            state.Checkpointed = std::max(checkpointed, 0);
+        }
+
+        // Frames used by readers or busy locks - retry later
+        if (ret == SQLITE_BUSY || state.Checkpointed < state.Frames)
+            state.Retry = true;
+    }
 } // PocketServices
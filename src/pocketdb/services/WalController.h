@@ -1,4 +1,3 @@
-
 // Copyright (c) 2018-2022 The Pocketnet developers
 // Distributed under the Apache 2.0 software license, see the accompanying
 // https://www.apache.org/licenses/LICENSE-2.0
@@ -9,18 +8,52 @@
 #include <boost/thread.hpp>
 #include "util/time.h"
 #include "sync.h"
-#include "util/html.h"
+#include "univalue.h"
 
 #include "pocketdb/SQLiteDatabase.h"
-#include "pocketdb/repositories/web/WebRepository.h"
-#include "pocketdb/models/web/WebTag.h"
-#include "pocketdb/models/web/WebContent.h"
+
+#include <condition_variable>
+#include <map>
+#include <string>
+
+static const bool DEFAULT_SQL_WAL_CONTROLLER = true;
+// WAL frames after commit that wake up controller, same as SQLite autocheckpoint
+static const int DEFAULT_SQL_WAL_CHECKPOINT_PAGES = 1000;
+// WAL file size in megabytes truncated when readers are idle
+static const int DEFAULT_SQL_WAL_TRUNCATE_SIZE = 100;
+// Busy timeout of RESTART and TRUNCATE checkpoints, they must not stall writers
+static const int WAL_CHECKPOINT_BUSY_TIMEOUT = 100;
 
 namespace PocketServices
 {
     using namespace PocketDb;
-    using namespace PocketDbWeb;
 
+    // Checkpoint state of one database schema (main, web)
+    struct WalSchemaState
+    {
+        // Frames in WAL after last commit or checkpoint
+        int Frames = 0;
+        int Checkpointed = 0;
+        // New commits above threshold
+        bool Pending = false;
+        // Not completed checkpoint, retried by timeout
+        bool Retry = false;
+
+        int64_t Passive = 0;
+        int64_t Restart = 0;
+        int64_t Truncate = 0;
+        int64_t Busy = 0;
+        int64_t LastDuration = 0;
+        int64_t MaxDuration = 0;
+    };
+
+    /**
+    * Checkpoints of WAL files moved out of writers commit path. Writer connections are
+    * registered with sqlite3_wal_hook, commits above threshold wake up the controller thread,
+    * which runs PASSIVE checkpoints by own connection. RESTART and TRUNCATE are used only when
+    * read-only connections of RPC pool are idle, so they do not wait for long readers.
+    * Without running controller the hook does the same PASSIVE checkpoint as SQLite autocheckpoint.
+    */
     class WalController
     {
     public:
@@ -28,19 +61,34 @@ namespace PocketServices
         void Start(boost::thread_group& threadGroup);
         void Stop();
 
+        // Install wal hook on writer connection
+        void Register(SQLiteDatabase& db);
+
+        UniValue Statistic();
+
     private:
         SQLiteDatabaseRef sqliteDbInst;
-        WebRepositoryRef webRepoInst;
-
-        bool shutdown = false;
 
         Mutex _running_mutex;
-        Mutex _queue_mutex;
-        std::condition_variable _queue_cond;
+
+        Mutex m_mutex;
+        std::condition_variable m_cv;
+        bool m_running GUARDED_BY(m_mutex) = false;
+
+        int m_checkpointFrames = DEFAULT_SQL_WAL_CHECKPOINT_PAGES;
+        size_t m_truncateBytes = (size_t) DEFAULT_SQL_WAL_TRUNCATE_SIZE * 1024 * 1024;
+
+        std::map<std::string, WalSchemaState> m_schemas GUARDED_BY(m_mutex);
+
+        static int WalHook(void* arg, sqlite3* db, const char* dbName, int frames);
+        void OnCommit(sqlite3* db, const std::string& dbName, int frames);
 
         void Worker();
+        void Checkpoint(const std::string& dbName);
     };
 
+    extern WalController WalControllerInst;
+
 } // PocketServices
 
 #endif // POCKETDB_WAL_CONTROLLER_H
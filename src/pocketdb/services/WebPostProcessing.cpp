@@ -4,7 +4,9 @@
 
 #include "pocketdb/services/WebPostProcessing.h"
 #include "pocketdb/consensus/Reputation.h"
+#include "pocketdb/services/WalController.h"
 #include "init.h"
+#include "util/threadnames.h"
 
 namespace PocketServices
 {
@@ -12,18 +14,61 @@ namespace PocketServices
 
     void WebPostProcessor::Start(boost::thread_group& threadGroup)
     {
-        shutdown = false;
+        {
+            LOCK(m_mutex);
+            shutdown = false;
+        }
+
+        {
+            LOCK(cs_main);
+            Notify(ChainActive().Height());
+        }
+
         threadGroup.create_thread([this] { Worker(); });
     }
 
     void WebPostProcessor::Stop()
     {
-        shutdown = true;
+        {
+            LOCK(m_mutex);
+            shutdown = true;
+        }
+
+        m_cv.notify_all();
 
         // Wait all tasks completed
         LOCK(_running_mutex);
     }
 
+    void WebPostProcessor::Notify(int height)
+    {
+        {
+            LOCK(m_mutex);
+            m_chainHeight = height;
+        }
+
+        m_cv.notify_all();
+    }
+
+    UniValue WebPostProcessor::Statistic()
+    {
+        LOCK(m_mutex);
+
+        UniValue result(UniValue::VOBJ);
+        result.pushKV("height", m_writtenHeight);
+        result.pushKV("chainheight", m_chainHeight);
+        result.pushKV("lag", max(m_chainHeight - m_writtenHeight, 0));
+        result.pushKV("catchup", m_chainHeight - m_writtenHeight > WEB_CATCHUP_LAG);
+        result.pushKV("depth", (int64_t) m_batches.size());
+        result.pushKV("batches", m_batchesWritten);
+        result.pushKV("resets", m_resets);
+        result.pushKV("lastheights", m_lastHeights);
+        result.pushKV("lastreadlatency", m_lastReadLatency);
+        result.pushKV("lastwritelatency", m_lastWriteLatency);
+        result.pushKV("maxwritelatency", m_maxWriteLatency);
+        return result;
+    }
+
     void WebPostProcessor::Worker()
     {
         LogPrintf("WebPostProcessor: starting thread worker\n");
@@ -39,17 +84,48 @@ namespace PocketServices
 
         webRepoInst = make_shared<WebRepository>(*sqliteDbInst, false);
 
+        // Writes to web database are checkpointed in background
+        WalControllerInst.Register(*sqliteDbInst);
+
+        // Reader extracts next heights from main database by own connection
+        sqliteDbReaderInst = make_shared<SQLiteDatabase>(true);
+        sqliteDbReaderInst->Init(dbBasePath, "main");
+
+        webRepoReaderInst = make_shared<WebRepository>(*sqliteDbReaderInst, false);
+
+        RepairAccountStatistic();
+
+        ResetPipeline(webRepoInst->GetCurrentHeight());
+        thread reader([this]() { Reader(); });
+
         // Start worker infinity loop
         while (true)
         {
+            if (!ProcessNextBatch())
+            {
+                // Wakeup by new batch, new block or shutdown
+                WAIT_LOCK(m_mutex, lock);
+                m_cv.wait_for(lock, std::chrono::milliseconds{10000}, [&]() { return shutdown || !m_batches.empty(); });
+            }
+
+            LOCK(m_mutex);
             if (shutdown)
                 break;
-
-            if (!ProcessNextHeight())
-                UninterruptibleSleep(std::chrono::milliseconds{10000});
         }
 
+        reader.join();
+
         // Shutdown DB
+        sqliteDbReaderInst->m_connection_mutex.lock();
+
+        webRepoReaderInst->Destroy();
+        webRepoReaderInst = nullptr;
+
+        sqliteDbReaderInst->Close();
+
+        sqliteDbReaderInst->m_connection_mutex.unlock();
+        sqliteDbReaderInst = nullptr;
+
         sqliteDbInst->m_connection_mutex.lock();
 
         webRepoInst->Destroy();
@@ -64,146 +140,392 @@ namespace PocketServices
         LogPrintf("WebPostProcessor: thread worker exit\n");
     }
 
-    bool WebPostProcessor::ProcessNextHeight()
+    void WebPostProcessor::Reader()
+    {
+        util::ThreadRename("pocketwebread");
+
+        while (true)
+        {
+            int heightFrom, heightTo;
+            uint64_t generation;
+            {
+                WAIT_LOCK(m_mutex, lock);
+                m_cv.wait_for(lock, std::chrono::milliseconds{10000}, [&]() {
+                    return shutdown || (m_batches.size() < WEB_PIPELINE_DEPTH && m_readHeight < m_chainHeight);
+                });
+
+                if (shutdown)
+                    break;
+
+                if (m_batches.size() >= WEB_PIPELINE_DEPTH || m_readHeight >= m_chainHeight)
+                    continue;
+
+                // Far behind the chain - ranges of heights, otherwise each block as soon as possible
+                heightFrom = m_readHeight + 1;
+                heightTo = heightFrom;
+                if (m_chainHeight - m_readHeight > WEB_CATCHUP_LAG)
+                    heightTo = min(m_chainHeight, heightFrom + MAX_WEB_BATCH_HEIGHTS - 1);
+
+                generation = m_generation;
+            }
+
+            WebHeightBatch batch;
+            bool ok = ReadBatch(heightFrom, heightTo, batch);
+
+            {
+                LOCK(m_mutex);
+
+                // Pipeline was reset by writer while reading
+                if (generation != m_generation)
+                    continue;
+
+                if (ok && batch.Hashes.empty())
+                {
+                    // Active chain is shorter than notified, wait next block
+                    m_chainHeight = m_readHeight;
+                    continue;
+                }
+
+                if (ok)
+                {
+                    m_readHeight = batch.HeightTo;
+                    m_lastReadLatency = batch.ReadLatency;
+                    m_batches.push_back(move(batch));
+                }
+            }
+
+            if (ok)
+            {
+                m_cv.notify_all();
+                continue;
+            }
+
+            // Retry after pause
+            WAIT_LOCK(m_mutex, lock);
+            m_cv.wait_for(lock, std::chrono::milliseconds{10000}, [&]() { return shutdown; });
+        }
+    }
+
+    bool WebPostProcessor::ReadBatch(int heightFrom, int heightTo, WebHeightBatch& batch)
     {
         try
         {
             int64_t nTime1 = GetTimeMicros();
-            
+
+            {
+                LOCK(cs_main);
+                for (int height = heightFrom; height <= heightTo; height++)
+                {
+                    auto pindex = ChainActive()[height];
+                    if (!pindex)
+                        break;
+
+                    batch.Hashes.push_back(pindex->GetBlockHash().GetHex());
+                }
+            }
+
+            if (batch.Hashes.empty())
+                return true;
+
+            batch.HeightFrom = heightFrom;
+            batch.HeightTo = heightFrom + (int) batch.Hashes.size() - 1;
+
+            // Connected block may be not committed to the database yet - range is read again later
+            // instead of being marked processed without its data
+            if (!webRepoReaderInst->ExistsBlock(batch.Hashes.back(), batch.HeightTo))
+            {
+                LogPrint(BCLog::WARN, "WebPostProcessor::ReadBatch - block %s at height %d not visible yet\n", batch.Hashes.back(), batch.HeightTo);
+                return false;
+            }
+
+            batch.Tags = webRepoReaderInst->GetContentTags(batch.HeightFrom, batch.HeightTo);
+            auto appTags = webRepoReaderInst->GetAppTags(batch.HeightFrom, batch.HeightTo);
+            batch.Tags.insert(batch.Tags.end(), appTags.begin(), appTags.end());
+            PrepareTags(batch.Tags);
+
+            batch.Contents = webRepoReaderInst->GetContent(batch.HeightFrom, batch.HeightTo);
+            PrepareSearchContent(batch.Contents);
+
+            batch.ReadLatency = GetTimeMicros() - nTime1;
+            LogPrint(BCLog::BENCH, "    - WebPostProcessor::ReadBatch (%d-%d): %.2fms\n", batch.HeightFrom, batch.HeightTo, 0.001 * (double) batch.ReadLatency);
+
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            LogPrintf("Warning: WebPostProcessor::ReadBatch - %s\n", e.what());
+            return false;
+        }
+    }
+
+    void WebPostProcessor::ResetPipeline(int height)
+    {
+        {
+            LOCK(m_mutex);
+            m_batches.clear();
+            m_readHeight = height;
+            m_writtenHeight = height;
+            m_generation++;
+        }
+
+        m_cv.notify_all();
+    }
+
+    bool WebPostProcessor::ProcessNextBatch()
+    {
+        try
+        {
+            int64_t nTime1 = GetTimeMicros();
+
             int currHeight = webRepoInst->GetCurrentHeight();
             gStatEngineInstance.HeightWeb = currHeight;
 
-            // Return 'false' for non found work
-            if (ChainActive().Height() - currHeight <= 0)
-                return false;
+            // Last processed block disconnected - statistic is restored before other chain is processed
+            if (RollbackDisconnected(currHeight))
+            {
+                ResetPipeline(currHeight);
+                return true;
+            }
 
-            // Proccess next block height
-            currHeight += 1;
+            WebHeightBatch batch;
+            {
+                LOCK(m_mutex);
+                if (m_batches.empty())
+                    return false;
 
-            // Launch all needed processes
-            ProcessTags(currHeight);
-            ProcessSearchContent(currHeight);
-        
-            webRepoInst->UpsertBarteronAccounts(currHeight);
-            webRepoInst->UpsertBarteronOffers(currHeight);
+                batch = move(m_batches.front());
+                m_batches.pop_front();
+            }
 
-            int period = 60;
-            if (gArgs.GetChainName() == CBaseChainParams::REGTEST)
-                period = 1;
-            
-            if (currHeight % period == 0 && pindexBestHeader && (pindexBestHeader->nHeight - currHeight) < period)
+            // Reader can continue
+            m_cv.notify_all();
+
+            bool actual = batch.HeightFrom == currHeight + 1;
+            if (actual)
             {
-                int64_t nTime2 = GetTimeMicros();
-                
-                webRepoInst->CollectAccountStatistic();
-                
-                int64_t nTime3 = GetTimeMicros();
-                LogPrint(BCLog::BENCH, "    - WebPostProcessor::ProcessNextHeight (CollectAccountStatistic): %.2fms\n", 0.001 * (double)(nTime3 - nTime2));
+                // Blocks can be disconnected after read
+                LOCK(cs_main);
+                for (size_t i = 0; i < batch.Hashes.size() && actual; i++)
+                {
+                    auto pindex = ChainActive()[batch.HeightFrom + (int) i];
+                    actual = pindex && pindex->GetBlockHash().GetHex() == batch.Hashes[i];
+                }
             }
-            
-            webRepoInst->SetCurrentHeight(currHeight);
-            
-            int64_t nTime4 = GetTimeMicros();
-            LogPrint(BCLog::BENCH, "    - WebPostProcessor::ProcessNextHeight: %.2fms\n", 0.001 * (double)(nTime4 - nTime1));
-            
+
+            if (!actual)
+            {
+                LogPrint(BCLog::SYNC, "WebPostProcessor: batch %d-%d is not actual, read again from %d\n", batch.HeightFrom, batch.HeightTo, currHeight + 1);
+                ResetPipeline(currHeight);
+
+                LOCK(m_mutex);
+                m_resets++;
+                return true;
+            }
+
+            if (!WriteBatch(batch))
+            {
+                // Batch is read again after blocks are committed
+                ResetPipeline(webRepoInst->GetCurrentHeight());
+                return false;
+            }
+
+            int64_t nTime2 = GetTimeMicros();
+            LogPrint(BCLog::BENCH, "    - WebPostProcessor::ProcessNextBatch (%d-%d): %.2fms\n", batch.HeightFrom, batch.HeightTo, 0.001 * (double)(nTime2 - nTime1));
+
+            {
+                LOCK(m_mutex);
+                m_writtenHeight = batch.HeightTo;
+                m_batchesWritten++;
+                m_lastHeights = (int) batch.Hashes.size();
+                m_lastWriteLatency = nTime2 - nTime1;
+                m_maxWriteLatency = max(m_maxWriteLatency, m_lastWriteLatency);
+            }
+
             return true;
         }
         catch (const std::exception& e)
         {
-            LogPrintf("Warning: WebPostProcessor::ProcessNextHeight - %s\n", e.what());
+            LogPrintf("Warning: WebPostProcessor::ProcessNextBatch - %s\n", e.what());
 	        return false;
         }
     }
 
-
-    void WebPostProcessor::ProcessTags(int height)
+    bool WebPostProcessor::WriteBatch(const WebHeightBatch& batch)
     {
-        try
+        // Tags and search content of whole range - one transaction for each
+        WriteTags(batch.Tags);
+        WriteSearchContent(batch.Contents);
+
+        // Statistic journal is kept by height
+        for (int height = batch.HeightFrom; height <= batch.HeightTo; height++)
         {
+            webRepoInst->UpsertBarteronAccounts(height);
+            webRepoInst->UpsertBarteronOffers(height);
+
             int64_t nTime1 = GetTimeMicros();
 
-            auto contentTags = webRepoInst->GetContentTags(height);
-            auto appTags = webRepoInst->GetAppTags(height);
-            contentTags.insert(contentTags.end(), appTags.begin(), appTags.end());
-            
-            if (contentTags.empty())
-                return;
+            if (!webRepoInst->UpdateAccountStatistic(height, batch.Hashes[height - batch.HeightFrom]))
+            {
+                LogPrint(BCLog::WARN, "WebPostProcessor::WriteBatch - block at height %d not visible yet\n", height);
+                webRepoInst->SetCurrentHeight(height - 1);
+                gStatEngineInstance.HeightWeb = height - 1;
+                return false;
+            }
 
             int64_t nTime2 = GetTimeMicros();
-            LogPrint(BCLog::BENCH, "    - WebPostProcessor::ProcessTags (Select): %.2fms\n", 0.001 * (double)(nTime2 - nTime1));
+            LogPrint(BCLog::BENCH, "    - WebPostProcessor::WriteBatch (UpdateAccountStatistic): %.2fms\n", 0.001 * (double)(nTime2 - nTime1));
+        }
+
+        webRepoInst->SetCurrentHeight(batch.HeightTo);
+        gStatEngineInstance.HeightWeb = batch.HeightTo;
+        return true;
+    }
 
-            // Decode contentTags before upsert
-            for (auto& contentTag : contentTags)
+    bool WebPostProcessor::RollbackDisconnected(int& height)
+    {
+        string processedHash = webRepoInst->GetProcessedBlock(height);
+        if (processedHash.empty())
+        {
+            // Heights up to last full recompute are not journaled
+            if (height <= webRepoInst->GetAccountStatisticHeight())
+                return false;
+
+            // Rollback is deeper than journal - block at height can not be checked
+            LogPrintf("WebPostProcessor: rollback at height %d is deeper than account statistic journal\n", height);
+        }
+        else
+        {
             {
-                contentTag.Value = HtmlUtils::UrlDecode(contentTag.Value);
-                HtmlUtils::StringToLower(contentTag.Value);
+                LOCK(cs_main);
+                auto pindex = ChainActive()[height];
+                if (pindex && pindex->GetBlockHash().GetHex() == processedHash)
+                    return false;
             }
 
-            int64_t nTime3 = GetTimeMicros();
-            LogPrint(BCLog::BENCH, "    - WebPostProcessor::ProcessTags (Prepare): %.2fms\n", 0.001 * (double)(nTime3 - nTime2));
+            LogPrintf("WebPostProcessor: block %s at height %d disconnected, rollback account statistic\n", processedHash, height);
 
-            // Insert content tags
-            webRepoInst->UpsertContentTags(contentTags);
+            if (webRepoInst->RollbackAccountStatistic(height))
+            {
+                height -= 1;
+                webRepoInst->SetCurrentHeight(height);
+                return true;
+            }
+
+            LogPrintf("WebPostProcessor: block %s is included in full recompute of account statistic\n", processedHash);
+            height -= 1;
+        }
 
-            int64_t nTime4 = GetTimeMicros();
-            LogPrint(BCLog::BENCH, "    - WebPostProcessor::ProcessTags (Upsert): %.2fms\n", 0.001 * (double)(nTime4 - nTime3));
+        // Statistic can not be restored from journal - recompute from current chain
+        // and continue processing from the height included in the recompute
+        height = min(height, RecomputeAccountStatistic());
+        webRepoInst->SetCurrentHeight(height);
+        return true;
+    }
+
+    void WebPostProcessor::RepairAccountStatistic()
+    {
+        try
+        {
+            if (!gArgs.GetBoolArg("-repairaccountstatistic", false) && webRepoInst->GetAccountStatisticHeight() >= 0)
+                return;
+
+            RecomputeAccountStatistic();
         }
         catch (const std::exception& e)
         {
-            LogPrintf("Warning: WebPostProcessor::ProcessTags - %s\n", e.what());
+            LogPrintf("Warning: WebPostProcessor::RepairAccountStatistic - %s\n", e.what());
         }
     }
 
-    void WebPostProcessor::ProcessSearchContent(int height)
+    int WebPostProcessor::RecomputeAccountStatistic()
+    {
+        LogPrintf("WebPostProcessor: full recompute of account statistic..\n");
+
+        int64_t nTime1 = GetTimeMicros();
+        int height = webRepoInst->RepairAccountStatistic();
+        int64_t nTime2 = GetTimeMicros();
+
+        LogPrintf("WebPostProcessor: account statistic recomputed at height %d in %.2fs\n", height, 0.000001 * (double)(nTime2 - nTime1));
+        return height;
+    }
+
+    void WebPostProcessor::PrepareTags(vector<WebTag>& contentTags)
+    {
+        // Decode contentTags before upsert
+        for (auto& contentTag : contentTags)
+        {
+            contentTag.Value = HtmlUtils::UrlDecode(contentTag.Value);
+            HtmlUtils::StringToLower(contentTag.Value);
+        }
+    }
+
+    void WebPostProcessor::WriteTags(const vector<WebTag>& contentTags)
     {
         try
         {
+            if (contentTags.empty())
+                return;
+
             int64_t nTime1 = GetTimeMicros();
 
-            vector<WebContent> contentList = webRepoInst->GetContent(height);
-            if (contentList.empty())
-                return;
+            // Insert content tags
+            webRepoInst->UpsertContentTags(contentTags);
 
             int64_t nTime2 = GetTimeMicros();
-            LogPrint(BCLog::BENCH, "    - WebPostProcessor::ProcessSearchContent (Select): %.2fms\n", 0.001 * (double)(nTime2 - nTime1));
+            LogPrint(BCLog::BENCH, "    - WebPostProcessor::WriteTags (Upsert): %.2fms\n", 0.001 * (double)(nTime2 - nTime1));
+        }
+        catch (const std::exception& e)
+        {
+            LogPrintf("Warning: WebPostProcessor::WriteTags - %s\n", e.what());
+        }
+    }
 
-            // Decode content before upsert
-            for (auto& contentItm : contentList)
-            {
-                if (contentItm.Value.empty())
-                    continue;
+    void WebPostProcessor::PrepareSearchContent(vector<WebContent>& contentList)
+    {
+        // Decode content before upsert
+        for (auto& contentItm : contentList)
+        {
+            if (contentItm.Value.empty())
+                continue;
 
-                switch (contentItm.FieldType)
-                {
-                    case ContentFieldType_ContentPostCaption:
-                    case ContentFieldType_ContentVideoCaption:
-                    case ContentFieldType_ContentPostMessage:
-                    case ContentFieldType_ContentVideoMessage:
-                    case ContentFieldType_AccountUserAbout:
-                    case ContentFieldType_AccountUserName:
-                        contentItm.Value = HtmlUtils::UrlDecode(contentItm.Value);
-                        break;
-                    case ContentFieldType_CommentMessage:
-                        // TODO (aok): get message from JSON
-                        break;
-                    default:
-                        break;
-                }
-                
+            switch (contentItm.FieldType)
+            {
+                case ContentFieldType_ContentPostCaption:
+                case ContentFieldType_ContentVideoCaption:
+                case ContentFieldType_ContentPostMessage:
+                case ContentFieldType_ContentVideoMessage:
+                case ContentFieldType_AccountUserAbout:
+                case ContentFieldType_AccountUserName:
+                    contentItm.Value = HtmlUtils::UrlDecode(contentItm.Value);
+                    break;
+                case ContentFieldType_CommentMessage:
+                    // TODO (aok): get message from JSON
+                    break;
+                default:
+                    break;
             }
+            
+        }
+    }
+
+    void WebPostProcessor::WriteSearchContent(const vector<WebContent>& contentList)
+    {
+        try
+        {
+            if (contentList.empty())
+                return;
 
-            int64_t nTime3 = GetTimeMicros();
-            LogPrint(BCLog::BENCH, "    - WebPostProcessor::ProcessSearchContent (Prepare): %.2fms\n", 0.001 * (double)(nTime3 - nTime2));
+            int64_t nTime1 = GetTimeMicros();
 
             // Insert content
             webRepoInst->UpsertContent(contentList);
 
-            int64_t nTime4 = GetTimeMicros();
-            LogPrint(BCLog::BENCH, "    - WebPostProcessor::ProcessSearchContent (Upsert): %.2fms\n", 0.001 * (double)(nTime4 - nTime3));
+            int64_t nTime2 = GetTimeMicros();
+            LogPrint(BCLog::BENCH, "    - WebPostProcessor::WriteSearchContent (Upsert): %.2fms\n", 0.001 * (double)(nTime2 - nTime1));
         }
         catch (const std::exception& e)
         {
-            LogPrintf("Warning: WebPostProcessor::ProcessSearchContent - %s\n", e.what());
+            LogPrintf("Warning: WebPostProcessor::WriteSearchContent - %s\n", e.what());
         }
     }
 
@@ -8,6 +8,7 @@
 #include <boost/thread.hpp>
 #include "util/time.h"
 #include "sync.h"
+#include "univalue.h"
 #include "util/html.h"
 
 #include "pocketdb/SQLiteDatabase.h"
@@ -15,30 +16,98 @@
 #include "pocketdb/models/web/WebTag.h"
 #include "pocketdb/models/web/WebContent.h"
 
+#include <condition_variable>
+#include <deque>
+#include <thread>
+
+// Web database behind the chain by more heights is processed by ranges
+static const int WEB_CATCHUP_LAG = 10;
+static const int MAX_WEB_BATCH_HEIGHTS = 100;
+// Ranges read ahead while previous one is written
+static const size_t WEB_PIPELINE_DEPTH = 2;
+
 namespace PocketServices
 {
     using namespace PocketDb;
     using namespace PocketDbWeb;
 
+    // Data of heights range extracted from main database
+    struct WebHeightBatch
+    {
+        int HeightFrom = 0;
+        int HeightTo = 0;
+        // Hashes of blocks in active chain at time of read
+        vector<string> Hashes;
+        vector<WebTag> Tags;
+        vector<WebContent> Contents;
+        int64_t ReadLatency = 0;
+    };
+
+    /**
+    * Builds web database from connected blocks. Reader thread extracts next heights from
+    * the main database by own connection while the worker writes previous ones, so reads and
+    * upserts overlap. Far behind the chain heights are processed by ranges. Worker and reader
+    * are woken up by Notify from ConnectTip.
+    */
     class WebPostProcessor
     {
     public:
         WebPostProcessor();
         void Start(boost::thread_group& threadGroup);
         void Stop();
- 
-        void ProcessTags(int height);
-        void ProcessSearchContent(int height);
+
+        // New block connected at height
+        void Notify(int height);
+
+        UniValue Statistic();
+
+        static void PrepareTags(vector<WebTag>& contentTags);
+        static void PrepareSearchContent(vector<WebContent>& contentList);
 
     private:
         SQLiteDatabaseRef sqliteDbInst;
         WebRepositoryRef webRepoInst;
+        SQLiteDatabaseRef sqliteDbReaderInst;
+        WebRepositoryRef webRepoReaderInst;
 
-        bool shutdown = false;
         Mutex _running_mutex;
 
+        Mutex m_mutex;
+        condition_variable m_cv;
+        bool shutdown GUARDED_BY(m_mutex) = false;
+
+        deque<WebHeightBatch> m_batches GUARDED_BY(m_mutex);
+        int m_chainHeight GUARDED_BY(m_mutex) = 0;
+        int m_readHeight GUARDED_BY(m_mutex) = 0;
+        int m_writtenHeight GUARDED_BY(m_mutex) = 0;
+        // Incremented when read batches are discarded
+        uint64_t m_generation GUARDED_BY(m_mutex) = 0;
+
+        // Metrics
+        int64_t m_batchesWritten GUARDED_BY(m_mutex) = 0;
+        int64_t m_resets GUARDED_BY(m_mutex) = 0;
+        int m_lastHeights GUARDED_BY(m_mutex) = 0;
+        int64_t m_lastReadLatency GUARDED_BY(m_mutex) = 0;
+        int64_t m_lastWriteLatency GUARDED_BY(m_mutex) = 0;
+        int64_t m_maxWriteLatency GUARDED_BY(m_mutex) = 0;
+
         void Worker();
-        bool ProcessNextHeight();
+        void Reader();
+        bool ReadBatch(int heightFrom, int heightTo, WebHeightBatch& batch);
+        // Discard read batches, reader continues after height
+        void ResetPipeline(int height);
+        bool ProcessNextBatch();
+        // Returns false if some block of batch is not committed yet, processed heights are saved
+        bool WriteBatch(const WebHeightBatch& batch);
+        void WriteTags(const vector<WebTag>& contentTags);
+        void WriteSearchContent(const vector<WebContent>& contentList);
+        // Returns true if block processed at height is not in active chain anymore and was rolled back,
+        // height is changed to the new processed height
+        bool RollbackDisconnected(int& height);
+        // Full recompute on first start or with -repairaccountstatistic
+        void RepairAccountStatistic();
+        // Returns chain height included in the recompute
+        int RecomputeAccountStatistic();
 
     };
 
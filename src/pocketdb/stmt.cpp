@@ -55,6 +55,22 @@ namespace PocketDb
         return true;
     }
 
+    void Stmt::TryBindStatementText(int index, string_view value)
+    {
+        auto res = m_stmt->BindText(index, value);
+        if (!CheckValidResult(res))
+            throw runtime_error(strprintf("%s: Failed bind SQL statement - index:%d value:%s\n",
+                __func__, index, string(value)));
+    }
+
+    bool Stmt::TryBindStatementText(int index, const optional<string_view>& value)
+    {
+        if (!value) return true;
+
+        TryBindStatementText(index, *value);
+        return true;
+    }
+
     bool Stmt::TryBindStatementInt(int index, const optional<int>& value)
     {
         if (!value) return true;
@@ -117,6 +133,91 @@ namespace PocketDb
         func(cursor);
     }
 
+    // ----------------------------------------------
+    // STMT CACHE
+    // ----------------------------------------------
+
+    Stmt& StmtCache::Get(SQLiteDatabase& db, const string& sql)
+    {
+        lock_guard<mutex> lock(m_mutex);
+
+        // Generation is taken before hints are removed - statement prepared with newer hints is only re-prepared once more
+        auto generation = SQLiteDatabase::MissingIndexesGeneration();
+
+        auto itr = m_index.find(sql);
+        if (itr != m_index.end())
+        {
+            auto& entry = *itr->second;
+            m_lru.splice(m_lru.begin(), m_lru, itr->second);
+
+            if (entry.Generation == generation)
+            {
+                m_hits++;
+                Pin(entry);
+                return *entry.Statement;
+            }
+
+            // Set of missing indexes changed - previous statement stays alive while pinned
+            m_misses++;
+            auto stmt = make_shared<Stmt>();
+            stmt->Init(db, SQLiteDatabase::RemoveMissingIndexHints(sql));
+            entry.Statement = std::move(stmt);
+            entry.Generation = generation;
+            entry.PinEpoch = 0;
+            Pin(entry);
+            return *entry.Statement;
+        }
+
+        m_misses++;
+
+        // Hints to deferred indexes that are not built yet fail the prepare
+        auto stmt = make_shared<Stmt>();
+        stmt->Init(db, SQLiteDatabase::HasMissingIndexes() ? SQLiteDatabase::RemoveMissingIndexHints(sql) : sql);
+
+        m_lru.push_front(Entry{sql, std::move(stmt), generation});
+        m_index.emplace(m_lru.front().Sql, m_lru.begin());
+        Pin(m_lru.front());
+
+        // Pinned statements are only dropped from cache, finalized in Unpin
+        while (m_lru.size() > m_capacity)
+        {
+            m_index.erase(m_lru.back().Sql);
+            m_lru.pop_back();
+        }
+
+        return *m_lru.front().Statement;
+    }
+
+    void StmtCache::Pin(Entry& entry)
+    {
+        if (entry.PinEpoch == m_pinEpoch)
+            return;
+
+        entry.PinEpoch = m_pinEpoch;
+        m_pinned.push_back(entry.Statement);
+    }
+
+    void StmtCache::Unpin()
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_pinned.clear();
+        m_pinEpoch++;
+    }
+
+    void StmtCache::Clear()
+    {
+        lock_guard<mutex> lock(m_mutex);
+        m_index.clear();
+        m_lru.clear();
+        m_pinned.clear();
+    }
+
+    size_t StmtCache::Size()
+    {
+        lock_guard<mutex> lock(m_mutex);
+        return m_lru.size();
+    }
+
     // ----------------------------------------------
     // CURSOR
     // ----------------------------------------------
@@ -199,6 +300,12 @@ namespace PocketDb
     {
         return TryGetColumn<std::string>(index);
     }
+    tuple<bool, string_view> Cursor::TryGetColumnStringView(int index)
+    {
+        m_currentCollectIndex = index + 1;
+        auto val = m_stmt->GetColumnTextView(index);
+        return {val.has_value(), val.value_or(string_view())};
+    }
     tuple<bool, int64_t> Cursor::TryGetColumnInt64(int index)
     {
         return TryGetColumn<int64_t>(index);
@@ -237,6 +344,11 @@ namespace PocketDb
         return sqlite3_bind_text(m_stmt, index, val.c_str(), (int)val.size(), SQLITE_STATIC);
     }
 
+    int StmtWrapper::BindText(int index, std::string_view val)
+    {
+        return sqlite3_bind_text(m_stmt, index, val.data(), (int)val.size(), SQLITE_STATIC);
+    }
+
     int StmtWrapper::BindInt(int index, int val)
     {
         return sqlite3_bind_int(m_stmt, index, val);
@@ -265,6 +377,16 @@ namespace PocketDb
         return string(reinterpret_cast<const char*>(sqlite3_column_text(m_stmt, index)));
     }
 
+    optional<string_view> StmtWrapper::GetColumnTextView(int index)
+    {
+        if (GetColumnType(index) != SQLITE_TEXT) {
+            return nullopt;
+        }
+        // Text pointer must be taken before bytes count
+        auto text = reinterpret_cast<const char*>(sqlite3_column_text(m_stmt, index));
+        return string_view(text, sqlite3_column_bytes(m_stmt, index));
+    }
+
     std::optional<int> StmtWrapper::GetColumnInt(int index)
     {
         if (GetColumnType(index) != SQLITE_INTEGER) {
@@ -10,6 +10,11 @@
 #include <sqlite3.h>
 
 #include <optional>
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <string_view>
+#include <unordered_map>
 
 namespace PocketDb
 {
@@ -34,6 +39,7 @@ namespace PocketDb
         int Step();
 
         int BindText(int index, const std::string& val);
+        int BindText(int index, std::string_view val);
         int BindInt(int index, int val);
         int BindInt64(int index, int64_t val);
         int BindNull(int index);
@@ -41,6 +47,8 @@ namespace PocketDb
         int GetColumnType(int index);
 
         optional<string> GetColumnText(int index);
+        // View over sqlite memory, valid until next step or reset of statement
+        optional<string_view> GetColumnTextView(int index);
         optional<int> GetColumnInt(int index);
         optional<int64_t> GetColumnInt64(int index);
 
@@ -87,6 +95,9 @@ namespace PocketDb
         // Forces user to handle memory more correct because of SQLITE_STATIC requires it
         bool TryBindStatementText(int index, const std::optional<std::string>&& value) = delete;
         bool TryBindStatementText(int index, const std::optional<std::string>& value);
+        // Value must be alive until statement is executed
+        void TryBindStatementText(int index, std::string_view value);
+        bool TryBindStatementText(int index, const std::optional<std::string_view>& value);
         bool TryBindStatementInt(int index, const std::optional<int>& value);
         void TryBindStatementInt(int index, int value);
         bool TryBindStatementInt64(int index, const std::optional<int64_t>& value);
@@ -115,6 +126,9 @@ namespace PocketDb
                 else if constexpr (std::is_convertible_v<T, int64_t> || std::is_convertible_v<T, optional<int64_t>>) {
                     stmt.TryBindStatementInt64(i++, t);
                 }
+                else if constexpr (std::is_same_v<T, string_view> || std::is_same_v<T, optional<string_view>>) {
+                    stmt.TryBindStatementText(i++, t);
+                }
                 else if constexpr (std::is_convertible_v<T, string> || std::is_convertible_v<T, optional<string>>) {
                     stmt.TryBindStatementText(i++, t);
                 } else {
@@ -127,6 +141,54 @@ namespace PocketDb
         };
     };
 
+    /**
+    * Bounded LRU cache of prepared statements keyed by original SQL text.
+    * Hints to missing deferred indexes are removed only when statement is prepared,
+    * statements prepared for other set of missing indexes are prepared again.
+    * One instance is owned by every SQLiteDatabase connection so all repositories
+    * working over the same connection share prepared statements.
+    * Statements returned by Get() are pinned until Unpin() at the end of connection
+    * transaction - evicted statement stays alive while caller may hold the reference.
+    */
+    class StmtCache
+    {
+    public:
+        explicit StmtCache(size_t capacity) : m_capacity(std::max<size_t>(capacity, 1)) {}
+        StmtCache(const StmtCache&) = delete;
+
+        Stmt& Get(SQLiteDatabase& db, const std::string& sql);
+        void Unpin();
+        void Clear();
+
+        size_t Size();
+        int64_t Hits() const { return m_hits; }
+        int64_t Misses() const { return m_misses; }
+
+    private:
+        struct Entry
+        {
+            std::string Sql;
+            std::shared_ptr<Stmt> Statement;
+            // SQLiteDatabase::MissingIndexesGeneration() when statement was prepared
+            uint64_t Generation = 0;
+            // Entry is in m_pinned if equal to current m_pinEpoch
+            uint64_t PinEpoch = 0;
+        };
+
+        size_t m_capacity;
+        std::list<Entry> m_lru;
+        // Keys point to strings owned by m_lru nodes
+        std::unordered_map<std::string_view, std::list<Entry>::iterator> m_index;
+        std::vector<std::shared_ptr<Stmt>> m_pinned;
+        uint64_t m_pinEpoch = 1;
+        std::mutex m_mutex;
+
+        void Pin(Entry& entry);
+
+        std::atomic<int64_t> m_hits{0};
+        std::atomic<int64_t> m_misses{0};
+    };
+
     template <size_t N>
     class SeqRes
     {
@@ -211,6 +273,8 @@ namespace PocketDb
             return {res, val};
         }
         tuple<bool, string> TryGetColumnString(int index);
+        // Without copy - value is valid only until next Step()
+        tuple<bool, string_view> TryGetColumnStringView(int index);
         tuple<bool, int64_t> TryGetColumnInt64(int index);
         tuple<bool, int> TryGetColumnInt(int index);
     
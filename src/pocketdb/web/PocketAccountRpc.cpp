@@ -702,8 +702,9 @@ namespace PocketWeb::PocketWebRpc
             if (request.params.size() > 4 && request.params[4].isNum())
                 limit = min(0, request.params[4].get_int());
 
-            return request.DbConnection()->WebRpcRepoInst->GetSubscribersAddresses(
-                address, { ACTION_SUBSCRIBE, ACTION_SUBSCRIBE_PRIVATE }, orderBy, orderDesc, offset, limit);
+            request.SetSerializedResult(request.DbConnection()->WebRpcRepoInst->GetSubscribersAddresses(
+                address, { ACTION_SUBSCRIBE, ACTION_SUBSCRIBE_PRIVATE }, orderBy, orderDesc, offset, limit));
+            return NullUniValue;
         }};
     }
 
@@ -69,7 +69,8 @@ namespace PocketWeb::PocketWebRpc
         }
         else
         {
-            return request.DbConnection()->WebRpcRepoInst->GetCommentsByPost(postHash, parentHash, addressHash);
+            request.SetSerializedResult(request.DbConnection()->WebRpcRepoInst->GetCommentsByPost(postHash, parentHash, addressHash));
+            return NullUniValue;
         }
     },
         };
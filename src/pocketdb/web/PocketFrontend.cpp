@@ -5,36 +5,107 @@
 // https://www.apache.org/licenses/LICENSE-2.0
 
 #include "pocketdb/web/PocketFrontend.h"
+#include "crypto/sha256.h"
 #include "fs.h"
+#include "util/strencodings.h"
+
+#include <cerrno>
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace PocketWeb
 {
     using namespace std;
 
-    tuple<bool, string> PocketFrontend::ReadFileFromDisk(const string& path)
+    shared_ptr<FileContent> FileContent::Open(const fs::path& path)
+    {
+#ifndef WIN32
+        int fd = open(path.string().c_str(), O_RDONLY);
+        if (fd < 0)
+            return nullptr;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+        {
+            close(fd);
+            return nullptr;
+        }
+
+        string buffer((size_t) st.st_size, '\0');
+        size_t readed = 0;
+        while (readed < buffer.size())
+        {
+            ssize_t res = read(fd, &buffer[readed], buffer.size() - readed);
+            if (res < 0 && errno == EINTR)
+                continue;
+            if (res <= 0)
+                break;
+            readed += (size_t) res;
+        }
+        close(fd);
+
+        // Truncated while reading
+        buffer.resize(readed);
+        return make_shared<FileContent>(move(buffer));
+#else
+        ifstream file(path.string(), ios::binary);
+        if (!file)
+            return nullptr;
+
+        return make_shared<FileContent>(string((istreambuf_iterator<char>(file)), istreambuf_iterator<char>()));
+#endif
+    }
+
+    size_t StaticFile::CacheSize() const
+    {
+        size_t size = Path.capacity() + Name.capacity() + ContentType.capacity() + ETag.capacity() + 128;
+        if (Content)
+            size += Content->Size();
+        for (const auto&[encoding, data] : Encoded)
+            size += data.capacity();
+        return size;
+    }
+
+    tuple<bool, shared_ptr<FileContent>> PocketFrontend::ReadFileFromDisk(const string& path)
     {
         try
         {
-            string _path = (_rootPath / path).string();
+            auto _path = _rootPath / path;
 
             if (fs::exists(_path) && !fs::is_directory(_path))
             {
-                ifstream file(_path);
-                string content((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
-                return {true, content};
+                if (auto content = FileContent::Open(_path))
+                    return {true, content};
             }
 
-            return {false, ""};
+            return {false, nullptr};
         }
         catch (const std::exception& e)
         {
             LogPrintf("Warning: failed read file %s with error %s\n", path, e.what());
-            return {false, ""};
+            return {false, nullptr};
         }
     }
 
     tuple<bool, shared_ptr<StaticFile>> PocketFrontend::ReadFile(const string& path)
     {
+        // State before read - change between stat and read is caught on next check
+        int64_t modifiedTime = 0;
+        uintmax_t fileSize = 0;
+        try
+        {
+            modifiedTime = (int64_t) fs::last_write_time(_rootPath / path);
+            fileSize = fs::file_size(_rootPath / path);
+        }
+        catch (const std::exception&)
+        {
+            return {false, nullptr};
+        }
+
         // Try read file from disk
         auto[readOk, content] = ReadFileFromDisk(path);
         if (!readOk)
@@ -48,16 +119,37 @@ namespace PocketWeb
             _name = pathParts.back();
 
         // Build file struct
-        auto file = shared_ptr<StaticFile>(new StaticFile{
-            path,
-            _name,
-            DetectContentType(_name),
-            content
-        });
+        auto file = make_shared<StaticFile>();
+        file->Path = path;
+        file->Name = _name;
+        file->ContentType = DetectContentType(_name);
+        file->Content = content;
+        file->ModifiedTime = modifiedTime;
+        file->FileSize = fileSize;
+        BuildVariants(*file);
 
         return {true, file};
     }
 
+    void PocketFrontend::BuildVariants(StaticFile& file)
+    {
+        auto content = file.Content->View();
+
+        unsigned char hash[CSHA256::OUTPUT_SIZE];
+        CSHA256().Write((const unsigned char*) content.data(), content.size()).Finalize(hash);
+        file.ETag = "\"" + HexStr(Span<const unsigned char>(hash, 8)) + "\"";
+
+        if (content.size() < HTTP_COMPRESSION_MIN_SIZE || !IsCompressibleContentType(file.ContentType))
+            return;
+
+        for (auto encoding : {HTTPContentEncoding::BROTLI, HTTPContentEncoding::GZIP, HTTPContentEncoding::DEFLATE})
+        {
+            string compressed;
+            if (CompressContent(content, encoding, HTTP_PRECOMPRESSION_LEVEL, compressed) && compressed.size() < content.size())
+                file.Encoded.emplace(encoding, move(compressed));
+        }
+    }
+
     string PocketFrontend::DetectContentType(string fileName)
     {
         auto _extension = fileName;
@@ -90,48 +182,117 @@ namespace PocketWeb
                 throw;
         }
 
-        auto testContent = shared_ptr<StaticFile>(new StaticFile{
-            "/404.html",
-            "404.html",
-            "",
-            "<html><body>Not Found</body></html>"
-        });
+        auto testContent = make_shared<StaticFile>();
+        testContent->Path = "/404.html";
+        testContent->Name = "404.html";
+        testContent->Content = make_shared<FileContent>("<html><body>Not Found</body></html>");
 
-        LOCK(CacheMutex);
-        Cache.emplace(
-            "/404.html",
-            testContent
-        );
+        // Not a file on disk - never checked for changes
+        testContent->ModifiedTime = -1;
+
+        CacheEmplace("/404.html", testContent);
+    }
+
+    void PocketFrontend::SetMaxSize(int megabytes)
+    {
+        MaxCacheSize = (size_t) std::max(megabytes, 0) * 1024 * 1024;
     }
 
     void PocketFrontend::ClearCache()
     {
         LOCK(CacheMutex);
         Cache.clear();
+        CacheOrder.clear();
+        CacheSize = 0;
 
         LogPrint(BCLog::RESTFRONTEND, "Cache cleared\n");
     }
 
-    void PocketFrontend::CacheEmplace(const string& path, shared_ptr <StaticFile>& content)
+    void PocketFrontend::CacheErase(const string& path)
+    {
+        AssertLockHeld(CacheMutex);
+
+        auto entry = Cache.find(path);
+        if (entry == Cache.end())
+            return;
+
+        CacheSize -= (*entry->second)->CacheSize();
+        CacheOrder.erase(entry->second);
+        Cache.erase(entry);
+    }
+
+    void PocketFrontend::CheckChanges()
     {
+        vector<shared_ptr<StaticFile>> files;
+        {
+            LOCK(CacheMutex);
+            files.assign(CacheOrder.begin(), CacheOrder.end());
+        }
+
+        // Disk is checked without lock - requests are served from cache meanwhile
+        vector<string> changed;
+        for (const auto& file : files)
+        {
+            if (file->ModifiedTime < 0)
+                continue;
+
+            try
+            {
+                auto _path = _rootPath / file->Path;
+                if (!fs::exists(_path) || (int64_t) fs::last_write_time(_path) != file->ModifiedTime || fs::file_size(_path) != file->FileSize)
+                    changed.push_back(file->Path);
+            }
+            catch (const std::exception&)
+            {
+                changed.push_back(file->Path);
+            }
+        }
+
+        if (changed.empty())
+            return;
+
         LOCK(CacheMutex);
-        if (Cache.find(path) == Cache.end())
+        for (const auto& path : changed)
         {
-            LogPrint(BCLog::RESTFRONTEND, "File '%s' emplaced in cache\n", path);
-            Cache.emplace(path, content);
+            LogPrint(BCLog::RESTFRONTEND, "File '%s' changed on disk, removed from cache\n", path);
+            CacheErase(path);
         }
     }
 
-    tuple<bool, shared_ptr<StaticFile>> PocketFrontend::CacheGet(const string& path)
+    void PocketFrontend::CacheEmplace(const string& path, shared_ptr <StaticFile>& content)
     {
+        size_t size = content->CacheSize();
+
         LOCK(CacheMutex);
         if (Cache.find(path) != Cache.end())
+            return;
+
+        // File larger than whole cache is served but not kept
+        if (size > MaxCacheSize)
+            return;
+
+        LogPrint(BCLog::RESTFRONTEND, "File '%s' emplaced in cache\n", path);
+        CacheOrder.push_front(content);
+        Cache.emplace(path, CacheOrder.begin());
+        CacheSize += size;
+
+        while (CacheSize > MaxCacheSize && !CacheOrder.empty())
         {
-            LogPrint(BCLog::RESTFRONTEND, "File '%s' found in cache\n", path);
-            return {true, Cache.at(path)};
+            auto evicted = CacheOrder.back()->Path;
+            LogPrint(BCLog::RESTFRONTEND, "File '%s' evicted from cache\n", evicted);
+            CacheErase(evicted);
         }
+    }
+
+    tuple<bool, shared_ptr<StaticFile>> PocketFrontend::CacheGet(const string& path)
+    {
+        LOCK(CacheMutex);
+        auto entry = Cache.find(path);
+        if (entry == Cache.end())
+            return {false, nullptr};
 
-        return {false, nullptr};
+        CacheOrder.splice(CacheOrder.begin(), CacheOrder, entry->second);
+        return {true, *entry->second};
     }
 
     tuple <HTTPStatusCode, shared_ptr<StaticFile>> PocketFrontend::NotFound()
@@ -8,6 +8,7 @@
 #define SRC_POCKETFRONTEND_H
 
 #include "fs.h"
+#include "httpcompression.h"
 #include "sync.h"
 #include "util/system.h"
 #include "logging.h"
@@ -15,18 +16,63 @@
 #include "boost/algorithm/string/split.hpp"
 #include "boost/algorithm/string/classification.hpp"
 
+#include <list>
+#include <string_view>
+#include <unordered_map>
+
+static const int DEFAULT_STATIC_CACHE_SIZE = 128;
+static const int DEFAULT_STATIC_WATCH_INTERVAL = 5;
+
 namespace PocketWeb
 {
     using namespace std;
 
+    /**
+    * Read-only content of file on disk. Content is copied to memory when file is opened, so bytes
+    * under ETag and compressed variants do not change and replies referencing them can not fault
+    * when the file is truncated or rewritten in place.
+    */
+    class FileContent
+    {
+    private:
+        string m_buffer;
+
+    public:
+        explicit FileContent(string content) : m_buffer(move(content)) {}
+
+        FileContent(const FileContent&) = delete;
+        FileContent& operator=(const FileContent&) = delete;
+
+        static shared_ptr<FileContent> Open(const fs::path& path);
+
+        const char* Data() const { return m_buffer.data(); }
+        size_t Size() const { return m_buffer.size(); }
+        string_view View() const { return m_buffer; }
+    };
+
     struct StaticFile
     {
         string Path;
         string Name;
         string ContentType;
-        string Content;
+        shared_ptr<const FileContent> Content;
+        // Strong validator from content hash
+        string ETag;
+        // Compressed once on read and served while file is cached
+        map<HTTPContentEncoding, string> Encoded;
+        // State of file on disk when it was read, for change detection
+        int64_t ModifiedTime = 0;
+        uintmax_t FileSize = 0;
+
+        // Memory accounted in cache - content and compressed variants
+        size_t CacheSize() const;
     };
 
+    /**
+    * Static assets served by the static socket. Files are cached with their compressed variants,
+    * the least recently used are evicted above -staticcachesize. Cached files are checked on disk
+    * every -staticwatchinterval seconds and dropped when changed.
+    */
     class PocketFrontend
     {
     protected:
@@ -34,7 +80,11 @@ namespace PocketWeb
         boost::filesystem::path _rootPath;
 
         Mutex CacheMutex;
-        map<string, shared_ptr<StaticFile>> Cache;
+        // Recently used at front
+        list<shared_ptr<StaticFile>> CacheOrder;
+        unordered_map<string, list<shared_ptr<StaticFile>>::iterator> Cache;
+        size_t CacheSize = 0;
+        atomic<size_t> MaxCacheSize{(size_t) DEFAULT_STATIC_CACHE_SIZE * 1024 * 1024};
 
         map<string, string> MimeTypes{
             {"default", "application/octet-stream"},
@@ -48,22 +98,32 @@ namespace PocketWeb
             {"jpg",     "image/jpeg"},
         };
 
-        tuple<bool, string> ReadFileFromDisk(const string& path);
+        tuple<bool, shared_ptr<FileContent>> ReadFileFromDisk(const string& path);
 
         tuple<bool, shared_ptr<StaticFile>> ReadFile(const string& path);
 
+        void BuildVariants(StaticFile& file);
+
         string DetectContentType(string fileName);
 
         tuple <HTTPStatusCode, shared_ptr<StaticFile>> NotFound();
 
+        void CacheErase(const string& path);
+
     public:
 
         PocketFrontend() = default;
 
         void Init();
 
+        // Limit of memory for cached files in megabytes
+        void SetMaxSize(int megabytes);
+
         void ClearCache();
 
+        // Drop cached files changed or removed on disk
+        void CheckChanges();
+
         void CacheEmplace(const string& path, shared_ptr<StaticFile>& content);
 
         tuple<bool, shared_ptr<StaticFile>> CacheGet(const string& path);
@@ -127,6 +127,7 @@ static const CRPCCommand commands[] =
     {"system",         "gettime",                          &GetTime,                        {}},
     {"system",         "getcoininfo",                      &GetCoinInfo,                    {"height"}},
     {"system",         "getlateststat",                    &GetLatestStat,                  {}},
+    {"system",         "getrpcstatistic",                  &GetRpcStatistic,                {}},
     {"system",         "getposdifficulty",                 &GetPosDifficulty,               {"height"}},
     
     // Transactions
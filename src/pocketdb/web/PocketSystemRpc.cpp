@@ -5,7 +5,11 @@
 #include "pocketdb/web/PocketSystemRpc.h"
 #include "rpc/blockchain.h"
 #include "rpc/util.h"
+#include "httpserver.h"
 #include "init.h"
+#include "pocketdb/pocketnet.h"
+#include "pocketdb/services/BlockPayloadCache.h"
+#include "pocketdb/services/MempoolMirror.h"
 
 namespace PocketWeb::PocketWebRpc
 {
@@ -152,6 +156,133 @@ namespace PocketWeb::PocketWebRpc
                                 {RPCResult::Type::NUM, "http", ""},
                                 {RPCResult::Type::NUM, "https", ""},
                             }
+                        },
+                        {
+                            RPCResult::Type::OBJ, "sqlpool", "",
+                            {
+                                {RPCResult::Type::NUM, "size", ""},
+                                {RPCResult::Type::NUM, "open", ""},
+                                {RPCResult::Type::NUM, "inuse", ""},
+                                {RPCResult::Type::NUM, "acquired", ""},
+                                {RPCResult::Type::NUM, "waited", ""},
+                                {RPCResult::Type::NUM, "timeouts", ""},
+                                {RPCResult::Type::NUM, "avgwaitms", ""},
+                                {RPCResult::Type::NUM, "maxwaitms", ""},
+                                {RPCResult::Type::NUM, "stmtcached", ""},
+                                {RPCResult::Type::NUM, "stmthitrate", ""},
+                            }
+                        },
+                        {
+                            RPCResult::Type::OBJ, "registrycache", "",
+                            {
+                                {RPCResult::Type::NUM, "ids", ""},
+                                {RPCResult::Type::NUM, "strings", ""},
+                                {RPCResult::Type::NUM, "memory", ""},
+                                {RPCResult::Type::NUM, "maxmemory", ""},
+                                {RPCResult::Type::NUM, "hits", ""},
+                                {RPCResult::Type::NUM, "misses", ""},
+                                {RPCResult::Type::NUM, "hitrate", ""},
+                            }
+                        },
+                        {
+                            RPCResult::Type::OBJ, "mempoolmirror", "",
+                            {
+                                {RPCResult::Type::NUM, "depth", ""},
+                                {RPCResult::Type::NUM, "maxdepth", ""},
+                                {RPCResult::Type::NUM, "written", ""},
+                                {RPCResult::Type::NUM, "batches", ""},
+                                {RPCResult::Type::NUM, "flushes", ""},
+                                {RPCResult::Type::NUM, "errors", ""},
+                                {RPCResult::Type::NUM, "lastlatency", "Microseconds"},
+                                {RPCResult::Type::NUM, "maxlatency", "Microseconds"},
+                                {RPCResult::Type::NUM, "avglatency", "Microseconds"},
+                            }
+                        },
+                        {
+                            RPCResult::Type::OBJ, "payloadcache", "",
+                            {
+                                {RPCResult::Type::NUM, "entries", ""},
+                                {RPCResult::Type::NUM, "memory", ""},
+                                {RPCResult::Type::NUM, "maxmemory", ""},
+                                {RPCResult::Type::NUM, "stored", ""},
+                                {RPCResult::Type::NUM, "hits", ""},
+                                {RPCResult::Type::NUM, "misses", ""},
+                                {RPCResult::Type::NUM, "hitrate", ""},
+                            }
+                        },
+                        {
+                            RPCResult::Type::OBJ, "websocket", "",
+                            {
+                                {RPCResult::Type::NUM, "connections", ""},
+                                {RPCResult::Type::NUM, "addresses", ""},
+                                {RPCResult::Type::NUM, "fanouts", "Notified blocks"},
+                                {RPCResult::Type::NUM, "lastrecipients", ""},
+                                {RPCResult::Type::NUM, "lastmessages", ""},
+                                {RPCResult::Type::NUM, "lastbytes", ""},
+                                {RPCResult::Type::NUM, "lastlatency", "Microseconds"},
+                                {RPCResult::Type::NUM, "maxlatency", "Microseconds"},
+                                {RPCResult::Type::NUM, "avglatency", "Microseconds"},
+                            }
+                        },
+                        {
+                            RPCResult::Type::OBJ, "web", "",
+                            {
+                                {RPCResult::Type::NUM, "height", "Last height processed to web database"},
+                                {RPCResult::Type::NUM, "chainheight", ""},
+                                {RPCResult::Type::NUM, "lag", "Heights behind the chain"},
+                                {RPCResult::Type::BOOL, "catchup", "Heights are processed by ranges"},
+                                {RPCResult::Type::NUM, "depth", "Read ranges waiting for write"},
+                                {RPCResult::Type::NUM, "batches", ""},
+                                {RPCResult::Type::NUM, "resets", "Read ranges discarded by reorganizations"},
+                                {RPCResult::Type::NUM, "lastheights", ""},
+                                {RPCResult::Type::NUM, "lastreadlatency", "Microseconds"},
+                                {RPCResult::Type::NUM, "lastwritelatency", "Microseconds"},
+                                {RPCResult::Type::NUM, "maxwritelatency", "Microseconds"},
+                            }
+                        },
+                        {
+                            RPCResult::Type::OBJ_DYN, "wal", "WAL checkpoints by database",
+                            {
+                                {
+                                    RPCResult::Type::OBJ, "main|web", "",
+                                    {
+                                        {RPCResult::Type::NUM, "walsize", "Bytes"},
+                                        {RPCResult::Type::NUM, "frames", "Frames in WAL after last commit or checkpoint"},
+                                        {RPCResult::Type::NUM, "checkpointed", ""},
+                                        {RPCResult::Type::NUM, "passive", ""},
+                                        {RPCResult::Type::NUM, "restart", ""},
+                                        {RPCResult::Type::NUM, "truncate", ""},
+                                        {RPCResult::Type::NUM, "busy", "Checkpoints not completed because of locks"},
+                                        {RPCResult::Type::NUM, "lastduration", "Microseconds"},
+                                        {RPCResult::Type::NUM, "maxduration", "Microseconds"},
+                                    }
+                                }
+                            }
+                        },
+                        {
+                            RPCResult::Type::OBJ, "rpc", "RPC requests of statistic window",
+                            {
+                                {RPCResult::Type::NUM, "requests", ""},
+                                {RPCResult::Type::NUM, "failed", ""},
+                                {RPCResult::Type::OBJ, "queue", "Wait before execution, microseconds", {{RPCResult::Type::ELISION, "", "count, avg, p50, p95, p99, max"}}},
+                                {RPCResult::Type::OBJ, "exec", "Execution, microseconds", {{RPCResult::Type::ELISION, "", "count, avg, p50, p95, p99, max"}}},
+                                {RPCResult::Type::NUM, "window", "Seconds"},
+                            }
+                        },
+                        {
+                            RPCResult::Type::OBJ, "http", "Work queues of HTTP sockets",
+                            {
+                                {RPCResult::Type::OBJ_DYN, "queues", "Lanes of queue by name: main, public, post, rest, static",
+                                    {{RPCResult::Type::ELISION, "", "fast, normal, heavy lanes with depth, cost (microseconds) and shed"}}},
+                                {RPCResult::Type::OBJ, "clients", "",
+                                    {
+                                        {RPCResult::Type::NUM, "active", "Addresses with requests in progress"},
+                                        {RPCResult::Type::NUM, "limit", "Concurrent requests of address"},
+                                        {RPCResult::Type::NUM, "rejected", ""},
+                                    }
+                                },
+                                {RPCResult::Type::NUM, "deadline", "Predicted wait rejected, milliseconds"},
+                            }
                         }
                     },
                 },
@@ -216,6 +347,34 @@ namespace PocketWeb::PocketWebRpc
         ports.pushKV("https", staticPort);
         entry.pushKV("ports", ports);
 
+        // Read-only connections pool state
+        entry.pushKV("sqlpool", PocketDb::SQLiteConnectionPoolInst.Statistic());
+
+        // Shared Registry strings and ids cache state
+        entry.pushKV("registrycache", PocketDb::RegistryCacheInst.Statistic());
+
+        // Write-behind queue of Mempool table
+        entry.pushKV("mempoolmirror", PocketServices::MempoolMirrorInst.Statistic());
+
+        // Serialized block payloads for peers
+        entry.pushKV("payloadcache", PocketServices::BlockPayloadCacheInst.Statistic());
+
+        // Websocket subscribers and block notifications fan-out
+        if (WSConnections)
+            entry.pushKV("websocket", WSConnections->Statistic());
+
+        // Web database processing lag
+        entry.pushKV("web", PocketServices::WebPostProcessorInst.Statistic());
+
+        // Background WAL checkpoints
+        entry.pushKV("wal", PocketServices::WalControllerInst.Statistic());
+
+        // RPC latency percentiles
+        entry.pushKV("rpc", gStatEngineInstance.Statistic());
+
+        // HTTP work queue lanes
+        entry.pushKV("http", HTTPQueueStatistic());
+
         return entry;
     },
         };
@@ -300,6 +459,48 @@ namespace PocketWeb::PocketWebRpc
         };
     }
     
+    RPCHelpMan GetRpcStatistic()
+    {
+        return RPCHelpMan{"getrpcstatistic",
+                "\nReturns latency percentiles of RPC methods and SQL functions for statistic window\n",
+                { },
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::NUM, "window", "Seconds"},
+                        {
+                            RPCResult::Type::OBJ_DYN, "methods", "",
+                            {
+                                {
+                                    RPCResult::Type::OBJ, "method", "",
+                                    {
+                                        {RPCResult::Type::NUM, "requests", ""},
+                                        {RPCResult::Type::NUM, "failed", ""},
+                                        {RPCResult::Type::OBJ, "queue", "Wait before execution, microseconds", {{RPCResult::Type::ELISION, "", "count, avg, p50, p95, p99, max"}}},
+                                        {RPCResult::Type::OBJ, "exec", "Execution, microseconds", {{RPCResult::Type::ELISION, "", "count, avg, p50, p95, p99, max"}}},
+                                    }
+                                }
+                            }
+                        },
+                        {
+                            RPCResult::Type::OBJ_DYN, "sql", "Collected with -collectstat or -debug=statsqlbench",
+                            {
+                                {RPCResult::Type::OBJ, "func", "Microseconds", {{RPCResult::Type::ELISION, "", "count, avg, p50, p95, p99, max"}}},
+                            }
+                        },
+                    },
+                },
+                RPCExamples{
+                    HelpExampleCli("getrpcstatistic", "") +
+                    HelpExampleRpc("getrpcstatistic", "")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+        {
+            return gStatEngineInstance.RequestStatistic();
+        },
+        };
+    }
+
     RPCHelpMan GetPosDifficulty()
     {
         return RPCHelpMan{
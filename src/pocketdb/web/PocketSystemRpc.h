@@ -17,6 +17,7 @@ namespace PocketWeb::PocketWebRpc
     RPCHelpMan GetPeerInfo();
     RPCHelpMan GetNodeInfo();
     RPCHelpMan GetLatestStat();
+    RPCHelpMan GetRpcStatistic();
     RPCHelpMan GetPosDifficulty();
 }
 
@@ -22,6 +22,12 @@
 #include "util/system.h"
 #include "validationinterface.h"
 
+#include <crypto/common.h>
+#include <hash.h>
+
+#include <atomic>
+#include <thread>
+
 double GetPosDifficulty(const CBlockIndex *blockindex)
 {
     // Floating point number that is a multiple of the minimum difficulty,
@@ -366,6 +372,170 @@ bool CheckStakeKernelHash(CBlockIndex *pindexPrev, unsigned int nBits, CBlockInd
     return true;
 }
 
+bool BuildStakeKernelCandidate(const COutPoint& prevout, uint32_t nBlockFromTime, const StakeKernelHashTx& txPrev,
+    unsigned int nBits, StakeKernelCandidate& candidate)
+{
+    bool fNegative, fOverflow;
+    arith_uint256 bnTarget;
+    bnTarget.SetCompact(nBits, &fNegative, &fOverflow);
+    if (fNegative || fOverflow)
+        return false;
+
+    candidate.Prevout = prevout;
+    candidate.BlockFromTime = nBlockFromTime;
+    candidate.TxTime = (uint32_t) txPrev.TxTime;
+    candidate.Target = bnTarget * arith_uint256(std::min(txPrev.OutValue, Params().GetConsensus().nStakeMaximumThreshold));
+    return true;
+}
+
+// Checks candidates [nBegin, nEnd) and stops at first hit or when earlier hit found by other thread
+static void SearchStakeKernelRange(const std::vector<StakeKernelCandidate>& candidates, uint64_t nStakeModifier,
+    uint32_t nTimeTx, int64_t nSearchInterval, size_t nBegin, size_t nEnd, std::atomic<size_t>& nBest, StakeKernelHit& hit)
+{
+    const uint32_t nStakeMinAge = Params().GetConsensus().nStakeMinAge;
+
+    // Serialized as modifier, block from time, tx time, prevout hash, prevout n, time - only the last field changes
+    unsigned char source[56];
+    WriteLE64(source, nStakeModifier);
+
+    for (size_t i = nBegin; i < nEnd && i < nBest.load(std::memory_order_relaxed); i++)
+    {
+        const auto& candidate = candidates[i];
+        WriteLE32(source + 8, candidate.BlockFromTime);
+        WriteLE32(source + 12, candidate.TxTime);
+        memcpy(source + 16, candidate.Prevout.hash.begin(), 32);
+        WriteLE32(source + 48, candidate.Prevout.n);
+
+        for (int64_t n = 0; n < nSearchInterval; n++)
+        {
+            uint32_t nTime = nTimeTx - (uint32_t) n;
+            if ((nTime & STAKE_TIMESTAMP_MASK) != 0 || nTime < candidate.TxTime || candidate.BlockFromTime + nStakeMinAge > nTime)
+                continue;
+
+            WriteLE32(source + 52, nTime);
+
+            uint256 hash;
+            CHash256().Write(source).Finalize(hash);
+            if (UintToArith256(hash) > candidate.Target)
+                continue;
+
+            hit = {i, nTime};
+
+            size_t nPrev = nBest.load();
+            while (i < nPrev && !nBest.compare_exchange_weak(nPrev, i));
+            return;
+        }
+    }
+}
+
+bool SearchStakeKernel(const std::vector<StakeKernelCandidate>& candidates, uint64_t nStakeModifier, uint32_t nTimeTx,
+    int64_t nSearchInterval, int nThreads, size_t nFrom, StakeKernelHit& hit)
+{
+    if (nFrom >= candidates.size())
+        return false;
+
+    size_t nCount = candidates.size() - nFrom;
+    size_t nWorkers = std::max(1, std::min(nThreads, (int) (nCount / MIN_STAKE_KERNEL_CANDIDATES_PER_THREAD)));
+
+    std::atomic<size_t> nBest{candidates.size()};
+    std::vector<StakeKernelHit> hits(nWorkers);
+
+    if (nWorkers == 1)
+    {
+        SearchStakeKernelRange(candidates, nStakeModifier, nTimeTx, nSearchInterval, nFrom, candidates.size(), nBest, hits[0]);
+    }
+    else
+    {
+        // Contiguous ranges keep order of candidates - the lowest hit index wins
+        std::vector<std::thread> threads;
+        size_t nChunk = (nCount + nWorkers - 1) / nWorkers;
+        for (size_t w = 0; w < nWorkers; w++)
+        {
+            size_t nBegin = nFrom + w * nChunk;
+            size_t nEnd = std::min(nBegin + nChunk, candidates.size());
+            threads.emplace_back(SearchStakeKernelRange, std::cref(candidates), nStakeModifier, nTimeTx, nSearchInterval,
+                nBegin, nEnd, std::ref(nBest), std::ref(hits[w]));
+        }
+
+        for (auto& thread : threads)
+            thread.join();
+    }
+
+    size_t nIndex = nBest.load();
+    if (nIndex >= candidates.size())
+        return false;
+
+    hit = hits[(nIndex - nFrom) / ((nCount + nWorkers - 1) / nWorkers)];
+    return true;
+}
+
+void StakeKernelTable::Load(const CBlockIndex* pindexPrev, unsigned int nBits, const std::vector<COutPoint>& prevouts)
+{
+    int64_t nTime1 = GetTimeMicros();
+
+    std::vector<std::string> hashes;
+    hashes.reserve(prevouts.size());
+    for (const auto& prevout : prevouts)
+        hashes.push_back(prevout.hash.GetHex());
+
+    std::sort(hashes.begin(), hashes.end());
+    hashes.erase(std::unique(hashes.begin(), hashes.end()), hashes.end());
+
+    auto txs = TransRepoInst.GetStakeKernelHashTxs(hashes);
+
+    m_candidates.clear();
+    m_positions.clear();
+    m_candidates.reserve(prevouts.size());
+    m_positions.reserve(prevouts.size());
+
+    {
+        LOCK(cs_main);
+
+        for (size_t i = 0; i < prevouts.size(); i++)
+        {
+            auto it = txs.find({prevouts[i].hash.GetHex(), (int) prevouts[i].n});
+            if (it == txs.end() || it->second.BlockHash.empty())
+                continue;
+
+            auto blockIt = g_chainman.BlockIndex().find(uint256S(it->second.BlockHash));
+            if (blockIt == g_chainman.BlockIndex().end())
+                continue;
+
+            StakeKernelCandidate candidate;
+            if (!BuildStakeKernelCandidate(prevouts[i], blockIt->second->GetBlockTime(), it->second, nBits, candidate))
+                continue;
+
+            m_candidates.push_back(candidate);
+            m_positions.push_back(i);
+        }
+    }
+
+    m_tip = pindexPrev->GetBlockHash();
+    m_bits = nBits;
+    m_prevouts = prevouts;
+
+    LogPrint(BCLog::STAKEMODIF, "StakeKernelTable : loaded %d of %d candidates for %s in %.2fms\n",
+        m_candidates.size(), prevouts.size(), m_tip.GetHex(), 0.001 * (double) (GetTimeMicros() - nTime1));
+}
+
+bool StakeKernelTable::Search(const CBlockIndex* pindexPrev, unsigned int nBits, const std::vector<COutPoint>& prevouts,
+    uint32_t nTimeTx, int64_t nSearchInterval, int nThreads, size_t nFrom, StakeKernelHit& hit)
+{
+    LOCK(m_mutex);
+
+    if (m_tip != pindexPrev->GetBlockHash() || m_bits != nBits || m_prevouts != prevouts)
+        Load(pindexPrev, nBits, prevouts);
+
+    // First candidate at or after requested position
+    size_t nCandidate = std::lower_bound(m_positions.begin(), m_positions.end(), nFrom) - m_positions.begin();
+
+    if (!SearchStakeKernel(m_candidates, pindexPrev->nStakeModifier, nTimeTx, nSearchInterval, nThreads, nCandidate, hit))
+        return false;
+
+    hit.Index = m_positions[hit.Index];
+    return true;
+}
+
 // Check whether the coinstake timestamp meets protocol
 bool CheckCoinStakeTimestamp(int nHeight, int64_t nTimeBlock, int64_t nTimeTx)
 {
@@ -22,6 +22,10 @@ static const int STAKE_TIMESTAMP_MASK = 15;
 
 static const int MODIFIER_INTERVAL_RATIO = 3;
 
+// Threads of kernel search, used only for large candidate tables
+static const int DEFAULT_STAKING_KERNEL_THREADS = 1;
+static const size_t MIN_STAKE_KERNEL_CANDIDATES_PER_THREAD = 1000;
+
 #ifdef ENABLE_WALLET
 class CWallet;
 #endif
@@ -67,6 +71,52 @@ bool CheckProofOfStake(CBlockIndex* pindexPrev, CTransactionRef const & tx, unsi
 
 bool CheckCoinStakeTimestamp(int nHeight, int64_t nTimeBlock, int64_t nTimeTx);
 
+// Kernel data of one staking output, hashing does not need database and block index
+struct StakeKernelCandidate
+{
+    COutPoint Prevout;
+    uint32_t BlockFromTime;
+    uint32_t TxTime;
+    // Base target weighted by output value
+    arith_uint256 Target;
+};
+
+struct StakeKernelHit
+{
+    size_t Index;
+    uint32_t Time;
+};
+
+bool BuildStakeKernelCandidate(const COutPoint& prevout, uint32_t nBlockFromTime, const StakeKernelHashTx& txPrev, unsigned int nBits, StakeKernelCandidate& candidate);
+
+// Same hash as CheckStakeKernelHash for timestamps nTimeTx, nTimeTx - 1, ... nTimeTx - nSearchInterval + 1.
+// Returns the first candidate from index nFrom that meets its target, earlier timestamps of it are not checked.
+bool SearchStakeKernel(const std::vector<StakeKernelCandidate>& candidates, uint64_t nStakeModifier, uint32_t nTimeTx,
+    int64_t nSearchInterval, int nThreads, size_t nFrom, StakeKernelHit& hit);
+
+/**
+* Kernel candidates of wallet coins loaded by one query and reused until tip or coins change,
+* instead of reading the previous transaction and block index for every coin and timestamp.
+*/
+class StakeKernelTable
+{
+public:
+    // Hit index is position in prevouts
+    bool Search(const CBlockIndex* pindexPrev, unsigned int nBits, const std::vector<COutPoint>& prevouts, uint32_t nTimeTx,
+        int64_t nSearchInterval, int nThreads, size_t nFrom, StakeKernelHit& hit);
+
+private:
+    Mutex m_mutex;
+    uint256 m_tip GUARDED_BY(m_mutex);
+    unsigned int m_bits GUARDED_BY(m_mutex) = 0;
+    std::vector<COutPoint> m_prevouts GUARDED_BY(m_mutex);
+    std::vector<StakeKernelCandidate> m_candidates GUARDED_BY(m_mutex);
+    // Position in prevouts of each candidate, ascending
+    std::vector<size_t> m_positions GUARDED_BY(m_mutex);
+
+    void Load(const CBlockIndex* pindexPrev, unsigned int nBits, const std::vector<COutPoint>& prevouts) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+};
+
 bool ComputeNextStakeModifier(const CBlockIndex* pindexPrev, uint64_t& nStakeModifier, bool& fGeneratedStakeModifier);
 
 bool GetRatingRewards(CAmount nCredit, std::vector<CTxOut>& results, CAmount& totalAmount, const CBlockIndex* pindex, CDataStream& hashProofOfStakeSource, std::vector<opcodetype>& winner_types, const CBlock* block = nullptr);
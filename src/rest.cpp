@@ -6,6 +6,7 @@
 #include <chain.h>
 #include <chainparams.h>
 #include <core_io.h>
+#include <httpcompression.h>
 #include <httpserver.h>
 #include <index/txindex.h>
 #include <node/context.h>
@@ -23,6 +24,7 @@
 #include <validation.h>
 #include <version.h>
 #include <pos.h>
+#include <init.h>
 
 #include <boost/algorithm/string.hpp>
 #include <univalue.h>
@@ -822,6 +824,17 @@ static bool rest_emission(const util::Ref& context, HTTPRequest* req, const std:
     return true;
 }
 
+// Prometheus scrape target
+static bool rest_metrics(const util::Ref& context, HTTPRequest* req, const std::string& strURIPart)
+{
+    if (!CheckWarmup(req))
+        return false;
+
+    req->WriteHeader("Content-Type", "text/plain; version=0.0.4");
+    req->WriteReply(HTTP_OK, gStatEngineInstance.PrometheusText() + HTTPQueuePrometheusText());
+    return true;
+}
+
 static bool get_static_status(HTTPRequest* req, const std::string& strURIPart)
 {
     if (!CheckWarmup(req))
@@ -905,8 +918,44 @@ static bool get_static_web(const util::Ref& context, HTTPRequest* req, const std
 
     if (auto[code, file] = PocketWeb::PocketFrontendInst.GetFile(strURIPart); code == HTTP_OK)
     {
+        // Serve precompressed variant instead of compressing on every request
+        auto encoded = file->Encoded.end();
+        if (!file->Encoded.empty())
+        {
+            req->WriteHeader("Vary", "Accept-Encoding");
+
+            auto[hasAcceptEncoding, acceptEncoding] = req->GetHeader("Accept-Encoding");
+            encoded = file->Encoded.find(SelectContentEncoding(hasAcceptEncoding ? acceptEncoding : ""));
+        }
+
+        // Each encoded variant is a different representation with its own strong validator
+        if (!file->ETag.empty())
+        {
+            auto etag = file->ETag;
+            if (encoded != file->Encoded.end())
+                etag.insert(etag.size() - 1, "-" + ContentEncodingName(encoded->first));
+
+            req->WriteHeader("ETag", etag);
+
+            auto[hasIfNoneMatch, ifNoneMatch] = req->GetHeader("If-None-Match");
+            if (hasIfNoneMatch && ifNoneMatch.find(etag) != std::string::npos)
+            {
+                req->WriteReply(HTTP_NOT_MODIFIED);
+                return true;
+            }
+        }
+
         req->WriteHeader("Content-Type", file->ContentType);
-        req->WriteReply(code, file->Content);
+
+        if (encoded != file->Encoded.end())
+        {
+            req->WriteHeader("Content-Encoding", ContentEncodingName(encoded->first));
+            req->WriteReply(code, file, encoded->second.data(), encoded->second.size());
+            return true;
+        }
+
+        // Cached file stays alive until sent even if evicted meanwhile
+        req->WriteReply(code, file, file->Content->Data(), file->Content->Size());
         return true;
     }
     else
@@ -1007,6 +1056,7 @@ static const struct
     {"/rest/blockhash",          rest_blockhash},
     {"/rest/emission",           rest_emission},
     {"/rest/topaddresses",       rest_topaddresses},
+    {"/rest/metrics",            rest_metrics},
 };
 
 void StartREST(const util::Ref& context)
@@ -46,6 +46,7 @@
 #include <mutex>
 
 #include "pocketdb/services/ChainPostProcessing.h"
+#include "pocketdb/services/MempoolMirror.h"
 
 struct CUpdatedBlock
 {
@@ -1521,6 +1522,7 @@ static RPCHelpMan getmempoolinfo()
         throw JSONRPCError(RPC_INTERNAL_ERROR, "Null mempool");
     }
     UniValue result = mempoolInfoToJSON(*node.mempool);
+    PocketServices::MempoolMirrorInst.Flush();
     int sqliteMempoolCount = PocketDb::TransRepoInst.MempoolCount();
 
     UniValue size(UniValue::VOBJ);
@@ -4,6 +4,7 @@
 
 #include <rpc/cache.h>
 #include <rpc/server.h>
+#include <crypto/sha256.h>
 
 static const unsigned int MAX_CACHE_SIZE_MB = 64;
 
@@ -32,12 +33,13 @@ std::map<std::string, int> RPCCacheInfoGenerator::Generate() const
     return result;
 }
 
-RPCCacheEntry::RPCCacheEntry(UniValue data, int validUntill)
+RPCCacheEntry::RPCCacheEntry(std::shared_ptr<const std::string> data, int validUntill, size_t keySize)
     : m_data(std::move(data)),
       m_validUntill(std::move(validUntill))
 {
+    m_size = keySize + sizeof(RPCCacheEntry) + m_data->size();
 }
-const UniValue& RPCCacheEntry::GetData() const
+const std::shared_ptr<const std::string>& RPCCacheEntry::GetData() const
 {
     return m_data;
 }
@@ -47,109 +49,216 @@ const int& RPCCacheEntry::GetValidUntill() const
 }
 const size_t RPCCacheEntry::Size() const
 {
-    return m_data.write().size();
+    return m_size;
 }
 
 RPCCache::RPCCache() 
 {
-    m_maxCacheSize = gArgs.GetArg("-rpccachesize", MAX_CACHE_SIZE_MB) * 1024 * 1024;
-    m_cacheSize = 0;
+    m_maxShardSize = gArgs.GetArg("-rpccachesize", MAX_CACHE_SIZE_MB) * 1024 * 1024 / RPC_CACHE_SHARDS;
 }
 
-std::string RPCCache::MakeHashKey(const JSONRPCRequest& req)
+// Serialize value with object keys sorted recursively
+static void WriteCanonical(const UniValue& value, std::string& out)
+{
+    if (value.isObject())
+    {
+        std::vector<size_t> order(value.size());
+        for (size_t i = 0; i < order.size(); i++)
+            order[i] = i;
+
+        const auto& keys = value.getKeys();
+        std::sort(order.begin(), order.end(), [&keys](size_t a, size_t b) { return keys[a] < keys[b]; });
+
+        out += '{';
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            if (i > 0) out += ',';
+            out += UniValue(keys[order[i]]).write();
+            out += ':';
+            WriteCanonical(value[order[i]], out);
+        }
+        out += '}';
+    }
+    else if (value.isArray())
+    {
+        out += '[';
+        for (size_t i = 0; i < value.size(); i++)
+        {
+            if (i > 0) out += ',';
+            WriteCanonical(value[i], out);
+        }
+        out += ']';
+    }
+    else
+    {
+        out += value.write();
+    }
+}
+
+uint256 RPCCache::MakeHashKey(const JSONRPCRequest& req)
 {
     std::string hashKey = req.strMethod;
+    hashKey += '\0';
+    WriteCanonical(req.params, hashKey);
 
-    hashKey += req.params.write();
+    uint256 key;
+    CSHA256().Write((const unsigned char*) hashKey.data(), hashKey.size()).Finalize(key.begin());
+    return key;
+}
 
-    return hashKey;
+RPCCacheShard& RPCCache::Shard(const uint256& key)
+{
+    // Bucket hash uses the first bytes of key, shard is selected by the last one
+    return m_shards[*(key.end() - 1) % RPC_CACHE_SHARDS];
 }
 
 void RPCCache::Clear()
 {
-    LOCK(CacheMutex);
-    m_cache.clear();
-    m_cacheSize = 0;
+    for (auto& shard : m_shards)
+    {
+        LOCK(shard.CacheMutex);
+        shard.m_cache.clear();
+        shard.m_cacheSize = 0;
+    }
 
     LogPrint(BCLog::RPC, "RPC cache cleared.\n");
 }
 
-void RPCCache::ClearOverdue(int height)
+void RPCCache::ClearOverdue(RPCCacheShard& shard, int height)
 {
-    for (auto itr = m_cache.begin(); itr != m_cache.end();) {
-        if(itr->second.GetValidUntill() <= height) {
-            m_cacheSize -= (itr->first.size() + itr->second.Size()); // Decreasing cache size 
-            itr = m_cache.erase(itr);
+    // Entries are checked once per shard for every new height
+    if (shard.m_purgeHeight == height)
+        return;
+
+    shard.m_purgeHeight = height;
+
+    for (auto itr = shard.m_cache.begin(); itr != shard.m_cache.end();) {
+        if (itr->second.GetValidUntill() + RPC_CACHE_STALE_BLOCKS <= height) {
+            shard.m_cacheSize -= itr->second.Size(); // Decreasing cache size
+            itr = shard.m_cache.erase(itr);
         } else {
             itr++;
         }
     }
 }
 
-void RPCCache::Put(const std::string& path, const UniValue& content, const int& lifeTime)
+RPCCacheLookup RPCCache::Lookup(const JSONRPCRequest& req)
 {
-    auto currentHeight = ChainActiveSafeHeight();
+    RPCCacheLookup lookup;
 
-    auto validUntill = currentHeight + lifeTime;
+    // Return empty lookup if method not supported for caching.
+    auto group = m_supportedMethods.find(req.strMethod);
+    if (group == m_supportedMethods.end())
+        return lookup;
 
-    LOCK(CacheMutex);
+    lookup.fill = true;
+    lookup.lifeTime = group->second;
+    lookup.key = MakeHashKey(req);
 
-    int size = path.size() + content.write().size();
+    auto height = ChainActiveSafeHeight();
+    auto& shard = Shard(lookup.key);
 
-    ClearOverdue(currentHeight);
+    LOCK(shard.CacheMutex);
 
-    if (m_maxCacheSize < size + m_cacheSize) {
-        LogPrint(BCLog::RPC, "RPC cache over size limit: current = %d, max = %d\n", m_cacheSize, m_maxCacheSize);
-        return;
+    auto entry = shard.m_cache.find(lookup.key);
+    if (entry == shard.m_cache.end())
+        return lookup;
+
+    // Actual entry
+    if (entry->second.GetValidUntill() > height) {
+        LogPrint(BCLog::RPC, "RPC Cache get found %s in cache\n", req.strMethod);
+        lookup.fill = false;
+        lookup.data = entry->second.GetData();
+        lookup.validUntill = entry->second.GetValidUntill();
+        return lookup;
     }
 
-    if (auto entry = m_cache.find(path); entry != m_cache.end()) {
-        LogPrint(BCLog::RPC, "RPC cache put update '%s'\n", path);
-        // Adjust cache size, remove old element size, add new element size
-        m_cacheSize -= entry->second.Size();
-        m_cacheSize += content.write().size();
-    } else {
-        LogPrint(BCLog::RPC, "RPC cache put '%s', size %d\n", path, size);
-        m_cacheSize += size;
+    // Entry from previous height - serve it until single request recomputes a new one
+    if (entry->second.GetValidUntill() + RPC_CACHE_STALE_BLOCKS > height) {
+        if (entry->second.refreshing) {
+            lookup.fill = false;
+            lookup.data = entry->second.GetData();
+            lookup.validUntill = entry->second.GetValidUntill();
+            return lookup;
+        }
+
+        entry->second.refreshing = true;
+        return lookup;
     }
 
-    m_cache.insert_or_assign(path, RPCCacheEntry(content, validUntill));
+    shard.m_cacheSize -= entry->second.Size();
+    shard.m_cache.erase(entry);
+    return lookup;
 }
 
-UniValue RPCCache::Get(const std::string& path)
+int RPCCache::Put(const RPCCacheLookup& lookup, std::shared_ptr<const std::string> content)
 {
-    LOCK(CacheMutex);
+    if (!lookup.fill)
+        return 0;
+
+    auto currentHeight = ChainActiveSafeHeight();
+    auto validUntill = currentHeight + lookup.lifeTime;
+    RPCCacheEntry newEntry(std::move(content), validUntill, lookup.key.size());
+
+    auto& shard = Shard(lookup.key);
+    LOCK(shard.CacheMutex);
 
-    ClearOverdue(ChainActiveSafeHeight());
+    ClearOverdue(shard, currentHeight);
+
+    auto entry = shard.m_cache.find(lookup.key);
+    int64_t oldSize = (entry != shard.m_cache.end() ? entry->second.Size() : 0);
+
+    if (m_maxShardSize < shard.m_cacheSize - oldSize + (int64_t) newEntry.Size()) {
+        LogPrint(BCLog::RPC, "RPC cache over size limit: current = %d, max = %d\n", shard.m_cacheSize, m_maxShardSize);
+
+        // Do not keep stale entry that can not be refreshed
+        if (entry != shard.m_cache.end()) {
+            shard.m_cacheSize -= oldSize;
+            shard.m_cache.erase(entry);
+        }
 
-    if (auto entry = m_cache.find(path); entry != m_cache.end()) {
-        LogPrint(BCLog::RPC, "RPC Cache get found %s in cache\n", path);
-        return entry->second.GetData();
+        return validUntill;
     }
 
-    // Return empty UniValue if nothing found in cache.
-    return UniValue();
+    shard.m_cacheSize += newEntry.Size() - oldSize;
+    shard.m_cache.insert_or_assign(lookup.key, std::move(newEntry));
+    return validUntill;
 }
 
-UniValue RPCCache::GetRpcCache(const JSONRPCRequest& req)
+std::string RPCCache::ETag(const uint256& key, int validUntill, const UniValue& id)
 {
-    // Return empty UniValue if method not supported for caching.
-    if (m_supportedMethods.find(req.strMethod) == m_supportedMethods.end())
-        return UniValue();
-
-    return Get(MakeHashKey(req));
+    // Reply envelope carries request id, so it is a part of the validator
+    uint256 tag;
+    std::string strId = id.write();
+    CSHA256().Write(key.begin(), key.size()).Write((const unsigned char*) strId.data(), strId.size()).Finalize(tag.begin());
+    return strprintf("W/\"%s-%d\"", tag.GetHex().substr(0, 16), validUntill);
 }
 
-void RPCCache::PutRpcCache(const JSONRPCRequest& req, const UniValue& content)
+void RPCCache::Abort(const RPCCacheLookup& lookup)
 {
-    if (auto group = m_supportedMethods.find(req.strMethod); group != m_supportedMethods.end()) {
-        Put(MakeHashKey(req), content, group->second);
-    }
+    if (!lookup.fill)
+        return;
+
+    auto& shard = Shard(lookup.key);
+    LOCK(shard.CacheMutex);
+
+    // Allow next request to recompute entry
+    if (auto entry = shard.m_cache.find(lookup.key); entry != shard.m_cache.end())
+        entry->second.refreshing = false;
 }
 
 std::tuple<int64_t, int64_t> RPCCache::Statistic()
 {
-    LOCK(CacheMutex);
+    int64_t count = 0;
+    int64_t size = 0;
+
+    for (auto& shard : m_shards)
+    {
+        LOCK(shard.CacheMutex);
+        count += shard.m_cache.size();
+        size += shard.m_cacheSize;
+    }
+
     // Return number of elements in cache and size of cache in bytes
-    return { (int64_t) m_cache.size(), (int64_t) m_cacheSize };
-}
\ No newline at end of file
+    return { count, size };
+}
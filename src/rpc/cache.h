@@ -8,6 +8,12 @@
 #include <sync.h>
 #include <logging.h>
 #include <validation.h>
+#include <uint256.h>
+#include <crypto/common.h>
+
+#include <array>
+#include <memory>
+#include <unordered_map>
 
 class JSONRPCRequest;
 
@@ -28,25 +34,60 @@ private:
     std::vector<RPCCacheInfoGroup> m_groups;
 };
 
+/** Number of independently locked cache shards */
+static const int RPC_CACHE_SHARDS = 16;
+/** Number of blocks an expired entry is still served while it is recomputed */
+static const int RPC_CACHE_STALE_BLOCKS = 1;
+
+struct RPCCacheKeyHasher
+{
+    size_t operator()(const uint256& key) const { return ReadLE64(key.begin()); }
+};
+
 class RPCCacheEntry
 {
 public:
-    RPCCacheEntry(UniValue data, int validUntill);
-    const UniValue& GetData() const;
+    RPCCacheEntry(std::shared_ptr<const std::string> data, int validUntill, size_t keySize);
+    const std::shared_ptr<const std::string>& GetData() const;
     const int& GetValidUntill() const;
+    // Size is calculated once on insert
     const size_t Size() const;
+
+    // Set while a single request recomputes expired entry
+    bool refreshing = false;
 private:
+    std::shared_ptr<const std::string> m_data;
     int m_validUntill;
-    UniValue m_data;
+    size_t m_size;
+};
+
+/** Result of cache lookup. If `data` is empty caller should execute method and
+ * call RPCCache::Put (or RPCCache::Abort on failure) when `fill` is set. */
+struct RPCCacheLookup
+{
+    bool fill = false;
+    uint256 key;
+    int lifeTime = 0;
+    std::shared_ptr<const std::string> data;
+    // Height the found entry is valid until
+    int validUntill = 0;
+};
+
+class RPCCacheShard
+{
+public:
+    Mutex CacheMutex;
+    std::unordered_map<uint256, RPCCacheEntry, RPCCacheKeyHasher> m_cache GUARDED_BY(CacheMutex);
+    int64_t m_cacheSize GUARDED_BY(CacheMutex) = 0;
+    int m_purgeHeight GUARDED_BY(CacheMutex) = -1;
 };
 
 class RPCCache
 {
 private:
-    Mutex CacheMutex;
-    std::map<std::string, RPCCacheEntry> m_cache;
-    int m_cacheSize;
-    int m_maxCacheSize;
+    std::array<RPCCacheShard, RPC_CACHE_SHARDS> m_shards;
+    int64_t m_maxShardSize;
+
     // <methodName, lifeTime>
     std::map<std::string, int> m_supportedMethods = {
         { "getlastcomments", 1 },
@@ -87,26 +128,30 @@ private:
         { "getrecommendedaccountbyaddress", 60 },
         { "getaccountearning", 1 },
     };
-    
-    /* Make a key for the unordered hash map by concatenating together the methodname and
-     * params.  TODO: We will likely need to improve this methodology in the future in
-     * case parameters are delivered in out of order by the front-end clients.
+
+    /* Make a hash key from method name and canonical params representation,
+     * so named params given in a different order hit the same entry.
      */
-    std::string MakeHashKey(const JSONRPCRequest& req);
-    void ClearOverdue(int height);
+    uint256 MakeHashKey(const JSONRPCRequest& req);
+    RPCCacheShard& Shard(const uint256& key);
+    void ClearOverdue(RPCCacheShard& shard, int height) EXCLUSIVE_LOCKS_REQUIRED(shard.CacheMutex);
 
 public:
     RPCCache();
 
     void Clear();
 
-    void Put(const std::string& path, const UniValue& content, const int& lifeTime);
+    // Find serialized result for request. Expired entries are served
+    // to all callers except one which is elected to recompute it.
+    RPCCacheLookup Lookup(const JSONRPCRequest& req);
 
-    UniValue Get(const std::string& path);
+    // Returns height the content is valid until, 0 if method is not cached
+    int Put(const RPCCacheLookup& lookup, std::shared_ptr<const std::string> content);
 
-    UniValue GetRpcCache(const JSONRPCRequest& req);
+    // Weak validator of reply with cached result - same key, validity height and request id give the same content
+    static std::string ETag(const uint256& key, int validUntill, const UniValue& id);
 
-    void PutRpcCache(const JSONRPCRequest& req, const UniValue& content);
+    void Abort(const RPCCacheLookup& lookup);
 
     std::tuple<int64_t, int64_t> Statistic();
 
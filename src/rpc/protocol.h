@@ -10,12 +10,14 @@
 enum HTTPStatusCode
 {
     HTTP_OK                    = 200,
+    HTTP_NOT_MODIFIED          = 304,
     HTTP_BAD_REQUEST           = 400,
     HTTP_UNAUTHORIZED          = 401,
     HTTP_FORBIDDEN             = 403,
     HTTP_NOT_FOUND             = 404,
     HTTP_BAD_METHOD            = 405,
     HTTP_TIMEOUT               = 408,
+    HTTP_TOO_MANY_REQUESTS     = 429,
     HTTP_INTERNAL_SERVER_ERROR = 500,
     HTTP_SERVICE_UNAVAILABLE   = 503,
 };
@@ -44,12 +44,26 @@ void JSONRPCRequest::parse(const UniValue& valRequest)
 }
 
 
-void JSONRPCRequest::SetDbConnection(const DbConnectionRef& _dbConnection)
+void JSONRPCRequest::SetDbConnection(std::function<DbConnectionRef()> provider)
 {
-    dbConnection = _dbConnection;
+    dbConnectionProvider = std::move(provider);
+    dbConnection = nullptr;
 }
 
 const DbConnectionRef& JSONRPCRequest::DbConnection() const
 {
+    if (!dbConnection && dbConnectionProvider)
+        dbConnection = dbConnectionProvider();
+
     return dbConnection;
 }
+
+void JSONRPCRequest::SetSerializedResult(std::string&& result) const
+{
+    *serializedResult = std::make_shared<const std::string>(std::move(result));
+}
+
+std::shared_ptr<const std::string> JSONRPCRequest::TakeSerializedResult() const
+{
+    return std::move(*serializedResult);
+}
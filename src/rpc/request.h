@@ -8,6 +8,8 @@
 
 #include "pocketdb/SQLiteConnection.h"
 #include "rpc/requestutils.h"
+#include <functional>
+#include <memory>
 #include <string>
 
 #include <univalue.h>
@@ -35,17 +37,25 @@ public:
     //! added or removed above.
     JSONRPCRequest(const JSONRPCRequest& other, const util::Ref& context)
         : id(other.id), strMethod(other.strMethod), params(other.params), fHelp(other.fHelp), URI(other.URI),
-          authUser(other.authUser), peerAddr(other.peerAddr), context(context)
+          authUser(other.authUser), peerAddr(other.peerAddr), context(context), dbConnectionProvider(other.dbConnectionProvider), serializedResult(other.serializedResult)
     {
     }
 
     void parse(const UniValue& valRequest);
 
-    void SetDbConnection(const DbConnectionRef& _dbConnection);
+    //! Connection is taken from provider on the first DbConnection() call
+    void SetDbConnection(std::function<DbConnectionRef()> provider);
     const DbConnectionRef& DbConnection() const;
 
+    //! Handler can write result JSON itself, then returned UniValue is ignored.
+    //! Slot is shared between copies of request made while dispatching.
+    void SetSerializedResult(std::string&& result) const;
+    std::shared_ptr<const std::string> TakeSerializedResult() const;
+
 private:
-    DbConnectionRef dbConnection;
+    std::function<DbConnectionRef()> dbConnectionProvider;
+    mutable DbConnectionRef dbConnection;
+    std::shared_ptr<std::shared_ptr<const std::string>> serializedResult = std::make_shared<std::shared_ptr<const std::string>>();
 };
 
 #endif // POCKETCOIN_RPC_REQUEST_H
@@ -45,6 +45,21 @@ std::string JSONRPCReply(const UniValue& result, const UniValue& error, const Un
     return reply.write() + "\n";
 }
 
+std::string JSONRPCReplySerialized(const std::string& result, const UniValue& id)
+{
+    // Same layout as JSONRPCReply without error but with already serialized result
+    std::string strId = id.write();
+
+    std::string reply;
+    reply.reserve(result.size() + strId.size() + 32);
+    reply += "{\"result\":";
+    reply += result;
+    reply += ",\"error\":null,\"id\":";
+    reply += strId;
+    reply += "}\n";
+    return reply;
+}
+
 UniValue JSONRPCError(int code, const std::string& message)
 {
     UniValue error(UniValue::VOBJ);
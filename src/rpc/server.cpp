@@ -30,7 +30,7 @@ static RPCTimerInterface* timerInterface = nullptr;
 /* Map of name to timer. */
 static Mutex g_deadline_timers_mutex;
 static std::map<std::string, std::unique_ptr<RPCTimerBase> > deadlineTimers GUARDED_BY(g_deadline_timers_mutex);
-static bool ExecuteCommand(const CRPCCommand& command, const JSONRPCRequest& request, UniValue& result, bool last_handler, RPCCache* cache);
+static bool ExecuteCommand(const CRPCCommand& command, const JSONRPCRequest& request, UniValue& result, bool last_handler);
 
 struct RPCCommandExecution
 {
@@ -313,6 +313,68 @@ static inline JSONRPCRequest transformNamedArguments(const JSONRPCRequest& in, c
 }
 
 UniValue CRPCTable::execute(const JSONRPCRequest &request) const
+{
+    auto lookup = cache->Lookup(request);
+    if (lookup.data) {
+        UniValue result;
+        if (result.read(*lookup.data))
+            return result;
+    }
+
+    UniValue result;
+    std::shared_ptr<const std::string> serialized;
+    try {
+        result = executeCommand(request);
+        serialized = request.TakeSerializedResult();
+    } catch (...) {
+        cache->Abort(lookup);
+        throw;
+    }
+
+    // Handler wrote result JSON itself
+    if (serialized)
+        result.read(*serialized);
+
+    // Save return value in cache for later
+    if (lookup.fill)
+        cache->Put(lookup, serialized ? serialized : std::make_shared<const std::string>(result.write()));
+
+    return result;
+}
+
+std::shared_ptr<const std::string> CRPCTable::executeSerialized(const JSONRPCRequest &request, std::string* etag) const
+{
+    auto lookup = cache->Lookup(request);
+    if (lookup.data)
+    {
+        if (etag)
+            *etag = RPCCache::ETag(lookup.key, lookup.validUntill, request.id);
+
+        return lookup.data;
+    }
+
+    UniValue result;
+    std::shared_ptr<const std::string> serialized;
+    try {
+        result = executeCommand(request);
+        serialized = request.TakeSerializedResult();
+    } catch (...) {
+        cache->Abort(lookup);
+        throw;
+    }
+
+    // Result serialized once for both reply and cache
+    // if handler did not write it itself
+    if (!serialized)
+        serialized = std::make_shared<const std::string>(result.write());
+
+    if (int validUntill = cache->Put(lookup, serialized); validUntill > 0 && etag)
+        *etag = RPCCache::ETag(lookup.key, validUntill, request.id);
+
+    return serialized;
+}
+
+UniValue CRPCTable::executeCommand(const JSONRPCRequest &request) const
 {
     // Return immediately if in warmup
     {
@@ -333,7 +395,7 @@ UniValue CRPCTable::execute(const JSONRPCRequest &request) const
     if (it != mapCommands.end()) {
         UniValue result;
         for (const auto& command : it->second) {
-            if (ExecuteCommand(*command, request, result, &command == &it->second.back(), cache.get())) {
+            if (ExecuteCommand(*command, request, result, &command == &it->second.back())) {
                 return result;
             }
         }
@@ -342,14 +404,12 @@ UniValue CRPCTable::execute(const JSONRPCRequest &request) const
     throw JSONRPCError(RPC_METHOD_NOT_FOUND, "Method not found");
 }
 
-static bool ExecuteCommand(const CRPCCommand& command, const JSONRPCRequest& request, UniValue& result, bool last_handler, RPCCache* cache)
+static bool ExecuteCommand(const CRPCCommand& command, const JSONRPCRequest& request, UniValue& result, bool last_handler)
 {
     auto start = gStatEngineInstance.GetCurrentSystemTime();
 
     bool ret = true;
-    // See if this request reply is cached
-    UniValue tmpRes = cache->GetRpcCache(request);
-    if (tmpRes.isNull())
+    UniValue tmpRes;
     {
         RPCCommandExecution execution(request.strMethod);
         // Execute, convert arguments to array if necessary
@@ -358,21 +418,26 @@ static bool ExecuteCommand(const CRPCCommand& command, const JSONRPCRequest& req
         } else {
             ret = command.actor(request, tmpRes, last_handler);
         }
-
-        // Save return value in cache for later
-        if (ret)
-            cache->PutRpcCache(request, tmpRes);
     }
     
     auto stop = gStatEngineInstance.GetCurrentSystemTime();
 
-    auto diff = (stop - start);
+    auto diff = std::chrono::duration_cast<std::chrono::milliseconds>(stop - start);
     LogPrint(BCLog::RPC, "RPC Method time %s (%s) - %ldms\n", request.strMethod, request.peerAddr.substr(0, request.peerAddr.find(':')), diff.count());
 
     result = std::move(tmpRes);
     return ret;
 }
 
+const CRPCCommand* CRPCTable::operator[](const std::string& name) const
+{
+    auto it = mapCommands.find(name);
+    if (it == mapCommands.end() || it->second.empty())
+        return nullptr;
+
+    return it->second.front();
+}
+
 std::vector<std::string> CRPCTable::listCommands() const
 {
     std::vector<std::string> commandList;
@@ -164,6 +164,8 @@ class CRPCTable
 private:
     std::map<std::string, std::vector<const CRPCCommand*>> mapCommands;
     std::unique_ptr<RPCCache> cache {new RPCCache()};
+
+    UniValue executeCommand(const JSONRPCRequest &request) const;
 public:
     const CRPCCommand* operator[](const std::string& name) const;
     std::string help(const std::string& name, const JSONRPCRequest& helpreq) const;
@@ -177,6 +179,14 @@ public:
      */
     UniValue execute(const JSONRPCRequest &request) const;
 
+    /**
+     * Execute a method and return serialized result.
+     * Cached results are returned as is without UniValue serialization.
+     * ETag of result is set for cached methods.
+     * @throws an exception (UniValue) when an error happens.
+     */
+    std::shared_ptr<const std::string> executeSerialized(const JSONRPCRequest &request, std::string* etag = nullptr) const;
+
     /**
     * Returns a list of registered commands
     * @returns List of registered commands.
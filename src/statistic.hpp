@@ -12,12 +12,20 @@
 #include <sqlite3.h>
 #include <boost/thread.hpp>
 #include <boost/format.hpp>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <cmath>
 #include <cstdint>
 #include <ctime>
+#include <memory>
+#include <mutex>
 #include <net.h>
 #include <numeric>
+#include <optional>
 #include <set>
+#include <shared_mutex>
+#include <unordered_map>
 
 #include "pocketdb/pocketnet.h"
 
@@ -25,10 +33,17 @@ namespace Statistic
 {
     using namespace std;
     using RequestKey = std::string;
-    using RequestTime = std::chrono::milliseconds;
+    using RequestTime = std::chrono::microseconds;
     using RequestIP = std::string;
     using RequestPayloadSize = std::size_t;
 
+    // Number of slots in rolling window, window length is -statdepth
+    static const int STAT_WINDOW_SLOTS = 6;
+    // Methods and SQL functions with own histograms, others are counted as "other"
+    static const size_t MAX_STAT_KEYS = 1000;
+    // Requests of methods not registered in RPC table
+    static const char* const STAT_UNKNOWN_KEY = "unknown";
+
     struct RequestSample
     {
         RequestKey Key;
@@ -41,185 +56,451 @@ namespace Statistic
         RequestPayloadSize OutputSize;
     };
 
-    class RequestStatEngine
+    /**
+    * Lock-free log-linear histogram of microsecond values (HDR-style). Values below 16 are exact,
+    * above them every power of two is split into 8 buckets, so the relative error is below 1/8.
+    * Values above 2^38 us (~76 hours) are counted in the last bucket.
+    */
+    class LatencyHistogram
     {
     public:
-        RequestStatEngine() = default;
+        static constexpr int SUB_BUCKETS = 8;
+        static constexpr int MAX_SHIFT = 34;
+        static constexpr int BUCKETS = (MAX_SHIFT + 2) * SUB_BUCKETS;
 
-        int HeightWeb = 0;
+        static int Index(uint64_t value)
+        {
+            value = std::min(value, (uint64_t(1) << (MAX_SHIFT + 4)) - 1);
+            if (value < 2 * SUB_BUCKETS)
+                return (int) value;
 
-        void AddSample(const RequestSample& sample)
+            int shift = 63 - __builtin_clzll(value) - 3;
+            return (shift + 1) * SUB_BUCKETS + (int) ((value >> shift) - SUB_BUCKETS);
+        }
+
+        // Highest value counted in bucket
+        static uint64_t UpperBound(int index)
         {
-            if (sample.TimestampEnd < sample.TimestampBegin)
-                return;
+            if (index < 2 * SUB_BUCKETS)
+                return (uint64_t) index;
 
-            LOCK(_samplesLock);
-            _samples.push_back(sample);
+            int shift = index / SUB_BUCKETS - 1;
+            uint64_t mantissa = index % SUB_BUCKETS + SUB_BUCKETS;
+            return ((mantissa + 1) << shift) - 1;
         }
 
-        std::size_t GetNumSamplesSince(RequestTime time)
+        void Record(uint64_t value)
         {
-            LOCK(_samplesLock);
-            return std::count_if(
-                _samples.begin(),
-                _samples.end(),
-                [=](const RequestSample& sample)
-                {
-                    return sample.TimestampEnd >= time && sample.TimestampEnd <= RequestTime::max();
-                });
+            m_counts[Index(value)].fetch_add(1, std::memory_order_relaxed);
+            m_count.fetch_add(1, std::memory_order_relaxed);
+            m_sum.fetch_add(value, std::memory_order_relaxed);
+
+            uint64_t max = m_max.load(std::memory_order_relaxed);
+            while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed));
         }
 
-        std::size_t GetNumFailedSamplesSince(RequestTime time)
+        void Reset()
         {
-            LOCK(_samplesLock);
-            return std::count_if(
-                _samples.begin(),
-                _samples.end(),
-                [=](const RequestSample& sample)
-                {
-                    return sample.TimestampEnd >= time && sample.TimestampEnd <= RequestTime::max() && sample.Failed;
-                });
+            for (auto& count : m_counts)
+                count.store(0, std::memory_order_relaxed);
+
+            m_count.store(0, std::memory_order_relaxed);
+            m_sum.store(0, std::memory_order_relaxed);
+            m_max.store(0, std::memory_order_relaxed);
+        }
+
+        friend struct HistogramSnapshot;
+
+    private:
+        std::array<std::atomic<uint32_t>, BUCKETS> m_counts{};
+        std::atomic<uint64_t> m_count{0};
+        std::atomic<uint64_t> m_sum{0};
+        std::atomic<uint64_t> m_max{0};
+    };
+
+    // Merged copy of histograms for percentiles
+    struct HistogramSnapshot
+    {
+        std::array<uint64_t, LatencyHistogram::BUCKETS> Counts{};
+        uint64_t Count = 0;
+        uint64_t Sum = 0;
+        uint64_t Max = 0;
+
+        void Add(const LatencyHistogram& histogram)
+        {
+            for (int i = 0; i < LatencyHistogram::BUCKETS; i++)
+                Counts[i] += histogram.m_counts[i].load(std::memory_order_relaxed);
+
+            Count += histogram.m_count.load(std::memory_order_relaxed);
+            Sum += histogram.m_sum.load(std::memory_order_relaxed);
+            Max = std::max(Max, histogram.m_max.load(std::memory_order_relaxed));
         }
 
-        RequestTime GetAvgRequestTimeSince(RequestTime since)
+        void Add(const HistogramSnapshot& other)
         {
-            LOCK(_samplesLock);
+            for (int i = 0; i < LatencyHistogram::BUCKETS; i++)
+                Counts[i] += other.Counts[i];
 
-            if (_samples.empty())
-                return {};
+            Count += other.Count;
+            Sum += other.Sum;
+            Max = std::max(Max, other.Max);
+        }
 
-            RequestTime sum{};
-            std::size_t count{};
+        uint64_t Percentile(double quantile) const
+        {
+            if (Count == 0)
+                return 0;
 
-            for (auto& sample : _samples)
+            auto rank = (uint64_t) std::max(1.0, std::ceil(quantile * (double) Count));
+            uint64_t seen = 0;
+            for (int i = 0; i < LatencyHistogram::BUCKETS; i++)
             {
-                if (sample.TimestampEnd.count() > 0 && sample.TimestampEnd >= since && sample.Key != "WorkQueue::Enqueue")
-                {
-                    sum += sample.TimestampEnd - sample.TimestampBegin;
-                    count++;
-                }
+                seen += Counts[i];
+                if (seen >= rank)
+                    return std::min(LatencyHistogram::UpperBound(i), Max);
             }
 
-            if (count <= 0) return {};
-            return sum / count;
+            return Max;
         }
 
-        RequestTime GetAvgExecutionTimeSince(RequestTime since)
+        uint64_t Avg() const
         {
-            LOCK(_samplesLock);
+            return Count ? Sum / Count : 0;
+        }
 
-            if (_samples.empty())
-                return {};
+        // Values in microseconds
+        UniValue ToJson() const
+        {
+            UniValue result(UniValue::VOBJ);
+            result.pushKV("count", (int64_t) Count);
+            result.pushKV("avg", (int64_t) Avg());
+            result.pushKV("p50", (int64_t) Percentile(0.50));
+            result.pushKV("p95", (int64_t) Percentile(0.95));
+            result.pushKV("p99", (int64_t) Percentile(0.99));
+            result.pushKV("max", (int64_t) Max);
+            return result;
+        }
+    };
 
-            RequestTime sum{};
-            std::size_t count{};
+    /**
+    * Ring of slots of slotSeconds each. Slot of current time is reset by the first writer after rotation,
+    * samples written concurrently with the reset may be lost - acceptable for statistic.
+    */
+    template<typename Slot>
+    class RollingWindow
+    {
+    public:
+        Slot& Current(int64_t now, int64_t slotSeconds)
+        {
+            int64_t epoch = now / slotSeconds;
+            auto& entry = m_slots[epoch % STAT_WINDOW_SLOTS];
+
+            int64_t prev = entry.Epoch.load(std::memory_order_acquire);
+            if (prev < epoch && entry.Epoch.compare_exchange_strong(prev, epoch))
+                entry.Value.Reset();
+
+            return entry.Value;
+        }
 
-            for (auto& sample : _samples)
+        template<typename Func>
+        void ForEach(int64_t now, int64_t slotSeconds, Func func) const
+        {
+            int64_t epoch = now / slotSeconds;
+            for (const auto& entry : m_slots)
             {
-                if (sample.TimestampEnd.count() > 0 && sample.TimestampEnd >= since && sample.Key != "WorkQueue::Enqueue")
-                {
-                    sum += sample.TimestampEnd - sample.TimestampExec;
-                    count++;
-                }
+                int64_t slotEpoch = entry.Epoch.load(std::memory_order_acquire);
+                if (slotEpoch > epoch - STAT_WINDOW_SLOTS && slotEpoch <= epoch)
+                    func(entry.Value);
             }
+        }
 
-            if (count <= 0) return {};
-            return sum / count;
+    private:
+        struct Entry
+        {
+            std::atomic<int64_t> Epoch{-1};
+            Slot Value;
+        };
+
+        std::array<Entry, STAT_WINDOW_SLOTS> m_slots;
+    };
+
+    // Rolling windows by method or function name, lookup of existing key takes only shared lock
+    template<typename Slot>
+    class KeyedWindows
+    {
+    public:
+        RollingWindow<Slot>& Get(const string& key)
+        {
+            {
+                std::shared_lock<std::shared_mutex> lock(m_mutex);
+                if (auto it = m_windows.find(key); it != m_windows.end())
+                    return *it->second;
+            }
+
+            std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+            // Keys come from clients - limit memory
+            auto& window = m_windows[m_windows.size() < MAX_STAT_KEYS || m_windows.count(key) ? key : "other"];
+            if (!window)
+                window = std::make_unique<RollingWindow<Slot>>();
+
+            return *window;
         }
 
-        std::vector<RequestSample> GetTopHeavyTimeSamplesSince(std::size_t limit, RequestTime since)
+        template<typename Func>
+        void ForEach(Func func) const
         {
-            return GetTopTimeSamplesImpl(limit, since);
+            std::shared_lock<std::shared_mutex> lock(m_mutex);
+            for (const auto& [key, window] : m_windows)
+                func(key, *window);
         }
 
-        std::vector<RequestSample> GetTopHeavyTimeSamples(std::size_t limit)
+    private:
+        mutable std::shared_mutex m_mutex;
+        std::unordered_map<string, std::unique_ptr<RollingWindow<Slot>>> m_windows;
+    };
+
+    struct RequestSlot
+    {
+        // From request creation to start of execution
+        LatencyHistogram Queue;
+        LatencyHistogram Exec;
+        std::atomic<uint64_t> Failed{0};
+
+        void Reset()
+        {
+            Queue.Reset();
+            Exec.Reset();
+            Failed.store(0, std::memory_order_relaxed);
+        }
+    };
+
+    struct SqlSlot
+    {
+        LatencyHistogram Time;
+
+        void Reset()
         {
-            return GetTopHeavyTimeSamplesSince(limit, RequestTime::min());
+            Time.Reset();
         }
+    };
+
+    // Request sources for detailed statistic
+    struct SourceSlot
+    {
+        mutable Mutex Lock;
+        std::set<RequestIP> IPs GUARDED_BY(Lock);
+        std::optional<RequestSample> Heaviest GUARDED_BY(Lock);
+
+        void Reset()
+        {
+            LOCK(Lock);
+            IPs.clear();
+            Heaviest.reset();
+        }
+    };
+
+    struct RequestSnapshot
+    {
+        HistogramSnapshot Queue;
+        HistogramSnapshot Exec;
+        uint64_t Failed = 0;
+
+        void Add(const RequestSnapshot& other)
+        {
+            Queue.Add(other.Queue);
+            Exec.Add(other.Exec);
+            Failed += other.Failed;
+        }
+
+        UniValue ToJson() const
+        {
+            UniValue result(UniValue::VOBJ);
+            result.pushKV("requests", (int64_t) Exec.Count);
+            result.pushKV("failed", (int64_t) Failed);
+            result.pushKV("queue", Queue.ToJson());
+            result.pushKV("exec", Exec.ToJson());
+            return result;
+        }
+    };
+
+    class RequestStatEngine
+    {
+    public:
+        RequestStatEngine() = default;
+
+        int HeightWeb = 0;
 
-        std::vector<RequestSample> GetTopHeavyInputSamplesSince(std::size_t limit, RequestTime since)
+        void AddSample(const RequestSample& sample)
         {
-            return GetTopSizeSamplesImpl(limit, &RequestSample::InputSize, since);
+            if (sample.TimestampEnd < sample.TimestampBegin || sample.TimestampExec < sample.TimestampBegin)
+                return;
+
+            int64_t now = std::chrono::duration_cast<std::chrono::seconds>(sample.TimestampEnd).count();
+
+            auto& slot = _requests.Get(sample.Key).Current(now, _slotSeconds);
+            slot.Queue.Record((sample.TimestampExec - sample.TimestampBegin).count());
+            slot.Exec.Record((sample.TimestampEnd - sample.TimestampExec).count());
+            if (sample.Failed)
+                slot.Failed.fetch_add(1, std::memory_order_relaxed);
+
+            // Sources are kept only when reported - set insert under lock is too heavy for every request
+            if (!CollectSources())
+                return;
+
+            auto& sources = _sources.Current(now, _slotSeconds);
+
+            LOCK(sources.Lock);
+            sources.IPs.insert(sample.SourceIP);
+            if (!sources.Heaviest || sample.TimestampEnd - sample.TimestampBegin > sources.Heaviest->TimestampEnd - sources.Heaviest->TimestampBegin)
+                sources.Heaviest = sample;
         }
 
-        std::vector<RequestSample> GetTopHeavyInputSamples(std::size_t limit)
+        // Window snapshots of all methods
+        std::map<RequestKey, RequestSnapshot> GetRequestSnapshots()
         {
-            return GetTopHeavyInputSamplesSince(limit, RequestTime::min());
+            int64_t now = GetCurrentSystemSeconds();
+            std::map<RequestKey, RequestSnapshot> result;
+
+            _requests.ForEach([&](const RequestKey& key, const RollingWindow<RequestSlot>& window) {
+                auto& snapshot = result[key];
+                window.ForEach(now, _slotSeconds, [&](const RequestSlot& slot) {
+                    snapshot.Queue.Add(slot.Queue);
+                    snapshot.Exec.Add(slot.Exec);
+                    snapshot.Failed += slot.Failed.load(std::memory_order_relaxed);
+                });
+            });
+
+            return result;
         }
 
-        std::vector<RequestSample> GetTopHeavyOutputSamplesSince(std::size_t limit, RequestTime since)
+        std::map<string, HistogramSnapshot> GetSqlSnapshots()
         {
-            return GetTopSizeSamplesImpl(limit, &RequestSample::OutputSize, since);
+            int64_t now = GetCurrentSystemSeconds();
+            std::map<string, HistogramSnapshot> result;
+
+            _sql.ForEach([&](const string& key, const RollingWindow<SqlSlot>& window) {
+                auto& snapshot = result[key];
+                window.ForEach(now, _slotSeconds, [&](const SqlSlot& slot) {
+                    snapshot.Add(slot.Time);
+                });
+            });
+
+            return result;
         }
 
-        std::vector<RequestSample> GetTopHeavyOutputSamples(std::size_t limit)
+        // Compact totals for getnodeinfo
+        UniValue Statistic()
         {
-            return GetTopHeavyOutputSamplesSince(limit, RequestTime::min());
+            RequestSnapshot total;
+            for (const auto& [key, snapshot] : GetRequestSnapshots())
+                total.Add(snapshot);
+
+            UniValue result = total.ToJson();
+            result.pushKV("window", _slotSeconds * STAT_WINDOW_SLOTS);
+            return result;
         }
 
-        std::set<RequestIP> GetUniqueSourceIPsSince(RequestTime since)
+        // Latency percentiles by method and SQL function for getrpcstatistic
+        UniValue RequestStatistic()
         {
-            std::set<RequestIP> result{};
+            UniValue methods(UniValue::VOBJ);
+            for (const auto& [key, snapshot] : GetRequestSnapshots())
+                methods.pushKV(key, snapshot.ToJson());
 
-            LOCK(_samplesLock);
-            for (auto& sample : _samples)
-                if (sample.TimestampEnd >= since)
-                    result.insert(sample.SourceIP);
+            UniValue sql(UniValue::VOBJ);
+            for (const auto& [key, snapshot] : GetSqlSnapshots())
+                sql.pushKV(key, snapshot.ToJson());
 
+            UniValue result(UniValue::VOBJ);
+            result.pushKV("window", _slotSeconds * STAT_WINDOW_SLOTS);
+            result.pushKV("methods", methods);
+            result.pushKV("sql", sql);
             return result;
         }
 
-        std::set<RequestIP> GetUniqueSourceIPs()
+        // Prometheus text exposition format, summaries in seconds
+        std::string PrometheusText()
         {
-            return GetUniqueSourceIPsSince(RequestTime::min());
+            std::string result;
+
+            const auto escape = [](const std::string& value) {
+                std::string escaped;
+                for (char c : value)
+                {
+                    if (c == '\\' || c == '"') escaped += '\\';
+                    if (c == '\n') { escaped += "\\n"; continue; }
+                    escaped += c;
+                }
+                return escaped;
+            };
+
+            const auto summary = [&](const std::string& name, const std::string& help, const std::string& label,
+                const std::map<std::string, const HistogramSnapshot*>& snapshots) {
+                result += strprintf("# HELP %s %s\n# TYPE %s summary\n", name, help, name);
+                for (const auto& [key, snapshot] : snapshots)
+                {
+                    auto labels = strprintf("%s=\"%s\"", label, escape(key));
+                    for (double quantile : {0.5, 0.95, 0.99})
+                        result += strprintf("%s{%s,quantile=\"%g\"} %.6f\n", name, labels, quantile, snapshot->Percentile(quantile) / 1e6);
+                    result += strprintf("%s_sum{%s} %.6f\n", name, labels, snapshot->Sum / 1e6);
+                    result += strprintf("%s_count{%s} %d\n", name, labels, snapshot->Count);
+                }
+            };
+
+            auto requests = GetRequestSnapshots();
+            auto sql = GetSqlSnapshots();
+
+            std::map<std::string, const HistogramSnapshot*> queue, exec, sqlTime;
+            for (const auto& [key, snapshot] : requests)
+            {
+                queue[key] = &snapshot.Queue;
+                exec[key] = &snapshot.Exec;
+            }
+            for (const auto& [key, snapshot] : sql)
+                sqlTime[key] = &snapshot;
+
+            summary("pocketnet_rpc_queue_seconds", "Wait of RPC request before execution", "method", queue);
+            summary("pocketnet_rpc_exec_seconds", "Execution of RPC request", "method", exec);
+            summary("pocketnet_sql_seconds", "Execution of SQL function", "func", sqlTime);
+
+            result += "# HELP pocketnet_rpc_failed Failed RPC requests in window\n# TYPE pocketnet_rpc_failed gauge\n";
+            for (const auto& [key, snapshot] : requests)
+                result += strprintf("pocketnet_rpc_failed{method=\"%s\"} %d\n", escape(key), snapshot.Failed);
+
+            result += strprintf("# HELP pocketnet_height Height of chain and web database\n# TYPE pocketnet_height gauge\n"
+                "pocketnet_height{db=\"main\"} %d\npocketnet_height{db=\"web\"} %d\n", ChainActive().Height(), HeightWeb);
+
+            return result;
         }
 
-        UniValue CompileStatsAsJsonSince(RequestTime since, const util::Ref& context)
+        UniValue CompileStatsAsJson(const util::Ref& context)
         {
             UniValue result{UniValue::VOBJ};
             const auto& node = EnsureNodeContext(context);
 
-            constexpr auto top_limit = 1;
             const auto sample_to_json = [](const RequestSample& sample)
             {
                 UniValue value{UniValue::VOBJ};
 
                 value.pushKV("Key", sample.Key);
-                value.pushKV("TimestampBegin", sample.TimestampBegin.count());
-                value.pushKV("TimestampEnd", sample.TimestampEnd.count());
-                value.pushKV("TimestampProcess", sample.TimestampEnd.count() - sample.TimestampBegin.count());
+                value.pushKV("TimestampBegin", std::chrono::duration_cast<std::chrono::milliseconds>(sample.TimestampBegin).count());
+                value.pushKV("TimestampEnd", std::chrono::duration_cast<std::chrono::milliseconds>(sample.TimestampEnd).count());
+                value.pushKV("TimestampProcess", std::chrono::duration_cast<std::chrono::milliseconds>(sample.TimestampEnd - sample.TimestampBegin).count());
                 value.pushKV("SourceIP", sample.SourceIP);
-                value.pushKV("InputSize", (int)sample.InputSize);
-                value.pushKV("OutputSize", (int)sample.OutputSize);
 
                 return value;
             };
 
-            UniValue unique_ips_json{UniValue::VARR};
-            UniValue top_tm_json{UniValue::VARR};
-            UniValue top_in_json{UniValue::VARR};
-            UniValue top_out_json{UniValue::VARR};
-
-            auto unique_ips = GetUniqueSourceIPsSince(since);
-            auto unique_ips_count = unique_ips.size();
-            if (gArgs.GetBoolArg("-collectstat", false) || LogInstance().WillLogCategory(BCLog::STATDETAIL))
-            {
-                auto top_tm = GetTopHeavyTimeSamplesSince(top_limit, since);
-                auto top_in = GetTopHeavyInputSamplesSince(top_limit, since);
-                auto top_out = GetTopHeavyOutputSamplesSince(top_limit, since);
-
-                for (auto& ip : unique_ips)
-                    unique_ips_json.push_back(ip);
-
-                for (auto& sample : top_tm)
-                    top_tm_json.push_back(sample_to_json(sample));
-
-                for (auto& sample : top_in)
-                    top_in_json.push_back(sample_to_json(sample));
-
-                for (auto& sample : top_out)
-                    top_out_json.push_back(sample_to_json(sample));
-            }
+            // Request sources of window
+            std::set<RequestIP> unique_ips;
+            std::optional<RequestSample> heaviest;
+            _sources.ForEach(GetCurrentSystemSeconds(), _slotSeconds, [&](const SourceSlot& slot) {
+                LOCK(slot.Lock);
+                unique_ips.insert(slot.IPs.begin(), slot.IPs.end());
+                if (slot.Heaviest && (!heaviest || slot.Heaviest->TimestampEnd - slot.Heaviest->TimestampBegin > heaviest->TimestampEnd - heaviest->TimestampBegin))
+                    heaviest = slot.Heaviest;
+            });
 
             UniValue chainStat(UniValue::VOBJ);
             chainStat.pushKV("Version", FormatVersion(CLIENT_VERSION));
@@ -236,7 +517,7 @@ namespace Statistic
 
             // SQL statistic
             UniValue sqlStats(UniValue::VOBJ);
-            sqlite3_int64 current64 = 0, highWater64 = 0; 
+            sqlite3_int64 current64 = 0, highWater64 = 0;
             sqlite3_status64(SQLITE_STATUS_MEMORY_USED, &current64, &highWater64, false);
             sqlStats.pushKV("MemoryUsed", (int64_t) current64);
             sqlStats.pushKV("MemoryUsedMax", (int64_t) highWater64);
@@ -247,7 +528,7 @@ namespace Statistic
             sqlStats.pushKV("PageCacheSize", (int64_t) current64);
             sqlStats.pushKV("PageCacheSizeMax", (int64_t) highWater64);
             sqlite3 *db = PocketDb::SQLiteDbInst.m_db;
-            int current = 0, highWater = 0; 
+            int current = 0, highWater = 0;
             sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_USED, &current, &highWater, false);
             sqlStats.pushKV("CacheUsed", current);
             sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_USED_SHARED, &current, &highWater, false);
@@ -261,24 +542,41 @@ namespace Statistic
             result.pushKV("SQL", sqlStats);
 
             // SQL benchmark statistic
-            if (gArgs.GetBoolArg("-collectstat", false) || LogInstance().WillLogCategory(BCLog::STATSQLBENCH))
+            if (_collectStat || LogInstance().WillLogCategory(BCLog::STATSQLBENCH))
             {
-                result.pushKV("SQLBench", GetAvgSqlBench());
+                UniValue sqlBench(UniValue::VOBJ);
+                for (const auto& [func, snapshot] : GetSqlSnapshots())
+                    sqlBench.pushKV(func, snapshot.ToJson());
+
+                result.pushKV("SQLBench", sqlBench);
             }
 
             // RPC statistic
+            RequestSnapshot total;
+            for (const auto& [key, snapshot] : GetRequestSnapshots())
+                total.Add(snapshot);
+
             UniValue rpcStat(UniValue::VOBJ);
-            rpcStat.pushKV("RequestsAll", (int)GetNumSamplesSince(since));
-            rpcStat.pushKV("RequestsFailed", (int)GetNumFailedSamplesSince(since));
-            rpcStat.pushKV("AvgReqTime", GetAvgRequestTimeSince(since).count());
-            rpcStat.pushKV("AvgExecTime", GetAvgExecutionTimeSince(since).count());
-            rpcStat.pushKV("UniqueIPs", (int)unique_ips_count);
+            rpcStat.pushKV("RequestsAll", (int64_t) total.Exec.Count);
+            rpcStat.pushKV("RequestsFailed", (int64_t) total.Failed);
+            rpcStat.pushKV("AvgReqTime", (int64_t) (total.Queue.Avg() + total.Exec.Avg()) / 1000);
+            rpcStat.pushKV("AvgExecTime", (int64_t) total.Exec.Avg() / 1000);
+            rpcStat.pushKV("Queue", total.Queue.ToJson());
+            rpcStat.pushKV("Exec", total.Exec.ToJson());
+            if (CollectSources())
+                rpcStat.pushKV("UniqueIPs", (int)unique_ips.size());
             if (gArgs.GetBoolArg("-collectstat", false) || LogInstance().WillLogCategory(BCLog::STATDETAIL))
             {
+                UniValue unique_ips_json{UniValue::VARR};
+                for (auto& ip : unique_ips)
+                    unique_ips_json.push_back(ip);
+
+                UniValue top_tm_json{UniValue::VARR};
+                if (heaviest)
+                    top_tm_json.push_back(sample_to_json(*heaviest));
+
                 rpcStat.pushKV("UniqueIps", unique_ips_json);
                 rpcStat.pushKV("TopTime", top_tm_json);
-                rpcStat.pushKV("TopInputSize", top_in_json);
-                rpcStat.pushKV("TopOutputSize", top_out_json);
             }
             result.pushKV("RPC", rpcStat);
 
@@ -291,9 +589,16 @@ namespace Statistic
             return std::chrono::duration_cast<RequestTime>(std::chrono::system_clock::now().time_since_epoch());
         }
 
+        int64_t GetCurrentSystemSeconds()
+        {
+            return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        }
+
         void Run(boost::thread_group& threadGroup, const util::Ref& context)
         {
             shutdown = false;
+            _slotSeconds = std::max<int64_t>(gArgs.GetArg("-statdepth", 60) / STAT_WINDOW_SLOTS, 1);
+            _collectStat = gArgs.GetBoolArg("-collectstat", false);
             m_interrupt.reset();
             threadGroup.create_thread(boost::bind(&RequestStatEngine::PeriodicStatLogger, this, boost::cref(context)));
         }
@@ -311,25 +616,24 @@ namespace Statistic
 
             while (!shutdown)
             {
-                auto chunkSize = GetCurrentSystemTime() - std::chrono::milliseconds(statLoggerSleep);
-                _latestPage = CompileStatsAsJsonSince(chunkSize, context);
+                _latestPage = CompileStatsAsJson(context);
                 LogPrint(BCLog::STAT, msg.c_str(), statLoggerSleep / 1000, _latestPage.write(2, 1));
                 LogPrint(BCLog::STATDETAIL, msg.c_str(), statLoggerSleep / 1000, _latestPage.write(1));
 
-                RemoveSamplesBefore(chunkSize * 2);
                 m_interrupt.sleep_for(std::chrono::milliseconds{statLoggerSleep});
             }
         }
 
+        // Request sources for unique IPs and heaviest request of statistic page
+        bool CollectSources() const
+        {
+            return _collectStat || LogInstance().WillLogCategory(BCLog::STAT) || LogInstance().WillLogCategory(BCLog::STATDETAIL);
+        }
+
         void SetSqlBench(const string& func, double time)
         {
             if (gArgs.GetBoolArg("-collectstat", false) || LogInstance().WillLogCategory(BCLog::STATSQLBENCH))
-            {
-                LOCK(_sqlBenchRecordsLock);
-
-                _sqlBenchRecordsTimes[func] += time;
-                _sqlBenchRecordsCounts[func] += 1;
-            }
+                _sql.Get(func).Current(GetCurrentSystemSeconds(), _slotSeconds).Time.Record((uint64_t) (time * 1000));
         }
 
         UniValue LatestPage()
@@ -339,118 +643,17 @@ namespace Statistic
 
     private:
         CThreadInterrupt m_interrupt;
-        std::vector<RequestSample> _samples;
-        Mutex _samplesLock;
         bool shutdown = false;
 
-        Mutex _sqlBenchRecordsLock;
-        map<string, double> _sqlBenchRecordsTimes;
-        map<string, int> _sqlBenchRecordsCounts;
+        std::atomic<int64_t> _slotSeconds{10};
+        std::atomic<bool> _collectStat{false};
+        KeyedWindows<RequestSlot> _requests;
+        KeyedWindows<SqlSlot> _sql;
+        RollingWindow<SourceSlot> _sources;
 
         UniValue _latestPage;
-
-        void RemoveSamplesBefore(RequestTime time)
-        {
-            LOCK(_samplesLock);
-            int64_t sizeBefore = _samples.size();
-
-            _samples.erase(
-                std::remove_if(
-                    _samples.begin(),
-                    _samples.end(),
-                    [time](const RequestSample& sample)
-                    {
-                        return sample.TimestampEnd < time;
-                    }),
-                _samples.end());
-        }
-
-        std::vector<RequestSample> GetTopSizeSamplesImpl(std::size_t limit, RequestPayloadSize RequestSample::*size_field, RequestTime since)
-        {
-            LOCK(_samplesLock);
-            auto samples_copy = _samples;
-
-            samples_copy.erase(
-                std::remove_if(
-                    samples_copy.begin(),
-                    samples_copy.end(),
-                    [since](const RequestSample& sample)
-                    {
-                        return sample.TimestampEnd < since;
-                    }),
-                samples_copy.end());
-
-            std::sort(
-                samples_copy.begin(),
-                samples_copy.end(),
-                [size_field](const RequestSample& left, const RequestSample& right)
-                {
-                    return left.*size_field > right.*size_field;
-                });
-
-            if (samples_copy.size() > limit)
-                samples_copy.resize(limit);
-
-            return samples_copy;
-        }
-
-        std::vector<RequestSample> GetTopTimeSamplesImpl(std::size_t limit, RequestTime since)
-        {
-            LOCK(_samplesLock);
-            auto samples_copy = _samples;
-
-            samples_copy.erase(
-                std::remove_if(
-                    samples_copy.begin(),
-                    samples_copy.end(),
-                    [since](const RequestSample& sample)
-                    {
-                        return sample.TimestampEnd < since;
-                    }),
-                samples_copy.end());
-
-            std::sort(
-                samples_copy.begin(),
-                samples_copy.end(),
-                [](const RequestSample& left, const RequestSample& right)
-                {
-                    return left.TimestampEnd - left.TimestampBegin > right.TimestampEnd - right.TimestampBegin;
-                });
-
-            if (samples_copy.size() > limit)
-                samples_copy.resize(limit);
-
-            return samples_copy;
-        }
-
-        UniValue GetAvgSqlBench()
-        {
-            UniValue result(UniValue::VOBJ);
-
-            LOCK(_sqlBenchRecordsLock);
-
-            double ttl_time = 0;
-            int ttl_count = 0;
-            for (const auto& rcrd : _sqlBenchRecordsTimes)
-            {
-                int cnt = _sqlBenchRecordsCounts[rcrd.first];
-                double avg = rcrd.second / cnt;
-                result.pushKV(rcrd.first, boost::str(boost::format("%.2f") % avg) + "ms / " + boost::str(boost::format("%.2f") % rcrd.second) + "ms / " + to_string(cnt));
-                
-                ttl_time += rcrd.second;
-                ttl_count += cnt;
-            }
-            result.pushKV("!Total", boost::str(boost::format("%.2f") % (ttl_time/ttl_count)) + "ms / " + boost::str(boost::format("%.2f") % ttl_time) + "ms / " + to_string(ttl_count));
-
-            _sqlBenchRecordsTimes.clear();
-            _sqlBenchRecordsCounts.clear();
-
-            return result;
-        }
     };
 
-    static RequestStatEngine gStatEngineInstance;
-
 } // namespace Statistic
 
-#endif // POCKETCOIN_STATISTIC_H
\ No newline at end of file
+#endif // POCKETCOIN_STATISTIC_H
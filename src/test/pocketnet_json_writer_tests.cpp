@@ -0,0 +1,124 @@
+// Copyright (c) 2022 The Pocketcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <pocketdb/helpers/JsonWriter.h>
+#include <test/util/setup_common.h>
+#include <univalue.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <optional>
+
+using PocketHelpers::JsonWriter;
+
+namespace
+{
+    // Row of cursor as read by getcomments - absent columns are not written
+    struct Row
+    {
+        std::string Id;
+        std::optional<std::string> Msg;
+        std::optional<int64_t> Time;
+        std::optional<std::string> Flags;
+        bool Donation;
+        bool Deleted;
+    };
+
+    std::string WriteUniValue(const std::vector<Row>& rows)
+    {
+        UniValue result(UniValue::VARR);
+        for (const auto& row : rows)
+        {
+            UniValue record(UniValue::VOBJ);
+            record.pushKV("id", row.Id);
+            if (row.Msg) record.pushKV("msg", *row.Msg);
+            if (row.Time) record.pushKV("time", std::to_string(*row.Time));
+            if (row.Time) record.pushKV("timeInt", *row.Time);
+            record.pushKV("donation", row.Donation);
+            record.pushKV("children", 0);
+            record.pushKV("parentid", row.Deleted ? NullUniValue : UniValue(row.Id));
+
+            if (row.Flags)
+            {
+                UniValue flags(UniValue::VOBJ);
+                flags.read(*row.Flags);
+                record.pushKV("flags", flags);
+            }
+
+            record.pushKV("scores", UniValue(UniValue::VARR));
+            record.pushKV("info", UniValue(UniValue::VOBJ));
+            result.push_back(record);
+        }
+
+        return result.write();
+    }
+
+    std::string WriteJsonWriter(const std::vector<Row>& rows)
+    {
+        JsonWriter result;
+        result.BeginArray();
+        for (const auto& row : rows)
+        {
+            result.BeginObject();
+            result.Member("id", row.Id);
+            if (row.Msg) result.Member("msg", *row.Msg);
+            if (row.Time) result.Member("time", std::to_string(*row.Time));
+            if (row.Time) result.Member("timeInt", *row.Time);
+            result.Member("donation", row.Donation);
+            result.Member("children", 0);
+
+            result.Key("parentid");
+            if (row.Deleted) result.Null();
+            else result.String(row.Id);
+
+            if (row.Flags)
+                result.Key("flags").Raw(*row.Flags);
+
+            result.Key("scores").BeginArray().EndArray();
+            result.Key("info").BeginObject().EndObject();
+            result.EndObject();
+        }
+        result.EndArray();
+
+        return result.Release();
+    }
+}
+
+BOOST_FIXTURE_TEST_SUITE(pocketnet_json_writer_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(json_writer_equals_univalue)
+{
+    std::string controls;
+    for (int ch = 0; ch < 0x20; ch++)
+        controls += (char) ch;
+    controls += '\x7f';
+
+    std::vector<Row> rows{
+        {"plain", std::string("message"), 1650000000, std::string(R"({"1":2,"3":1})"), false, false},
+        {"escaping", std::string(R"(quote " backslash \ slash / tab	end)"), -1, std::nullopt, true, false},
+        {"controls", controls, 0, std::nullopt, false, true},
+        {"unicode", std::string("\xd0\xbf\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82 \xe2\x9c\x93 \xf0\x9f\x98\x80"), std::nullopt, std::string("{}"), true, true},
+        {"null columns", std::nullopt, std::nullopt, std::nullopt, false, false},
+        {"", std::string(""), INT64_MAX, std::nullopt, false, false},
+    };
+
+    BOOST_CHECK_EQUAL(WriteJsonWriter(rows), WriteUniValue(rows));
+
+    // Empty result and single row
+    BOOST_CHECK_EQUAL(WriteJsonWriter({}), WriteUniValue({}));
+    BOOST_CHECK_EQUAL(WriteJsonWriter({rows[1]}), WriteUniValue({rows[1]}));
+
+    // Random bytes are escaped the same way
+    for (int i = 0; i < 100; i++)
+    {
+        std::string msg(InsecureRandRange(64), '\0');
+        for (auto& ch : msg)
+            ch = (char) InsecureRandRange(256);
+
+        std::vector<Row> random{{msg, msg, (int64_t) g_insecure_rand_ctx.rand64(), std::nullopt, InsecureRandBool(), InsecureRandBool()}};
+        BOOST_CHECK_EQUAL(WriteJsonWriter(random), WriteUniValue(random));
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,66 @@
+// Copyright (c) 2022 The Pocketcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <pocketdb/services/Serializer.h>
+#include <primitives/block.h>
+#include <script/standard.h>
+#include <test/util/setup_common.h>
+#include <websocket/notifyprocessor.h>
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+    CTransactionRef CreateContentTx(const std::string& op, int n)
+    {
+        CMutableTransaction tx;
+        tx.nTime = 1650000000 + n;
+        tx.vin.resize(1);
+        tx.vin[0].prevout = COutPoint(uint256S(std::to_string(n + 1)), 1);
+        tx.vout.resize(2);
+        tx.vout[0].scriptPubKey = CScript() << OP_RETURN << ParseHex(op) << ParseHex(std::string(64, 'a'));
+        tx.vout[1].scriptPubKey = GetScriptForDestination(PKHash(uint160(std::vector<unsigned char>(20, (unsigned char) (n + 1)))));
+        tx.vout[1].nValue = 100000;
+        return MakeTransactionRef(tx);
+    }
+
+    void CheckPostAndEdit(const NotifyBlockData& data, const CTransactionRef& post)
+    {
+        BOOST_REQUIRE_EQUAL(data.Txs.size(), 2u);
+        BOOST_CHECK_EQUAL(data.Txs[0].OpType, "share");
+        BOOST_CHECK_EQUAL(data.Txs[1].OpType, "");
+
+        BOOST_CHECK_EQUAL(data.SharesCnt, 1);
+        BOOST_REQUIRE_EQUAL(data.ContentHashes.size(), 1u);
+        BOOST_CHECK_EQUAL(data.ContentHashes[0], post->GetHash().GetHex());
+        BOOST_CHECK_EQUAL(data.ContentAddresses.size(), 1u);
+    }
+}
+
+BOOST_FIXTURE_TEST_SUITE(pocketnet_notify_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(notify_post_edit_not_shared)
+{
+    NotifyBlockEntry entry;
+    entry.Index = nullptr;
+
+    auto post = CreateContentTx(OR_POST, 0);
+    entry.Block.vtx.push_back(post);
+    entry.Block.vtx.push_back(CreateContentTx(OR_POSTEDIT, 1));
+
+    // Types from PocketBlock parsed by ConnectTip
+    auto[ok, pocketBlock] = PocketServices::Serializer::DeserializeBlock(entry.Block);
+    BOOST_REQUIRE(ok);
+    entry.PocketBlock = std::make_shared<PocketHelpers::PocketBlock>(std::move(pocketBlock));
+    CheckPostAndEdit(NotifyBlockProcessor::PrepareBlock(entry), post);
+
+    // Types from OP_RETURN without PocketBlock
+    entry.PocketBlock = nullptr;
+    auto data = NotifyBlockProcessor::PrepareBlock(entry);
+    CheckPostAndEdit(data, post);
+    BOOST_CHECK_EQUAL(data.LangHashes.size(), 1u);
+    BOOST_CHECK(data.LangHashes.count(post->GetHash().GetHex()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
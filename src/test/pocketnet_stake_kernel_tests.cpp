@@ -0,0 +1,109 @@
+// Copyright (c) 2022 The Pocketcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chain.h>
+#include <pos.h>
+#include <random.h>
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+namespace
+{
+    // Target of 0xffff << 216 weighted by output value up to 1024 - a few hits in a table of random candidates
+    const unsigned int KERNEL_BITS = 0x1e00ffff;
+    const int KERNEL_COINS = 4000;
+    const int64_t KERNEL_INTERVAL = 64 * (STAKE_TIMESTAMP_MASK + 1);
+
+    struct KernelCoin
+    {
+        StakeKernelHashTx Tx;
+        CBlockIndex BlockFrom;
+        StakeKernelCandidate Candidate;
+    };
+
+    // Previous search of wallet - first coin and latest timestamp accepted by CheckStakeKernelHash
+    bool CheckEach(std::vector<KernelCoin>& coins, CBlockIndex& indexPrev, uint32_t nTimeTx, size_t nFrom, StakeKernelHit& hit)
+    {
+        for (size_t i = nFrom; i < coins.size(); i++)
+        {
+            for (int64_t n = 0; n < KERNEL_INTERVAL; n++)
+            {
+                uint32_t nTime = nTimeTx - (uint32_t) n;
+                if ((nTime & STAKE_TIMESTAMP_MASK) != 0)
+                    continue;
+
+                arith_uint256 hashProofOfStake, targetProofOfStake;
+                CDataStream hashProofOfStakeSource(SER_GETHASH, 0);
+                if (CheckStakeKernelHash(&indexPrev, KERNEL_BITS, coins[i].BlockFrom, coins[i].Tx, coins[i].Candidate.Prevout,
+                    nTime, hashProofOfStake, hashProofOfStakeSource, targetProofOfStake, false))
+                {
+                    hit = {i, nTime};
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+}
+
+BOOST_FIXTURE_TEST_SUITE(pocketnet_stake_kernel_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(stake_kernel_search_equals_check)
+{
+    const uint32_t nStakeMinAge = Params().GetConsensus().nStakeMinAge;
+
+    int found = 0;
+    for (int round = 0; round < 8; round++)
+    {
+        uint32_t nTimeTx = (1650000000 + (uint32_t) InsecureRandRange(100000)) & ~STAKE_TIMESTAMP_MASK;
+        int64_t maxValue = 1 + InsecureRandRange(1024);
+
+        CBlockIndex indexPrev;
+        indexPrev.nStakeModifier = g_insecure_rand_ctx.rand64();
+
+        // Coins are mature, not mature yet and younger than some of searched timestamps
+        std::vector<KernelCoin> coins(KERNEL_COINS);
+        for (auto& coin : coins)
+        {
+            coin.BlockFrom.nTime = nTimeTx - nStakeMinAge - KERNEL_INTERVAL + (uint32_t) InsecureRandRange(KERNEL_INTERVAL * 2);
+            coin.Tx = {"", (int64_t) coin.BlockFrom.nTime - (int64_t) InsecureRandRange(KERNEL_INTERVAL), 1 + (int64_t) InsecureRandRange(maxValue)};
+            if (InsecureRandRange(10) == 0)
+                coin.Tx.TxTime = nTimeTx - (uint32_t) InsecureRandRange(KERNEL_INTERVAL);
+
+            COutPoint prevout(InsecureRand256(), (uint32_t) InsecureRandRange(4));
+            BOOST_REQUIRE(BuildStakeKernelCandidate(prevout, coin.BlockFrom.nTime, coin.Tx, KERNEL_BITS, coin.Candidate));
+        }
+
+        std::vector<StakeKernelCandidate> candidates;
+        for (const auto& coin : coins)
+            candidates.push_back(coin.Candidate);
+
+        size_t nFrom = InsecureRandBool() ? 0 : InsecureRandRange(KERNEL_COINS);
+
+        StakeKernelHit expected{0, 0};
+        bool expectedFound = CheckEach(coins, indexPrev, nTimeTx, nFrom, expected);
+        found += expectedFound;
+
+        // Single thread and ranges of candidates split across threads
+        for (int threads : {1, 4})
+        {
+            StakeKernelHit hit{0, 0};
+            bool hitFound = SearchStakeKernel(candidates, indexPrev.nStakeModifier, nTimeTx, KERNEL_INTERVAL, threads, nFrom, hit);
+
+            BOOST_CHECK_EQUAL(hitFound, expectedFound);
+            if (hitFound && expectedFound)
+            {
+                BOOST_CHECK_EQUAL(hit.Index, expected.Index);
+                BOOST_CHECK_EQUAL(hit.Time, expected.Time);
+            }
+        }
+    }
+
+    // Random rounds must exercise the hit path
+    BOOST_CHECK(found > 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
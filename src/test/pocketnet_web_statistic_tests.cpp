@@ -0,0 +1,231 @@
+// Copyright (c) 2022 The Pocketcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <test/util/setup_common.h>
+#include <tinyformat.h>
+#include "pocketdb/pocketnet.h"
+#include "pocketdb/repositories/web/WebRepository.h"
+
+#include <map>
+#include <set>
+
+#include <boost/test/unit_test.hpp>
+
+using namespace PocketDb;
+
+namespace
+{
+    void Exec(const std::string& sql)
+    {
+        char* error = nullptr;
+        int res = sqlite3_exec(SQLiteDbInst.m_db, sql.c_str(), nullptr, nullptr, &error);
+        BOOST_REQUIRE_MESSAGE(res == SQLITE_OK, sql + ": " + (error ? error : ""));
+    }
+
+    std::set<std::string> AccountStatistic()
+    {
+        std::set<std::string> result;
+        sqlite3_exec(SQLiteDbInst.m_db, "select AccountRegId, Type, Data from web.AccountStatistic",
+            [](void* data, int argc, char** argv, char**) {
+                std::string row;
+                for (int i = 0; i < argc; i++)
+                    row += std::string(argv[i] ? argv[i] : "null") + ";";
+                static_cast<std::set<std::string>*>(data)->insert(row);
+                return 0;
+            }, &result, nullptr);
+        return result;
+    }
+
+    // Social transactions of random accounts written to the main tables the way block indexing does
+    struct ChainGenerator
+    {
+        struct Content { int64_t Author; int64_t LastTx; int Type; int64_t Uid; };
+
+        int64_t NextId = 1000;
+        int64_t NextUid = 0;
+        std::map<int64_t, std::pair<int64_t, int>> Accounts;
+        std::map<int64_t, Content> Contents;
+        std::map<std::pair<int64_t, int64_t>, int64_t> Subscribes;
+        std::map<int64_t, int64_t> ContentRatings;
+
+        int Height = 0;
+        int BlockNum = 0;
+        int64_t BlockId = 0;
+
+        int64_t Tx(int type, int64_t regId1, std::optional<int64_t> regId2 = {}, std::optional<int64_t> regId3 = {},
+            std::optional<int64_t> int1 = {}, std::optional<int64_t> uid = {}, std::optional<int64_t> id = {})
+        {
+            auto str = [](const std::optional<int64_t>& v) { return v ? std::to_string(*v) : std::string("null"); };
+
+            int64_t txId = id ? *id : ++NextId;
+            Exec(strprintf("insert into Transactions (RowId, Type, Time, RegId1, RegId2, RegId3, Int1) values (%d, %d, %d, %d, %s, %s, %s)",
+                txId, type, Height, regId1, str(regId2), str(regId3), str(int1)));
+            Exec(strprintf("insert into Chain (TxId, BlockId, BlockNum, Height, Uid) values (%d, %d, %d, %d, %s)",
+                txId, BlockId, ++BlockNum, Height, str(uid)));
+            return txId;
+        }
+
+        void SetLast(int64_t prevTx, int64_t txId)
+        {
+            if (prevTx)
+                Exec(strprintf("delete from Last where TxId = %d", prevTx));
+            Exec(strprintf("insert into Last (TxId) values (%d)", txId));
+        }
+
+        std::string Block(int height)
+        {
+            Height = height;
+            BlockNum = 0;
+            BlockId = ++NextId;
+            auto hash = strprintf("block%d", height);
+            Exec(strprintf("insert into Registry (RowId, String) values (%d, '%s')", BlockId, hash));
+
+            int count = InsecureRandRange(7);
+            for (int i = 0; i < count; i++)
+                Action(1 + InsecureRandRange(8));
+
+            return hash;
+        }
+
+        void Action(int64_t address)
+        {
+            int action = InsecureRandRange(100);
+            bool registered = Accounts.count(address) && Accounts[address].second == 100;
+
+            // Registration, re-registration after delete and delete of account
+            if (!registered || action < 7)
+            {
+                int type = registered ? 170 : 100;
+                auto txId = Tx(type, address);
+                if (!Accounts.count(address))
+                    Exec(strprintf("insert into First (TxId) values (%d)", txId));
+                SetLast(Accounts.count(address) ? Accounts[address].first : 0, txId);
+                Accounts[address] = {txId, type};
+                return;
+            }
+
+            // New content, edit or delete of own content
+            if (action < 30)
+            {
+                std::vector<int64_t> own;
+                for (const auto& [root, content] : Contents)
+                    if (content.Author == address && content.Type != 207)
+                        own.push_back(root);
+
+                if (!own.empty() && InsecureRandRange(10) < 4)
+                {
+                    auto root = own[InsecureRandRange(own.size())];
+                    auto& content = Contents[root];
+                    int type = InsecureRandBool() ? 207 : content.Type;
+                    auto txId = Tx(type, address, root, {}, {}, content.Uid);
+                    SetLast(content.LastTx, txId);
+                    content.LastTx = txId;
+                    content.Type = type;
+                    return;
+                }
+
+                int types[] = {200, 201, 211};
+                int type = types[InsecureRandRange(3)];
+                auto root = ++NextId;
+                Tx(type, address, root, {}, {}, ++NextUid, root);
+                Exec(strprintf("insert into First (TxId) values (%d)", root));
+                SetLast(0, root);
+                Contents[root] = {address, root, type, NextUid};
+                return;
+            }
+
+            // Subscribe, private subscribe and unsubscribe
+            if (action < 55)
+            {
+                int64_t target = 1 + InsecureRandRange(8);
+                if (target == address)
+                    return;
+
+                int types[] = {302, 303, 304};
+                auto txId = Tx(types[InsecureRandRange(3)], address, target);
+                SetLast(Subscribes[{address, target}], txId);
+                Subscribes[{address, target}] = txId;
+                return;
+            }
+
+            std::vector<int64_t> live;
+            for (const auto& [root, content] : Contents)
+                if (content.Type != 207 && content.Author != address)
+                    live.push_back(root);
+
+            if (live.empty())
+                return;
+
+            auto root = live[InsecureRandRange(live.size())];
+            auto& content = Contents[root];
+
+            // Moderation flag
+            if (action < 70)
+            {
+                Tx(410, address, root, content.Author, 1 + InsecureRandRange(3));
+                return;
+            }
+
+            // Content score with rating of content
+            if (action < 90)
+            {
+                int64_t value = 1 + InsecureRandRange(5);
+                Tx(300, address, root, {}, value);
+
+                auto& rating = ContentRatings[content.Uid];
+                rating += value - 3;
+                Exec(strprintf("update Ratings set Last = 0 where Type = 2 and Uid = %d", content.Uid));
+                Exec(strprintf("insert into Ratings (Type, Last, Height, Uid, Value) values (2, 1, %d, %d, %d)", Height, content.Uid, rating));
+                return;
+            }
+
+            // Other actions counted only in ActionsCount
+            int types[] = {204, 301, 305};
+            Tx(types[InsecureRandRange(3)], address, root);
+        }
+    };
+}
+
+BOOST_FIXTURE_TEST_SUITE(pocketnet_web_statistic_tests, TestingSetup)
+
+BOOST_AUTO_TEST_CASE(account_statistic_incremental_equals_full)
+{
+    WebRepository repo(SQLiteDbInst, false);
+    ChainGenerator chain;
+
+    const int height = 120;
+    for (int h = 1; h <= height; h++)
+    {
+        auto hash = chain.Block(h);
+
+        auto before = AccountStatistic();
+        BOOST_REQUIRE(repo.UpdateAccountStatistic(h, hash));
+
+        // Last block is restored from journal and applied again
+        if (h == height)
+        {
+            auto after = AccountStatistic();
+            BOOST_CHECK(repo.RollbackAccountStatistic(h));
+            BOOST_CHECK(AccountStatistic() == before);
+            BOOST_CHECK(repo.UpdateAccountStatistic(h, hash));
+            BOOST_CHECK(AccountStatistic() == after);
+        }
+    }
+
+    // Block not committed to the main database is not applied
+    BOOST_CHECK(!repo.UpdateAccountStatistic(height + 1, "unknown"));
+
+    auto incremental = AccountStatistic();
+    BOOST_CHECK(!incremental.empty());
+
+    repo.CollectAccountStatistic();
+    BOOST_CHECK(AccountStatistic() == incremental);
+
+    // Blocks included in full recompute are not restored from journal
+    BOOST_CHECK_EQUAL(repo.RepairAccountStatistic(), height);
+    BOOST_CHECK(!repo.RollbackAccountStatistic(height));
+    BOOST_CHECK(AccountStatistic() == incremental);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -22,6 +22,7 @@
 #include <index/txindex.h>
 
 #include "pocketdb/pocketnet.h"
+#include "pocketdb/services/MempoolMirror.h"
 
 CTxMemPoolEntry::CTxMemPoolEntry(const CTransactionRef& _tx, const CAmount& _nFee,
                                  int64_t _nTime, unsigned int _entryHeight,
@@ -424,7 +425,7 @@ void CTxMemPool::addUnchecked(const CTxMemPoolEntry& entry, setEntries& setAnces
     indexed_transaction_set::iterator newit = mapTx.insert(entry).first;
 
     // Accept in SQL Mempool
-    PocketDb::TransRepoInst.MempoolInsert(entry.GetTx().GetHash().ToString());
+    PocketServices::MempoolMirrorInst.Insert(entry.GetTx().GetHash().ToString());
 
     // Update transaction for any feeDelta created by PrioritiseTransaction
     // TODO: refactor so that the fee delta is calculated before inserting
@@ -510,13 +511,13 @@ void CTxMemPool::removeUnchecked(txiter it, MemPoolRemovalReason reason)
     mapTx.erase(it);
 
     // Remove from SQL Mempool
-    PocketDb::TransRepoInst.MempoolRemove(hash.ToString());
+    PocketServices::MempoolMirrorInst.Remove(hash.ToString());
     LogPrint(BCLog::MEMPOOL, "SQL MempoolRemove: %s - Reason: %s\n", hash.ToString(), ReasonToString(reason));
 
     // For some situations, you also need to clear the sql transaction
     if (reason == MemPoolRemovalReason::CONFLICT)
     {
-        PocketDb::TransRepoInst.RemoveTransaction(hash.ToString());
+        PocketServices::MempoolMirrorInst.RemoveTransaction(hash.ToString());
         LogPrint(BCLog::MEMPOOL, "SQL RemoveTransaction: %s - Reason: %s\n", hash.ToString(), ReasonToString(reason));
     }
 
@@ -697,7 +698,7 @@ void CTxMemPool::_clear()
     mapTx.clear();
     mapNextTx.clear();
     // Clean SQL Mempool
-    PocketDb::TransRepoInst.MempoolClear();
+    PocketServices::MempoolMirrorInst.Clear();
     totalTxSize = 0;
     cachedInnerUsage = 0;
     lastRollingFeeUpdate = GetTime();
@@ -58,7 +58,10 @@
 
 #include "pocketdb/services/ChainPostProcessing.h"
 #include "pocketdb/services/Accessor.h"
+#include "pocketdb/services/MempoolMirror.h"
+#include "pocketdb/pocketnet.h"
 #include "pocketdb/consensus/Helper.h"
+#include "pocketdb/consensus/PayloadCheckQueue.h"
 
 std::unordered_map<std::string, int> pocketProcessed;
 
@@ -1041,6 +1044,11 @@ bool MemPoolAccept::Finalize(ATMPArgs& args, Workspace& ws)
 
     // Restore and validate pocketnet part
     PTransactionRef _pocketTx = pocketTx;
+
+    // Queued removal of the same transaction must not delete payload checked and written below.
+    // Mempool table is flushed by consensus right before mempool limits are counted.
+    if (PocketServices::MempoolMirrorInst.Pending(hash.GetHex()))
+        PocketServices::MempoolMirrorInst.Flush();
     if (!_pocketTx && !PocketDb::TransRepoInst.Exists(tx.GetHash().GetHex()))
     {
         // Try deserialize transaction
@@ -2507,6 +2515,7 @@ bool CChainState::ConnectBlock(const CBlock& block, const PocketBlockRef& pocket
         try
         {
             PocketServices::ChainPostProcessing::Index(block, pindex->nHeight);
+            PocketServices::ChainPostProcessing::GroupCommit(pindex->nHeight, IsInitialBlockDownload());
         }
         catch (const std::exception& e)
         {
@@ -2641,6 +2650,17 @@ bool CChainState::FlushStateToDisk(
             if (!CheckDiskSpace(GetBlocksDir())) {
                 return AbortNode(state, "Disk space is too low!", _("Disk space is too low!"));
             }
+            {
+                LOG_TIME_MILLIS_WITH_CATEGORY("write pocket group commit to disk", BCLog::BENCH);
+
+                // Pocket data of all blocks referenced by the block index must be durable first,
+                // so after a crash pocket database is never behind the chainstate
+                try {
+                    PocketDb::SQLiteDbInst.CommitBatch();
+                } catch (const std::exception& e) {
+                    return AbortNode(state, strprintf("Failed to commit pocket database: %s", e.what()));
+                }
+            }
             {
                 LOG_TIME_MILLIS_WITH_CATEGORY("write block and undo data to disk", BCLog::BENCH);
 
@@ -3022,7 +3042,9 @@ bool CChainState::ConnectTip(BlockValidationState& state, const CChainParams& ch
     uint256 _block_hash = blockConnecting.GetHash();
     std::string _block_hash_str = _block_hash.GetHex();
 
-    NotifyWSClients(blockConnecting, pindexNew);
+    NotifyWSClients(blockConnecting, pocketBlock, pindexNew);
+    // Heights of open group commit batch are not readable by web processor connections yet
+    PocketServices::WebPostProcessorInst.Notify(PocketDb::SQLiteDbInst.VisibleHeight(pindexNew->nHeight));
 
     LogPrint(BCLog::SYNC, "+++ Block connected to chain: %d BH: %s\n", pindexNew->nHeight,
         pindexNew->GetBlockHash().GetHex());
@@ -3032,10 +3054,10 @@ bool CChainState::ConnectTip(BlockValidationState& state, const CChainParams& ch
 }
 
 typedef std::map<std::string, std::string> custom_fields;
-void CChainState::NotifyWSClients(const CBlock& block, CBlockIndex* blockIndex)
+void CChainState::NotifyWSClients(const CBlock& block, const PocketBlockRef& pocketBlock, CBlockIndex* blockIndex)
 {
     if (notifyClientsQueue) {
-        notifyClientsQueue->Add({block, blockIndex});
+        notifyClientsQueue->Add({block, blockIndex, pocketBlock});
     }
 }
 
@@ -4446,7 +4468,12 @@ bool ChainstateManager::ProcessNewBlock(BlockValidationState& state, const CChai
             if (_pindex)
                 checkHeight = _pindex->nHeight;
 
-            if (auto[ok, result] = PocketConsensus::SocialConsensusHelper::Check(*pblock, pocketBlock, checkHeight); !ok)
+            // Payload of downloaded block may be already checked on PayloadCheckQueue workers
+            if (PocketConsensus::PayloadCheckQueueInst.TakeChecked(pblock->GetHash(), checkHeight, pocketBlock))
+            {
+                LogPrint(BCLog::CONSENSUS, "    Block payload checked ahead: Height: %d BH: %s\n", checkHeight, hash);
+            }
+            else if (auto[ok, result] = PocketConsensus::SocialConsensusHelper::Check(*pblock, pocketBlock, checkHeight); !ok)
             {
                 if (_pindex)
                     _pindex->nStatus &= ~BLOCK_HAVE_DATA;
@@ -4480,6 +4507,7 @@ bool ChainstateManager::ProcessNewBlock(BlockValidationState& state, const CChai
         {
             try
             {
+                PocketServices::MempoolMirrorInst.Flush();
                 PocketDb::TransRepoInst.InsertTransactions(*pocketBlock);
                 pocketProcessed.emplace(hash, pindex->nHeight);
             }
@@ -4882,7 +4910,9 @@ void CChainState::LoadMempool(const ArgsManager& args)
         LOCK(cs_main);
         LOCK(m_mempool.cs);
         LogPrintf("Clean SQL mempool..\n");
-        PocketDb::TransRepoInst.MempoolClear();
+        // Ordered after pending mirror writes, so none of them is applied after the clear
+        PocketServices::MempoolMirrorInst.Clear();
+        PocketServices::MempoolMirrorInst.Flush();
     }
 
     m_mempool.SetIsLoaded(!ShutdownRequested());
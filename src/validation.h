@@ -25,7 +25,6 @@
 #include <txdb.h>
 #include <versionbits.h>
 #include <serialize.h>
-#include <protectedmap.h>
 
 #include <atomic>
 #include <map>
@@ -40,12 +39,21 @@
 #include <boost/thread/mutex.hpp>
 
 #include "websocket/ws.h"
+#include "websocket/wsconnections.h"
 #include "pocketdb/helpers/TransactionHelper.h"
 using namespace PocketHelpers;
 extern std::unordered_map<std::string, int> pocketProcessed;
 
-extern std::shared_ptr<Queue<std::pair<CBlock, CBlockIndex*>>> notifyClientsQueue;
-extern std::shared_ptr<ProtectedMap<std::string, WSUser>> WSConnections;
+// Connected block for websocket notifications, payload of block is already parsed by ConnectTip
+struct NotifyBlockEntry
+{
+    CBlock Block;
+    CBlockIndex* Index;
+    PocketBlockRef PocketBlock;
+};
+
+extern std::shared_ptr<Queue<NotifyBlockEntry>> notifyClientsQueue;
+extern std::shared_ptr<WSConnectionRegistry> WSConnections;
 
 class CChainState;
 class BlockValidationState;
@@ -768,7 +776,7 @@ private:
     bool ActivateBestChainStep(BlockValidationState& state, const CChainParams& chainparams, CBlockIndex* pindexMostWork, const std::shared_ptr<const CBlock>& pblock, const std::shared_ptr<PocketHelpers::PocketBlock>& pocketBlock, bool& fInvalidFound, ConnectTrace& connectTrace) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_mempool.cs);
     bool ConnectTip(BlockValidationState& state, const CChainParams& chainparams, CBlockIndex* pindexNew, const std::shared_ptr<const CBlock>& pblock, const std::shared_ptr<PocketHelpers::PocketBlock>& pocketBlockPart, ConnectTrace& connectTrace, DisconnectedBlockTransactions& disconnectpool) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_mempool.cs);
 
-    void NotifyWSClients(const CBlock& block, CBlockIndex* blockIndex);
+    void NotifyWSClients(const CBlock& block, const PocketBlockRef& pocketBlock, CBlockIndex* blockIndex);
 
     CBlockIndex* FindMostWorkChain() EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     void ReceivedBlockTransactions(const CBlock& block, CBlockIndex* pindexNew, const FlatFilePos& pos, const Consensus::Params& consensusParams) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
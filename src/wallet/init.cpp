@@ -9,6 +9,7 @@
 #include <net.h>
 #include <node/context.h>
 #include <node/ui_interface.h>
+#include <pos.h>
 #include <staker.h>
 #include <outputtype.h>
 #include <univalue.h>
@@ -46,6 +47,7 @@ void WalletInit::AddWalletOptions(ArgsManager& argsman) const
     argsman.AddArg("-disablewallet", "Do not load the wallet and disable wallet RPC calls", ArgsManager::ALLOW_ANY, OptionsCategory::WALLET);
     argsman.AddArg("-staking", "Use staking thread", ArgsManager::ALLOW_ANY, OptionsCategory::WALLET);
     argsman.AddArg("-stakingrequirespeers", strprintf("Use the staking logic only if there are peers (default: %u)", DEFAULT_STAKINGREQUIRESPEERS), ArgsManager::ALLOW_ANY, OptionsCategory::WALLET);
+    argsman.AddArg("-stakingkernelthreads=<n>", strprintf("Number of threads of stake kernel search for wallets with many coins (default: %d)", DEFAULT_STAKING_KERNEL_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::WALLET);
     argsman.AddArg("-discardfee=<amt>", strprintf("The fee rate (in %s/kB) that indicates your tolerance for discarding change by adding it to the fee (default: %s). "
                                                                 "Note: An output is discarded if it is dust at this rate, but we will always discard up to the dust relay fee and a discard fee above that is limited by the fee estimate for the longest target",
                                                               CURRENCY_UNIT, FormatMoney(DEFAULT_DISCARD_FEE)), ArgsManager::ALLOW_ANY, OptionsCategory::WALLET);
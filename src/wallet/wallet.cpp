@@ -4827,79 +4827,89 @@ bool CWallet::CreateCoinStake(const FillableSigningProvider& keystore, unsigned
 
 	LogPrint(BCLog::STAKEMODIF, "CreateCoinStake : Selected UTXO=%d txNew.nTime=%s nSearchInterval=%ld nBits=%#010x\n", setCoins.size(), FormatISO8601DateTime(txNew.nTime), nSearchInterval, nBits);
 	
-	for (auto & pcoin : setCoins) {
-		static int nMaxStakeSearchInterval = 60;
-		bool fKernelFound = false;
-		for (unsigned int n = 0; n < fmin(nSearchInterval, (int64_t)nMaxStakeSearchInterval) && !fKernelFound && pindexPrev == ::ChainActive().Tip(); n++) {
+	static int nMaxStakeSearchInterval = 60;
 
-			// Check whether the coinstake timestamp meets protocol
-			if (((txNew.nTime - n) & STAKE_TIMESTAMP_MASK) != 0)
-			    continue;
+	std::vector<std::pair<const CWalletTx*, unsigned int>> vCoins(setCoins.begin(), setCoins.end());
+	std::vector<COutPoint> vPrevouts;
+	vPrevouts.reserve(vCoins.size());
+	for (auto & pcoin : vCoins)
+		vPrevouts.push_back(COutPoint(pcoin.first->tx->GetHash(), pcoin.second));
 
-			boost::this_thread::interruption_point();
-			// Search backward in time from the given txNew timestamp
-			// Search nSearchInterval seconds back up to nMaxStakeSearchInterval
-			COutPoint prevoutStake = COutPoint(pcoin.first->tx->GetHash(), pcoin.second);
-			int64_t nBlockTime;
+	if (!m_stake_kernels)
+		m_stake_kernels = std::make_shared<StakeKernelTable>();
 
-			if (CheckKernel(pindexPrev, nBits, txNew.nTime - n, prevoutStake, &nBlockTime, this, hashProofOfStakeSource))
-			{
-				// Found a kernel
-				LogPrint(BCLog::STAKEMODIF, "CreateCoinStake : kernel found at txNew.nTime=%d - %d sec\n", txNew.nTime, n);
-				std::vector<std::vector<unsigned char>> vSolutions;
-				CScript scriptPubKeyOut;
-				scriptPubKeyKernel = pcoin.first->tx->vout[pcoin.second].scriptPubKey;
-				TxoutType whichType = Solver(scriptPubKeyKernel, vSolutions);
-				if (whichType == TxoutType::NONSTANDARD) {
-					LogPrintf("CreateCoinStake : failed to parse kernel\n");
-					break;
-				}
+	int nKernelThreads = (int)gArgs.GetArg("-stakingkernelthreads", DEFAULT_STAKING_KERNEL_THREADS);
 
-				LogPrint(BCLog::STAKEMODIF, "CreateCoinStake : parsed kernel type=%d\n", GetTxnOutputType(whichType));
-				if (whichType != TxoutType::PUBKEY && whichType != TxoutType::PUBKEYHASH) {
-					LogPrint(BCLog::STAKEMODIF, "CreateCoinStake : no support for kernel type=\"%s\"\n", GetTxnOutputType(whichType));
-					break;  // only support pay to public key and pay to address
-				}
-				
-				if (whichType == TxoutType::PUBKEYHASH) {
-					// convert to pay to public key type
-					if (!keystore.GetKey(CKeyID(uint160(vSolutions[0])), key)) {
-						LogPrint(BCLog::STAKEMODIF, "CreateCoinStake : failed to get key for kernel type=\"%s\"\n", GetTxnOutputType(whichType));
-						break;  // unable to find corresponding public key
-					}
-					scriptPubKeyOut << ToByteVector(key.GetPubKey()) << OP_CHECKSIG;
-				}
+	// Search nSearchInterval seconds back from txNew timestamp up to nMaxStakeSearchInterval, coins in selection order
+	StakeKernelHit hit;
+	size_t nFrom = 0;
+	while (pindexPrev == ::ChainActive().Tip() &&
+		m_stake_kernels->Search(pindexPrev, nBits, vPrevouts, txNew.nTime, std::min(nSearchInterval, (int64_t)nMaxStakeSearchInterval), nKernelThreads, nFrom, hit)) {
 
-				if (whichType == TxoutType::PUBKEY) {
-					std::vector<unsigned char>& vchPubKey = vSolutions[0];
-					if (!keystore.GetKey(CKeyID(Hash160(vchPubKey)), key)) {
-						LogPrint(BCLog::STAKEMODIF, "CreateCoinStake : failed to get key for kernel type=\"%s\"\n", GetTxnOutputType(whichType));
-						break;  // unable to find corresponding public key
-					}
+		boost::this_thread::interruption_point();
 
-					if (key.GetPubKey() != CPubKey(vchPubKey)) {
-						LogPrint(BCLog::STAKEMODIF, "CreateCoinStake : invalid key for kernel type=\"%s\"\n", GetTxnOutputType(whichType));
-						break; // keys mismatch
-					}
+		// Coins not usable as kernel are skipped, search continues from the next one
+		nFrom = hit.Index + 1;
 
-					scriptPubKeyOut = scriptPubKeyKernel;
-				}
+		auto & pcoin = vCoins[hit.Index];
+		unsigned int n = txNew.nTime - hit.Time;
+		int64_t nBlockTime;
+
+		// Full check of found kernel, also fills hashProofOfStakeSource
+		if (!CheckKernel(pindexPrev, nBits, hit.Time, vPrevouts[hit.Index], &nBlockTime, this, hashProofOfStakeSource)) {
+			LogPrintf("CreateCoinStake : kernel candidate %s rejected by CheckKernel\n", vPrevouts[hit.Index].ToString());
+			continue;
+		}
+
+		// Found a kernel
+		LogPrint(BCLog::STAKEMODIF, "CreateCoinStake : kernel found at txNew.nTime=%d - %d sec\n", txNew.nTime, n);
+		std::vector<std::vector<unsigned char>> vSolutions;
+		CScript scriptPubKeyOut;
+		scriptPubKeyKernel = pcoin.first->tx->vout[pcoin.second].scriptPubKey;
+		TxoutType whichType = Solver(scriptPubKeyKernel, vSolutions);
+		if (whichType == TxoutType::NONSTANDARD) {
+			LogPrintf("CreateCoinStake : failed to parse kernel\n");
+			continue;
+		}
 
-				txNew.nTime -= n;
-				txNew.vin.push_back(CTxIn(pcoin.first->tx->GetHash(), pcoin.second));
-				nCredit += pcoin.first->tx->vout[pcoin.second].nValue;
-				vwtxPrev.insert(std::make_pair(pcoin.first, pcoin.second));
-				txNew.vout.push_back(CTxOut(0, scriptPubKeyOut));
+		LogPrint(BCLog::STAKEMODIF, "CreateCoinStake : parsed kernel type=%d\n", GetTxnOutputType(whichType));
+		if (whichType != TxoutType::PUBKEY && whichType != TxoutType::PUBKEYHASH) {
+			LogPrint(BCLog::STAKEMODIF, "CreateCoinStake : no support for kernel type=\"%s\"\n", GetTxnOutputType(whichType));
+			continue;  // only support pay to public key and pay to address
+		}
 
-				LogPrint(BCLog::STAKEMODIF, "CreateCoinStake : added kernel type=%d, chained tx value=%ld, tx time=%s\n", GetTxnOutputType(whichType), pcoin.first->tx->vout[pcoin.second].nValue, FormatISO8601DateTime(pcoin.first->tx->nTime));
-				fKernelFound = true;
-				break;
+		if (whichType == TxoutType::PUBKEYHASH) {
+			// convert to pay to public key type
+			if (!keystore.GetKey(CKeyID(uint160(vSolutions[0])), key)) {
+				LogPrint(BCLog::STAKEMODIF, "CreateCoinStake : failed to get key for kernel type=\"%s\"\n", GetTxnOutputType(whichType));
+				continue;  // unable to find corresponding public key
 			}
+			scriptPubKeyOut << ToByteVector(key.GetPubKey()) << OP_CHECKSIG;
 		}
 
-		if (fKernelFound) {
-			break; // if kernel is found stop searching
+		if (whichType == TxoutType::PUBKEY) {
+			std::vector<unsigned char>& vchPubKey = vSolutions[0];
+			if (!keystore.GetKey(CKeyID(Hash160(vchPubKey)), key)) {
+				LogPrint(BCLog::STAKEMODIF, "CreateCoinStake : failed to get key for kernel type=\"%s\"\n", GetTxnOutputType(whichType));
+				continue;  // unable to find corresponding public key
+			}
+
+			if (key.GetPubKey() != CPubKey(vchPubKey)) {
+				LogPrint(BCLog::STAKEMODIF, "CreateCoinStake : invalid key for kernel type=\"%s\"\n", GetTxnOutputType(whichType));
+				continue; // keys mismatch
+			}
+
+			scriptPubKeyOut = scriptPubKeyKernel;
 		}
+
+		txNew.nTime -= n;
+		txNew.vin.push_back(CTxIn(pcoin.first->tx->GetHash(), pcoin.second));
+		nCredit += pcoin.first->tx->vout[pcoin.second].nValue;
+		vwtxPrev.insert(std::make_pair(pcoin.first, pcoin.second));
+		txNew.vout.push_back(CTxOut(0, scriptPubKeyOut));
+
+		LogPrint(BCLog::STAKEMODIF, "CreateCoinStake : added kernel type=%d, chained tx value=%ld, tx time=%s\n", GetTxnOutputType(whichType), pcoin.first->tx->vout[pcoin.second].nValue, FormatISO8601DateTime(pcoin.first->tx->nTime));
+		break; // if kernel is found stop searching
 	}
 
 	if (nCredit == 0 || nCredit > nBalance) {
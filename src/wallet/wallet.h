@@ -103,6 +103,7 @@ class CCoinControl;
 class COutput;
 class CScript;
 class CWalletTx;
+class StakeKernelTable;
 struct FeeCalculation;
 enum class FeeEstimateMode;
 class ReserveDestination;
@@ -740,6 +741,8 @@ private:
     bool CreateTransactionInternal(const std::vector<CRecipient>& vecSend, CTransactionRef& tx, CAmount& nFeeRet, int& nChangePosInOut, bilingual_str& error, const CCoinControl& coin_control, FeeCalculation& fee_calc_out, bool sign);
 
     uint64_t nLastCoinStakeSearchTime=0;
+    // Kernel candidates of staking coins, reused until tip changes
+    std::shared_ptr<StakeKernelTable> m_stake_kernels;
 
 public:
     /*
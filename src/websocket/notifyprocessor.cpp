@@ -4,8 +4,18 @@
 #include "primitives/block.h"
 #include "pocketdb/pocketnet.h"
 
+// Connected addresses in one query of subscribed content counters
+static const size_t MAX_NOTIFY_ADDRESSES_QUERY = 1000;
 
-NotifyBlockProcessor::NotifyBlockProcessor(std::shared_ptr<ProtectedMap<std::string, WSUser>> WSConnections) 
+static std::shared_ptr<SimpleWeb::OutMessage> Serialize(const UniValue& msg)
+{
+    auto out = std::make_shared<SimpleWeb::OutMessage>();
+    *out << msg.write();
+    return out;
+}
+
+
+NotifyBlockProcessor::NotifyBlockProcessor(std::shared_ptr<WSConnectionRegistry> WSConnections)
 {
     m_WSConnections = std::move(WSConnections);
 
@@ -45,147 +55,203 @@ void NotifyBlockProcessor::PrepareWSMessage(std::map<std::string, std::vector<Un
     messages[addrTo].push_back(msg);
 }
 
-void NotifyBlockProcessor::Process(std::pair<CBlock, CBlockIndex*> entry)
+std::string NotifyBlockProcessor::GetOpType(PocketTx::TxType type)
 {
-    if (m_WSConnections->empty()) {
-        return;
+    switch (type)
+    {
+        case PocketTx::CONTENT_POST: return "share";
+        case PocketTx::CONTENT_VIDEO: return "video";
+        case PocketTx::CONTENT_ARTICLE: return "article";
+        case PocketTx::CONTENT_STREAM: return "stream";
+        case PocketTx::CONTENT_AUDIO: return "audio";
+        case PocketTx::BOOST_CONTENT: return "contentBoost";
+        case PocketTx::ACTION_SCORE_CONTENT: return "upvoteShare";
+        case PocketTx::ACTION_SUBSCRIBE: return "subscribe";
+        case PocketTx::ACTION_SUBSCRIBE_PRIVATE: return "subscribePrivate";
+        case PocketTx::ACCOUNT_USER: return "userInfo";
+        case PocketTx::ACTION_SUBSCRIBE_CANCEL: return "unsubscribe";
+        case PocketTx::ACTION_SCORE_COMMENT: return "cScore";
+        case PocketTx::CONTENT_COMMENT: return "comment";
+        case PocketTx::CONTENT_COMMENT_EDIT: return "commentEdit";
+        case PocketTx::CONTENT_COMMENT_DELETE: return "commentDelete";
+        default: return "";
     }
+}
 
-    const auto& block = entry.first;
-    auto blockIndex = entry.second;
-    auto blockHeight = blockIndex->nHeight;
-    std::map<std::string, std::vector<UniValue>> messages;
-    uint256 _block_hash = block.GetHash();
-    // vtx[1] - always staking transaction
-    string _block_stake_txHash = (block.IsProofOfStake() && block.vtx.size() > 1) ? block.vtx[1]->GetHash().GetHex() : "";
-
-    int sharesCnt = 0;
-    std::map<std::string, std::map<std::string, int>> contentLangCnt;
-    // TODO: Notification from POCKETNET_TEAM
-    // std::string txidpocketnet;
-    // std::string addrespocketnet = (Params().NetworkIDString() == CBaseChainParams::MAIN) ? "PEj7QNjKdDPqE9kMDRboKoCtp8V6vZeZPd" : "TAqR1ncH95eq9XKSDRR18DtpXqktxh74UU";
-    // auto pocketnetaccinfo = notifierRepoInst->GetAccountInfoByAddress(addrespocketnet);
-
-    for (const auto& tx : block.vtx) {
-        std::map<std::string, std::pair<int, int64_t>> addrs;
-        int64_t txtime = tx->nTime;
-        std::string txid = tx->GetHash().GetHex();
-        std::string optype;
-
-        // Get all addresses from tx outs and check OP_RETURN
-        for (size_t i = 0; i < tx->vout.size(); i++) {
-            const CTxOut& txout = tx->vout[i];
-            
-            try
-            {
-                if (txout.scriptPubKey[0] == OP_RETURN) {
-                    std::string asmstr = ScriptToAsmStr(txout.scriptPubKey);
-                    std::vector<std::string> spl;
-                    boost::split(spl, asmstr, boost::is_any_of("\t "));
-                    if (spl.size() >= 3) {
-                        if (spl[1] == OR_POST) {
-                            optype = "share";
-                            sharesCnt += 1;
-
-                            auto response = notifierRepoInst->GetPostLang(txid);
-
-                            if (response.exists("lang"))
-                            {
-                                std::string lang = response["lang"].get_str();
-
-                                contentLangCnt[OR_POST][lang] += 1;
-                            }
-                        }
-                        else if (spl[1] == OR_VIDEO) {
-                            optype = "video";
-                            sharesCnt += 1;
-
-                            auto response = notifierRepoInst->GetPostLang(txid);
-
-                            if (response.exists("lang"))
-                            {
-                                std::string lang = response["lang"].get_str();
+// Post edits share type with posts and differ by OP_RETURN, other content edits keep the root tx hash
+bool NotifyBlockProcessor::IsContentEdit(const CTransactionRef& tx, const PTransactionRef& ptx, PocketTx::TxType type)
+{
+    if (ptx && ptx->GetHash() && ptx->GetString2() && *ptx->GetString2() != *ptx->GetHash())
+        return true;
 
-                                contentLangCnt[OR_VIDEO][lang] += 1;
-                            }
-                        }
-                        else if (spl[1] == OR_ARTICLE) {
-                            optype = "article";
-                            sharesCnt += 1;
+    if (type != PocketTx::CONTENT_POST)
+        return false;
 
-                            auto response = notifierRepoInst->GetPostLang(txid);
+    std::vector<std::string> vasm;
+    return TransactionHelper::ParseAsmType(tx, vasm) == OR_POSTEDIT;
+}
 
-                            if (response.exists("lang"))
-                            {
-                                std::string lang = response["lang"].get_str();
+NotifyBlockData NotifyBlockProcessor::PrepareBlock(const NotifyBlockEntry& entry)
+{
+    NotifyBlockData data;
+    data.Txs.reserve(entry.Block.vtx.size());
 
-                                contentLangCnt[OR_ARTICLE][lang] += 1;
-                            }
-                        }
-                        else if (spl[1] == OR_STREAM) {
-                            optype = "stream";
-                            sharesCnt += 1;
+    std::unordered_map<std::string, PTransactionRef> pocketTxs;
+    if (entry.PocketBlock)
+    {
+        pocketTxs.reserve(entry.PocketBlock->size());
+        for (const auto& ptx : *entry.PocketBlock)
+            if (ptx && ptx->GetHash())
+                pocketTxs.emplace(*ptx->GetHash(), ptx);
+    }
 
-                            auto response = notifierRepoInst->GetPostLang(txid);
+    for (const auto& tx : entry.Block.vtx) {
+        NotifyTx& ntx = data.Txs.emplace_back();
+        ntx.Time = tx->nTime;
+        ntx.Txid = tx->GetHash().GetHex();
 
-                            if (response.exists("lang"))
-                            {
-                                std::string lang = response["lang"].get_str();
+        PTransactionRef ptx;
+        TxType txType = TxType::NOT_SUPPORTED;
+        if (auto it = pocketTxs.find(ntx.Txid); it != pocketTxs.end()) {
+            ptx = it->second;
+            txType = *ptx->GetType();
+        }
+        else if (!entry.PocketBlock) {
+            txType = TransactionHelper::ParseType(tx);
+        }
 
-                                contentLangCnt[OR_STREAM][lang] += 1;
-                            }
-                        }
-                        else if (spl[1] == OR_AUDIO) {
-                            optype = "audio";
-                            sharesCnt += 1;
+        // Edits of content are not notified as new content
+        bool contentEdit = false;
+        switch (txType)
+        {
+            case TxType::CONTENT_POST:
+            case TxType::CONTENT_VIDEO:
+            case TxType::CONTENT_ARTICLE:
+            case TxType::CONTENT_STREAM:
+            case TxType::CONTENT_AUDIO:
+                contentEdit = IsContentEdit(tx, ptx, txType);
+                break;
+            default:
+                break;
+        }
 
-                            auto response = notifierRepoInst->GetPostLang(txid);
+        ntx.OpType = contentEdit ? "" : GetOpType(txType);
 
-                            if (response.exists("lang"))
-                            {
-                                std::string lang = response["lang"].get_str();
-
-                                contentLangCnt[OR_AUDIO][lang] += 1;
-                            }
-                        }
-                        else if (spl[1] == OR_CONTENT_BOOST)
-                            optype = "contentBoost";
-                        else if (spl[1] == OR_SCORE)
-                            optype = "upvoteShare";
-                        else if (spl[1] == OR_SUBSCRIBE)
-                            optype = "subscribe";
-                        else if (spl[1] == OR_SUBSCRIBEPRIVATE)
-                            optype = "subscribePrivate";
-                        else if (spl[1] == OR_USERINFO)
-                            optype = "userInfo";
-                        else if (spl[1] == OR_UNSUBSCRIBE)
-                            optype = "unsubscribe";
-                        else if (spl[1] == OR_COMMENT_SCORE)
-                            optype = "cScore";
-                        else if (spl[1] == OR_COMMENT)
-                            optype = "comment";
-                        else if (spl[1] == OR_COMMENT_EDIT)
-                            optype = "commentEdit";
-                        else if (spl[1] == OR_COMMENT_DELETE)
-                            optype = "commentDelete";
-                    }
-                }
-            }
-            catch (const UniValue& e)
-            {
-                LogPrint(BCLog::WARN, "Exception %s\n", e.write());
-            }
+        // Get all addresses from tx outs
+        for (size_t i = 0; i < tx->vout.size(); i++) {
+            const CTxOut& txout = tx->vout[i];
 
             CTxDestination destAddress;
             bool fValidAddress = ExtractDestination(txout.scriptPubKey, destAddress);
             if (fValidAddress) {
                 std::string encoded_address = EncodeDestination(destAddress);
-                if (addrs.find(encoded_address) == addrs.end())
-                    addrs.emplace(encoded_address, std::make_pair(i, (int64_t)txout.nValue));
+                if (ntx.Addrs.find(encoded_address) == ntx.Addrs.end())
+                    ntx.Addrs.emplace(encoded_address, std::make_pair(i, (int64_t)txout.nValue));
             }
         }
 
-        for (auto const& addr : addrs)
+        switch (txType)
+        {
+            case TxType::CONTENT_POST:
+            case TxType::CONTENT_VIDEO:
+            case TxType::CONTENT_ARTICLE:
+            case TxType::CONTENT_STREAM:
+            case TxType::CONTENT_AUDIO:
+                if (contentEdit)
+                    break;
+
+                data.SharesCnt += 1;
+                data.ContentHashes.push_back(ntx.Txid);
+                for (const auto& addr : ntx.Addrs)
+                    data.ContentAddresses.insert(addr.first);
+
+                // Language is String1 of content payload
+                if (ptx && ptx->HasPayload()) {
+                    if (const auto& lang = ptx->GetPayload()->GetString1(); lang)
+                        data.ContentLangCnt[txType][*lang] += 1;
+                }
+                else {
+                    data.LangHashes.emplace(ntx.Txid, txType);
+                }
+                break;
+            case TxType::BOOST_CONTENT:
+                data.BoostHashes.push_back(ntx.Txid);
+                break;
+            case TxType::ACTION_SCORE_CONTENT:
+                data.ScoreHashes.push_back(ntx.Txid);
+                break;
+            case TxType::ACTION_SUBSCRIBE:
+            case TxType::ACTION_SUBSCRIBE_PRIVATE:
+            case TxType::ACTION_SUBSCRIBE_CANCEL:
+                data.SubscribeHashes.push_back(ntx.Txid);
+                break;
+            case TxType::ACTION_SCORE_COMMENT:
+                data.CommentScoreHashes.push_back(ntx.Txid);
+                break;
+            case TxType::CONTENT_COMMENT:
+            case TxType::CONTENT_COMMENT_EDIT:
+            case TxType::CONTENT_COMMENT_DELETE:
+                data.CommentHashes.push_back(ntx.Txid);
+                break;
+            default:
+                break;
+        }
+    }
+
+    return data;
+}
+
+void NotifyBlockProcessor::Process(NotifyBlockEntry entry)
+{
+    if (m_WSConnections->empty()) {
+        return;
+    }
+
+    const auto& block = entry.Block;
+    auto blockIndex = entry.Index;
+    auto blockHeight = blockIndex->nHeight;
+    std::map<std::string, std::vector<UniValue>> messages;
+    uint256 _block_hash = block.GetHash();
+    // vtx[1] - always staking transaction
+    string _block_stake_txHash = (block.IsProofOfStake() && block.vtx.size() > 1) ? block.vtx[1]->GetHash().GetHex() : "";
+
+    auto data = PrepareBlock(entry);
+    // TODO: Notification from POCKETNET_TEAM
+    // std::string txidpocketnet;
+    // std::string addrespocketnet = (Params().NetworkIDString() == CBaseChainParams::MAIN) ? "PEj7QNjKdDPqE9kMDRboKoCtp8V6vZeZPd" : "TAqR1ncH95eq9XKSDRR18DtpXqktxh74UU";
+    // auto pocketnetaccinfo = notifierRepoInst->GetAccountInfoByAddress(addrespocketnet);
+
+    // All lookups of block - one query per kind
+    if (!data.LangHashes.empty())
+    {
+        std::vector<std::string> langHashes;
+        for (const auto& item : data.LangHashes)
+            langHashes.push_back(item.first);
+
+        for (const auto& [hash, lang] : notifierRepoInst->GetPostLangs(langHashes))
+            data.ContentLangCnt[data.LangHashes[hash]][lang] += 1;
+    }
+
+    auto postInfos = notifierRepoInst->GetPostInfos(data.ContentHashes);
+    auto reposts = notifierRepoInst->GetOriginalPostAddressesByReposts(data.ContentHashes);
+    auto privateSubscribes = notifierRepoInst->GetPrivateSubscribeAddressesByAddressesTo({data.ContentAddresses.begin(), data.ContentAddresses.end()});
+    auto boosts = notifierRepoInst->GetBoostInfos(data.BoostHashes);
+    auto scores = notifierRepoInst->GetPostInfoAddressesByScores(data.ScoreHashes);
+    auto subscribes = notifierRepoInst->GetSubscribesAddressesTo(data.SubscribeHashes);
+    auto commentScores = notifierRepoInst->GetCommentInfoAddressesByScores(data.CommentScoreHashes);
+    auto comments = notifierRepoInst->GetFullCommentInfos(data.CommentHashes);
+
+    auto find = [](const std::map<std::string, UniValue>& responses, const std::string& key) -> const UniValue* {
+        auto it = responses.find(key);
+        return it != responses.end() ? &it->second : nullptr;
+    };
+
+    for (const auto& ntx : data.Txs) {
+        const auto& txid = ntx.Txid;
+        const auto& txtime = ntx.Time;
+        const auto& optype = ntx.OpType;
+
+        for (auto const& addr : ntx.Addrs)
         {
             // Event for new transaction
             custom_fields cTrFields{
@@ -199,175 +265,176 @@ void NotifyBlockProcessor::Process(std::pair<CBlock, CBlockIndex*> entry)
             // Event for new PocketNET transaction
             if (optype == "share" || optype == "video" || optype == "article" || optype == "stream" || optype == "audio")
             {
-                auto response = notifierRepoInst->GetPostInfo(txid);
-                if (response.exists("hash") && response.exists("rootHash") && response["hash"].get_str() != response["rootHash"].get_str())
+                if (auto response = find(postInfos, txid); response && response->exists("hash") && response->exists("rootHash") && (*response)["hash"].get_str() != (*response)["rootHash"].get_str())
                     continue;
 
-                auto repostResponse = notifierRepoInst->GetOriginalPostAddressByRepost(txid);
-                if (repostResponse.exists("hash"))
+                if (auto repostResponse = find(reposts, txid); repostResponse && repostResponse->exists("hash"))
                 {
-                    std::string address = repostResponse["address"].get_str();
+                    std::string address = (*repostResponse)["address"].get_str();
 
                     custom_fields cFields
                     {
                         {"mesType",    "reshare"},
-                        {"txidRepost", repostResponse["hash"].get_str()},
-                        {"addrFrom",   repostResponse["addressRepost"].get_str()},
-                        {"nameFrom",   repostResponse["nameRepost"].get_str()}
+                        {"txidRepost", (*repostResponse)["hash"].get_str()},
+                        {"addrFrom",   (*repostResponse)["addressRepost"].get_str()},
+                        {"nameFrom",   (*repostResponse)["nameRepost"].get_str()}
                     };
-                    if (repostResponse.exists("avatarRepost"))
-                        cFields.emplace("avatarFrom",repostResponse["avatarRepost"].get_str());
+                    if (repostResponse->exists("avatarRepost"))
+                        cFields.emplace("avatarFrom",(*repostResponse)["avatarRepost"].get_str());
 
                     PrepareWSMessage(messages, "event", address, txid, txtime, cFields);
                 }
 
-                auto subscribesResponse = notifierRepoInst->GetPrivateSubscribeAddressesByAddressTo(addr.first);
-                for (size_t i = 0; i < subscribesResponse.size(); ++i)
+                if (auto subscribesResponse = find(privateSubscribes, addr.first); subscribesResponse)
                 {
-                    auto address = subscribesResponse[i]["addressTo"].get_str();
+                    for (size_t i = 0; i < subscribesResponse->size(); ++i)
+                    {
+                        const auto& subscribe = (*subscribesResponse)[i];
+                        auto address = subscribe["addressTo"].get_str();
 
-                    custom_fields cFields{
-                            {"mesType", "postfromprivate"},
-                            {"addrFrom", addr.first},
-                            {"nameFrom",   subscribesResponse[i]["nameFrom"].get_str()}
-                    };
+                        custom_fields cFields{
+                                {"mesType", "postfromprivate"},
+                                {"addrFrom", addr.first},
+                                {"nameFrom",   subscribe["nameFrom"].get_str()}
+                        };
 
-                    if (subscribesResponse[i].exists("avatarFrom"))
-                        cFields.emplace("avatarFrom",subscribesResponse[i]["avatarFrom"].get_str());
+                        if (subscribe.exists("avatarFrom"))
+                            cFields.emplace("avatarFrom",subscribe["avatarFrom"].get_str());
 
-                    PrepareWSMessage(messages, "event", address, txid, txtime, cFields);
+                        PrepareWSMessage(messages, "event", address, txid, txtime, cFields);
+                    }
                 }
             }
             else if (optype == "contentBoost")
             {
-                auto response = notifierRepoInst->GetBoostInfo(txid);
-                if (response.exists("contentHash"))
+                auto response = find(boosts, txid);
+                if (response && response->exists("contentHash"))
                 {
-                    if(response["contentAddress"].get_str() == addr.first)
+                    if((*response)["contentAddress"].get_str() == addr.first)
                         continue;
 
                     custom_fields cFields
                         {
                             {"mesType", optype},
                             {"addrFrom", addr.first},
-                            {"nameFrom", response["boostName"].get_str()},
-                            {"boostAmount", response["boostAmount"].get_str()},
-                            {"posttxid", response["contentHash"].get_str()},
+                            {"nameFrom", (*response)["boostName"].get_str()},
+                            {"boostAmount", (*response)["boostAmount"].get_str()},
+                            {"posttxid", (*response)["contentHash"].get_str()},
                             {"reason", "boost"},
                         };
 
-                    if (response.exists("boostAvatar"))
-                        cFields.emplace("avatarFrom",response["boostAvatar"].get_str());
+                    if (response->exists("boostAvatar"))
+                        cFields.emplace("avatarFrom",(*response)["boostAvatar"].get_str());
 
-                    PrepareWSMessage(messages, "event", response["contentAddress"].get_str(), txid, txtime, cFields);
+                    PrepareWSMessage(messages, "event", (*response)["contentAddress"].get_str(), txid, txtime, cFields);
                 }
             }
             else if (optype == "upvoteShare")
             {
-                auto response = notifierRepoInst->GetPostInfoAddressByScore(txid);
-                if (response.exists("postTxHash"))
+                auto response = find(scores, txid);
+                if (response && response->exists("postTxHash"))
                 {
                     custom_fields cFields
                     {
                         {"mesType", optype},
                         {"addrFrom", addr.first},
-                        {"nameFrom", response["scoreName"].get_str()},
-                        {"posttxid", response["postTxHash"].get_str()},
-                        {"upvoteVal", response["value"].get_str()}
+                        {"nameFrom", (*response)["scoreName"].get_str()},
+                        {"posttxid", (*response)["postTxHash"].get_str()},
+                        {"upvoteVal", (*response)["value"].get_str()}
                     };
 
-                    if (response.exists("scoreAvatar"))
-                        cFields.emplace("avatarFrom",response["scoreAvatar"].get_str());
+                    if (response->exists("scoreAvatar"))
+                        cFields.emplace("avatarFrom",(*response)["scoreAvatar"].get_str());
 
-                    PrepareWSMessage(messages, "event", response["postAddress"].get_str(), txid, txtime, cFields);
+                    PrepareWSMessage(messages, "event", (*response)["postAddress"].get_str(), txid, txtime, cFields);
                 }
             }
             else if (optype == "subscribe" || optype == "subscribePrivate" || optype == "unsubscribe")
             {
-                auto response = notifierRepoInst->GetSubscribeAddressTo(txid);
-                if (response.exists("addressTo"))
+                auto response = find(subscribes, txid);
+                if (response && response->exists("addressTo"))
                 {
                     custom_fields cFields
                     {
                         {"mesType", optype},
                         {"addrFrom", addr.first},
-                        {"nameFrom", response["nameFrom"].get_str()}
+                        {"nameFrom", (*response)["nameFrom"].get_str()}
                     };
 
-                    if (response.exists("avatarFrom"))
-                        cFields.emplace("avatarFrom",response["avatarFrom"].get_str());
+                    if (response->exists("avatarFrom"))
+                        cFields.emplace("avatarFrom",(*response)["avatarFrom"].get_str());
 
-                    PrepareWSMessage(messages, "event", response["addressTo"].get_str(), txid, txtime, cFields);
+                    PrepareWSMessage(messages, "event", (*response)["addressTo"].get_str(), txid, txtime, cFields);
                 }
             }
             else if (optype == "cScore")
             {
-                auto response = notifierRepoInst->GetCommentInfoAddressByScore(txid);
-                if (response.exists("commentHash"))
+                auto response = find(commentScores, txid);
+                if (response && response->exists("commentHash"))
                 {
                     custom_fields cFields
                     {
                         {"mesType", optype},
                         {"addrFrom", addr.first},
-                        {"nameFrom", response["scoreCommentName"].get_str()},
-                        {"commentid", response["commentHash"].get_str()},
-                        {"upvoteVal", response["value"].get_str()}
+                        {"nameFrom", (*response)["scoreCommentName"].get_str()},
+                        {"commentid", (*response)["commentHash"].get_str()},
+                        {"upvoteVal", (*response)["value"].get_str()}
                     };
 
-                    if (response.exists("scoreCommentAvatar"))
-                        cFields.emplace("avatarFrom",response["scoreCommentAvatar"].get_str());
+                    if (response->exists("scoreCommentAvatar"))
+                        cFields.emplace("avatarFrom",(*response)["scoreCommentAvatar"].get_str());
 
-                    PrepareWSMessage(messages, "event", response["commentAddress"].get_str(), txid, txtime, cFields);
+                    PrepareWSMessage(messages, "event", (*response)["commentAddress"].get_str(), txid, txtime, cFields);
                 }
             }
             else if (optype == "comment" || optype == "commentEdit" || optype == "commentDelete")
             {
-                auto response = notifierRepoInst->GetFullCommentInfo(txid);
-                if (response.exists("postHash"))
+                auto response = find(comments, txid);
+                if (response && response->exists("postHash"))
                 {
-                    if (response.exists("answerAddress") && !response["answerAddress"].get_str().empty())
+                    if (response->exists("answerAddress") && !(*response)["answerAddress"].get_str().empty())
                     {
                         custom_fields c1Fields
                             {
                                 {"mesType", optype},
                                 {"addrFrom", addr.first},
-                                {"nameFrom", response["commentName"].get_str()},
-                                {"posttxid", response["postHash"].get_str()},
-                                {"parentid", response["parentHash"].get_str()},
-                                {"answerid", response["answerHash"].get_str()},
+                                {"nameFrom", (*response)["commentName"].get_str()},
+                                {"posttxid", (*response)["postHash"].get_str()},
+                                {"parentid", (*response)["parentHash"].get_str()},
+                                {"answerid", (*response)["answerHash"].get_str()},
                                 {"reason", "answer"},
                             };
 
-                        if (response.exists("commentAvatar"))
-                            c1Fields.emplace("avatarFrom",response["commentAvatar"].get_str());
+                        if (response->exists("commentAvatar"))
+                            c1Fields.emplace("avatarFrom",(*response)["commentAvatar"].get_str());
 
-                        PrepareWSMessage(messages, "event", response["answerAddress"].get_str(), response["rootHash"].get_str(), txtime, c1Fields);
+                        PrepareWSMessage(messages, "event", (*response)["answerAddress"].get_str(), (*response)["rootHash"].get_str(), txtime, c1Fields);
                     }
 
-                    if(response["postAddress"].get_str() == addr.first)
+                    if((*response)["postAddress"].get_str() == addr.first)
                         continue;
 
                     custom_fields cFields
                     {
                         {"mesType", optype},
                         {"addrFrom", addr.first},
-                        {"nameFrom", response["commentName"].get_str()},
-                        {"posttxid", response["postHash"].get_str()},
-                        {"parentid", response["parentHash"].get_str()},
-                        {"answerid", response["answerHash"].get_str()},
+                        {"nameFrom", (*response)["commentName"].get_str()},
+                        {"posttxid", (*response)["postHash"].get_str()},
+                        {"parentid", (*response)["parentHash"].get_str()},
+                        {"answerid", (*response)["answerHash"].get_str()},
                         {"reason", "post"},
                     };
 
-                    if (response.exists("commentAvatar"))
-                        cFields.emplace("avatarFrom",response["commentAvatar"].get_str());
+                    if (response->exists("commentAvatar"))
+                        cFields.emplace("avatarFrom",(*response)["commentAvatar"].get_str());
 
-                    if (response.exists("donation"))
+                    if (response->exists("donation"))
                     {
                         cFields.emplace("donation", "true");
-                        cFields.emplace("amount", std::to_string(response["amount"].get_int64()));
+                        cFields.emplace("amount", std::to_string((*response)["amount"].get_int64()));
                     }
 
-                    PrepareWSMessage(messages, "event", response["postAddress"].get_str(), response["rootHash"].get_str(), txtime, cFields);
+                    PrepareWSMessage(messages, "event", (*response)["postAddress"].get_str(), (*response)["rootHash"].get_str(), txtime, cFields);
                 }
             }
         }
@@ -416,89 +483,108 @@ void NotifyBlockProcessor::Process(std::pair<CBlock, CBlockIndex*> entry)
 
     // Prepare total shares by content type and language
     UniValue contentsLang(UniValue::VOBJ);
-    for (const auto& itemContent : contentLangCnt){
+    for (const auto& itemContent : data.ContentLangCnt){
         UniValue langContents(UniValue::VOBJ);
         for (const auto& itemLang : itemContent.second) {
             langContents.pushKV(itemLang.first, itemLang.second);
         }
-        contentsLang.pushKV(TransactionHelper::TxStringType(PocketHelpers::TransactionHelper::ConvertOpReturnToType(itemContent.first)), langContents);
+        contentsLang.pushKV(TransactionHelper::TxStringType(itemContent.first), langContents);
     }
 
-    // Send all WS clients messages
-    auto send = [&](std::pair<const std::string, WSUser>& connWS) {
+    // Connections not notified about this block yet, grouped by address
+    auto recipients = m_WSConnections->Behind(blockHeight);
+    std::map<std::string, std::vector<const WSRecipient*>> recipientsByAddress;
+    for (const auto& recipient : recipients)
+        recipientsByAddress[recipient.Address].push_back(&recipient);
+
+    // Counters of subscribed content for all connected addresses
+    std::map<std::string, UniValue> subscribesCounts;
+    std::vector<std::string> connAddressesPart;
+    for (auto it = recipientsByAddress.begin(); it != recipientsByAddress.end(); )
+    {
+        connAddressesPart.push_back((it++)->first);
+        if (connAddressesPart.size() == MAX_NOTIFY_ADDRESSES_QUERY || it == recipientsByAddress.end())
+        {
+            subscribesCounts.merge(notifierRepoInst->GetPostCountsFromMySubscribes(connAddressesPart, blockHeight));
+            connAddressesPart.clear();
+        }
+    }
+
+    // TODO: Notification from POCKETNET_TEAM
+    // if (txidpocketnet != "")
+    // {
+    //     UniValue m(UniValue::VOBJ);
+    //     m.pushKV("msg", "sharepocketnet");
+    //     m.pushKV("time", std::to_string(block.nTime));
+    //     m.pushKV("addrFrom", addrespocketnet);
+    //     if (pocketnetaccinfo.exists("name")) m.pushKV("nameFrom", pocketnetaccinfo["name"].get_str());
+    //     if (pocketnetaccinfo.exists("avatar")) m.pushKV("avatarFrom", pocketnetaccinfo["avatar"].get_str());
+    //     m.pushKV("txids", txidpocketnet.substr(0, txidpocketnet.size() - 1));
+    //     addressMessages.push_back(Serialize(m));
+    // }
+
+    // Send all WS clients messages. Each message is serialized once for all connections of address
+    // and sent without registry locks.
+    int64_t nTimeSend = GetTimeMicros();
+    size_t sentMessages = 0;
+    size_t sentBytes = 0;
+
+    for (const auto& [address, connections] : recipientsByAddress)
+    {
         UniValue msg(UniValue::VOBJ);
-        msg.pushKV("addr", connWS.second.Address);
+        msg.pushKV("addr", address);
         msg.pushKV("stakeTxHash", _block_stake_txHash);
         msg.pushKV("msg", "new block");
         msg.pushKV("blockhash", _block_hash.GetHex());
         msg.pushKV("time", std::to_string(block.nTime));
-        msg.pushKV("height", blockIndex->nHeight);
-        msg.pushKV("shares", sharesCnt);
+        msg.pushKV("height", blockHeight);
+        msg.pushKV("shares", data.SharesCnt);
         msg.pushKV("contentsLang", contentsLang);
 
-        auto countResponse = notifierRepoInst->GetPostCountFromMySubscribes(connWS.second.Address, blockIndex->nHeight);
-        if (countResponse.exists("cntTotal"))
-        {
-            msg.pushKV("sharesSubscr", countResponse["cntTotal"].get_int());
+        // Addresses without subscribed content in block get zero counters
+        static const UniValue emptyCount(UniValue::VOBJ);
+        auto countResponse = find(subscribesCounts, address);
+        if (!countResponse)
+            countResponse = &emptyCount;
 
-            UniValue contentsSubscribes(UniValue::VOBJ);
-            contentsSubscribes.pushKV("share", (countResponse.exists("cntPost") ? countResponse["cntPost"].get_int() : 0));
-            contentsSubscribes.pushKV("video", (countResponse.exists("cntVideo") ? countResponse["cntVideo"].get_int() : 0));
-            contentsSubscribes.pushKV("article", (countResponse.exists("cntArticle") ? countResponse["cntArticle"].get_int() : 0));
-            contentsSubscribes.pushKV("stream", (countResponse.exists("cntStream") ? countResponse["cntStream"].get_int() : 0));
-            contentsSubscribes.pushKV("audio", (countResponse.exists("cntAudio") ? countResponse["cntAudio"].get_int() : 0));
+        msg.pushKV("sharesSubscr", (countResponse->exists("cntTotal") ? (*countResponse)["cntTotal"].get_int() : 0));
 
-            msg.pushKV("contentsSubscribes", contentsSubscribes);
-        }
+        UniValue contentsSubscribes(UniValue::VOBJ);
+        contentsSubscribes.pushKV("share", (countResponse->exists("cntPost") ? (*countResponse)["cntPost"].get_int() : 0));
+        contentsSubscribes.pushKV("video", (countResponse->exists("cntVideo") ? (*countResponse)["cntVideo"].get_int() : 0));
+        contentsSubscribes.pushKV("article", (countResponse->exists("cntArticle") ? (*countResponse)["cntArticle"].get_int() : 0));
+        contentsSubscribes.pushKV("stream", (countResponse->exists("cntStream") ? (*countResponse)["cntStream"].get_int() : 0));
+        contentsSubscribes.pushKV("audio", (countResponse->exists("cntAudio") ? (*countResponse)["cntAudio"].get_int() : 0));
 
-        if (blockIndex->nHeight > connWS.second.Block)
-        {
-            try
-            {
-                connWS.second.Connection->send(msg.write(), [](const SimpleWeb::error_code& ec) {});
-            }
-            catch (const std::exception& e)
-            {
-                LogPrintf("Error: CChainState::NotifyWSClients (1) - %s\n", e.what());
-            }
+        msg.pushKV("contentsSubscribes", contentsSubscribes);
+
+        std::vector<std::shared_ptr<SimpleWeb::OutMessage>> addressMessages{ Serialize(msg) };
+        if (auto it = messages.find(address); it != messages.end())
+            for (const auto& m : it->second)
+                addressMessages.push_back(Serialize(m));
 
-            // TODO: Notification from POCKETNET_TEAM
-            // if (txidpocketnet != "")
-            // {
-            //     try
-            //     {
-            //         UniValue m(UniValue::VOBJ);
-            //         m.pushKV("msg", "sharepocketnet");
-            //         m.pushKV("time", std::to_string(block.nTime));
-            //         m.pushKV("addrFrom", addrespocketnet);
-            //         if (pocketnetaccinfo.exists("name")) m.pushKV("nameFrom", pocketnetaccinfo["name"].get_str());
-            //         if (pocketnetaccinfo.exists("avatar")) m.pushKV("avatarFrom", pocketnetaccinfo["avatar"].get_str());
-            //         m.pushKV("txids", txidpocketnet.substr(0, txidpocketnet.size() - 1));
-            //         connWS.second.Connection->send(m.write(), [](const SimpleWeb::error_code& ec) {});
-            //     }
-            //     catch (const std::exception& e)
-            //     {
-            //         LogPrintf("Error: CChainState::NotifyWSClients (1) - %s\n", e.what());
-            //     }
-            // }
-
-            if (messages.find(connWS.second.Address) != messages.end())
+        for (const auto* connWS : connections)
+        {
+            for (const auto& m : addressMessages)
             {
-                for (auto m : messages[connWS.second.Address])
+                try
                 {
-                    try
-                    {
-                        connWS.second.Connection->send(m.write(), [](const SimpleWeb::error_code& ec) {});
-                    }
-                    catch (const std::exception& e)
-                    {
-                        LogPrintf("Error: CChainState::NotifyWSClients (2) - %s\n", e.what());
-                    }
+                    connWS->Connection->send(m, [](const SimpleWeb::error_code& ec) {});
+                    sentMessages++;
+                    sentBytes += m->size();
+                }
+                catch (const std::exception& e)
+                {
+                    LogPrintf("Error: CChainState::NotifyWSClients - %s\n", e.what());
                 }
             }
-
-            connWS.second.Block = blockIndex->nHeight;
         }
-    };
-    m_WSConnections->Iterate(send);
+    }
+
+    m_WSConnections->SetBlock(recipients, blockHeight);
+
+    int64_t latency = GetTimeMicros() - nTimeSend;
+    m_WSConnections->AddFanout(recipients.size(), sentMessages, sentBytes, latency);
+    LogPrint(BCLog::SYNC, "Websocket notify: block %d sent %d messages to %d connections in %.2fms\n",
+        blockHeight, sentMessages, recipients.size(), 0.001 * latency);
 }
@@ -2,31 +2,61 @@
 #define POCKETCOIN_NOTIFYPROCESSOR_H
 
 #include "eventloop.h"
-#include "protectedmap.h"
 #include "univalue.h"
+#include "validation.h"
 #include "websocket/ws.h"
+#include "websocket/wsconnections.h"
 
 #include "pocketdb/SQLiteDatabase.h"
 #include "pocketdb/repositories/web/NotifierRepository.h"
 
 using namespace PocketDb;
 
-class CBlock;
-class CBlockIndex;
-class WSUser;
-
 typedef std::map<std::string, std::string> custom_fields;
 
-class NotifyBlockProcessor : public IQueueProcessor<std::pair<CBlock, CBlockIndex*>>
+// Transaction of block with notification type and addresses of outputs
+struct NotifyTx
+{
+    std::string Txid;
+    int64_t Time;
+    std::string OpType;
+    // Address -> first output number and amount
+    std::map<std::string, std::pair<int, int64_t>> Addrs;
+};
+
+// Transactions of block with hashes grouped by kind of lookup, so each lookup is one query per block
+struct NotifyBlockData
+{
+    std::vector<NotifyTx> Txs;
+    int SharesCnt = 0;
+    std::map<PocketTx::TxType, std::map<std::string, int>> ContentLangCnt;
+
+    // Content without payload in PocketBlock - language is selected from db
+    std::map<std::string, PocketTx::TxType> LangHashes;
+    std::vector<std::string> ContentHashes;
+    std::set<std::string> ContentAddresses;
+    std::vector<std::string> BoostHashes;
+    std::vector<std::string> ScoreHashes;
+    std::vector<std::string> SubscribeHashes;
+    std::vector<std::string> CommentScoreHashes;
+    std::vector<std::string> CommentHashes;
+};
+
+class NotifyBlockProcessor : public IQueueProcessor<NotifyBlockEntry>
 {
 public:
-    explicit NotifyBlockProcessor(std::shared_ptr<ProtectedMap<std::string, WSUser>> WSConnections);
+    explicit NotifyBlockProcessor(std::shared_ptr<WSConnectionRegistry> WSConnections);
     ~NotifyBlockProcessor() override;
-    void Process(std::pair<CBlock, CBlockIndex*> entry) override;
+    void Process(NotifyBlockEntry entry) override;
+
+    // Types of transactions are taken from parsed PocketBlock, OP_RETURN is parsed only without it
+    static NotifyBlockData PrepareBlock(const NotifyBlockEntry& entry);
+    static std::string GetOpType(PocketTx::TxType type);
+    static bool IsContentEdit(const CTransactionRef& tx, const PTransactionRef& ptx, PocketTx::TxType type);
 
 private:
     void PrepareWSMessage(std::map<std::string, std::vector<UniValue>>& messages, std::string msg_type, std::string addrTo, std::string txid, int64_t txtime, custom_fields cFields);
-    std::shared_ptr<ProtectedMap<std::string, WSUser>> m_WSConnections;
+    std::shared_ptr<WSConnectionRegistry> m_WSConnections;
     
     SQLiteDatabaseRef sqliteDbInst;
     NotifierRepositoryRef notifierRepoInst;
@@ -0,0 +1,160 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#include "websocket/wsconnections.h"
+
+void WSConnectionRegistry::insert_or_assign(const std::string& id, const WSUser& user)
+{
+    erase(id);
+
+    auto& shard = GetShard(user.Address);
+    LOCK(shard.m_mutex);
+    shard.m_users.insert_or_assign(id, user);
+    shard.m_addresses[user.Address].insert(id);
+}
+
+void WSConnectionRegistry::erase(const std::string& id)
+{
+    for (auto& shard : m_shards)
+        if (Erase(shard, id))
+            return;
+}
+
+bool WSConnectionRegistry::empty()
+{
+    return count() == 0;
+}
+
+int WSConnectionRegistry::count()
+{
+    size_t result = 0;
+    for (auto& shard : m_shards)
+    {
+        LOCK(shard.m_mutex);
+        result += shard.m_users.size();
+    }
+
+    return (int) result;
+}
+
+void WSConnectionRegistry::Iterate(const std::function<void(const std::pair<const std::string, WSUser>&)>& func)
+{
+    for (auto& shard : m_shards)
+    {
+        LOCK(shard.m_mutex);
+        for (const auto& elem : shard.m_users)
+            func(elem);
+    }
+}
+
+std::vector<WSRecipient> WSConnectionRegistry::Find(const std::string& address)
+{
+    std::vector<WSRecipient> result;
+
+    auto& shard = GetShard(address);
+    LOCK(shard.m_mutex);
+
+    auto it = shard.m_addresses.find(address);
+    if (it == shard.m_addresses.end())
+        return result;
+
+    for (const auto& id : it->second)
+    {
+        const auto& user = shard.m_users.at(id);
+        result.push_back({id, user.Address, user.Block, user.Connection});
+    }
+
+    return result;
+}
+
+std::vector<WSRecipient> WSConnectionRegistry::Behind(int height)
+{
+    std::vector<WSRecipient> result;
+
+    for (auto& shard : m_shards)
+    {
+        LOCK(shard.m_mutex);
+        for (const auto& [id, user] : shard.m_users)
+            if (height > user.Block)
+                result.push_back({id, user.Address, user.Block, user.Connection});
+    }
+
+    return result;
+}
+
+void WSConnectionRegistry::SetBlock(const std::vector<WSRecipient>& recipients, int height)
+{
+    for (const auto& recipient : recipients)
+    {
+        auto& shard = GetShard(recipient.Address);
+        LOCK(shard.m_mutex);
+
+        // Connection can be closed or registered again during fan-out
+        if (auto it = shard.m_users.find(recipient.Id); it != shard.m_users.end() && it->second.Address == recipient.Address)
+            it->second.Block = std::max(it->second.Block, height);
+    }
+}
+
+void WSConnectionRegistry::AddFanout(size_t recipients, size_t messages, size_t bytes, int64_t latency)
+{
+    LOCK(m_stat_mutex);
+    m_fanouts++;
+    m_lastRecipients = (int64_t) recipients;
+    m_lastMessages = (int64_t) messages;
+    m_lastBytes = (int64_t) bytes;
+    m_lastLatency = latency;
+    m_maxLatency = std::max(m_maxLatency, latency);
+    m_totalLatency += latency;
+}
+
+UniValue WSConnectionRegistry::Statistic()
+{
+    size_t connections = 0;
+    size_t addresses = 0;
+    for (auto& shard : m_shards)
+    {
+        LOCK(shard.m_mutex);
+        connections += shard.m_users.size();
+        addresses += shard.m_addresses.size();
+    }
+
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("connections", (int64_t) connections);
+    result.pushKV("addresses", (int64_t) addresses);
+
+    LOCK(m_stat_mutex);
+    result.pushKV("fanouts", m_fanouts);
+    result.pushKV("lastrecipients", m_lastRecipients);
+    result.pushKV("lastmessages", m_lastMessages);
+    result.pushKV("lastbytes", m_lastBytes);
+    result.pushKV("lastlatency", m_lastLatency);
+    result.pushKV("maxlatency", m_maxLatency);
+    result.pushKV("avglatency", m_fanouts > 0 ? m_totalLatency / m_fanouts : 0);
+    return result;
+}
+
+WSConnectionRegistry::Shard& WSConnectionRegistry::GetShard(const std::string& address)
+{
+    return m_shards[std::hash<std::string>{}(address) % WS_CONNECTIONS_SHARDS];
+}
+
+bool WSConnectionRegistry::Erase(Shard& shard, const std::string& id)
+{
+    LOCK(shard.m_mutex);
+
+    auto it = shard.m_users.find(id);
+    if (it == shard.m_users.end())
+        return false;
+
+    auto addr = shard.m_addresses.find(it->second.Address);
+    if (addr != shard.m_addresses.end())
+    {
+        addr->second.erase(id);
+        if (addr->second.empty())
+            shard.m_addresses.erase(addr);
+    }
+
+    shard.m_users.erase(it);
+    return true;
+}
@@ -0,0 +1,83 @@
+// Copyright (c) 2018-2022 The Pocketnet developers
+// Distributed under the Apache 2.0 software license, see the accompanying
+// https://www.apache.org/licenses/LICENSE-2.0
+
+#ifndef POCKETCOIN_WSCONNECTIONS_H
+#define POCKETCOIN_WSCONNECTIONS_H
+
+#include "sync.h"
+#include "univalue.h"
+#include "websocket/ws.h"
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Independently locked parts of websocket subscribers registry
+static const size_t WS_CONNECTIONS_SHARDS = 16;
+
+// Snapshot of connection for sending outside of registry locks
+struct WSRecipient
+{
+    std::string Id;
+    std::string Address;
+    int Block;
+    std::shared_ptr<SimpleWeb::IWSConnection> Connection;
+};
+
+/**
+* Websocket subscribers sharded by address. Connects and disconnects lock one shard only,
+* block notifications take snapshots of connections shard by shard and send without locks,
+* so fan-out of a block to many clients doesn't stall new connections.
+*/
+class WSConnectionRegistry
+{
+public:
+    // Connection registered again with other address is moved
+    void insert_or_assign(const std::string& id, const WSUser& user);
+    void erase(const std::string& id);
+    bool empty();
+    int count();
+
+    // Calls func under lock of one shard at a time
+    void Iterate(const std::function<void(const std::pair<const std::string, WSUser>&)>& func);
+
+    std::vector<WSRecipient> Find(const std::string& address);
+    // Connections not notified about block at height yet
+    std::vector<WSRecipient> Behind(int height);
+    void SetBlock(const std::vector<WSRecipient>& recipients, int height);
+
+    // Metrics of one block fan-out, latency in microseconds
+    void AddFanout(size_t recipients, size_t messages, size_t bytes, int64_t latency);
+    UniValue Statistic();
+
+private:
+    struct Shard
+    {
+        Mutex m_mutex;
+        std::unordered_map<std::string, WSUser> m_users GUARDED_BY(m_mutex);
+        // Address -> connection ids
+        std::unordered_map<std::string, std::unordered_set<std::string>> m_addresses GUARDED_BY(m_mutex);
+    };
+
+    std::array<Shard, WS_CONNECTIONS_SHARDS> m_shards;
+
+    Mutex m_stat_mutex;
+    int64_t m_fanouts GUARDED_BY(m_stat_mutex) = 0;
+    int64_t m_lastRecipients GUARDED_BY(m_stat_mutex) = 0;
+    int64_t m_lastMessages GUARDED_BY(m_stat_mutex) = 0;
+    int64_t m_lastBytes GUARDED_BY(m_stat_mutex) = 0;
+    int64_t m_lastLatency GUARDED_BY(m_stat_mutex) = 0;
+    int64_t m_maxLatency GUARDED_BY(m_stat_mutex) = 0;
+    int64_t m_totalLatency GUARDED_BY(m_stat_mutex) = 0;
+
+    Shard& GetShard(const std::string& address);
+    // Removes connection from shard, returns false if it is not there
+    static bool Erase(Shard& shard, const std::string& id);
+};
+
+#endif // POCKETCOIN_WSCONNECTIONS_H